@@ -0,0 +1,132 @@
+<?php
+/**
+ * 計測ハーネス
+ *
+ * SocketManager::executeUnit の ticks/sec を計測する
+ *
+ * 3 ステータスを巡回するプロトコルUNITを N 接続に割り当て、1 接続 1 回の実行を 1 tick として数える
+ * コンパイル済みの UNIT（UNIT ID による実行）と、コンパイル済みテーブルを空にした名前による実行（従来の経路）を順に計測する
+ *
+ * php bench/execute_unit.php [接続数=1000] [計測秒数=3]
+ */
+
+use SocketManager\Library\IEntryUnits;
+use SocketManager\Library\SocketManager;
+use SocketManager\Library\SocketManagerParameter;
+
+
+// composer を使わずに実行できるようにする
+spl_autoload_register(function(string $p_class)
+{
+    $prefix = 'SocketManager\\Library\\';
+    if(strncmp($p_class, $prefix, strlen($prefix)) === 0)
+    {
+        $path = __DIR__.'/../src/'.str_replace('\\', '/', substr($p_class, strlen($prefix))).'.php';
+        if(file_exists($path))
+        {
+            require_once($path);
+        }
+    }
+});
+require_once(__DIR__.'/../src/FrameWork/helpers.php');
+if(!function_exists('config'))
+{
+    function config(string $p_key, $p_default = null)
+    {
+        return $p_default;
+    }
+}
+
+
+/**
+ * 計測用の UNIT（start → second → third → start を巡回する）
+ */
+class BenchEntryUnits implements IEntryUnits
+{
+    public function getQueueList(): array
+    {
+        return ['bench'];
+    }
+
+    public function getUnitList(string $p_que): array
+    {
+        return [
+            ['status' => 'start', 'unit' => function(SocketManagerParameter $p_param): ?string { return 'second'; }],
+            ['status' => 'second', 'unit' => function(SocketManagerParameter $p_param): ?string { return 'third'; }],
+            ['status' => 'third', 'unit' => function(SocketManagerParameter $p_param): ?string { return 'start'; }]
+        ];
+    }
+}
+
+
+$count = (int)($argv[1] ?? 1000);
+$seconds = (float)($argv[2] ?? 3);
+
+ob_start();
+$manager = new SocketManager('localhost', 0);
+ob_end_clean();
+$manager->setProtocolUnits(new BenchEntryUnits());
+
+// 接続の生成（private メソッドはクロージャを束縛して呼び出す）
+$cids = (function(int $p_count): array
+{
+    $ret = [];
+    for($i = 0; $i < $p_count; $i++)
+    {
+        $pair = [];
+        socket_create_pair(AF_UNIX, SOCK_STREAM, 0, $pair);
+        $des = $this->createDescriptor($pair[0]);
+        $this->setQueueNameForStart('protocol_names', $des['connection_id'], 'bench');
+        $ret[] = $des['connection_id'];
+    }
+    return $ret;
+})->call($manager, $count);
+
+// 1 周期分の実行（周期ドリブン処理と同じく接続IDを設定してから executeUnit を呼び出す）
+$cycle = Closure::bind(function(array $p_cids): void
+{
+    foreach($p_cids as $cid)
+    {
+        $this->unit_parameter->setConnectionId($cid);
+        $this->executeUnit($cid, 'protocol_names');
+    }
+}, $manager, SocketManager::class);
+
+$measure = function() use($cycle, $cids, $seconds): float
+{
+    // ウォームアップ
+    for($i = 0; $i < 10; $i++)
+    {
+        $cycle($cids);
+    }
+
+    $ticks = 0;
+    $start = hrtime(true);
+    $limit = $start + (int)($seconds * 1e9);
+    do
+    {
+        $cycle($cids);
+        $ticks += count($cids);
+        $now = hrtime(true);
+    } while($now < $limit);
+
+    return $ticks / (($now - $start) / 1e9);
+};
+
+$compiled = $measure();
+
+// コンパイル済みテーブルを空にして名前による実行へ切り替える
+$driven = (fn() => $this->cycle_driven_for_protocol)->call($manager);
+(function(): void
+{
+    $this->compiled_units = [];
+    $this->compiled_index = [];
+    $this->compiled_transitions = [];
+})->call($driven);
+
+$names = $measure();
+
+printf("connections=%d  php=%s  opcache.jit=%s\n", $count, PHP_VERSION, ini_get('opcache.jit') ?: 'off');
+printf("compiled  %12.0f ticks/sec\n", $compiled);
+printf("names     %12.0f ticks/sec\n", $names);
+printf("ratio     %12.2f\n", $compiled / $names);
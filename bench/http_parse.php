@@ -0,0 +1,138 @@
+<?php
+/**
+ * 計測ハーネス
+ *
+ * socketsfd_http_parse のスループットをコーパスのファイルごとに計測する
+ *
+ * コーパスは 1 ファイルが 1 つ以上のリクエストをそのまま連結した生のバイト列（接続の受信ストリーム）
+ * 実際のトラフィックで計測する場合は tcpflow 等で取り出したクライアント→サーバー方向のストリームをディレクトリに置いて指定する
+ * 同梱の bench/http_corpus/ は動作確認用の手書きのサンプルで、実トラフィックではない
+ *
+ * ・php      : strpos / explode によるヘッダ解析（Content-Length のみ対応。chunked のファイルは計測しない）
+ * ・native   : socketsfd_http_parse（socketsfd 拡張がある時のみ）
+ *
+ * php bench/http_parse.php [コーパスのディレクトリ=bench/http_corpus] [計測秒数=1]
+ */
+
+$dir = $argv[1] ?? __DIR__.'/http_corpus';
+$seconds = (float)($argv[2] ?? 1);
+
+
+/**
+ * PHP によるリクエストの解析（パイプラインされたリクエストをすべて取り出す）
+ *
+ * @param string $p_input 入力
+ * @return ?array リクエストのリスト or null（chunked 等で解析できない）
+ */
+function bench_http_parse_php(string $p_input): ?array
+{
+    $ret = [];
+    $pos = 0;
+    $end = strlen($p_input);
+    while($pos < $end)
+    {
+        $head_end = strpos($p_input, "\r\n\r\n", $pos);
+        if($head_end === false)
+        {
+            break;
+        }
+        $lines = explode("\r\n", substr($p_input, $pos, $head_end - $pos));
+        $line = explode(' ', array_shift($lines), 3);
+        if(count($line) !== 3)
+        {
+            return null;
+        }
+        $headers = [];
+        foreach($lines as $header)
+        {
+            $colon = strpos($header, ':');
+            if($colon === false)
+            {
+                return null;
+            }
+            $headers[strtolower(substr($header, 0, $colon))] = trim(substr($header, $colon + 1));
+        }
+        if(isset($headers['transfer-encoding']))
+        {
+            return null;
+        }
+        $len = (int)($headers['content-length'] ?? 0);
+        if($head_end + 4 + $len > $end)
+        {
+            break;
+        }
+        $ret[] = ['method' => $line[0], 'target' => $line[1], 'version' => $line[2], 'headers' => $headers, 'body_offset' => $head_end + 4, 'body_length' => $len];
+        $pos = $head_end + 4 + $len;
+    }
+
+    return $ret;
+}
+
+/**
+ * 1 つの実装の計測
+ *
+ * @param callable $p_fnc 解析関数（引数は入力。戻り値はリクエストのリスト）
+ * @param string $p_input 入力
+ * @param float $p_seconds 計測秒数
+ * @return float 1 秒あたりのリクエスト数
+ */
+function bench_http_measure(callable $p_fnc, string $p_input, float $p_seconds): float
+{
+    $reqs = 0;
+    $start = hrtime(true);
+    $limit = $start + (int)($p_seconds * 1e9);
+    do
+    {
+        $reqs += count($p_fnc($p_input));
+        $now = hrtime(true);
+    } while($now < $limit);
+
+    return $reqs / (($now - $start) / 1e9);
+}
+
+
+$native = function_exists('socketsfd_http_parse');
+printf("php=%s  opcache.jit=%s  native=%s  corpus=%s\n", PHP_VERSION, ini_get('opcache.jit') ?: 'off', $native ? 'yes' : 'no', $dir);
+printf("%-28s  %6s  %8s  %12s  %12s\n", 'file', 'reqs', 'B/req', 'php req/s', 'native req/s');
+
+$files = glob(rtrim($dir, '/').'/*') ?: [];
+foreach($files as $file)
+{
+    $raw = file_get_contents($file);
+    if($raw === false || $raw === '')
+    {
+        continue;
+    }
+
+    // 64KB 程度になるまで繰り返してパイプラインの入力にする
+    $input = str_repeat($raw, max(1, intdiv(65536, strlen($raw))));
+
+    $php = null;
+    $w_ret = bench_http_parse_php($input);
+    if($w_ret !== null)
+    {
+        $php = bench_http_measure(fn($p) => bench_http_parse_php($p), $input, $seconds);
+    }
+
+    $ext = null;
+    $count = $w_ret === null ? 0 : count($w_ret);
+    if($native === true)
+    {
+        $state = null;
+        $w_ret = socketsfd_http_parse($input, $state);
+        if($w_ret === false)
+        {
+            printf("%-28s  parse error %d\n", basename($file), $state['error'] ?? 0);
+            continue;
+        }
+        $count = count($w_ret);
+        $ext = bench_http_measure(function($p)
+        {
+            $state = null;
+            return socketsfd_http_parse($p, $state);
+        }, $input, $seconds);
+    }
+
+    printf("%-28s  %6d  %8.0f  %12s  %12s\n", basename($file), $count, $count > 0 ? strlen($input) / $count : 0,
+        $php === null ? '-' : sprintf('%.0f', $php), $ext === null ? '-' : sprintf('%.0f', $ext));
+}
@@ -0,0 +1,154 @@
+<?php
+/**
+ * 計測ハーネス
+ *
+ * WebSocket フレームのデコード（ヘッダ解析＋アンマスク）をペイロードサイズごとに比較する
+ *
+ * ・bytewise : PHP で 1 バイトずつ XOR する UNIT の実装
+ * ・strxor   : PHP でマスクを str_repeat で伸ばして文字列同士を XOR する実装
+ * ・native   : socketsfd_ws_decode（socketsfd 拡張がある時のみ）
+ *
+ * 入力はマスク付きのテキストフレームを連結したもの（サーバー側の受信と同じ）
+ *
+ * php bench/ws_codec.php [計測秒数=1]
+ */
+
+$seconds = (float)($argv[1] ?? 1);
+
+
+/**
+ * マスク付きフレームの生成
+ *
+ * @param string $p_payload ペイロード
+ * @return string フレーム
+ */
+function bench_ws_frame(string $p_payload): string
+{
+    $len = strlen($p_payload);
+    $head = chr(0x81);
+    if($len < 126)
+    {
+        $head .= chr(0x80 | $len);
+    }
+    else
+    if($len < 65536)
+    {
+        $head .= chr(0x80 | 126).pack('n', $len);
+    }
+    else
+    {
+        $head .= chr(0x80 | 127).pack('J', $len);
+    }
+    $mask = random_bytes(4);
+    $body = $p_payload ^ substr(str_repeat($mask, intdiv($len, 4) + 1), 0, $len);
+
+    return $head.$mask.$body;
+}
+
+/**
+ * PHP によるデコード
+ *
+ * @param string $p_input 入力
+ * @param bool $p_bytewise true（1 バイトずつ XOR） or false（文字列同士の XOR）
+ * @return array ペイロードのリスト
+ */
+function bench_ws_decode_php(string $p_input, bool $p_bytewise): array
+{
+    $ret = [];
+    $pos = 0;
+    $end = strlen($p_input);
+    while($pos + 2 <= $end)
+    {
+        $b1 = ord($p_input[$pos + 1]);
+        $len = $b1 & 0x7f;
+        $hdr = 2;
+        if($len === 126)
+        {
+            $len = unpack('n', $p_input, $pos + 2)[1];
+            $hdr = 4;
+        }
+        else
+        if($len === 127)
+        {
+            $len = unpack('J', $p_input, $pos + 2)[1];
+            $hdr = 10;
+        }
+        if($pos + $hdr + 4 + $len > $end)
+        {
+            break;
+        }
+        $mask = substr($p_input, $pos + $hdr, 4);
+        $data = substr($p_input, $pos + $hdr + 4, $len);
+        if($p_bytewise === true)
+        {
+            for($i = 0; $i < $len; $i++)
+            {
+                $data[$i] = $data[$i] ^ $mask[$i & 3];
+            }
+        }
+        else
+        {
+            $data = $data ^ substr(str_repeat($mask, intdiv($len, 4) + 1), 0, $len);
+        }
+        $ret[] = $data;
+        $pos += $hdr + 4 + $len;
+    }
+
+    return $ret;
+}
+
+/**
+ * 1 つの実装の計測
+ *
+ * @param callable $p_fnc デコード関数（引数は入力）
+ * @param string $p_input 入力
+ * @param int $p_frames 入力に含まれるフレーム数
+ * @param float $p_seconds 計測秒数
+ * @return float 1 フレームあたりの時間（ns）
+ */
+function bench_ws_measure(callable $p_fnc, string $p_input, int $p_frames, float $p_seconds): float
+{
+    $p_fnc($p_input);
+
+    $calls = 0;
+    $start = hrtime(true);
+    $limit = $start + (int)($p_seconds * 1e9);
+    do
+    {
+        $p_fnc($p_input);
+        $calls++;
+        $now = hrtime(true);
+    } while($now < $limit);
+
+    return ($now - $start) / ($calls * $p_frames);
+}
+
+
+$native = function_exists('socketsfd_ws_decode');
+printf("php=%s  opcache.jit=%s  native=%s\n", PHP_VERSION, ini_get('opcache.jit') ?: 'off', $native ? 'yes' : 'no');
+printf("%8s  %14s  %14s  %14s\n", 'size', 'bytewise ns', 'strxor ns', 'native ns');
+
+foreach([100, 4096, 1048576] as $size)
+{
+    // 1 回の入力がおよそ 1MB になるようにフレームを並べる
+    $frames = max(1, intdiv(1048576, $size));
+    $input = '';
+    for($i = 0; $i < $frames; $i++)
+    {
+        $input .= bench_ws_frame(random_bytes($size));
+    }
+
+    $bytewise = bench_ws_measure(fn($p) => bench_ws_decode_php($p, true), $input, $frames, $seconds);
+    $strxor = bench_ws_measure(fn($p) => bench_ws_decode_php($p, false), $input, $frames, $seconds);
+    $ext = null;
+    if($native === true)
+    {
+        $ext = bench_ws_measure(function($p)
+        {
+            $state = null;
+            return socketsfd_ws_decode($p, $state, SOCKETSFD_WS_MASKED);
+        }, $input, $frames, $seconds);
+    }
+
+    printf("%8d  %14.0f  %14.0f  %14s\n", $size, $bytewise, $strxor, $ext === null ? '-' : sprintf('%.0f', $ext));
+}
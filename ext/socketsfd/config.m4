@@ -19,5 +19,5 @@ if test "$PHP_SOCKETSFD" != "no"; then
   dnl ---- Add include path ----
   PHP_ADD_INCLUDE(`php-config --include-dir`/ext/sockets)
 
-  PHP_NEW_EXTENSION(socketsfd, socketsfd.c, $ext_shared)
+  PHP_NEW_EXTENSION(socketsfd, socketsfd.c socketsfd_io.c socketsfd_buffer.c socketsfd_ws.c socketsfd_http.c, $ext_shared)
 fi
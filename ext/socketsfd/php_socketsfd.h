@@ -0,0 +1,64 @@
+#ifndef PHP_SOCKETSFD_H
+#define PHP_SOCKETSFD_H
+
+extern zend_module_entry socketsfd_module_entry;
+#define phpext_socketsfd_ptr &socketsfd_module_entry
+
+/* ========= SocketsFd\Buffer（socketsfd_buffer.c） ========= */
+
+extern zend_class_entry *socketsfd_buffer_ce;
+
+int socketsfd_buffer_minit(INIT_FUNC_ARGS);
+
+const char *socketsfd_buffer_linear(zend_object *obj, size_t *len);
+void socketsfd_buffer_discard(zend_object *obj, size_t n);
+
+/* ========= WebSocket コーデック（socketsfd_ws.c） ========= */
+
+int socketsfd_ws_minit(INIT_FUNC_ARGS);
+
+PHP_FUNCTION(socketsfd_ws_decode);
+PHP_FUNCTION(socketsfd_ws_encode);
+
+/* ========= HTTP/1.1 リクエストパーサ（socketsfd_http.c） ========= */
+
+int socketsfd_http_minit(INIT_FUNC_ARGS);
+
+PHP_FUNCTION(socketsfd_http_parse);
+
+/* ========= I/O ドライバ（socketsfd_io.c / Linux 専用） ========= */
+
+#ifndef PHP_WIN32
+
+int socketsfd_io_minit(INIT_FUNC_ARGS);
+
+PHP_FUNCTION(socketsfd_io_create);
+PHP_FUNCTION(socketsfd_io_register);
+PHP_FUNCTION(socketsfd_io_register_listen);
+PHP_FUNCTION(socketsfd_io_register_udp_listen);
+PHP_FUNCTION(socketsfd_io_connect);
+PHP_FUNCTION(socketsfd_io_set_resolver);
+PHP_FUNCTION(socketsfd_io_set_profile);
+PHP_FUNCTION(socketsfd_io_set_busy_poll);
+PHP_FUNCTION(socketsfd_io_set_framing);
+PHP_FUNCTION(socketsfd_io_set_rate_limit);
+PHP_FUNCTION(socketsfd_set_affinity);
+PHP_FUNCTION(socketsfd_io_unregister);
+PHP_FUNCTION(socketsfd_io_wait);
+PHP_FUNCTION(socketsfd_io_getsockname);
+PHP_FUNCTION(socketsfd_io_send_file);
+PHP_FUNCTION(socketsfd_io_send);
+PHP_FUNCTION(socketsfd_io_set_zerocopy);
+PHP_FUNCTION(socketsfd_io_flush);
+PHP_FUNCTION(socketsfd_io_ipc_open);
+PHP_FUNCTION(socketsfd_io_ipc_send);
+PHP_FUNCTION(socketsfd_io_set_listen_exclusive);
+PHP_FUNCTION(socketsfd_io_stats_enable);
+PHP_FUNCTION(socketsfd_io_stats_begin);
+PHP_FUNCTION(socketsfd_io_stats_end);
+PHP_FUNCTION(socketsfd_io_stats_get);
+PHP_FUNCTION(socketsfd_io_metrics);
+
+#endif /* !PHP_WIN32 */
+
+#endif /* PHP_SOCKETSFD_H */
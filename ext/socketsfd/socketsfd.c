@@ -3,6 +3,7 @@
 #endif
 
 #include "php.h"
+#include "php_socketsfd.h"
 
 /* ========= 共通定義 ========= */
 
@@ -13,6 +14,9 @@ typedef SOCKET PHP_SOCKET;
 # define PHP_SOCKETS_INVALID_SOCKET INVALID_SOCKET
 #else
 # include "ext/sockets/php_sockets.h"  /* 本物の sockets 拡張に依存 */
+# include <dirent.h>
+# include <fcntl.h>
+# include <unistd.h>
 # define PHP_SOCKETS_INVALID_SOCKET -1
 #endif
 
@@ -209,8 +213,155 @@ ZEND_END_ARG_INFO()
 ZEND_BEGIN_ARG_INFO_EX(arginfo_socket_strerror, 0, 0, 1)
     ZEND_ARG_TYPE_INFO(0, errno, IS_LONG, 0)
 ZEND_END_ARG_INFO()
+#else
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_create, 0, 0, 0)
+    ZEND_ARG_TYPE_INFO(0, recv_buf_size, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_register, 0, 0, 2)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, fd, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, is_udp, _IS_BOOL, 0)
+    ZEND_ARG_TYPE_INFO(0, is_client, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_fd, 0, 0, 2)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, fd, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_set_profile, 0, 0, 3)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, is_client, _IS_BOOL, 0)
+    ZEND_ARG_TYPE_INFO(0, profile, IS_ARRAY, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_set_busy_poll, 0, 0, 2)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, enable, _IS_BOOL, 0)
+    ZEND_ARG_TYPE_INFO(0, usecs, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, budget, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, prefer, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_set_framing, 0, 0, 3)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, fd, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, spec, IS_ARRAY, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_connect, 0, 0, 3)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, host, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, port, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, timeout_ms, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_ipc_open, 0, 0, 3)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, owner, _IS_BOOL, 0)
+    ZEND_ARG_TYPE_INFO(0, capacity, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_set_listen_exclusive, 0, 0, 2)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, fd, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, batch, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_stats_enable, 0, 0, 2)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, enable, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_stats_metric, 0, 0, 2)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, metric, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_stats_get, 0, 0, 1)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, reset, _IS_BOOL, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_metrics, 0, 0, 1)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_set_resolver, 0, 0, 1)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, server, IS_STRING, 1)
+    ZEND_ARG_TYPE_INFO(0, port, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, timeout_ms, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, attempts, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_set_rate_limit, 0, 0, 3)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, fd, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, spec, IS_ARRAY, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_set_affinity, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, cpus, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_wait, 0, 0, 1)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, timeout_ms, IS_LONG, 0)
+    ZEND_ARG_INFO(1, fallback)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_getsockname, 0, 0, 4)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, fd, IS_LONG, 0)
+    ZEND_ARG_INFO(1, address)
+    ZEND_ARG_INFO(1, port)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_send_file, 0, 0, 3)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, fd, IS_LONG, 0)
+    ZEND_ARG_INFO(0, file)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_send, 0, 0, 3)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, fd, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, data, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_io_set_zerocopy, 0, 0, 2)
+    ZEND_ARG_OBJ_INFO(0, context, SocketsFd\\IoContext, 0)
+    ZEND_ARG_TYPE_INFO(0, threshold, IS_LONG, 0)
+ZEND_END_ARG_INFO()
 #endif
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_ws_decode, 0, 0, 1)
+    ZEND_ARG_INFO(0, input)
+    ZEND_ARG_INFO(1, state)
+    ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, max_payload, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_ws_encode, 0, 0, 1)
+    ZEND_ARG_INFO(0, payload)
+    ZEND_ARG_TYPE_INFO(0, opcode, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, flags, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, fragment_size, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_socketsfd_http_parse, 0, 0, 1)
+    ZEND_ARG_INFO(0, input)
+    ZEND_ARG_INFO(1, state)
+    ZEND_ARG_TYPE_INFO(0, max_header_size, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, max_body_size, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, max_requests, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 /* ========= 関数実装 ========= */
 
 /* proto int socketsfd(Socket $socket) */
@@ -237,6 +388,95 @@ PHP_FUNCTION(socketsfd)
 #endif
 }
 
+#ifndef PHP_WIN32
+/*
+ * proto array|false socketsfd_peer_cred(Socket $socket)
+ *
+ * UNIX ドメインソケットの接続相手の資格情報（SO_PEERCRED）を ['pid' => int, 'uid' => int, 'gid' => int] で返す。
+ * 値は connect／socketpair の時点のもの。未対応の OS や UNIX ドメイン以外では false。
+ */
+PHP_FUNCTION(socketsfd_peer_cred)
+{
+    zval *zsock;
+    php_socket *php_sock;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_OBJECT_OF_CLASS(zsock, socket_ce)
+    ZEND_PARSE_PARAMETERS_END();
+
+    php_sock = Z_SOCKET_P(zsock);
+    ENSURE_SOCKET_VALID(php_sock);
+
+#if defined(__linux__) && defined(SO_PEERCRED)
+    struct ucred cred;
+    socklen_t len = sizeof(cred);
+
+    if (getsockopt(php_sock->bsd_socket, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0) {
+        RETURN_FALSE;
+    }
+
+    array_init(return_value);
+    add_assoc_long(return_value, "pid", (zend_long) cred.pid);
+    add_assoc_long(return_value, "uid", (zend_long) cred.uid);
+    add_assoc_long(return_value, "gid", (zend_long) cred.gid);
+#else
+    RETURN_FALSE;
+#endif
+}
+
+/*
+ * proto int|false socketsfd_close_inherited(Socket $keep)
+ *
+ * fork した子プロセス用。標準入出力と $keep 以外の fd（/proc/self/fd）を /dev/null に差し替え、
+ * 親から引き継いだ待ち受けソケットや接続の参照を手放す。差し替えた数を返す。
+ * close ではなく差し替えるのは、親から引き継いだ PHP のオブジェクトが後から同じ番号を close しても、
+ * 子プロセスで新しく開いた fd を巻き込まないようにするため。
+ */
+PHP_FUNCTION(socketsfd_close_inherited)
+{
+    zval *zsock;
+    php_socket *php_sock;
+    struct dirent *de;
+    zend_long count = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_OBJECT_OF_CLASS(zsock, socket_ce)
+    ZEND_PARSE_PARAMETERS_END();
+
+    php_sock = Z_SOCKET_P(zsock);
+    ENSURE_SOCKET_VALID(php_sock);
+
+    int keep = php_sock->bsd_socket;
+    int null_fd = open("/dev/null", O_RDWR | O_CLOEXEC);
+    if (null_fd < 0) {
+        RETURN_FALSE;
+    }
+    DIR *dir = opendir("/proc/self/fd");
+    if (!dir) {
+        close(null_fd);
+        RETURN_FALSE;
+    }
+
+    /* 差し替えは既存の番号の上書きなので、走査中にエントリは増減しない */
+    while ((de = readdir(dir)) != NULL) {
+        if (de->d_name[0] < '0' || de->d_name[0] > '9') {
+            continue;
+        }
+        int fd = atoi(de->d_name);
+        if (fd <= 2 || fd == keep || fd == null_fd || fd == dirfd(dir)) {
+            continue;
+        }
+        if (dup2(null_fd, fd) == fd) {
+            count++;
+        }
+    }
+    closedir(dir);
+    close(null_fd);
+
+    RETURN_LONG(count);
+}
+#endif /* !PHP_WIN32 */
+
 #ifdef PHP_WIN32
 /* proto Socket socket_import_fd(int $fd) */
 PHP_FUNCTION(socket_import_fd)
@@ -1176,6 +1416,9 @@ PHP_FUNCTION(socket_strerror)
 
 static const zend_function_entry socketsfd_functions[] = {
     PHP_FE(socketsfd,        arginfo_socketsfd)
+    PHP_FE(socketsfd_ws_decode, arginfo_socketsfd_ws_decode)
+    PHP_FE(socketsfd_ws_encode, arginfo_socketsfd_ws_encode)
+    PHP_FE(socketsfd_http_parse, arginfo_socketsfd_http_parse)
 #ifdef PHP_WIN32
     PHP_FE(socket_import_fd,    arginfo_socket_import_fd)
     PHP_FE(socket_create,       arginfo_socket_create)
@@ -1198,6 +1441,35 @@ static const zend_function_entry socketsfd_functions[] = {
     PHP_FE(socket_select,       arginfo_socket_select)
     PHP_FE(socket_last_error,   arginfo_socket_last_error)
     PHP_FE(socket_strerror,     arginfo_socket_strerror)
+#else
+    PHP_FE(socketsfd_peer_cred,              arginfo_socketsfd)
+    PHP_FE(socketsfd_close_inherited,        arginfo_socketsfd)
+    PHP_FE(socketsfd_io_create,              arginfo_socketsfd_io_create)
+    PHP_FE(socketsfd_io_register,            arginfo_socketsfd_io_register)
+    PHP_FE(socketsfd_io_register_listen,     arginfo_socketsfd_io_fd)
+    PHP_FE(socketsfd_io_register_udp_listen, arginfo_socketsfd_io_fd)
+    PHP_FE(socketsfd_io_connect,             arginfo_socketsfd_io_connect)
+    PHP_FE(socketsfd_io_set_resolver,        arginfo_socketsfd_io_set_resolver)
+    PHP_FE(socketsfd_io_set_profile,         arginfo_socketsfd_io_set_profile)
+    PHP_FE(socketsfd_io_set_busy_poll,       arginfo_socketsfd_io_set_busy_poll)
+    PHP_FE(socketsfd_set_affinity,           arginfo_socketsfd_set_affinity)
+    PHP_FE(socketsfd_io_set_framing,         arginfo_socketsfd_io_set_framing)
+    PHP_FE(socketsfd_io_set_rate_limit,      arginfo_socketsfd_io_set_rate_limit)
+    PHP_FE(socketsfd_io_unregister,          arginfo_socketsfd_io_fd)
+    PHP_FE(socketsfd_io_wait,                arginfo_socketsfd_io_wait)
+    PHP_FE(socketsfd_io_getsockname,         arginfo_socketsfd_io_getsockname)
+    PHP_FE(socketsfd_io_send_file,           arginfo_socketsfd_io_send_file)
+    PHP_FE(socketsfd_io_send,                arginfo_socketsfd_io_send)
+    PHP_FE(socketsfd_io_set_zerocopy,        arginfo_socketsfd_io_set_zerocopy)
+    PHP_FE(socketsfd_io_flush,               arginfo_socketsfd_io_fd)
+    PHP_FE(socketsfd_io_ipc_open,            arginfo_socketsfd_io_ipc_open)
+    PHP_FE(socketsfd_io_ipc_send,            arginfo_socketsfd_io_send)
+    PHP_FE(socketsfd_io_set_listen_exclusive, arginfo_socketsfd_io_set_listen_exclusive)
+    PHP_FE(socketsfd_io_stats_enable,        arginfo_socketsfd_io_stats_enable)
+    PHP_FE(socketsfd_io_stats_begin,         arginfo_socketsfd_io_stats_metric)
+    PHP_FE(socketsfd_io_stats_end,           arginfo_socketsfd_io_stats_metric)
+    PHP_FE(socketsfd_io_stats_get,           arginfo_socketsfd_io_stats_get)
+    PHP_FE(socketsfd_io_metrics,             arginfo_socketsfd_io_metrics)
 #endif
     PHP_FE_END
 };
@@ -1229,7 +1501,20 @@ PHP_MINIT_FUNCTION(socketsfd)
     memcpy(&socket_object_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
     socket_object_handlers.offset   = XtOffsetOf(php_socket, std);
     socket_object_handlers.free_obj = socket_object_free;
+#else
+    if (socketsfd_io_minit(INIT_FUNC_ARGS_PASSTHRU) != SUCCESS) {
+        return FAILURE;
+    }
 #endif
+    if (socketsfd_buffer_minit(INIT_FUNC_ARGS_PASSTHRU) != SUCCESS) {
+        return FAILURE;
+    }
+    if (socketsfd_ws_minit(INIT_FUNC_ARGS_PASSTHRU) != SUCCESS) {
+        return FAILURE;
+    }
+    if (socketsfd_http_minit(INIT_FUNC_ARGS_PASSTHRU) != SUCCESS) {
+        return FAILURE;
+    }
     return SUCCESS;
 }
 
@@ -0,0 +1,592 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "php.h"
+#include "zend_exceptions.h"
+#include "zend_interfaces.h"
+#include "php_socketsfd.h"
+
+#include <string.h>
+
+/*
+ * SocketsFd\Buffer
+ *
+ * プロトコル解析用の可変長リングバッファ。
+ * 受信データを append で溜め、peek / readUint* / indexOf でその場のまま解析し、
+ * 確定した分だけ consume する（途中で PHP 文字列を作らない）。
+ *
+ * 容量は常に 2 のべき乗で、位置計算はマスクで行う。
+ */
+
+#define SOCKETSFD_BUFFER_MIN_CAPACITY 64
+
+/* ========= Buffer オブジェクト ========= */
+
+typedef struct {
+    char       *data;
+    size_t      cap;    /* 容量（2 のべき乗） */
+    size_t      head;   /* 先頭位置 */
+    size_t      len;    /* 格納サイズ */
+    zend_object std;
+} socketsfd_buffer_object;
+
+zend_class_entry *socketsfd_buffer_ce;
+static zend_object_handlers socketsfd_buffer_handlers;
+
+static inline socketsfd_buffer_object *socketsfd_buffer_from_obj(zend_object *obj)
+{
+    return (socketsfd_buffer_object *)((char *)obj - XtOffsetOf(socketsfd_buffer_object, std));
+}
+
+# define Z_SOCKETSFD_BUFFER_P(zv) socketsfd_buffer_from_obj(Z_OBJ_P((zv)))
+
+static size_t buffer_round_capacity(size_t size)
+{
+    size_t cap = SOCKETSFD_BUFFER_MIN_CAPACITY;
+    while (cap < size) {
+        cap <<= 1;
+    }
+    return cap;
+}
+
+/* 論理位置 off から n バイトを dst へコピー（折り返し対応） */
+static void buffer_copy_out(const socketsfd_buffer_object *b, size_t off, size_t n, char *dst)
+{
+    if (n == 0) {
+        return;
+    }
+
+    size_t pos   = (b->head + off) & (b->cap - 1);
+    size_t first = b->cap - pos;
+    if (first > n) {
+        first = n;
+    }
+
+    memcpy(dst, b->data + pos, first);
+    if (n > first) {
+        memcpy(dst + first, b->data, n - first);
+    }
+}
+
+static inline unsigned char buffer_byte_at(const socketsfd_buffer_object *b, size_t off)
+{
+    return (unsigned char)b->data[(b->head + off) & (b->cap - 1)];
+}
+
+/* 容量を new_cap に変更し、先頭を 0 に揃える */
+static void buffer_realloc(socketsfd_buffer_object *b, size_t new_cap)
+{
+    char *tmp = emalloc(new_cap);
+    buffer_copy_out(b, 0, b->len, tmp);
+    efree(b->data);
+
+    b->data = tmp;
+    b->cap  = new_cap;
+    b->head = 0;
+}
+
+/* extra バイト追加できるように容量を確保 */
+static void buffer_reserve(socketsfd_buffer_object *b, size_t extra)
+{
+    if (b->len + extra <= b->cap) {
+        return;
+    }
+    buffer_realloc(b, buffer_round_capacity(b->len + extra));
+}
+
+/* 折り返している場合は連続領域に並べ直す（検索用） */
+static void buffer_linearize(socketsfd_buffer_object *b)
+{
+    if (b->head + b->len <= b->cap) {
+        return;
+    }
+    buffer_realloc(b, b->cap);
+}
+
+static void buffer_append(socketsfd_buffer_object *b, const char *src, size_t n)
+{
+    if (n == 0) {
+        return;
+    }
+
+    buffer_reserve(b, n);
+
+    size_t pos   = (b->head + b->len) & (b->cap - 1);
+    size_t first = b->cap - pos;
+    if (first > n) {
+        first = n;
+    }
+
+    memcpy(b->data + pos, src, first);
+    if (n > first) {
+        memcpy(b->data, src + first, n - first);
+    }
+    b->len += n;
+}
+
+static void buffer_discard(socketsfd_buffer_object *b, size_t n)
+{
+    b->len -= n;
+    b->head = (b->len == 0) ? 0 : ((b->head + n) & (b->cap - 1));
+}
+
+static zend_object *socketsfd_buffer_object_create(zend_class_entry *ce)
+{
+    socketsfd_buffer_object *b = zend_object_alloc(sizeof(socketsfd_buffer_object), ce);
+
+    b->cap  = SOCKETSFD_BUFFER_MIN_CAPACITY;
+    b->data = emalloc(b->cap);
+    b->head = 0;
+    b->len  = 0;
+
+    zend_object_std_init(&b->std, ce);
+    object_properties_init(&b->std, ce);
+    b->std.handlers = &socketsfd_buffer_handlers;
+
+    return &b->std;
+}
+
+static void socketsfd_buffer_object_free(zend_object *object)
+{
+    socketsfd_buffer_object *b = socketsfd_buffer_from_obj(object);
+
+    if (b->data) {
+        efree(b->data);
+        b->data = NULL;
+    }
+
+    zend_object_std_dtor(&b->std);
+}
+
+static zend_object *socketsfd_buffer_object_clone(zend_object *old_object)
+{
+    socketsfd_buffer_object *src = socketsfd_buffer_from_obj(old_object);
+    zend_object *new_object = socketsfd_buffer_object_create(old_object->ce);
+    socketsfd_buffer_object *dst = socketsfd_buffer_from_obj(new_object);
+
+    zend_objects_clone_members(new_object, old_object);
+
+    buffer_reserve(dst, src->len);
+    buffer_copy_out(src, 0, src->len, dst->data);
+    dst->len = src->len;
+
+    return new_object;
+}
+
+/* offset / length の検査（範囲外は ValueError） */
+static bool buffer_check_range(zend_long offset, uint32_t offset_arg, zend_long length, uint32_t length_arg)
+{
+    if (offset < 0) {
+        zend_argument_value_error(offset_arg, "must be greater than or equal to 0");
+        return false;
+    }
+    if (length < 0) {
+        zend_argument_value_error(length_arg, "must be greater than or equal to 0");
+        return false;
+    }
+    return true;
+}
+
+/* ========= メソッド実装 ========= */
+
+/* proto SocketsFd\Buffer::__construct(int $capacity = 4096) */
+PHP_METHOD(SocketsFd_Buffer, __construct)
+{
+    zend_long capacity = 4096;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(capacity)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (capacity < 0) {
+        zend_argument_value_error(1, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+    buffer_reserve(b, (size_t)capacity);
+}
+
+/* proto int SocketsFd\Buffer::append(string $data) */
+PHP_METHOD(SocketsFd_Buffer, append)
+{
+    zend_string *data;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_STR(data)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+    buffer_append(b, ZSTR_VAL(data), ZSTR_LEN(data));
+
+    RETURN_LONG((zend_long)b->len);
+}
+
+/* proto string SocketsFd\Buffer::peek(int $length, int $offset = 0) */
+PHP_METHOD(SocketsFd_Buffer, peek)
+{
+    zend_long length;
+    zend_long offset = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_LONG(length)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (!buffer_check_range(offset, 2, length, 1)) {
+        RETURN_THROWS();
+    }
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+    if ((size_t)offset >= b->len) {
+        RETURN_EMPTY_STRING();
+    }
+
+    size_t n = b->len - (size_t)offset;
+    if ((size_t)length < n) {
+        n = (size_t)length;
+    }
+
+    zend_string *ret = zend_string_alloc(n, 0);
+    buffer_copy_out(b, (size_t)offset, n, ZSTR_VAL(ret));
+    ZSTR_VAL(ret)[n] = '\0';
+
+    RETURN_NEW_STR(ret);
+}
+
+/* proto int SocketsFd\Buffer::consume(int $length) */
+PHP_METHOD(SocketsFd_Buffer, consume)
+{
+    zend_long length;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_LONG(length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (!buffer_check_range(0, 1, length, 1)) {
+        RETURN_THROWS();
+    }
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+
+    size_t n = b->len;
+    if ((size_t)length < n) {
+        n = (size_t)length;
+    }
+    buffer_discard(b, n);
+
+    RETURN_LONG((zend_long)n);
+}
+
+/* proto ?int SocketsFd\Buffer::readUint16BE(int $offset = 0) */
+PHP_METHOD(SocketsFd_Buffer, readUint16BE)
+{
+    zend_long offset = 0;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (!buffer_check_range(offset, 1, 0, 1)) {
+        RETURN_THROWS();
+    }
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+    if ((size_t)offset + 2 > b->len) {
+        RETURN_NULL();  /* データ不足 */
+    }
+
+    size_t o = (size_t)offset;
+    RETURN_LONG(((zend_long)buffer_byte_at(b, o) << 8) | (zend_long)buffer_byte_at(b, o + 1));
+}
+
+/* proto ?int SocketsFd\Buffer::readUint32BE(int $offset = 0) */
+PHP_METHOD(SocketsFd_Buffer, readUint32BE)
+{
+    zend_long offset = 0;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (!buffer_check_range(offset, 1, 0, 1)) {
+        RETURN_THROWS();
+    }
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+    if ((size_t)offset + 4 > b->len) {
+        RETURN_NULL();  /* データ不足 */
+    }
+
+    size_t o = (size_t)offset;
+    uint32_t v = ((uint32_t)buffer_byte_at(b, o) << 24)
+               | ((uint32_t)buffer_byte_at(b, o + 1) << 16)
+               | ((uint32_t)buffer_byte_at(b, o + 2) << 8)
+               |  (uint32_t)buffer_byte_at(b, o + 3);
+
+    RETURN_LONG((zend_long)v);
+}
+
+/*
+ * proto ?int SocketsFd\Buffer::readVarint(int $offset = 0, ?int &$size = null)
+ *
+ * 符号なし LEB128（protobuf 形式）。$size には使用したバイト数を格納する。
+ */
+PHP_METHOD(SocketsFd_Buffer, readVarint)
+{
+    zend_long offset = 0;
+    zval *zsize = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(0, 2)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+        Z_PARAM_ZVAL(zsize)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (!buffer_check_range(offset, 1, 0, 1)) {
+        RETURN_THROWS();
+    }
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+
+    uint64_t v = 0;
+    for (size_t i = 0; i < 10; i++) {
+        size_t o = (size_t)offset + i;
+        if (o >= b->len) {
+            RETURN_NULL();  /* データ不足 */
+        }
+
+        unsigned char c = buffer_byte_at(b, o);
+        v |= (uint64_t)(c & 0x7f) << (7 * i);
+
+        if ((c & 0x80) == 0) {
+            if (zsize) {
+                ZEND_TRY_ASSIGN_REF_LONG(zsize, (zend_long)(i + 1));
+            }
+            RETURN_LONG((zend_long)v);
+        }
+    }
+
+    zend_throw_exception(NULL, "Varint is longer than 10 bytes", 0);
+}
+
+/* proto int|false SocketsFd\Buffer::indexOf(string $needle, int $offset = 0) */
+PHP_METHOD(SocketsFd_Buffer, indexOf)
+{
+    zend_string *needle;
+    zend_long offset = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_STR(needle)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (!buffer_check_range(offset, 2, 0, 2)) {
+        RETURN_THROWS();
+    }
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+
+    size_t nlen = ZSTR_LEN(needle);
+    if (nlen == 0 || (size_t)offset + nlen > b->len) {
+        RETURN_FALSE;
+    }
+
+    buffer_linearize(b);
+
+    const char *base = b->data + b->head;
+    const char *hay  = base + offset;
+    size_t      hlen = b->len - (size_t)offset;
+    const char *hit;
+
+    if (nlen == 1) {
+        hit = memchr(hay, ZSTR_VAL(needle)[0], hlen);
+    } else {
+        hit = zend_memnstr(hay, ZSTR_VAL(needle), nlen, hay + hlen);
+    }
+
+    if (hit == NULL) {
+        RETURN_FALSE;
+    }
+
+    RETURN_LONG((zend_long)(hit - base));
+}
+
+/* proto SocketsFd\Buffer SocketsFd\Buffer::slice(int $offset, ?int $length = null) */
+PHP_METHOD(SocketsFd_Buffer, slice)
+{
+    zend_long offset;
+    zend_long length = 0;
+    bool length_is_null = 1;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_LONG(offset)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG_OR_NULL(length, length_is_null)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (!buffer_check_range(offset, 1, length, 2)) {
+        RETURN_THROWS();
+    }
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+
+    size_t n = 0;
+    if ((size_t)offset < b->len) {
+        n = b->len - (size_t)offset;
+        if (!length_is_null && (size_t)length < n) {
+            n = (size_t)length;
+        }
+    }
+
+    object_init_ex(return_value, socketsfd_buffer_ce);
+    socketsfd_buffer_object *dst = Z_SOCKETSFD_BUFFER_P(return_value);
+
+    buffer_reserve(dst, n);
+    buffer_copy_out(b, (size_t)offset, n, dst->data);
+    dst->len = n;
+}
+
+/* proto int SocketsFd\Buffer::length() */
+PHP_METHOD(SocketsFd_Buffer, length)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    RETURN_LONG((zend_long)Z_SOCKETSFD_BUFFER_P(ZEND_THIS)->len);
+}
+
+/* proto void SocketsFd\Buffer::clear() */
+PHP_METHOD(SocketsFd_Buffer, clear)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+    b->head = 0;
+    b->len  = 0;
+}
+
+/* proto string SocketsFd\Buffer::__toString() */
+PHP_METHOD(SocketsFd_Buffer, __toString)
+{
+    ZEND_PARSE_PARAMETERS_NONE();
+
+    socketsfd_buffer_object *b = Z_SOCKETSFD_BUFFER_P(ZEND_THIS);
+
+    zend_string *ret = zend_string_alloc(b->len, 0);
+    buffer_copy_out(b, 0, b->len, ZSTR_VAL(ret));
+    ZSTR_VAL(ret)[b->len] = '\0';
+
+    RETURN_NEW_STR(ret);
+}
+
+/* ========= arginfo ========= */
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer___construct, 0, 0, 0)
+    ZEND_ARG_TYPE_INFO(0, capacity, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer_append, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, data, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer_peek, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer_consume, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer_read_uint, 0, 0, 0)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer_read_varint, 0, 0, 0)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, 0)
+    ZEND_ARG_INFO(1, size)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer_index_of, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, needle, IS_STRING, 0)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer_slice, 0, 0, 1)
+    ZEND_ARG_TYPE_INFO(0, offset, IS_LONG, 0)
+    ZEND_ARG_TYPE_INFO(0, length, IS_LONG, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_buffer_none, 0, 0, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_WITH_RETURN_TYPE_INFO_EX(arginfo_buffer___toString, 0, 0, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+/* ========= メソッドテーブル ========= */
+
+static const zend_function_entry socketsfd_buffer_methods[] = {
+    PHP_ME(SocketsFd_Buffer, __construct,  arginfo_buffer___construct,  ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, append,       arginfo_buffer_append,       ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, peek,         arginfo_buffer_peek,         ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, consume,      arginfo_buffer_consume,      ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, readUint16BE, arginfo_buffer_read_uint,    ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, readUint32BE, arginfo_buffer_read_uint,    ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, readVarint,   arginfo_buffer_read_varint,  ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, indexOf,      arginfo_buffer_index_of,     ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, slice,        arginfo_buffer_slice,        ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, length,       arginfo_buffer_none,         ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, clear,        arginfo_buffer_none,         ZEND_ACC_PUBLIC)
+    PHP_ME(SocketsFd_Buffer, __toString,   arginfo_buffer___toString,   ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+/* ========= C 側からの利用（他のソースファイル向け） ========= */
+
+/* 連続領域として先頭ポインタを取得（折り返していれば並べ直す） */
+const char *socketsfd_buffer_linear(zend_object *obj, size_t *len)
+{
+    socketsfd_buffer_object *b = socketsfd_buffer_from_obj(obj);
+
+    buffer_linearize(b);
+    *len = b->len;
+
+    return b->data + b->head;
+}
+
+/* 先頭から n バイト破棄 */
+void socketsfd_buffer_discard(zend_object *obj, size_t n)
+{
+    socketsfd_buffer_object *b = socketsfd_buffer_from_obj(obj);
+
+    if (n > b->len) {
+        n = b->len;
+    }
+    buffer_discard(b, n);
+}
+
+/* ========= MINIT ========= */
+
+int socketsfd_buffer_minit(INIT_FUNC_ARGS)
+{
+    zend_class_entry ce;
+
+    INIT_NS_CLASS_ENTRY(ce, "SocketsFd", "Buffer", socketsfd_buffer_methods);
+    socketsfd_buffer_ce = zend_register_internal_class(&ce);
+    socketsfd_buffer_ce->ce_flags |= ZEND_ACC_FINAL | ZEND_ACC_NO_DYNAMIC_PROPERTIES | ZEND_ACC_NOT_SERIALIZABLE;
+    socketsfd_buffer_ce->create_object = socketsfd_buffer_object_create;
+    zend_class_implements(socketsfd_buffer_ce, 1, zend_ce_stringable);
+
+    memcpy(&socketsfd_buffer_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    socketsfd_buffer_handlers.offset    = XtOffsetOf(socketsfd_buffer_object, std);
+    socketsfd_buffer_handlers.free_obj  = socketsfd_buffer_object_free;
+    socketsfd_buffer_handlers.clone_obj = socketsfd_buffer_object_clone;
+
+    return SUCCESS;
+}
@@ -0,0 +1,661 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "php.h"
+#include "php_socketsfd.h"
+
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * HTTP/1.1 リクエストパーサ（RFC 9112）
+ *
+ * 受信バッファ上で直接解析し、ボディはオフセットのみ返す（ゼロコピー）。
+ * 完結しているリクエストはパイプライン分もまとめて返し、未完の末尾は残す。
+ * chunked ボディはデコード済み文字列を返す。
+ *
+ * 解析部（http_parse_request）は zval に依存しない純粋な C で、
+ * 結果の配列化は PHP_FUNCTION 側で行う。
+ */
+
+#define HTTP_MAX_HEADERS 100
+
+#define HTTP_OK                  0
+#define HTTP_INCOMPLETE         -1
+#define HTTP_BAD_REQUEST        400
+#define HTTP_PAYLOAD_TOO_LARGE  413
+#define HTTP_HEADERS_TOO_LARGE  431
+#define HTTP_NOT_IMPLEMENTED    501
+
+typedef struct {
+    size_t name_off, name_len;
+    size_t value_off, value_len;
+} http_header;
+
+typedef struct {
+    size_t start;                       /* リクエスト先頭（空行スキップ後） */
+    size_t method_off, method_len;
+    size_t target_off, target_len;
+    int    version;                     /* 10 or 11 */
+
+    http_header headers[HTTP_MAX_HEADERS];
+    int         header_count;
+
+    size_t head_end;                    /* ヘッダ終端（ボディ先頭） */
+    int    chunked;
+    int    keep_alive;
+    size_t body_off, body_len;          /* 生ボディの範囲（chunked なら符号化されたまま） */
+    size_t decoded_len;                 /* chunked のデコード後サイズ */
+    size_t end;                         /* リクエスト終端 */
+} http_request;
+
+/* RFC 9110 tchar */
+static const unsigned char http_tchar[256] = {
+    ['!'] = 1, ['#'] = 1, ['$'] = 1, ['%'] = 1, ['&'] = 1, ['\''] = 1, ['*'] = 1, ['+'] = 1,
+    ['-'] = 1, ['.'] = 1, ['^'] = 1, ['_'] = 1, ['`'] = 1, ['|'] = 1, ['~'] = 1,
+    ['0'] = 1, ['1'] = 1, ['2'] = 1, ['3'] = 1, ['4'] = 1, ['5'] = 1, ['6'] = 1, ['7'] = 1, ['8'] = 1, ['9'] = 1,
+    ['A'] = 1, ['B'] = 1, ['C'] = 1, ['D'] = 1, ['E'] = 1, ['F'] = 1, ['G'] = 1, ['H'] = 1, ['I'] = 1,
+    ['J'] = 1, ['K'] = 1, ['L'] = 1, ['M'] = 1, ['N'] = 1, ['O'] = 1, ['P'] = 1, ['Q'] = 1, ['R'] = 1,
+    ['S'] = 1, ['T'] = 1, ['U'] = 1, ['V'] = 1, ['W'] = 1, ['X'] = 1, ['Y'] = 1, ['Z'] = 1,
+    ['a'] = 1, ['b'] = 1, ['c'] = 1, ['d'] = 1, ['e'] = 1, ['f'] = 1, ['g'] = 1, ['h'] = 1, ['i'] = 1,
+    ['j'] = 1, ['k'] = 1, ['l'] = 1, ['m'] = 1, ['n'] = 1, ['o'] = 1, ['p'] = 1, ['q'] = 1, ['r'] = 1,
+    ['s'] = 1, ['t'] = 1, ['u'] = 1, ['v'] = 1, ['w'] = 1, ['x'] = 1, ['y'] = 1, ['z'] = 1,
+};
+
+static inline int http_ieq(const char *a, size_t alen, const char *lit, size_t litlen)
+{
+    if (alen != litlen) {
+        return 0;
+    }
+    for (size_t i = 0; i < alen; i++) {
+        unsigned char c = (unsigned char)a[i];
+        if (c >= 'A' && c <= 'Z') {
+            c += 'a' - 'A';
+        }
+        if (c != (unsigned char)lit[i]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* カンマ区切りリストに token が含まれるか（Connection 用） */
+static int http_list_has(const char *v, size_t len, const char *tok, size_t toklen)
+{
+    size_t i = 0;
+    while (i < len) {
+        while (i < len && (v[i] == ' ' || v[i] == '\t' || v[i] == ',')) {
+            i++;
+        }
+        size_t s = i;
+        while (i < len && v[i] != ',') {
+            i++;
+        }
+        size_t e = i;
+        while (e > s && (v[e - 1] == ' ' || v[e - 1] == '\t')) {
+            e--;
+        }
+        if (http_ieq(v + s, e - s, tok, toklen)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* 行末（LF）を探し、CR を除いた行長を返す。見つからなければ HTTP_INCOMPLETE */
+static inline long http_line(const char *p, size_t pos, size_t len, size_t *next)
+{
+    const char *lf = memchr(p + pos, '\n', len - pos);
+    if (lf == NULL) {
+        return HTTP_INCOMPLETE;
+    }
+
+    size_t e = (size_t)(lf - p);
+    *next = e + 1;
+    if (e > pos && p[e - 1] == '\r') {
+        e--;
+    }
+    return (long)(e - pos);
+}
+
+/*
+ * chunked ボディの走査
+ *
+ * out != NULL ならデコード結果を書き込む。戻り値は HTTP_OK / HTTP_INCOMPLETE / エラーコード
+ */
+static int http_chunked(const char *p, size_t pos, size_t len, size_t max_body, size_t *end, size_t *decoded, char *out)
+{
+    size_t total = 0;
+
+    for (;;) {
+        size_t next;
+        long   ll = http_line(p, pos, len, &next);
+        if (ll < 0) {
+            return HTTP_INCOMPLETE;
+        }
+
+        /* chunk-size [; chunk-ext] */
+        size_t size = 0;
+        size_t i = pos;
+        size_t digits = 0;
+        for (; i < pos + (size_t)ll; i++) {
+            unsigned char c = (unsigned char)p[i];
+            int d;
+            if (c >= '0' && c <= '9') {
+                d = c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                d = c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                d = c - 'A' + 10;
+            } else {
+                break;
+            }
+            if (size > (SIZE_MAX >> 4)) {
+                return HTTP_PAYLOAD_TOO_LARGE;
+            }
+            size = (size << 4) | (size_t)d;
+            digits++;
+        }
+        if (digits == 0) {
+            return HTTP_BAD_REQUEST;
+        }
+        if (i < pos + (size_t)ll && p[i] != ';' && p[i] != ' ' && p[i] != '\t') {
+            return HTTP_BAD_REQUEST;
+        }
+        pos = next;
+
+        if (size == 0) {
+            /* trailer-section は読み飛ばす */
+            for (;;) {
+                ll = http_line(p, pos, len, &next);
+                if (ll < 0) {
+                    return HTTP_INCOMPLETE;
+                }
+                pos = next;
+                if (ll == 0) {
+                    break;
+                }
+            }
+            *end = pos;
+            *decoded = total;
+            return HTTP_OK;
+        }
+
+        if (max_body > 0 && total + size > max_body) {
+            return HTTP_PAYLOAD_TOO_LARGE;
+        }
+        if (len - pos < size) {
+            return HTTP_INCOMPLETE;
+        }
+        if (out) {
+            memcpy(out + total, p + pos, size);
+        }
+        total += size;
+        pos += size;
+
+        /* chunk-data 直後の CRLF */
+        if (pos >= len) {
+            return HTTP_INCOMPLETE;
+        }
+        if (p[pos] == '\r') {
+            if (pos + 1 >= len) {
+                return HTTP_INCOMPLETE;
+            }
+            pos++;
+        }
+        if (p[pos] != '\n') {
+            return HTTP_BAD_REQUEST;
+        }
+        pos++;
+    }
+}
+
+/* 1 リクエスト分を解析 */
+static int http_parse_request(const char *p, size_t pos, size_t len, size_t max_header, size_t max_body, http_request *r)
+{
+    size_t next;
+    long   ll;
+
+    /* リクエスト行の前の空行は無視する */
+    for (;;) {
+        if (pos >= len) {
+            return HTTP_INCOMPLETE;
+        }
+        if (p[pos] == '\n') {
+            pos++;
+        } else if (p[pos] == '\r') {
+            if (pos + 1 >= len) {
+                return HTTP_INCOMPLETE;
+            }
+            if (p[pos + 1] != '\n') {
+                return HTTP_BAD_REQUEST;
+            }
+            pos += 2;
+        } else {
+            break;
+        }
+    }
+    r->start = pos;
+
+    /* ヘッダ部の上限は終端が見つかる前に判定する（巨大ヘッダで溜め込まない） */
+    size_t limit = len;
+    if (max_header > 0 && len - pos > max_header) {
+        limit = pos + max_header;
+    }
+
+    /* request-line = method SP request-target SP HTTP-version */
+    ll = http_line(p, pos, limit, &next);
+    if (ll < 0) {
+        return (limit < len) ? HTTP_HEADERS_TOO_LARGE : HTTP_INCOMPLETE;
+    }
+
+    size_t le = pos + (size_t)ll;
+    size_t i  = pos;
+    while (i < le && http_tchar[(unsigned char)p[i]]) {
+        i++;
+    }
+    if (i == pos || i >= le || p[i] != ' ') {
+        return HTTP_BAD_REQUEST;
+    }
+    r->method_off = pos;
+    r->method_len = i - pos;
+
+    size_t t = ++i;
+    while (i < le && p[i] != ' ') {
+        unsigned char c = (unsigned char)p[i];
+        if (c < 0x21 || c == 0x7f) {
+            return HTTP_BAD_REQUEST;
+        }
+        i++;
+    }
+    if (i == t || i >= le) {
+        return HTTP_BAD_REQUEST;
+    }
+    r->target_off = t;
+    r->target_len = i - t;
+
+    i++;
+    if (le - i != 8 || memcmp(p + i, "HTTP/1.", 7) != 0) {
+        return HTTP_BAD_REQUEST;
+    }
+    if (p[i + 7] == '1') {
+        r->version = 11;
+    } else if (p[i + 7] == '0') {
+        r->version = 10;
+    } else {
+        return HTTP_BAD_REQUEST;
+    }
+    pos = next;
+
+    /* header-field = field-name ":" OWS field-value OWS */
+    r->header_count = 0;
+    r->chunked = 0;
+    r->keep_alive = (r->version == 11);
+
+    int    has_cl = 0;
+    int    has_te = 0;
+    size_t content_length = 0;
+
+    for (;;) {
+        ll = http_line(p, pos, limit, &next);
+        if (ll < 0) {
+            return (limit < len) ? HTTP_HEADERS_TOO_LARGE : HTTP_INCOMPLETE;
+        }
+        if (ll == 0) {
+            pos = next;
+            break;
+        }
+
+        le = pos + (size_t)ll;
+
+        /* obs-fold は受け付けない */
+        if (p[pos] == ' ' || p[pos] == '\t') {
+            return HTTP_BAD_REQUEST;
+        }
+
+        i = pos;
+        while (i < le && http_tchar[(unsigned char)p[i]]) {
+            i++;
+        }
+        if (i == pos || i >= le || p[i] != ':') {
+            return HTTP_BAD_REQUEST;
+        }
+        size_t ne = i++;
+
+        while (i < le && (p[i] == ' ' || p[i] == '\t')) {
+            i++;
+        }
+        size_t ve = le;
+        while (ve > i && (p[ve - 1] == ' ' || p[ve - 1] == '\t')) {
+            ve--;
+        }
+        for (size_t k = i; k < ve; k++) {
+            unsigned char c = (unsigned char)p[k];
+            if ((c < 0x20 && c != '\t') || c == 0x7f) {
+                return HTTP_BAD_REQUEST;
+            }
+        }
+
+        if (r->header_count >= HTTP_MAX_HEADERS) {
+            return HTTP_HEADERS_TOO_LARGE;
+        }
+        http_header *h = &r->headers[r->header_count++];
+        h->name_off  = pos;
+        h->name_len  = ne - pos;
+        h->value_off = i;
+        h->value_len = ve - i;
+
+        /* フレーミングに関わるヘッダ */
+        const char *nv = p + h->value_off;
+        if (http_ieq(p + pos, h->name_len, "content-length", 14)) {
+            size_t v = 0;
+            if (h->value_len == 0) {
+                return HTTP_BAD_REQUEST;
+            }
+            for (size_t k = 0; k < h->value_len; k++) {
+                if (nv[k] < '0' || nv[k] > '9') {
+                    return HTTP_BAD_REQUEST;
+                }
+                if (v > (SIZE_MAX - 9) / 10) {
+                    return HTTP_PAYLOAD_TOO_LARGE;
+                }
+                v = v * 10 + (size_t)(nv[k] - '0');
+            }
+            if (has_cl && v != content_length) {
+                return HTTP_BAD_REQUEST;
+            }
+            has_cl = 1;
+            content_length = v;
+        } else if (http_ieq(p + pos, h->name_len, "transfer-encoding", 17)) {
+            /* 最後の coding が chunked であること */
+            size_t e = h->value_len;
+            size_t s = e;
+            while (s > 0 && nv[s - 1] != ',') {
+                s--;
+            }
+            while (s < e && (nv[s] == ' ' || nv[s] == '\t')) {
+                s++;
+            }
+            if (!http_ieq(nv + s, e - s, "chunked", 7)) {
+                return HTTP_NOT_IMPLEMENTED;
+            }
+            has_te = 1;
+        } else if (http_ieq(p + pos, h->name_len, "connection", 10)) {
+            if (http_list_has(nv, h->value_len, "close", 5)) {
+                r->keep_alive = 0;
+            } else if (http_list_has(nv, h->value_len, "keep-alive", 10)) {
+                r->keep_alive = 1;
+            }
+        }
+
+        pos = next;
+    }
+    r->head_end = pos;
+
+    /* リクエストスマグリング対策：両方ある場合は拒否 */
+    if (has_te && has_cl) {
+        return HTTP_BAD_REQUEST;
+    }
+
+    r->body_off = pos;
+    if (has_te) {
+        if (r->version == 10) {
+            return HTTP_BAD_REQUEST;
+        }
+        r->chunked = 1;
+
+        size_t end, decoded;
+        int ret = http_chunked(p, pos, len, max_body, &end, &decoded, NULL);
+        if (ret != HTTP_OK) {
+            return ret;
+        }
+        r->body_len    = end - pos;
+        r->decoded_len = decoded;
+        r->end         = end;
+        return HTTP_OK;
+    }
+
+    if (max_body > 0 && content_length > max_body) {
+        return HTTP_PAYLOAD_TOO_LARGE;
+    }
+    if (len - pos < content_length) {
+        return HTTP_INCOMPLETE;
+    }
+    r->body_len    = content_length;
+    r->decoded_len = content_length;
+    r->end         = pos + content_length;
+
+    return HTTP_OK;
+}
+
+/* ========= 配列化 ========= */
+
+static zend_string *key_method;
+static zend_string *key_target;
+static zend_string *key_path;
+static zend_string *key_query;
+static zend_string *key_version;
+static zend_string *key_headers;
+static zend_string *key_offset;
+static zend_string *key_body_offset;
+static zend_string *key_body_length;
+static zend_string *key_body;
+static zend_string *key_chunked;
+static zend_string *key_keep_alive;
+static zend_string *key_length;
+static zend_string *key_consumed;
+static zend_string *key_error;
+
+static zend_string *http_method_get;
+static zend_string *http_method_post;
+
+static void http_add_long(HashTable *ht, zend_string *key, zend_long v)
+{
+    zval tmp;
+    ZVAL_LONG(&tmp, v);
+    zend_hash_add_new(ht, key, &tmp);
+}
+
+static void http_add_str(HashTable *ht, zend_string *key, zend_string *v)
+{
+    zval tmp;
+    ZVAL_STR(&tmp, v);
+    zend_hash_add_new(ht, key, &tmp);
+}
+
+static void http_build(zval *list, const char *p, http_request *r)
+{
+    zval item, tmp;
+    array_init_size(&item, 14);
+    zend_hash_real_init_mixed(Z_ARRVAL(item));
+    HashTable *ht = Z_ARRVAL(item);
+
+    /* よく使うメソッドは intern 済みのものを使う */
+    const char *m = p + r->method_off;
+    if (r->method_len == 3 && memcmp(m, "GET", 3) == 0) {
+        http_add_str(ht, key_method, http_method_get);
+    } else if (r->method_len == 4 && memcmp(m, "POST", 4) == 0) {
+        http_add_str(ht, key_method, http_method_post);
+    } else {
+        http_add_str(ht, key_method, zend_string_init(m, r->method_len, 0));
+    }
+
+    const char *tg = p + r->target_off;
+    http_add_str(ht, key_target, zend_string_init(tg, r->target_len, 0));
+
+    const char *q = memchr(tg, '?', r->target_len);
+    if (q) {
+        http_add_str(ht, key_path, zend_string_init(tg, (size_t)(q - tg), 0));
+        http_add_str(ht, key_query, zend_string_init(q + 1, r->target_len - (size_t)(q - tg) - 1, 0));
+    } else {
+        http_add_str(ht, key_path, zend_string_init(tg, r->target_len, 0));
+        http_add_str(ht, key_query, ZSTR_EMPTY_ALLOC());
+    }
+
+    http_add_long(ht, key_version, r->version);
+
+    /* ヘッダ名は小文字化。重複は ", " で連結 */
+    zval headers;
+    array_init_size(&headers, (uint32_t)r->header_count);
+    for (int i = 0; i < r->header_count; i++) {
+        http_header *h = &r->headers[i];
+
+        zend_string *name = zend_string_alloc(h->name_len, 0);
+        zend_str_tolower_copy(ZSTR_VAL(name), p + h->name_off, h->name_len);
+
+        zval *exist = zend_symtable_find(Z_ARRVAL(headers), name);
+        if (exist) {
+            size_t old = Z_STRLEN_P(exist);
+            zend_string *joined = zend_string_alloc(old + 2 + h->value_len, 0);
+            memcpy(ZSTR_VAL(joined), Z_STRVAL_P(exist), old);
+            memcpy(ZSTR_VAL(joined) + old, ", ", 2);
+            memcpy(ZSTR_VAL(joined) + old + 2, p + h->value_off, h->value_len);
+            ZSTR_VAL(joined)[old + 2 + h->value_len] = '\0';
+            zval_ptr_dtor(exist);
+            ZVAL_STR(exist, joined);
+            zend_string_release(name);
+        } else {
+            ZVAL_STRINGL_FAST(&tmp, p + h->value_off, h->value_len);
+            zend_symtable_add_new(Z_ARRVAL(headers), name, &tmp);
+            zend_string_release(name);
+        }
+    }
+    zend_hash_add_new(ht, key_headers, &headers);
+
+    http_add_long(ht, key_offset, (zend_long)r->start);
+    http_add_long(ht, key_body_offset, (zend_long)r->body_off);
+    http_add_long(ht, key_body_length, (zend_long)r->body_len);
+    http_add_long(ht, key_length, (zend_long)(r->end - r->start));
+
+    ZVAL_BOOL(&tmp, r->chunked);
+    zend_hash_add_new(ht, key_chunked, &tmp);
+    ZVAL_BOOL(&tmp, r->keep_alive);
+    zend_hash_add_new(ht, key_keep_alive, &tmp);
+
+    /* chunked のみデコード済みボディを返す（それ以外はオフセットで参照） */
+    if (r->chunked) {
+        zend_string *body = zend_string_alloc(r->decoded_len, 0);
+        size_t end, decoded;
+        http_chunked(p, r->body_off, r->end, 0, &end, &decoded, ZSTR_VAL(body));
+        ZSTR_VAL(body)[decoded] = '\0';
+        http_add_str(ht, key_body, body);
+    } else {
+        ZVAL_NULL(&tmp);
+        zend_hash_add_new(ht, key_body, &tmp);
+    }
+
+    zend_hash_next_index_insert_new(Z_ARRVAL_P(list), &item);
+}
+
+/* ========= 関数実装 ========= */
+
+/*
+ * proto array|false socketsfd_http_parse(string|SocketsFd\Buffer $input, ?array &$state = null, int $max_header_size = 8192, int $max_body_size = 0, int $max_requests = 0)
+ *
+ * $input 先頭から完結しているリクエストをすべて解析して配列で返す（未完の場合は空配列）。
+ * オフセットは $input 先頭からの位置。SocketsFd\Buffer の場合もバッファは消費しないので、
+ * ボディを取り出した後で $state['consumed'] 分を consume すること。
+ *
+ * $state:
+ *   'consumed' : 解析済みのバイト数
+ *   'error'    : 失敗時の HTTP ステータス（400 / 413 / 431 / 501）
+ */
+PHP_FUNCTION(socketsfd_http_parse)
+{
+    zval *zinput;
+    zval *zstate = NULL;
+    zend_long max_header = 8192;
+    zend_long max_body = 0;
+    zend_long max_requests = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 5)
+        Z_PARAM_ZVAL(zinput)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ZVAL(zstate)
+        Z_PARAM_LONG(max_header)
+        Z_PARAM_LONG(max_body)
+        Z_PARAM_LONG(max_requests)
+    ZEND_PARSE_PARAMETERS_END();
+
+    const char *p;
+    size_t len;
+
+    if (Z_TYPE_P(zinput) == IS_STRING) {
+        p   = Z_STRVAL_P(zinput);
+        len = Z_STRLEN_P(zinput);
+    } else if (Z_TYPE_P(zinput) == IS_OBJECT && Z_OBJCE_P(zinput) == socketsfd_buffer_ce) {
+        p = socketsfd_buffer_linear(Z_OBJ_P(zinput), &len);
+    } else {
+        zend_argument_type_error(1, "must be of type SocketsFd\\Buffer|string, %s given", zend_zval_value_name(zinput));
+        RETURN_THROWS();
+    }
+
+    if (max_header < 0 || max_body < 0 || max_requests < 0) {
+        zend_value_error("Limits must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    http_request *r = emalloc(sizeof(http_request));
+    size_t pos = 0;
+    int    error = 0;
+    zend_long count = 0;
+
+    array_init(return_value);
+
+    while (pos < len && (max_requests == 0 || count < max_requests)) {
+        int ret = http_parse_request(p, pos, len, (size_t)max_header, (size_t)max_body, r);
+        if (ret == HTTP_INCOMPLETE) {
+            break;
+        }
+        if (ret != HTTP_OK) {
+            error = ret;
+            break;
+        }
+
+        http_build(return_value, p, r);
+        pos = r->end;
+        count++;
+    }
+
+    efree(r);
+
+    if (zstate) {
+        zval st;
+        array_init_size(&st, 2);
+        http_add_long(Z_ARRVAL(st), key_consumed, (zend_long)pos);
+        http_add_long(Z_ARRVAL(st), key_error, error);
+        ZEND_TRY_ASSIGN_REF_ARR(zstate, Z_ARR(st));
+    }
+
+    if (error) {
+        zval_ptr_dtor(return_value);
+        RETURN_FALSE;
+    }
+}
+
+/* ========= MINIT ========= */
+
+int socketsfd_http_minit(INIT_FUNC_ARGS)
+{
+    key_method      = zend_string_init_interned("method", sizeof("method") - 1, 1);
+    key_target      = zend_string_init_interned("target", sizeof("target") - 1, 1);
+    key_path        = zend_string_init_interned("path", sizeof("path") - 1, 1);
+    key_query       = zend_string_init_interned("query", sizeof("query") - 1, 1);
+    key_version     = zend_string_init_interned("version", sizeof("version") - 1, 1);
+    key_headers     = zend_string_init_interned("headers", sizeof("headers") - 1, 1);
+    key_offset      = zend_string_init_interned("offset", sizeof("offset") - 1, 1);
+    key_body_offset = zend_string_init_interned("body_offset", sizeof("body_offset") - 1, 1);
+    key_body_length = zend_string_init_interned("body_length", sizeof("body_length") - 1, 1);
+    key_body        = zend_string_init_interned("body", sizeof("body") - 1, 1);
+    key_chunked     = zend_string_init_interned("chunked", sizeof("chunked") - 1, 1);
+    key_keep_alive  = zend_string_init_interned("keep_alive", sizeof("keep_alive") - 1, 1);
+    key_length      = zend_string_init_interned("length", sizeof("length") - 1, 1);
+    key_consumed    = zend_string_init_interned("consumed", sizeof("consumed") - 1, 1);
+    key_error       = zend_string_init_interned("error", sizeof("error") - 1, 1);
+
+    http_method_get  = zend_string_init_interned("GET", sizeof("GET") - 1, 1);
+    http_method_post = zend_string_init_interned("POST", sizeof("POST") - 1, 1);
+
+    return SUCCESS;
+}
@@ -0,0 +1,1350 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "php.h"
+#include "zend_exceptions.h"
+#include "php_streams.h"
+#include "php_socketsfd.h"
+
+#ifndef PHP_WIN32
+
+#include "ext/sockets/php_sockets.h"
+
+/*
+ * I/O ドライバ本体は FFI 版と同じソースをそのまま取り込む
+ * （C ソースが API / ABI 仕様となるため二重管理しない）
+ */
+#include "../../ffi/linux/libio_core_linux.c"
+
+/* ========= IoContext オブジェクト ========= */
+
+typedef struct {
+    io_context    ctx;
+    io_event_list events;
+    char         *recv_buf;     /* recv() 用の作業バッファ */
+    int           ready;        /* io_core_init 済みフラグ */
+    zend_object   std;
+} socketsfd_io_object;
+
+static zend_class_entry *socketsfd_io_ce;
+static zend_object_handlers socketsfd_io_handlers;
+
+/* イベント配列のキー／種別（MINIT で intern 済み） */
+static zend_string *key_cid;
+static zend_string *key_sock;
+static zend_string *key_type;
+static zend_string *key_bytes;
+static zend_string *key_error_code;
+static zend_string *key_data;
+
+static zend_string *type_read;
+static zend_string *type_write;
+static zend_string *type_error;
+static zend_string *type_disconnect;
+static zend_string *type_throttle;
+static zend_string *type_connect;
+static zend_string *type_connect_fail;
+static zend_string *type_accept;
+
+static inline socketsfd_io_object *socketsfd_io_from_obj(zend_object *obj)
+{
+    return (socketsfd_io_object *)((char *)obj - XtOffsetOf(socketsfd_io_object, std));
+}
+
+# define Z_SOCKETSFD_IO_P(zv) socketsfd_io_from_obj(Z_OBJ_P((zv)))
+
+# define ENSURE_IO_CONTEXT_VALID(io) \
+    do { \
+        if (!(io)->ready) { \
+            php_error_docref(NULL, E_WARNING, "Invalid or closed I/O context"); \
+            RETURN_FALSE; \
+        } \
+    } while (0)
+
+static zend_object *socketsfd_io_object_create(zend_class_entry *ce)
+{
+    socketsfd_io_object *io = zend_object_alloc(sizeof(socketsfd_io_object), ce);
+
+    memset(&io->ctx, 0, sizeof(io->ctx));
+    io->ctx.epfd    = -1;
+    io->events.count = 0;
+    io->recv_buf    = NULL;
+    io->ready       = 0;
+
+    zend_object_std_init(&io->std, ce);
+    object_properties_init(&io->std, ce);
+    io->std.handlers = &socketsfd_io_handlers;
+
+    return &io->std;
+}
+
+static void socketsfd_io_object_free(zend_object *object)
+{
+    socketsfd_io_object *io = socketsfd_io_from_obj(object);
+
+    if (io->ready) {
+        io_core_close(&io->ctx);
+        io->ready = 0;
+    }
+    if (io->recv_buf) {
+        efree(io->recv_buf);
+        io->recv_buf = NULL;
+    }
+
+    zend_object_std_dtor(&io->std);
+}
+
+static zend_function *socketsfd_io_get_constructor(zend_object *object)
+{
+    zend_throw_error(NULL, "Cannot directly construct SocketsFd\\IoContext, use socketsfd_io_create() instead");
+    return NULL;
+}
+
+/* MSG_ZEROCOPY の完了通知（または送信完了）で呼ばれ、保持していた文字列を手放す */
+static void socketsfd_io_release(void *owner)
+{
+    zend_string_release((zend_string *)owner);
+}
+
+/* ========= イベント配列の生成 ========= */
+
+static void socketsfd_io_add_event(zval *list, int fd, zend_string *type, zend_string *data, zend_long bytes, zend_long error_code)
+{
+    char cid_buf[16];
+    int  cid_len = snprintf(cid_buf, sizeof(cid_buf), "#%d", fd);
+
+    zval item, tmp;
+    array_init_size(&item, 6);
+    zend_hash_real_init_mixed(Z_ARRVAL(item));
+
+    ZVAL_STR(&tmp, zend_string_init(cid_buf, cid_len, 0));
+    zend_hash_add_new(Z_ARRVAL(item), key_cid, &tmp);
+
+    ZVAL_NULL(&tmp);    /* 拡張版では不要。互換性のため残す */
+    zend_hash_add_new(Z_ARRVAL(item), key_sock, &tmp);
+
+    ZVAL_INTERNED_STR(&tmp, type);
+    zend_hash_add_new(Z_ARRVAL(item), key_type, &tmp);
+
+    ZVAL_LONG(&tmp, bytes);
+    zend_hash_add_new(Z_ARRVAL(item), key_bytes, &tmp);
+
+    ZVAL_LONG(&tmp, error_code);
+    zend_hash_add_new(Z_ARRVAL(item), key_error_code, &tmp);
+
+    ZVAL_STR(&tmp, data);
+    zend_hash_add_new(Z_ARRVAL(item), key_data, &tmp);
+
+    zend_hash_next_index_insert_new(Z_ARRVAL_P(list), &item);
+}
+
+/*
+ * 受信分をレート制限へ計上し、制限に入った時はスロットルイベント（bytes = 読み込み停止 ms、error_code = 判定）を追加する
+ */
+static int socketsfd_io_rate(socketsfd_io_object *io, zval *list, int fd, size_t bytes)
+{
+    int notify, wait_ms;
+    int r = io_rate_consume(&io->ctx, fd, bytes, 1, &notify, &wait_ms);
+
+    if (notify) {
+        socketsfd_io_add_event(list, fd, type_throttle, ZSTR_EMPTY_ALLOC(), wait_ms, r);
+    }
+
+    return r;
+}
+
+/* ========= 関数実装 ========= */
+
+/* proto SocketsFd\IoContext|false socketsfd_io_create(int $recv_buf_size = 1024) */
+PHP_FUNCTION(socketsfd_io_create)
+{
+    zend_long recv_buf_size = 1024;
+
+    ZEND_PARSE_PARAMETERS_START(0, 1)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(recv_buf_size)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (recv_buf_size <= 0) {
+        zend_argument_value_error(1, "must be greater than 0");
+        RETURN_THROWS();
+    }
+
+    object_init_ex(return_value, socketsfd_io_ce);
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(return_value);
+
+    if (io_core_init(&io->ctx, (size_t)recv_buf_size) != 0) {
+        php_error_docref(NULL, E_WARNING, "io_core_init failed: %s", strerror(errno));
+        io_core_close(&io->ctx);
+        zval_ptr_dtor(return_value);
+        RETURN_FALSE;
+    }
+
+    io->ctx.release = socketsfd_io_release;
+    io->recv_buf = emalloc((size_t)recv_buf_size);
+    io->ready    = 1;
+}
+
+/* proto bool socketsfd_io_register(SocketsFd\IoContext $context, int $fd, bool $is_udp = false, bool $is_client = false) */
+PHP_FUNCTION(socketsfd_io_register)
+{
+    zval *zctx;
+    zend_long fd;
+    bool is_udp = 0, is_client = 0;
+
+    ZEND_PARSE_PARAMETERS_START(2, 4)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(is_udp)
+        Z_PARAM_BOOL(is_client)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    RETURN_BOOL(io_register(&io->ctx, (int)fd, is_udp, is_client) == 0);
+}
+
+/* proto bool socketsfd_io_register_listen(SocketsFd\IoContext $context, int $fd) */
+PHP_FUNCTION(socketsfd_io_register_listen)
+{
+    zval *zctx;
+    zend_long fd;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    RETURN_BOOL(io_registerListen(&io->ctx, (int)fd) == 0);
+}
+
+/* proto bool socketsfd_io_register_udp_listen(SocketsFd\IoContext $context, int $fd) */
+PHP_FUNCTION(socketsfd_io_register_udp_listen)
+{
+    zval *zctx;
+    zend_long fd;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    RETURN_BOOL(io_registerUdpListen(&io->ctx, (int)fd) == 0);
+}
+
+/*
+ * proto Socket|false socketsfd_io_connect(SocketsFd\IoContext $context, string $host, int $port, int $timeout_ms = 0)
+ *
+ * ノンブロッキングで接続を開始し、登録済みの Socket を返す（完了は socketsfd_io_wait() の connect／connect_fail イベントで通知）。
+ * $host が "unix:///path" / "unix://@name"（抽象名前空間）の場合は UNIX ドメインで接続する（$port は 0 で良い）。
+ * $host がホスト名の場合は名前解決も socketsfd_io_wait() の中で行う（TTL の間はキャッシュを使う）。
+ * $timeout_ms は名前解決を含めた期限。0 の場合はカーネルの既定に従う。
+ */
+PHP_FUNCTION(socketsfd_io_connect)
+{
+    zval *zctx;
+    zend_string *host;
+    zend_long port, timeout_ms = 0;
+
+    ZEND_PARSE_PARAMETERS_START(3, 4)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_STR(host)
+        Z_PARAM_LONG(port)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout_ms)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (port < 0 || port > 65535) {
+        zend_argument_value_error(3, "must be between 0 and 65535");
+        RETURN_THROWS();
+    }
+    if (timeout_ms < 0) {
+        zend_argument_value_error(4, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    int fd = io_connect(&io->ctx, ZSTR_VAL(host), (unsigned short)port, (int)timeout_ms);
+    if (fd < 0) {
+        php_error_docref(NULL, E_NOTICE, "io_connect failed: %s", strerror(errno));
+        RETURN_FALSE;
+    }
+
+    object_init_ex(return_value, socket_ce);
+    if (!socket_import_file_descriptor(fd, Z_SOCKET_P(return_value))) {
+        io_unregister(&io->ctx, fd);
+        close(fd);
+        zval_ptr_dtor(return_value);
+        RETURN_FALSE;
+    }
+}
+
+/*
+ * proto bool socketsfd_io_set_resolver(SocketsFd\IoContext $context, ?string $server = null, int $port = 53, int $timeout_ms = 0, int $attempts = 0)
+ *
+ * socketsfd_io_connect() の名前解決の問い合わせ先を設定する（null は /etc/resolv.conf の nameserver）。
+ * $timeout_ms は 1 回の問い合わせの応答待ち、$attempts は最大送信回数（0 は既定値）。
+ */
+PHP_FUNCTION(socketsfd_io_set_resolver)
+{
+    zval *zctx;
+    zend_string *server = NULL;
+    zend_long port = 53, timeout_ms = 0, attempts = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 5)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_STR_OR_NULL(server)
+        Z_PARAM_LONG(port)
+        Z_PARAM_LONG(timeout_ms)
+        Z_PARAM_LONG(attempts)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (port < 0 || port > 65535) {
+        zend_argument_value_error(3, "must be between 0 and 65535");
+        RETURN_THROWS();
+    }
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    RETURN_BOOL(io_set_resolver(&io->ctx, server ? ZSTR_VAL(server) : NULL, (unsigned short)port, (int)timeout_ms, (int)attempts) == 0);
+}
+
+/*
+ * proto bool socketsfd_io_set_profile(SocketsFd\IoContext $context, bool $is_client, ?array $profile)
+ *
+ * 以降に登録されるソケットへ適用するチューニングプロファイルを設定する（null で解除）。
+ * キー：nodelay / sndbuf / rcvbuf / quickack / notsent_lowat / busy_poll / user_timeout /
+ *       keepalive / keepidle / keepintvl / keepcnt
+ */
+PHP_FUNCTION(socketsfd_io_set_profile)
+{
+    zval *zctx;
+    bool is_client;
+    HashTable *options = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(3, 3)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_BOOL(is_client)
+        Z_PARAM_ARRAY_HT_OR_NULL(options)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    if (options == NULL) {
+        RETURN_BOOL(io_set_profile(&io->ctx, is_client, NULL) == 0);
+    }
+
+    io_sock_profile profile;
+    io_profile_reset(&profile);
+
+    zend_string *key;
+    zval *val;
+    ZEND_HASH_FOREACH_STR_KEY_VAL(options, key, val) {
+        int *field = NULL;
+
+        if (key == NULL) {
+            zend_argument_value_error(3, "must be an array with string keys");
+            RETURN_THROWS();
+        }
+        if (zend_string_equals_literal(key, "nodelay")) {
+            field = &profile.nodelay;
+        } else if (zend_string_equals_literal(key, "sndbuf")) {
+            field = &profile.sndbuf;
+        } else if (zend_string_equals_literal(key, "rcvbuf")) {
+            field = &profile.rcvbuf;
+        } else if (zend_string_equals_literal(key, "quickack")) {
+            field = &profile.quickack;
+        } else if (zend_string_equals_literal(key, "notsent_lowat")) {
+            field = &profile.notsent_lowat;
+        } else if (zend_string_equals_literal(key, "busy_poll")) {
+            field = &profile.busy_poll;
+        } else if (zend_string_equals_literal(key, "user_timeout")) {
+            field = &profile.user_timeout;
+        } else if (zend_string_equals_literal(key, "keepalive")) {
+            field = &profile.keepalive;
+        } else if (zend_string_equals_literal(key, "keepidle")) {
+            field = &profile.keepidle;
+        } else if (zend_string_equals_literal(key, "keepintvl")) {
+            field = &profile.keepintvl;
+        } else if (zend_string_equals_literal(key, "keepcnt")) {
+            field = &profile.keepcnt;
+        } else {
+            zend_argument_value_error(3, "contains unknown option \"%s\"", ZSTR_VAL(key));
+            RETURN_THROWS();
+        }
+
+        /* null は「変更しない」、bool は 0 / 1 */
+        if (Z_TYPE_P(val) == IS_NULL) {
+            continue;
+        }
+        zend_long v = zval_get_long(val);
+        if (v < 0 || v > INT_MAX) {
+            zend_argument_value_error(3, "option \"%s\" is out of range", ZSTR_VAL(key));
+            RETURN_THROWS();
+        }
+        *field = (int)v;
+    } ZEND_HASH_FOREACH_END();
+
+    RETURN_BOOL(io_set_profile(&io->ctx, is_client, &profile) == 0);
+}
+
+/*
+ * proto bool socketsfd_io_set_busy_poll(SocketsFd\IoContext $context, bool $enable, int $usecs = 0, int $budget = 0, bool $prefer = false)
+ *
+ * 有効にすると socketsfd_io_wait() はスリープせずに epoll_wait(0) を回す。
+ * usecs / budget / prefer はカーネル側のビジーポーリング設定（非対応でもモード自体は有効）。
+ */
+PHP_FUNCTION(socketsfd_io_set_busy_poll)
+{
+    zval *zctx;
+    bool enable;
+    zend_long usecs = 0, budget = 0;
+    bool prefer = 0;
+
+    ZEND_PARSE_PARAMETERS_START(2, 5)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_BOOL(enable)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(usecs)
+        Z_PARAM_LONG(budget)
+        Z_PARAM_BOOL(prefer)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (usecs < 0 || usecs > UINT32_MAX) {
+        zend_argument_value_error(3, "must be between 0 and %u", UINT32_MAX);
+        RETURN_THROWS();
+    }
+    if (budget < 0 || budget > 0xffff) {
+        zend_argument_value_error(4, "must be between 0 and 65535");
+        RETURN_THROWS();
+    }
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    int r = io_set_busy_poll(&io->ctx, enable, (unsigned int)usecs, (unsigned int)budget, prefer);
+    if (r == 1) {
+        php_error_docref(NULL, E_NOTICE, "Kernel busy-poll parameters not applied: %s", strerror(errno));
+    }
+
+    RETURN_BOOL(r >= 0);
+}
+
+/* proto bool socketsfd_set_affinity(array $cpus) */
+PHP_FUNCTION(socketsfd_set_affinity)
+{
+    HashTable *cpus;
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_ARRAY_HT(cpus)
+    ZEND_PARSE_PARAMETERS_END();
+
+    uint32_t count = zend_hash_num_elements(cpus);
+    if (count == 0 || count > CPU_SETSIZE) {
+        zend_argument_value_error(1, "must contain between 1 and %d CPU numbers", CPU_SETSIZE);
+        RETURN_THROWS();
+    }
+
+    int *list = safe_emalloc(count, sizeof(int), 0);
+    int  n = 0;
+    zval *val;
+    ZEND_HASH_FOREACH_VAL(cpus, val) {
+        zend_long cpu = zval_get_long(val);
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            efree(list);
+            zend_argument_value_error(1, "must contain CPU numbers between 0 and %d", CPU_SETSIZE - 1);
+            RETURN_THROWS();
+        }
+        list[n++] = (int)cpu;
+    } ZEND_HASH_FOREACH_END();
+
+    int r = io_set_affinity(list, n);
+    efree(list);
+
+    if (r != 0) {
+        php_error_docref(NULL, E_WARNING, "sched_setaffinity failed: %s", strerror(errno));
+        RETURN_FALSE;
+    }
+
+    RETURN_TRUE;
+}
+
+/*
+ * proto bool socketsfd_io_set_framing(SocketsFd\IoContext $context, int $fd, ?array $spec)
+ *
+ * 受信データのフレーミングを設定する（null で解除）。設定後の read イベントは完成したフレーム単位になる。
+ * キー：mode（'fixed' / 'length' / 'delimiter'）/ size / width / endian（'big' / 'little'）/ offset /
+ *       adjust / delimiter / strip / max_frame
+ */
+PHP_FUNCTION(socketsfd_io_set_framing)
+{
+    zval *zctx;
+    zend_long fd;
+    HashTable *options = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(3, 3)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+        Z_PARAM_ARRAY_HT_OR_NULL(options)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    if (options == NULL) {
+        RETURN_BOOL(io_set_framing(&io->ctx, (int)fd, NULL) == 0);
+    }
+
+    io_frame_spec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.len_width = 4;
+
+    zend_string *key;
+    zval *val;
+    ZEND_HASH_FOREACH_STR_KEY_VAL(options, key, val) {
+        if (key == NULL) {
+            zend_argument_value_error(3, "must be an array with string keys");
+            RETURN_THROWS();
+        }
+        if (zend_string_equals_literal(key, "mode")) {
+            zend_string *mode = zval_get_string(val);
+            if (zend_string_equals_literal(mode, "fixed")) {
+                spec.mode = IO_FRAME_FIXED;
+            } else if (zend_string_equals_literal(mode, "length")) {
+                spec.mode = IO_FRAME_LENGTH;
+            } else if (zend_string_equals_literal(mode, "delimiter")) {
+                spec.mode = IO_FRAME_DELIMITER;
+            }
+            zend_string_release(mode);
+        } else if (zend_string_equals_literal(key, "size")) {
+            zend_long v = zval_get_long(val);
+            spec.size = v > 0 ? (size_t)v : 0;
+        } else if (zend_string_equals_literal(key, "width")) {
+            spec.len_width = (int)zval_get_long(val);
+        } else if (zend_string_equals_literal(key, "endian")) {
+            zend_string *endian = zval_get_string(val);
+            spec.len_le = zend_string_equals_literal(endian, "little");
+            zend_string_release(endian);
+        } else if (zend_string_equals_literal(key, "offset")) {
+            zend_long v = zval_get_long(val);
+            spec.len_offset = v > 0 ? (size_t)v : 0;
+        } else if (zend_string_equals_literal(key, "adjust")) {
+            spec.len_adjust = (long long)zval_get_long(val);
+        } else if (zend_string_equals_literal(key, "delimiter")) {
+            zend_string *delim = zval_get_string(val);
+            if (ZSTR_LEN(delim) == 0 || ZSTR_LEN(delim) > IO_FRAME_DELIM_MAX) {
+                zend_string_release(delim);
+                zend_argument_value_error(3, "option \"delimiter\" must be between 1 and %d bytes", IO_FRAME_DELIM_MAX);
+                RETURN_THROWS();
+            }
+            memcpy(spec.delim, ZSTR_VAL(delim), ZSTR_LEN(delim));
+            spec.delim_len = ZSTR_LEN(delim);
+            zend_string_release(delim);
+        } else if (zend_string_equals_literal(key, "strip")) {
+            spec.strip = zend_is_true(val);
+        } else if (zend_string_equals_literal(key, "max_frame")) {
+            zend_long v = zval_get_long(val);
+            spec.max_frame = v > 0 ? (size_t)v : 0;
+        } else {
+            zend_argument_value_error(3, "contains unknown option \"%s\"", ZSTR_VAL(key));
+            RETURN_THROWS();
+        }
+    } ZEND_HASH_FOREACH_END();
+
+    if (spec.mode == IO_FRAME_NONE) {
+        zend_argument_value_error(3, "option \"mode\" must be \"fixed\", \"length\" or \"delimiter\"");
+        RETURN_THROWS();
+    }
+
+    RETURN_BOOL(io_set_framing(&io->ctx, (int)fd, &spec) == 0);
+}
+
+/*
+ * proto bool socketsfd_io_set_rate_limit(SocketsFd\IoContext $context, int $fd, ?array $spec)
+ *
+ * トークンバケットによる受信のレート制限を設定する（null で解除）。待ち受けの fd なら以降に受け入れる接続で共有する。
+ * キー：bytes（バイト／秒）/ bytes_burst / messages（read イベント数／秒、フレーミング中はフレーム数）/
+ *       messages_burst / policy（'delay' / 'drop' / 'disconnect'）
+ */
+PHP_FUNCTION(socketsfd_io_set_rate_limit)
+{
+    zval *zctx;
+    zend_long fd;
+    HashTable *options = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(3, 3)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+        Z_PARAM_ARRAY_HT_OR_NULL(options)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    if (options == NULL) {
+        RETURN_BOOL(io_set_rate_limit(&io->ctx, (int)fd, NULL) == 0);
+    }
+
+    io_rate_spec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.policy = IO_RATE_DELAY;
+
+    zend_string *key;
+    zval *val;
+    ZEND_HASH_FOREACH_STR_KEY_VAL(options, key, val) {
+        double *field = NULL;
+
+        if (key == NULL) {
+            zend_argument_value_error(3, "must be an array with string keys");
+            RETURN_THROWS();
+        }
+        if (zend_string_equals_literal(key, "policy")) {
+            zend_string *policy = zval_get_string(val);
+            if (zend_string_equals_literal(policy, "delay")) {
+                spec.policy = IO_RATE_DELAY;
+            } else if (zend_string_equals_literal(policy, "drop")) {
+                spec.policy = IO_RATE_DROP;
+            } else if (zend_string_equals_literal(policy, "disconnect")) {
+                spec.policy = IO_RATE_DISCONNECT;
+            } else {
+                zend_string_release(policy);
+                zend_argument_value_error(3, "option \"policy\" must be \"delay\", \"drop\" or \"disconnect\"");
+                RETURN_THROWS();
+            }
+            zend_string_release(policy);
+            continue;
+        }
+
+        if (zend_string_equals_literal(key, "bytes")) {
+            field = &spec.bytes_rate;
+        } else if (zend_string_equals_literal(key, "bytes_burst")) {
+            field = &spec.bytes_burst;
+        } else if (zend_string_equals_literal(key, "messages")) {
+            field = &spec.msgs_rate;
+        } else if (zend_string_equals_literal(key, "messages_burst")) {
+            field = &spec.msgs_burst;
+        } else {
+            zend_argument_value_error(3, "contains unknown option \"%s\"", ZSTR_VAL(key));
+            RETURN_THROWS();
+        }
+
+        double v = zval_get_double(val);
+        if (v < 0) {
+            zend_argument_value_error(3, "option \"%s\" must be greater than or equal to 0", ZSTR_VAL(key));
+            RETURN_THROWS();
+        }
+        *field = v;
+    } ZEND_HASH_FOREACH_END();
+
+    RETURN_BOOL(io_set_rate_limit(&io->ctx, (int)fd, &spec) == 0);
+}
+
+/* proto bool socketsfd_io_unregister(SocketsFd\IoContext $context, int $fd) */
+PHP_FUNCTION(socketsfd_io_unregister)
+{
+    zval *zctx;
+    zend_long fd;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    RETURN_BOOL(io_unregister(&io->ctx, (int)fd) == 0);
+}
+
+/*
+ * proto array|false socketsfd_io_wait(SocketsFd\IoContext $context, int $timeout_ms = 0, ?array &$fallback = null)
+ *
+ * TCP 接続ソケットの read イベントはここで recv() まで済ませ、data に格納して返す。
+ * 切断・エラー・UDP など PHP 側の判定が必要なものは bytes = 0 の read イベントとし、
+ * そのインデックスを $fallback に格納する。
+ */
+PHP_FUNCTION(socketsfd_io_wait)
+{
+    zval *zctx;
+    zend_long timeout_ms = 0;
+    zval *zfallback = NULL;
+
+    ZEND_PARSE_PARAMETERS_START(1, 3)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(timeout_ms)
+        Z_PARAM_ZVAL(zfallback)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    int n = io_select(&io->ctx, (int)timeout_ms, &io->events);
+    if (n < 0) {
+        if (errno != EINTR) {
+            RETURN_FALSE;
+        }
+        n = 0;  /* シグナル割り込みはイベントなしとして扱う */
+    }
+
+    zval fallback;
+    ZVAL_UNDEF(&fallback);
+
+    array_init_size(return_value, (uint32_t)n);
+
+    for (int i = 0; i < io->events.count; i++) {
+        io_event    *ev = &io->events.events[i];
+        io_fd_entry *e  = io_get_entry(&io->ctx, ev->handle);
+
+        zend_string *type  = NULL;
+        zend_string *data  = ZSTR_EMPTY_ALLOC();
+        zend_long    bytes = 0;
+        int          need_fallback = 0;
+
+        switch (ev->event_type) {
+            case IO_EVENT_READ:
+                type = type_read;
+
+                /* listen ソケットはアクセプト通知のみ（bytes = 0） */
+                if (e == NULL || e->is_listen) {
+                    break;
+                }
+
+                /* 共有メモリ IPC はリングから読み切る（読み残しは呼び鈴を鳴らし直して次回へ回す） */
+                if (e->shm) {
+                    int k;
+                    type = NULL;
+                    for (k = 0; k < IO_SHM_READ_BURST; k++) {
+                        ssize_t r = io_shm_recv(&io->ctx, ev->handle, io->recv_buf, io->ctx.recv_buf_size);
+                        if (r > 0) {
+                            io->ctx.counters[IO_CNT_BYTES_IN] += (uint64_t)r;
+                            socketsfd_io_add_event(return_value, ev->handle, type_read,
+                                zend_string_init(io->recv_buf, (size_t)r, 0), (zend_long)r, 0);
+                            continue;
+                        }
+                        if (r == 0) {
+                            socketsfd_io_add_event(return_value, ev->handle, type_disconnect, ZSTR_EMPTY_ALLOC(), 0, 0);
+                        } else if (errno != EAGAIN) {
+                            int err = errno;
+                            socketsfd_io_add_event(return_value, ev->handle, type_error, ZSTR_EMPTY_ALLOC(), 0, err);
+                        }
+                        break;
+                    }
+                    if (k == IO_SHM_READ_BURST) {
+                        io_shm_yield(&io->ctx, ev->handle);
+                    }
+                    break;
+                }
+
+                /* UDP は送信元アドレスが必要なため PHP 側で受信 */
+                if (e->is_udp) {
+                    need_fallback = 1;
+                    break;
+                }
+
+                ssize_t r = recv(ev->handle, io->recv_buf, io->ctx.recv_buf_size, 0);
+                if (r > 0) {
+                    io->ctx.counters[IO_CNT_BYTES_IN] += (uint64_t)r;
+                    /* TCP_QUICKACK は一度 ACK を返すと解除されるため受信のたびに戻す */
+                    if (e->quickack) {
+                        int one = 1;
+                        setsockopt(ev->handle, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+                    }
+
+                    /* フレーミング中は完成したフレームごとに read イベントを返す（未完成分はドライバ内に保持） */
+                    if (e->framer) {
+                        const char *frame;
+                        size_t      frame_len;
+                        int         fr;
+
+                        type = NULL;
+                        if (io_frame_feed(&io->ctx, ev->handle, io->recv_buf, (size_t)r) != 0) {
+                            int err = errno;
+                            socketsfd_io_add_event(return_value, ev->handle, type_error, ZSTR_EMPTY_ALLOC(), 0, err);
+                            break;
+                        }
+                        /* レート制限はフレーム単位（DROP はフレームごと破棄する） */
+                        while ((fr = io_frame_next(&io->ctx, ev->handle, &frame, &frame_len)) == 1) {
+                            int rc = socketsfd_io_rate(io, return_value, ev->handle, frame_len);
+                            if (rc == IO_RATE_EXCEEDED) {
+                                break;
+                            }
+                            if (rc == IO_RATE_DROPPED) {
+                                continue;
+                            }
+                            socketsfd_io_add_event(return_value, ev->handle, type_read,
+                                zend_string_init(frame, frame_len, 0), (zend_long)frame_len, 0);
+                        }
+                        if (fr < 0) {
+                            int err = errno;
+                            socketsfd_io_add_event(return_value, ev->handle, type_error, ZSTR_EMPTY_ALLOC(), 0, err);
+                        }
+                        break;
+                    }
+
+                    int rc = socketsfd_io_rate(io, return_value, ev->handle, (size_t)r);
+                    if (rc == IO_RATE_DROPPED || rc == IO_RATE_EXCEEDED) {
+                        type = NULL;
+                        break;
+                    }
+
+                    data  = zend_string_init(io->recv_buf, (size_t)r, 0);
+                    bytes = (zend_long)r;
+                } else if (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+                    type = NULL;    /* 取得できるデータがない */
+                } else {
+                    /* 切断／エラーは従来どおり PHP 側（ioRecv）で判定 */
+                    need_fallback = 1;
+                }
+                break;
+
+            case IO_EVENT_WRITE:
+                type = type_write;
+                break;
+
+            case IO_EVENT_ERROR:
+                type = type_error;
+                break;
+
+            case IO_EVENT_DISCONNECT:
+                type = type_disconnect;
+                break;
+
+            case IO_EVENT_CONNECT:
+                type = type_connect;
+                break;
+
+            case IO_EVENT_CONNECT_FAIL:
+                type = type_connect_fail;
+                break;
+
+            case IO_EVENT_ACCEPT: {
+                /* 共有待ち受けでドライバ内に受け入れた接続（sock に Socket を格納する） */
+                zval zsock, *item;
+
+                type = NULL;
+                object_init_ex(&zsock, socket_ce);
+                if (!socket_import_file_descriptor(ev->handle, Z_SOCKET_P(&zsock))) {
+                    io_unregister(&io->ctx, ev->handle);
+                    close(ev->handle);
+                    zval_ptr_dtor(&zsock);
+                    break;
+                }
+                socketsfd_io_add_event(return_value, ev->handle, type_accept, ZSTR_EMPTY_ALLOC(), 0, 0);
+                item = zend_hash_index_find(Z_ARRVAL_P(return_value), zend_hash_next_free_element(Z_ARRVAL_P(return_value)) - 1);
+                zend_hash_update(Z_ARRVAL_P(item), key_sock, &zsock);
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        if (type == NULL) {
+            continue;
+        }
+
+        if (need_fallback && zfallback != NULL) {
+            if (Z_ISUNDEF(fallback)) {
+                array_init(&fallback);
+            }
+            add_next_index_long(&fallback, (zend_long)zend_hash_num_elements(Z_ARRVAL_P(return_value)));
+        }
+
+        socketsfd_io_add_event(return_value, ev->handle, type, data, bytes, ev->error_code);
+    }
+
+    if (zfallback != NULL) {
+        if (Z_ISUNDEF(fallback)) {
+            ZEND_TRY_ASSIGN_REF_NULL(zfallback);
+        } else {
+            ZEND_TRY_ASSIGN_REF_ARR(zfallback, Z_ARR(fallback));
+        }
+    }
+}
+
+/*
+ * proto int|false socketsfd_io_send_file(SocketsFd\IoContext $context, int $fd, mixed $file, int $offset = 0, int $length = 0)
+ *
+ * $file はストリームリソースまたは fd。内容は PHP 側へ読み込まず、sendfile(2)／splice(2) で送信する。
+ * 戻り値は未送信バイト数（0 で完了）。残りは socketsfd_io_wait() 内で EPOLLOUT を契機に送信される。
+ */
+PHP_FUNCTION(socketsfd_io_send_file)
+{
+    zval *zctx, *zfile;
+    zend_long fd, offset = 0, length = 0;
+
+    ZEND_PARSE_PARAMETERS_START(3, 5)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+        Z_PARAM_ZVAL(zfile)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(offset)
+        Z_PARAM_LONG(length)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (offset < 0) {
+        zend_argument_value_error(4, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+    if (length < 0) {
+        zend_argument_value_error(5, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    int in_fd = -1;
+    if (Z_TYPE_P(zfile) == IS_LONG) {
+        in_fd = (int)Z_LVAL_P(zfile);
+    } else if (Z_TYPE_P(zfile) == IS_RESOURCE) {
+        php_stream *stream;
+        php_stream_from_zval(stream, zfile);
+
+        /* 書き込みバッファが残っていると送信内容と食い違うため先に吐き出す */
+        php_stream_flush(stream);
+        if (php_stream_cast(stream, PHP_STREAM_AS_FD | PHP_STREAM_CAST_INTERNAL, (void **)&in_fd, 0) != SUCCESS) {
+            php_error_docref(NULL, E_WARNING, "Stream cannot be represented as a file descriptor");
+            RETURN_FALSE;
+        }
+    } else {
+        zend_argument_type_error(3, "must be of type resource|int, %s given", zend_zval_type_name(zfile));
+        RETURN_THROWS();
+    }
+
+    ssize_t r = io_send_file(&io->ctx, (int)fd, in_fd, (off_t)offset, (size_t)length);
+    if (r < 0) {
+        php_error_docref(NULL, E_NOTICE, "io_send_file failed: %s", strerror(errno));
+        RETURN_FALSE;
+    }
+
+    RETURN_LONG((zend_long)r);
+}
+
+/*
+ * proto int|false socketsfd_io_send(SocketsFd\IoContext $context, int $fd, string $data)
+ *
+ * socketsfd_io_set_zerocopy() の閾値以上は MSG_ZEROCOPY で送信する。
+ * $data はカーネルから完了通知が届くまで参照を保持する（PHP 側でコピーは発生しない）。
+ * 戻り値は未送信バイト数（0 で完了）。
+ */
+PHP_FUNCTION(socketsfd_io_send)
+{
+    zval *zctx;
+    zend_long fd;
+    zend_string *data;
+
+    ZEND_PARSE_PARAMETERS_START(3, 3)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+        Z_PARAM_STR(data)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    /* 参照は io_send が失敗時も含めて socketsfd_io_release で返却する */
+    zend_string *owner = zend_string_copy(data);
+    ssize_t r = io_send(&io->ctx, (int)fd, ZSTR_VAL(owner), ZSTR_LEN(owner), owner);
+    if (r < 0) {
+        php_error_docref(NULL, E_NOTICE, "io_send failed: %s", strerror(errno));
+        RETURN_FALSE;
+    }
+
+    RETURN_LONG((zend_long)r);
+}
+
+/*
+ * proto Socket|false socketsfd_io_ipc_open(SocketsFd\IoContext $context, string $name, bool $owner, int $capacity = 0)
+ *
+ * 同じホスト上のプロセス間の共有メモリ IPC チャネルを開き、登録済みの Socket（呼び鈴）を返す。
+ * $owner = true の側がチャネルを作成し、false の側は作成済みのチャネルへ参加する。
+ * $capacity は方向ごとのリング容量（作成側のみ。0 は 1MB。2 のべき乗へ切り上げる）。
+ * 受信データは socketsfd_io_wait() の read イベントで、相手のクローズは disconnect イベントで通知される。
+ */
+PHP_FUNCTION(socketsfd_io_ipc_open)
+{
+    zval *zctx;
+    zend_string *name;
+    bool owner;
+    zend_long capacity = 0;
+
+    ZEND_PARSE_PARAMETERS_START(3, 4)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_STR(name)
+        Z_PARAM_BOOL(owner)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(capacity)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (capacity < 0 || capacity > IO_SHM_CAPACITY_MAX) {
+        zend_argument_value_error(4, "must be between 0 and %u", IO_SHM_CAPACITY_MAX);
+        RETURN_THROWS();
+    }
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    int fd = io_shm_open(&io->ctx, ZSTR_VAL(name), owner, (size_t)capacity);
+    if (fd < 0) {
+        php_error_docref(NULL, E_NOTICE, "io_shm_open failed: %s", strerror(errno));
+        RETURN_FALSE;
+    }
+
+    object_init_ex(return_value, socket_ce);
+    if (!socket_import_file_descriptor(fd, Z_SOCKET_P(return_value))) {
+        io_unregister(&io->ctx, fd);
+        close(fd);
+        zval_ptr_dtor(return_value);
+        RETURN_FALSE;
+    }
+}
+
+/*
+ * proto int|false socketsfd_io_ipc_send(SocketsFd\IoContext $context, int $fd, string $data)
+ *
+ * リングの空きへ書き込めた分だけ書き込み、書き込んだバイト数を返す（空きがなければ 0）。
+ * 相手が待機中の場合のみ呼び鈴を鳴らすため、連続した送信ではシステムコールを発行しない。
+ */
+PHP_FUNCTION(socketsfd_io_ipc_send)
+{
+    zval *zctx;
+    zend_long fd;
+    zend_string *data;
+
+    ZEND_PARSE_PARAMETERS_START(3, 3)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+        Z_PARAM_STR(data)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    ssize_t r = io_shm_send(&io->ctx, (int)fd, ZSTR_VAL(data), ZSTR_LEN(data));
+    if (r < 0) {
+        if (errno == EAGAIN) {
+            RETURN_LONG(0);
+        }
+        php_error_docref(NULL, E_NOTICE, "io_shm_send failed: %s", strerror(errno));
+        RETURN_FALSE;
+    }
+
+    RETURN_LONG((zend_long)r);
+}
+
+/* proto bool socketsfd_io_set_zerocopy(SocketsFd\IoContext $context, int $threshold) */
+PHP_FUNCTION(socketsfd_io_set_zerocopy)
+{
+    zval *zctx;
+    zend_long threshold;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(threshold)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (threshold < 0) {
+        zend_argument_value_error(2, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    RETURN_BOOL(io_set_zerocopy(&io->ctx, (size_t)threshold) == 0);
+}
+
+/*
+ * proto bool socketsfd_io_set_listen_exclusive(SocketsFd\IoContext $context, int $fd, int $batch = 0)
+ *
+ * prefork したワーカー間で共有する listen ソケットを EPOLLEXCLUSIVE で待ち受ける（batch = 0 は既定の 16 件）。
+ * 以降の受け入れはドライバ内で batch 件までまとめて行い、accept イベント（sock に Socket）で通知する。
+ */
+PHP_FUNCTION(socketsfd_io_set_listen_exclusive)
+{
+    zval *zctx;
+    zend_long fd;
+    zend_long batch = 0;
+
+    ZEND_PARSE_PARAMETERS_START(2, 3)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(batch)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (batch < 0 || batch > MAX_EVENTS) {
+        zend_argument_value_error(3, "must be between 0 and %d", MAX_EVENTS);
+        RETURN_THROWS();
+    }
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    if (io_set_listen_exclusive(&io->ctx, (int)fd, (int)batch) != 0) {
+        php_error_docref(NULL, E_NOTICE, "io_set_listen_exclusive failed: %s", strerror(errno));
+        RETURN_FALSE;
+    }
+    RETURN_TRUE;
+}
+
+/*
+ * proto bool socketsfd_io_stats_enable(SocketsFd\IoContext $context, bool $enable)
+ *
+ * ヒストグラムによる計測の開始／終了（終了すると計測値は破棄される）。
+ * 開始後は io_select が epoll_wait の所要時間（wait）と返したイベント数（events）を記録する。
+ */
+PHP_FUNCTION(socketsfd_io_stats_enable)
+{
+    zval *zctx;
+    bool enable;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_BOOL(enable)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    RETURN_BOOL(io_stats_enable(&io->ctx, enable ? 1 : 0) == 0);
+}
+
+/*
+ * proto void socketsfd_io_stats_begin(SocketsFd\IoContext $context, int $metric)
+ *
+ * 所要時間の計測開始（SOCKETSFD_IO_STAT_CYCLE／SOCKETSFD_IO_STAT_UNIT）。計測していなければ何もしない。
+ */
+PHP_FUNCTION(socketsfd_io_stats_begin)
+{
+    zval *zctx;
+    zend_long metric;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(metric)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    if (io->ready) {
+        io_stats_begin(&io->ctx, (int)metric);
+    }
+}
+
+/*
+ * proto void socketsfd_io_stats_end(SocketsFd\IoContext $context, int $metric)
+ *
+ * 所要時間の計測終了。SOCKETSFD_IO_STAT_DISPATCH は socketsfd_io_wait が戻ってからの経過時間を記録する。
+ */
+PHP_FUNCTION(socketsfd_io_stats_end)
+{
+    zval *zctx;
+    zend_long metric;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(metric)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    if (io->ready) {
+        io_stats_end(&io->ctx, (int)metric);
+    }
+}
+
+/*
+ * proto array|false socketsfd_io_stats_get(SocketsFd\IoContext $context, bool $reset = false)
+ *
+ * 計測対象名（cycle／wait／events／unit／dispatch）=> [count, min, max, mean, p50, p90, p99, p999]。
+ * 時間は ns、百分位はその度数区間の上限値（相対誤差 1/32 以内）。
+ */
+PHP_FUNCTION(socketsfd_io_stats_get)
+{
+    static const char *names[IO_STAT_COUNT] = { "cycle", "wait", "events", "unit", "dispatch" };
+    zval *zctx;
+    bool reset = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_BOOL(reset)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    if (!io->ctx.stats) {
+        RETURN_FALSE;
+    }
+
+    array_init_size(return_value, IO_STAT_COUNT);
+    for (int i = 0; i < IO_STAT_COUNT; i++) {
+        io_stats_summary s;
+        zval item;
+
+        io_stats_get(&io->ctx, i, &s, reset ? 1 : 0);
+
+        array_init_size(&item, 8);
+        add_assoc_long(&item, "count", (zend_long)s.count);
+        add_assoc_long(&item, "min", (zend_long)s.min);
+        add_assoc_long(&item, "max", (zend_long)s.max);
+        add_assoc_long(&item, "mean", (zend_long)s.mean);
+        add_assoc_long(&item, "p50", (zend_long)s.p50);
+        add_assoc_long(&item, "p90", (zend_long)s.p90);
+        add_assoc_long(&item, "p99", (zend_long)s.p99);
+        add_assoc_long(&item, "p999", (zend_long)s.p999);
+        add_assoc_zval(return_value, names[i], &item);
+    }
+}
+
+/*
+ * proto array|false socketsfd_io_metrics(SocketsFd\IoContext $context)
+ *
+ * ドライバのカウンタ（累積値）と現在値（送信キュー／fd テーブル／タイマーの件数）を名前 => 値で返す。
+ * 現在値は fd テーブルを走査して集計するため、メトリクスの取得時だけ呼ぶこと。
+ */
+PHP_FUNCTION(socketsfd_io_metrics)
+{
+    static const char *counter_names[IO_CNT_COUNT] = {
+        "bytes_in", "bytes_out", "selects", "events", "batch_full", "accepts"
+    };
+    static const char *gauge_names[IO_GAUGE_COUNT] = {
+        "fds", "fd_capacity", "listeners", "send_segments", "send_bytes", "send_max",
+        "zc_segments", "paused", "connecting", "dns_queries", "dns_cache"
+    };
+    zval *zctx;
+    uint64_t counters[IO_CNT_COUNT];
+    uint64_t gauges[IO_GAUGE_COUNT];
+
+    ZEND_PARSE_PARAMETERS_START(1, 1)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    if (io_get_metrics(&io->ctx, counters, gauges) != 0) {
+        RETURN_FALSE;
+    }
+
+    array_init_size(return_value, IO_CNT_COUNT + IO_GAUGE_COUNT);
+    for (int i = 0; i < IO_CNT_COUNT; i++) {
+        add_assoc_long(return_value, counter_names[i], (zend_long)counters[i]);
+    }
+    for (int i = 0; i < IO_GAUGE_COUNT; i++) {
+        add_assoc_long(return_value, gauge_names[i], (zend_long)gauges[i]);
+    }
+}
+
+/* proto int|false socketsfd_io_flush(SocketsFd\IoContext $context, int $fd) */
+PHP_FUNCTION(socketsfd_io_flush)
+{
+    zval *zctx;
+    zend_long fd;
+
+    ZEND_PARSE_PARAMETERS_START(2, 2)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    ssize_t r = io_flush(&io->ctx, (int)fd);
+    if (r < 0) {
+        php_error_docref(NULL, E_NOTICE, "io_flush failed: %s", strerror(errno));
+        RETURN_FALSE;
+    }
+
+    RETURN_LONG((zend_long)r);
+}
+
+/* proto bool socketsfd_io_getsockname(SocketsFd\IoContext $context, int $fd, string &$address, int &$port) */
+PHP_FUNCTION(socketsfd_io_getsockname)
+{
+    zval *zctx;
+    zend_long fd;
+    zval *zaddr, *zport;
+
+    ZEND_PARSE_PARAMETERS_START(4, 4)
+        Z_PARAM_OBJECT_OF_CLASS(zctx, socketsfd_io_ce)
+        Z_PARAM_LONG(fd)
+        Z_PARAM_ZVAL(zaddr)
+        Z_PARAM_ZVAL(zport)
+    ZEND_PARSE_PARAMETERS_END();
+
+    socketsfd_io_object *io = Z_SOCKETSFD_IO_P(zctx);
+    ENSURE_IO_CONTEXT_VALID(io);
+
+    char ip_buf[INET_ADDRSTRLEN];
+    unsigned short port = 0;
+
+    if (io_getsockname(&io->ctx, (int)fd, ip_buf, &port) != 0) {
+        RETURN_FALSE;
+    }
+
+    ZEND_TRY_ASSIGN_REF_STRING(zaddr, ip_buf);
+    ZEND_TRY_ASSIGN_REF_LONG(zport, (zend_long)port);
+
+    RETURN_TRUE;
+}
+
+/* ========= MINIT ========= */
+
+int socketsfd_io_minit(INIT_FUNC_ARGS)
+{
+    zend_class_entry ce;
+
+    INIT_NS_CLASS_ENTRY(ce, "SocketsFd", "IoContext", NULL);
+    socketsfd_io_ce = zend_register_internal_class(&ce);
+    socketsfd_io_ce->ce_flags |= ZEND_ACC_FINAL | ZEND_ACC_NO_DYNAMIC_PROPERTIES | ZEND_ACC_NOT_SERIALIZABLE;
+    socketsfd_io_ce->create_object = socketsfd_io_object_create;
+
+    memcpy(&socketsfd_io_handlers, zend_get_std_object_handlers(), sizeof(zend_object_handlers));
+    socketsfd_io_handlers.offset          = XtOffsetOf(socketsfd_io_object, std);
+    socketsfd_io_handlers.free_obj        = socketsfd_io_object_free;
+    socketsfd_io_handlers.get_constructor = socketsfd_io_get_constructor;
+    socketsfd_io_handlers.clone_obj       = NULL;
+
+    key_cid        = zend_string_init_interned("cid", sizeof("cid") - 1, 1);
+    key_sock       = zend_string_init_interned("sock", sizeof("sock") - 1, 1);
+    key_type       = zend_string_init_interned("type", sizeof("type") - 1, 1);
+    key_bytes      = zend_string_init_interned("bytes", sizeof("bytes") - 1, 1);
+    key_error_code = zend_string_init_interned("error_code", sizeof("error_code") - 1, 1);
+    key_data       = zend_string_init_interned("data", sizeof("data") - 1, 1);
+
+    type_read       = zend_string_init_interned("read", sizeof("read") - 1, 1);
+    type_write      = zend_string_init_interned("write", sizeof("write") - 1, 1);
+    type_error      = zend_string_init_interned("error", sizeof("error") - 1, 1);
+    type_disconnect = zend_string_init_interned("disconnect", sizeof("disconnect") - 1, 1);
+    type_throttle   = zend_string_init_interned("throttle", sizeof("throttle") - 1, 1);
+    type_connect    = zend_string_init_interned("connect", sizeof("connect") - 1, 1);
+    type_connect_fail = zend_string_init_interned("connect_fail", sizeof("connect_fail") - 1, 1);
+    type_accept     = zend_string_init_interned("accept", sizeof("accept") - 1, 1);
+
+    REGISTER_LONG_CONSTANT("SOCKETSFD_IO_STAT_CYCLE", IO_STAT_CYCLE, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_IO_STAT_WAIT", IO_STAT_WAIT, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_IO_STAT_EVENTS", IO_STAT_EVENTS, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_IO_STAT_UNIT", IO_STAT_UNIT, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_IO_STAT_DISPATCH", IO_STAT_DISPATCH, CONST_CS | CONST_PERSISTENT);
+
+    return SUCCESS;
+}
+
+#endif /* !PHP_WIN32 */
@@ -0,0 +1,596 @@
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include "php.h"
+#include "zend_cpuinfo.h"
+#include "php_socketsfd.h"
+
+#if PHP_VERSION_ID >= 80400
+# include "ext/random/php_random_csprng.h"
+#else
+# include "ext/random/php_random.h"
+#endif
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define SOCKETSFD_WS_SSE2 1
+#endif
+
+#if defined(SOCKETSFD_WS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+# include <immintrin.h>
+# define SOCKETSFD_WS_AVX2 1
+#endif
+
+/*
+ * WebSocket フレームコーデック（RFC 6455）
+ *
+ * socketsfd_ws_decode : ヘッダ解析・検証・アンマスク・フラグメント結合を C 側で一括処理
+ * socketsfd_ws_encode : ヘッダ生成・（クライアント側）マスク・フラグメント分割
+ *
+ * マスク処理は AVX2 / SSE2 / スカラーの順で利用可能なものを MINIT で選択する。
+ */
+
+/* ========= マスク処理 ========= */
+
+typedef void (*ws_mask_func)(char *dst, const char *src, size_t n, const unsigned char key[4]);
+
+static void ws_mask_scalar(char *dst, const char *src, size_t n, const unsigned char key[4])
+{
+    uint32_t k32;
+    memcpy(&k32, key, 4);
+    uint64_t k64 = ((uint64_t)k32 << 32) | k32;
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t v;
+        memcpy(&v, src + i, 8);
+        v ^= k64;
+        memcpy(dst + i, &v, 8);
+    }
+    for (; i < n; i++) {
+        dst[i] = src[i] ^ key[i & 3];
+    }
+}
+
+#ifdef SOCKETSFD_WS_SSE2
+static void ws_mask_sse2(char *dst, const char *src, size_t n, const unsigned char key[4])
+{
+    uint32_t k32;
+    memcpy(&k32, key, 4);
+    __m128i km = _mm_set1_epi32((int)k32);
+
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i + 16));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + i + 32));
+        __m128i d = _mm_loadu_si128((const __m128i *)(src + i + 48));
+        _mm_storeu_si128((__m128i *)(dst + i),      _mm_xor_si128(a, km));
+        _mm_storeu_si128((__m128i *)(dst + i + 16), _mm_xor_si128(b, km));
+        _mm_storeu_si128((__m128i *)(dst + i + 32), _mm_xor_si128(c, km));
+        _mm_storeu_si128((__m128i *)(dst + i + 48), _mm_xor_si128(d, km));
+    }
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(a, km));
+    }
+
+    /* 16 の倍数で進めているのでキーの位相はずれない */
+    ws_mask_scalar(dst + i, src + i, n - i, key);
+}
+#endif
+
+#ifdef SOCKETSFD_WS_AVX2
+__attribute__((target("avx2")))
+static void ws_mask_avx2(char *dst, const char *src, size_t n, const unsigned char key[4])
+{
+    /* 短いペイロードは SSE2 の方が速い（128 バイトのループに届かないため） */
+    if (n < 256) {
+        ws_mask_sse2(dst, src, n, key);
+        return;
+    }
+
+    uint32_t k32;
+    memcpy(&k32, key, 4);
+    __m256i km = _mm256_set1_epi32((int)k32);
+
+    size_t i = 0;
+    for (; i + 128 <= n; i += 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + i + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(src + i + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(src + i + 96));
+        _mm256_storeu_si256((__m256i *)(dst + i),      _mm256_xor_si256(a, km));
+        _mm256_storeu_si256((__m256i *)(dst + i + 32), _mm256_xor_si256(b, km));
+        _mm256_storeu_si256((__m256i *)(dst + i + 64), _mm256_xor_si256(c, km));
+        _mm256_storeu_si256((__m256i *)(dst + i + 96), _mm256_xor_si256(d, km));
+    }
+    for (; i + 32 <= n; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_xor_si256(a, km));
+    }
+
+    ws_mask_scalar(dst + i, src + i, n - i, key);
+}
+#endif
+
+static ws_mask_func ws_mask = ws_mask_scalar;
+
+/* ========= 共通定義 ========= */
+
+#define WS_OP_CONTINUATION  0x0
+#define WS_OP_TEXT          0x1
+#define WS_OP_BINARY        0x2
+#define WS_OP_CLOSE         0x8
+#define WS_OP_PING          0x9
+#define WS_OP_PONG          0xA
+
+#define WS_FLAG_MASKED      0x01    /* encode: マスクして送る／decode: マスク必須（サーバー側） */
+
+#define WS_CLOSE_PROTOCOL_ERROR  1002
+#define WS_CLOSE_TOO_BIG         1009
+
+static zend_string *key_opcode;
+static zend_string *key_rsv;
+static zend_string *key_data;
+static zend_string *key_consumed;
+static zend_string *key_error;
+
+static inline int ws_is_control(int op)
+{
+    return (op & 0x8) != 0;
+}
+
+static inline int ws_is_valid_opcode(int op)
+{
+    return op == WS_OP_CONTINUATION || op == WS_OP_TEXT || op == WS_OP_BINARY
+        || op == WS_OP_CLOSE || op == WS_OP_PING || op == WS_OP_PONG;
+}
+
+static void ws_add_frame(zval *list, int opcode, int rsv, zend_string *data)
+{
+    zval item, tmp;
+    array_init_size(&item, 3);
+    zend_hash_real_init_mixed(Z_ARRVAL(item));
+
+    ZVAL_LONG(&tmp, opcode);
+    zend_hash_add_new(Z_ARRVAL(item), key_opcode, &tmp);
+
+    ZVAL_LONG(&tmp, rsv);
+    zend_hash_add_new(Z_ARRVAL(item), key_rsv, &tmp);
+
+    ZVAL_STR(&tmp, data);
+    zend_hash_add_new(Z_ARRVAL(item), key_data, &tmp);
+
+    zend_hash_next_index_insert_new(Z_ARRVAL_P(list), &item);
+}
+
+/* ペイロードを取り出す（マスクされていればアンマスクしながらコピー） */
+static zend_string *ws_payload(const unsigned char *p, size_t n, const unsigned char *key)
+{
+    if (n == 0) {
+        return ZSTR_EMPTY_ALLOC();
+    }
+
+    zend_string *ret = zend_string_alloc(n, 0);
+    if (key) {
+        ws_mask(ZSTR_VAL(ret), (const char *)p, n, key);
+    } else {
+        memcpy(ZSTR_VAL(ret), p, n);
+    }
+    ZSTR_VAL(ret)[n] = '\0';
+
+    return ret;
+}
+
+/* ========= 関数実装 ========= */
+
+/*
+ * proto array|false socketsfd_ws_decode(string|SocketsFd\Buffer $input, ?array &$state = null, int $flags = 0, int $max_payload = 0)
+ *
+ * $input から完結しているフレームをすべて取り出し、[opcode, rsv, data] の配列で返す。
+ * フラグメントされたメッセージは結合して 1 件として返す（途中の制御フレームは先に返す）。
+ *
+ * $state には接続ごとのデコード状態（結合中のフラグメント）を保持する。
+ *   'consumed' : 今回消費したバイト数（文字列入力の場合は呼び出し側で切り詰める）
+ *   'error'    : 失敗時のクローズコード（1002 / 1009）
+ *
+ * SocketsFd\Buffer を渡した場合は消費した分がバッファから取り除かれる。
+ */
+PHP_FUNCTION(socketsfd_ws_decode)
+{
+    zval *zinput;
+    zval *zstate = NULL;
+    zend_long flags = 0;
+    zend_long max_payload = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 4)
+        Z_PARAM_ZVAL(zinput)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ZVAL(zstate)
+        Z_PARAM_LONG(flags)
+        Z_PARAM_LONG(max_payload)
+    ZEND_PARSE_PARAMETERS_END();
+
+    const unsigned char *p;
+    size_t len;
+    zend_object *buf_obj = NULL;
+
+    if (Z_TYPE_P(zinput) == IS_STRING) {
+        p   = (const unsigned char *)Z_STRVAL_P(zinput);
+        len = Z_STRLEN_P(zinput);
+    } else if (Z_TYPE_P(zinput) == IS_OBJECT && Z_OBJCE_P(zinput) == socketsfd_buffer_ce) {
+        buf_obj = Z_OBJ_P(zinput);
+        p = (const unsigned char *)socketsfd_buffer_linear(buf_obj, &len);
+    } else {
+        zend_argument_type_error(1, "must be of type SocketsFd\\Buffer|string, %s given", zend_zval_value_name(zinput));
+        RETURN_THROWS();
+    }
+
+    /* 結合中のフラグメントを状態から取り出す */
+    zend_string *frag        = NULL;
+    int          frag_opcode = 0;
+    int          frag_rsv    = 0;
+
+    if (zstate) {
+        zval *zs = zstate;
+        ZVAL_DEREF(zs);
+        if (Z_TYPE_P(zs) == IS_ARRAY) {
+            SEPARATE_ARRAY(zs);
+            zval *zd = zend_hash_find(Z_ARRVAL_P(zs), key_data);
+            if (zd && Z_TYPE_P(zd) == IS_STRING) {
+                frag = Z_STR_P(zd);
+                ZVAL_NULL(zd);  /* 参照を手放して追記時のコピーを避ける */
+
+                zval *zo = zend_hash_find(Z_ARRVAL_P(zs), key_opcode);
+                zval *zr = zend_hash_find(Z_ARRVAL_P(zs), key_rsv);
+                frag_opcode = (zo && Z_TYPE_P(zo) == IS_LONG) ? (int)Z_LVAL_P(zo) : WS_OP_BINARY;
+                frag_rsv    = (zr && Z_TYPE_P(zr) == IS_LONG) ? (int)Z_LVAL_P(zr) : 0;
+            }
+        }
+    }
+
+    size_t pos = 0;
+    int    error = 0;
+
+    array_init(return_value);
+
+    while (len - pos >= 2) {
+        const unsigned char *h = p + pos;
+
+        int      fin    = (h[0] & 0x80) != 0;
+        int      rsv    = (h[0] >> 4) & 0x7;
+        int      opcode = h[0] & 0x0f;
+        int      masked = (h[1] & 0x80) != 0;
+        uint64_t plen   = h[1] & 0x7f;
+        size_t   hlen   = 2;
+
+        if (plen == 126) {
+            if (len - pos < 4) {
+                break;
+            }
+            plen = ((uint64_t)h[2] << 8) | h[3];
+            hlen = 4;
+            if (plen < 126) {
+                error = WS_CLOSE_PROTOCOL_ERROR;    /* 最短表現でない */
+                break;
+            }
+        } else if (plen == 127) {
+            if (len - pos < 10) {
+                break;
+            }
+            plen = 0;
+            for (int i = 0; i < 8; i++) {
+                plen = (plen << 8) | h[2 + i];
+            }
+            hlen = 10;
+            if ((plen >> 63) != 0 || plen <= 0xffff) {
+                error = WS_CLOSE_PROTOCOL_ERROR;
+                break;
+            }
+        }
+
+        /* ヘッダの検証 */
+        if (!ws_is_valid_opcode(opcode)) {
+            error = WS_CLOSE_PROTOCOL_ERROR;
+            break;
+        }
+        if (ws_is_control(opcode) && (!fin || plen > 125)) {
+            error = WS_CLOSE_PROTOCOL_ERROR;
+            break;
+        }
+        if ((flags & WS_FLAG_MASKED) && !masked) {
+            error = WS_CLOSE_PROTOCOL_ERROR;
+            break;
+        }
+        if (opcode == WS_OP_CONTINUATION && frag == NULL) {
+            error = WS_CLOSE_PROTOCOL_ERROR;
+            break;
+        }
+        if ((opcode == WS_OP_TEXT || opcode == WS_OP_BINARY) && frag != NULL) {
+            error = WS_CLOSE_PROTOCOL_ERROR;
+            break;
+        }
+        if (max_payload > 0) {
+            uint64_t total = plen + ((opcode == WS_OP_CONTINUATION && frag) ? ZSTR_LEN(frag) : 0);
+            if (total > (uint64_t)max_payload) {
+                error = WS_CLOSE_TOO_BIG;
+                break;
+            }
+        }
+
+        const unsigned char *key = NULL;
+        if (masked) {
+            if (len - pos < hlen + 4) {
+                break;
+            }
+            key = h + hlen;
+            hlen += 4;
+        }
+
+        /* ペイロード未着 */
+        if ((uint64_t)(len - pos - hlen) < plen) {
+            break;
+        }
+
+        const unsigned char *payload = h + hlen;
+        size_t n = (size_t)plen;
+
+        if (ws_is_control(opcode)) {
+            ws_add_frame(return_value, opcode, rsv, ws_payload(payload, n, key));
+        } else if (opcode == WS_OP_CONTINUATION) {
+            size_t old = ZSTR_LEN(frag);
+            frag = zend_string_extend(frag, old + n, 0);
+            if (key) {
+                ws_mask(ZSTR_VAL(frag) + old, (const char *)payload, n, key);
+            } else {
+                memcpy(ZSTR_VAL(frag) + old, payload, n);
+            }
+            ZSTR_VAL(frag)[old + n] = '\0';
+
+            if (fin) {
+                ws_add_frame(return_value, frag_opcode, frag_rsv, frag);
+                frag = NULL;
+            }
+        } else if (fin) {
+            ws_add_frame(return_value, opcode, rsv, ws_payload(payload, n, key));
+        } else {
+            /* フラグメント開始（拡張の RSV ビットは先頭フレームのものを引き継ぐ） */
+            frag        = ws_payload(payload, n, key);
+            frag_opcode = opcode;
+            frag_rsv    = rsv;
+        }
+
+        pos += hlen + n;
+    }
+
+    if (buf_obj) {
+        socketsfd_buffer_discard(buf_obj, pos);
+    }
+
+    if (zstate) {
+        zval st, tmp;
+        array_init_size(&st, 5);
+
+        ZVAL_LONG(&tmp, frag ? frag_opcode : 0);
+        zend_hash_add_new(Z_ARRVAL(st), key_opcode, &tmp);
+        ZVAL_LONG(&tmp, frag ? frag_rsv : 0);
+        zend_hash_add_new(Z_ARRVAL(st), key_rsv, &tmp);
+        if (frag) {
+            ZVAL_STR(&tmp, frag);
+        } else {
+            ZVAL_NULL(&tmp);
+        }
+        zend_hash_add_new(Z_ARRVAL(st), key_data, &tmp);
+        ZVAL_LONG(&tmp, (zend_long)pos);
+        zend_hash_add_new(Z_ARRVAL(st), key_consumed, &tmp);
+        ZVAL_LONG(&tmp, error);
+        zend_hash_add_new(Z_ARRVAL(st), key_error, &tmp);
+
+        ZEND_TRY_ASSIGN_REF_ARR(zstate, Z_ARR(st));
+    } else if (frag) {
+        zend_string_release(frag);
+    }
+
+    if (error) {
+        zval_ptr_dtor(return_value);
+        RETURN_FALSE;
+    }
+}
+
+/* 1 フレーム分のヘッダ長 */
+static inline size_t ws_header_len(size_t n, int masked)
+{
+    size_t h = 2;
+    if (n > 0xffff) {
+        h += 8;
+    } else if (n > 125) {
+        h += 2;
+    }
+    return h + (masked ? 4 : 0);
+}
+
+/* 1 フレームを書き込み、書き込んだ末尾を返す */
+static char *ws_write_frame(char *out, int fin, int opcode, const char *src, size_t n, int masked)
+{
+    unsigned char *o = (unsigned char *)out;
+
+    *o++ = (unsigned char)((fin ? 0x80 : 0x00) | (opcode & 0x0f));
+
+    unsigned char mbit = masked ? 0x80 : 0x00;
+    if (n > 0xffff) {
+        *o++ = mbit | 127;
+        for (int i = 7; i >= 0; i--) {
+            *o++ = (unsigned char)(((uint64_t)n >> (8 * i)) & 0xff);
+        }
+    } else if (n > 125) {
+        *o++ = mbit | 126;
+        *o++ = (unsigned char)(n >> 8);
+        *o++ = (unsigned char)(n & 0xff);
+    } else {
+        *o++ = mbit | (unsigned char)n;
+    }
+
+    if (masked) {
+        unsigned char key[4];
+        if (php_random_bytes_silent(key, sizeof(key)) == FAILURE) {
+            /* 乱数源が使えない場合の代替（マスクの目的上、予測困難である必要は薄い） */
+            static uint32_t seed = 0x9e3779b9;
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            memcpy(key, &seed, 4);
+        }
+        memcpy(o, key, 4);
+        o += 4;
+        ws_mask((char *)o, src, n, key);
+    } else if (n > 0) {
+        memcpy(o, src, n);
+    }
+
+    return (char *)(o + n);
+}
+
+/* ペイロード 1 件分（フラグメント分割込み）のサイズ */
+static size_t ws_encoded_len(size_t n, size_t frag_size, int masked)
+{
+    if (frag_size == 0 || n <= frag_size) {
+        return ws_header_len(n, masked) + n;
+    }
+
+    size_t total = 0;
+    for (size_t off = 0; off < n; off += frag_size) {
+        size_t chunk = (n - off < frag_size) ? (n - off) : frag_size;
+        total += ws_header_len(chunk, masked) + chunk;
+    }
+    return total;
+}
+
+static char *ws_write_message(char *out, int opcode, const char *src, size_t n, size_t frag_size, int masked)
+{
+    if (frag_size == 0 || n <= frag_size || ws_is_control(opcode)) {
+        return ws_write_frame(out, 1, opcode, src, n, masked);
+    }
+
+    for (size_t off = 0; off < n; off += frag_size) {
+        size_t chunk = (n - off < frag_size) ? (n - off) : frag_size;
+        int    op    = (off == 0) ? opcode : WS_OP_CONTINUATION;
+        out = ws_write_frame(out, off + chunk >= n, op, src + off, chunk, masked);
+    }
+    return out;
+}
+
+/*
+ * proto string socketsfd_ws_encode(string|array $payload, int $opcode = SOCKETSFD_WS_OP_TEXT, int $flags = 0, int $fragment_size = 0)
+ *
+ * 配列を渡した場合は各要素を 1 メッセージとして連結したバイト列を返す（1 回の送信でまとめて書ける）。
+ * $fragment_size > 0 の場合、それを超えるデータメッセージはフラグメントに分割する。
+ */
+PHP_FUNCTION(socketsfd_ws_encode)
+{
+    zend_string *payload = NULL;
+    HashTable   *payloads = NULL;
+    zend_long opcode = WS_OP_TEXT;
+    zend_long flags = 0;
+    zend_long fragment_size = 0;
+
+    ZEND_PARSE_PARAMETERS_START(1, 4)
+        Z_PARAM_ARRAY_HT_OR_STR(payloads, payload)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_LONG(opcode)
+        Z_PARAM_LONG(flags)
+        Z_PARAM_LONG(fragment_size)
+    ZEND_PARSE_PARAMETERS_END();
+
+    if (!ws_is_valid_opcode((int)opcode) || opcode == WS_OP_CONTINUATION) {
+        zend_argument_value_error(2, "must be a valid WebSocket opcode");
+        RETURN_THROWS();
+    }
+    if (fragment_size < 0) {
+        zend_argument_value_error(4, "must be greater than or equal to 0");
+        RETURN_THROWS();
+    }
+
+    int    masked = (flags & WS_FLAG_MASKED) != 0;
+    size_t fsize  = (size_t)fragment_size;
+
+    if (payload) {
+        if (ws_is_control((int)opcode) && ZSTR_LEN(payload) > 125) {
+            zend_argument_value_error(1, "must not exceed 125 bytes for control frames");
+            RETURN_THROWS();
+        }
+
+        size_t total = ws_is_control((int)opcode)
+            ? ws_header_len(ZSTR_LEN(payload), masked) + ZSTR_LEN(payload)
+            : ws_encoded_len(ZSTR_LEN(payload), fsize, masked);
+
+        zend_string *ret = zend_string_alloc(total, 0);
+        ws_write_message(ZSTR_VAL(ret), (int)opcode, ZSTR_VAL(payload), ZSTR_LEN(payload), fsize, masked);
+        ZSTR_VAL(ret)[total] = '\0';
+
+        RETURN_NEW_STR(ret);
+    }
+
+    /* バッチ：サイズを先に確定させて 1 回で確保する */
+    size_t total = 0;
+    zval *zv;
+    ZEND_HASH_FOREACH_VAL(payloads, zv) {
+        ZVAL_DEREF(zv);
+        if (Z_TYPE_P(zv) != IS_STRING) {
+            zend_argument_type_error(1, "must contain only strings");
+            RETURN_THROWS();
+        }
+        if (ws_is_control((int)opcode) && Z_STRLEN_P(zv) > 125) {
+            zend_argument_value_error(1, "must not exceed 125 bytes for control frames");
+            RETURN_THROWS();
+        }
+        total += ws_is_control((int)opcode)
+            ? ws_header_len(Z_STRLEN_P(zv), masked) + Z_STRLEN_P(zv)
+            : ws_encoded_len(Z_STRLEN_P(zv), fsize, masked);
+    } ZEND_HASH_FOREACH_END();
+
+    zend_string *ret = zend_string_alloc(total, 0);
+    char *out = ZSTR_VAL(ret);
+    ZEND_HASH_FOREACH_VAL(payloads, zv) {
+        ZVAL_DEREF(zv);
+        out = ws_write_message(out, (int)opcode, Z_STRVAL_P(zv), Z_STRLEN_P(zv), fsize, masked);
+    } ZEND_HASH_FOREACH_END();
+    ZSTR_VAL(ret)[total] = '\0';
+
+    RETURN_NEW_STR(ret);
+}
+
+/* ========= MINIT ========= */
+
+int socketsfd_ws_minit(INIT_FUNC_ARGS)
+{
+    REGISTER_LONG_CONSTANT("SOCKETSFD_WS_OP_CONTINUATION", WS_OP_CONTINUATION, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_WS_OP_TEXT", WS_OP_TEXT, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_WS_OP_BINARY", WS_OP_BINARY, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_WS_OP_CLOSE", WS_OP_CLOSE, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_WS_OP_PING", WS_OP_PING, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_WS_OP_PONG", WS_OP_PONG, CONST_CS | CONST_PERSISTENT);
+    REGISTER_LONG_CONSTANT("SOCKETSFD_WS_MASKED", WS_FLAG_MASKED, CONST_CS | CONST_PERSISTENT);
+
+    key_opcode   = zend_string_init_interned("opcode", sizeof("opcode") - 1, 1);
+    key_rsv      = zend_string_init_interned("rsv", sizeof("rsv") - 1, 1);
+    key_data     = zend_string_init_interned("data", sizeof("data") - 1, 1);
+    key_consumed = zend_string_init_interned("consumed", sizeof("consumed") - 1, 1);
+    key_error    = zend_string_init_interned("error", sizeof("error") - 1, 1);
+
+    /* マスク処理の実装を選択 */
+#ifdef SOCKETSFD_WS_SSE2
+    ws_mask = ws_mask_sse2;
+#endif
+#ifdef SOCKETSFD_WS_AVX2
+    if (zend_cpu_supports_avx2()) {
+        ws_mask = ws_mask_avx2;
+    }
+#endif
+
+    return SUCCESS;
+}
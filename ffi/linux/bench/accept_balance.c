@@ -0,0 +1,258 @@
+/**
+ * 待ち受けの共有方式による接続の偏りの計測
+ *
+ * N 個のワーカープロセスが io_select で 64 バイトのエコーを返し、親プロセスが 64 並列で 3000 接続 × 10 往復を送る。
+ * 接続の 10% は 1 往復ごとに heavy_us マイクロ秒 CPU を回す重い接続で、軽い接続の往復時間がその影響をどれだけ受けるかを比べる。
+ * ・reuseport : ワーカーごとに SO_REUSEPORT の待ち受けソケットを持つ（カーネルが 4 タプルのハッシュで振り分ける）
+ * ・exclusive : 1 つの待ち受けソケットを共有し io_set_listen_exclusive で EPOLLEXCLUSIVE を設定する（SocketManager::forkWorkers の既定）
+ * 結果は軽い接続の p50 / p99 / p99.9、重い接続の p99、ワーカーごとの受け入れ数。2 つの方式を 2 回ずつ交互に計測する。
+ *
+ * gcc -O2 -o accept_balance accept_balance.c && ./accept_balance [workers=4 heavy_us=1500]
+ */
+#define _GNU_SOURCE
+#include "../libio_core_linux.c"
+#include <stdio.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+#define BENCH_PORT          39044
+#define BENCH_CONCURRENCY   64
+#define BENCH_CONNECTIONS   3000
+#define BENCH_REQUESTS      10
+#define BENCH_HEAVY_PCT     10
+#define BENCH_MSG_SIZE      64
+#define BENCH_MAX_WORKERS   64
+
+static int heavy_us = 1500;
+
+typedef struct
+{
+    int fd;
+    int left;
+    int heavy;
+    double t0;
+} bench_conn;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+static struct sockaddr_in bench_addr(void)
+{
+    struct sockaddr_in a = { .sin_family = AF_INET, .sin_port = htons(BENCH_PORT), .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    return a;
+}
+
+static int open_listen(int reuseport)
+{
+    struct sockaddr_in a = bench_addr();
+    int one = 1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if(reuseport) setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    if(bind(fd, (struct sockaddr *)&a, sizeof(a)) == -1) { perror("bind"); exit(1); }
+    listen(fd, 8192);
+    return fd;
+}
+
+// ワーカー側（'H' は重い往復、'Q' は終了して受け入れ数を返す）
+static void worker(int ls, int exclusive, int report)
+{
+    static io_event_list events;
+    io_context ctx;
+    char buf[BENCH_MSG_SIZE];
+    int accepted = 0;
+
+    memset(&ctx, 0, sizeof(ctx));
+    io_core_init(&ctx, 4096);
+    io_registerListen(&ctx, ls);
+    if(exclusive && io_set_listen_exclusive(&ctx, ls, 16) != 0) { perror("io_set_listen_exclusive"); _exit(1); }
+
+    for(;;)
+    {
+        int n = io_select(&ctx, 100, &events);
+        for(int i = 0; i < n; i++)
+        {
+            io_event *e = &events.events[i];
+            int fd = e->handle;
+
+            // 一括受け入れ（exclusive）は登録済みの接続として通知される
+            if(e->event_type == IO_EVENT_ACCEPT)
+            {
+                accepted++;
+                continue;
+            }
+            if(fd == ls)
+            {
+                for(;;)
+                {
+                    int c = accept4(ls, NULL, NULL, SOCK_NONBLOCK);
+                    if(c == -1) break;
+                    io_register(&ctx, c, 0, 0);
+                    accepted++;
+                }
+                continue;
+            }
+
+            ssize_t r = e->event_type == IO_EVENT_READ ? recv(fd, buf, sizeof(buf), 0) : 0;
+            if(r == -1 && errno == EAGAIN) continue;
+            if(r <= 0)
+            {
+                io_unregister(&ctx, fd);
+                close(fd);
+                continue;
+            }
+            if(buf[0] == 'Q')
+            {
+                accepted--;
+                write(report, &accepted, sizeof(accepted));
+                _exit(0);
+            }
+            if(buf[0] == 'H')
+            {
+                double end = now_ns() + heavy_us * 1e3;
+                while(now_ns() < end);
+            }
+            send(fd, buf, (size_t)r, MSG_NOSIGNAL);
+        }
+    }
+}
+
+static void open_conn(bench_conn *c, int ep, uint32_t idx)
+{
+    struct sockaddr_in a = bench_addr();
+    struct epoll_event ev = { .events = EPOLLIN, .data.u32 = idx };
+    char buf[BENCH_MSG_SIZE];
+
+    c->fd    = socket(AF_INET, SOCK_STREAM, 0);
+    c->left  = BENCH_REQUESTS;
+    c->heavy = rand() % 100 < BENCH_HEAVY_PCT;
+    connect(c->fd, (struct sockaddr *)&a, sizeof(a));
+
+    memset(buf, c->heavy ? 'H' : 'L', sizeof(buf));
+    c->t0 = now_ns();
+    send(c->fd, buf, sizeof(buf), 0);
+    epoll_ctl(ep, EPOLL_CTL_ADD, c->fd, &ev);
+}
+
+static void run(int workers, int exclusive)
+{
+    pid_t pids[BENCH_MAX_WORKERS];
+    int report[2];
+    int shared = exclusive ? open_listen(0) : -1;
+
+    pipe(report);
+    for(int w = 0; w < workers; w++)
+    {
+        int ls = exclusive ? shared : open_listen(1);
+        pids[w] = fork();
+        if(pids[w] == 0) worker(ls, exclusive, report[1]);
+        if(!exclusive) close(ls);
+    }
+    usleep(200000);
+
+    static bench_conn conns[BENCH_CONCURRENCY];
+    double *light = malloc(sizeof(double) * BENCH_CONNECTIONS * BENCH_REQUESTS);
+    double *heavy = malloc(sizeof(double) * BENCH_CONNECTIONS * BENCH_REQUESTS);
+    size_t nl = 0, nh = 0;
+    int started = 0, done = 0;
+    int ep = epoll_create1(0);
+    struct epoll_event evs[128];
+
+    srand(44);
+    double t_start = now_ns();
+    for(int i = 0; i < BENCH_CONCURRENCY && started < BENCH_CONNECTIONS; i++, started++) open_conn(&conns[i], ep, (uint32_t)i);
+
+    while(done < BENCH_CONNECTIONS)
+    {
+        int n = epoll_wait(ep, evs, 128, 1000);
+        for(int k = 0; k < n; k++)
+        {
+            uint32_t i = evs[k].data.u32;
+            bench_conn *c = &conns[i];
+            char buf[BENCH_MSG_SIZE];
+
+            ssize_t r = recv(c->fd, buf, sizeof(buf), MSG_WAITALL);
+            if(r <= 0) { fprintf(stderr, "recv %zd\n", r); exit(1); }
+
+            double d = now_ns() - c->t0;
+            if(c->heavy) heavy[nh++] = d;
+            else light[nl++] = d;
+
+            if(--c->left > 0)
+            {
+                c->t0 = now_ns();
+                send(c->fd, buf, sizeof(buf), 0);
+                continue;
+            }
+            close(c->fd);
+            done++;
+            if(started < BENCH_CONNECTIONS)
+            {
+                open_conn(c, ep, i);
+                started++;
+            }
+        }
+    }
+    double secs = (now_ns() - t_start) / 1e9;
+
+    qsort(light, nl, sizeof(double), cmp_double);
+    qsort(heavy, nh, sizeof(double), cmp_double);
+    printf("%-10s %6.2fs %7.0f req/s  light p50=%.2fms p99=%.2fms p999=%.2fms  heavy p99=%.2fms  accepted:",
+        exclusive ? "exclusive" : "reuseport", secs, (nl + nh) / secs,
+        light[nl / 2] / 1e6, light[nl * 99 / 100] / 1e6, light[nl * 999 / 1000] / 1e6, heavy[nh * 99 / 100] / 1e6);
+
+    // すべてのワーカーが終了するまで 'Q' を送る（どのワーカーが受け入れるかは分からない）
+    for(int got = 0; got < workers; )
+    {
+        struct sockaddr_in a = bench_addr();
+        struct pollfd p = { .fd = report[0], .events = POLLIN };
+        int q = socket(AF_INET, SOCK_STREAM, 0);
+
+        connect(q, (struct sockaddr *)&a, sizeof(a));
+        send(q, "Q", 1, MSG_NOSIGNAL);
+        if(poll(&p, 1, 200) > 0)
+        {
+            int count;
+            read(report[0], &count, sizeof(count));
+            printf(" %d", count);
+            got++;
+        }
+        close(q);
+    }
+    printf("\n");
+
+    for(int w = 0; w < workers; w++) waitpid(pids[w], NULL, 0);
+    if(shared >= 0) close(shared);
+    close(report[0]);
+    close(report[1]);
+    close(ep);
+    free(light);
+    free(heavy);
+}
+
+int main(int argc, char **argv)
+{
+    int workers = argc > 1 ? atoi(argv[1]) : 4;
+    if(argc > 2) heavy_us = atoi(argv[2]);
+    if(workers < 1 || workers > BENCH_MAX_WORKERS) workers = 4;
+
+    signal(SIGPIPE, SIG_IGN);
+    for(int round = 0; round < 2; round++)
+    {
+        run(workers, 0);
+        run(workers, 1);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+/**
+ * ビジーポーリングモードの往復レイテンシの計測
+ *
+ * 子プロセスが io_select で 64 バイトのエコーを返し、親プロセスが往復時間の p50 / p99 / p999 を求める。
+ * 通常モード（epoll_wait で待機）とビジーポーリングモード（io_set_busy_poll。epoll_wait(0) を回す）を順に計測する。
+ * CPU 番号を指定するとエコー側と計測側をそれぞれの CPU に固定する（ビジーポーリングは専用コアが前提）。
+ *
+ * gcc -O2 -o busy_poll busy_poll.c && ./busy_poll [server_cpu client_cpu]
+ */
+#define _GNU_SOURCE
+#include "../libio_core_linux.c"
+#include <stdio.h>
+#include <sys/wait.h>
+
+#define BENCH_ROUNDS    20000
+#define BENCH_WARMUP    1000
+#define BENCH_MSG_SIZE  64
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+// エコー側（io_select で受信を待ち、そのまま返す）
+static void echo_server(int ls, int busy, int cpu)
+{
+    static io_event_list events;
+    io_context ctx;
+    char buf[BENCH_MSG_SIZE];
+    int s = accept(ls, NULL, NULL);
+
+    if(cpu >= 0) io_set_affinity(&cpu, 1);
+
+    memset(&ctx, 0, sizeof(ctx));
+    io_core_init(&ctx, 1024);
+    ctx.profile[0].nodelay = 1;
+    io_set_busy_poll(&ctx, busy, 50, 8, 1);
+    io_register(&ctx, s, 0, 0);
+
+    for(;;)
+    {
+        int n = io_select(&ctx, busy ? 0 : 100, &events);
+        for(int i = 0; i < n; i++)
+        {
+            ssize_t r = recv(s, buf, sizeof(buf), 0);
+            if(r <= 0) _exit(0);
+            send(s, buf, (size_t)r, 0);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int server_cpu = argc > 2 ? atoi(argv[1]) : -1;
+    int client_cpu = argc > 2 ? atoi(argv[2]) : -1;
+    double *rtt = malloc(sizeof(double) * BENCH_ROUNDS);
+
+    if(client_cpu >= 0) io_set_affinity(&client_cpu, 1);
+
+    for(int busy = 0; busy < 2; busy++)
+    {
+        struct sockaddr_in a = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+        socklen_t len = sizeof(a);
+        int ls = socket(AF_INET, SOCK_STREAM, 0);
+        bind(ls, (struct sockaddr *)&a, sizeof(a));
+        getsockname(ls, (struct sockaddr *)&a, &len);
+        listen(ls, 1);
+
+        pid_t pid = fork();
+        if(pid == 0) echo_server(ls, busy, server_cpu);
+
+        int c = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        connect(c, (struct sockaddr *)&a, sizeof(a));
+        setsockopt(c, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        char buf[BENCH_MSG_SIZE] = { 0 };
+        for(int i = 0; i < BENCH_WARMUP + BENCH_ROUNDS; i++)
+        {
+            double t0 = now_ns();
+            send(c, buf, sizeof(buf), 0);
+            for(size_t got = 0; got < sizeof(buf); )
+            {
+                ssize_t r = recv(c, buf + got, sizeof(buf) - got, 0);
+                if(r <= 0) break;
+                got += (size_t)r;
+            }
+            if(i >= BENCH_WARMUP) rtt[i - BENCH_WARMUP] = now_ns() - t0;
+        }
+
+        close(c);
+        waitpid(pid, NULL, 0);
+        close(ls);
+
+        qsort(rtt, BENCH_ROUNDS, sizeof(double), cmp_double);
+        printf("%-8s p50=%.1fus p99=%.1fus p999=%.1fus\n", busy ? "busy" : "default",
+            rtt[BENCH_ROUNDS / 2] / 1e3, rtt[BENCH_ROUNDS * 99 / 100] / 1e3, rtt[BENCH_ROUNDS * 999 / 1000] / 1e3);
+    }
+
+    free(rtt);
+    return 0;
+}
@@ -0,0 +1,175 @@
+/**
+ * MSG_ZEROCOPY の損益分岐点の計測
+ *
+ * 送信サイズごとに通常の send と MSG_ZEROCOPY の送信スループットと送信スレッドの CPU 時間を比べる。
+ * 引数なしはループバックの受信スレッドへ送る（カーネルがコピーに切り替えるため上限側の損失だけが分かる）。
+ * 実際の NIC 経由で計測する場合は相手側で `nc -lk 9000 > /dev/null` 等を起動して host port を指定する。
+ *
+ * gcc -O2 -o zerocopy zerocopy.c -lpthread && ./zerocopy [host port]
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <linux/errqueue.h>
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
+
+#define BENCH_TOTAL     (1ULL << 30)    // サイズごとの送信量
+#define BENCH_MAX_SIZE  (1 << 20)
+
+static volatile int drain_stop;
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double thread_cpu_sec(void)
+{
+    struct rusage ru;
+    getrusage(RUSAGE_THREAD, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+}
+
+// ループバック側の受信（読み捨て）
+static void *drain(void *arg)
+{
+    static char buf[BENCH_MAX_SIZE];
+    int fd = *(int *)arg;
+    while(!drain_stop)
+    {
+        if(recv(fd, buf, sizeof(buf), 0) <= 0) break;
+    }
+    return NULL;
+}
+
+// 完了通知の回収（戻り値はカーネルがコピーした通知の数）
+static unsigned reap(int fd, unsigned *notes)
+{
+    unsigned copied = 0;
+    char ctl[128];
+    struct msghdr m;
+
+    for(;;)
+    {
+        memset(&m, 0, sizeof(m));
+        m.msg_control    = ctl;
+        m.msg_controllen = sizeof(ctl);
+        if(recvmsg(fd, &m, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) break;
+
+        struct cmsghdr *cm = CMSG_FIRSTHDR(&m);
+        if(!cm) continue;
+        struct sock_extended_err *serr = (struct sock_extended_err *)CMSG_DATA(cm);
+        if(serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+        *notes += serr->ee_data - serr->ee_info + 1;
+        if(serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) copied++;
+    }
+
+    return copied;
+}
+
+static int open_sink(const char *host, const char *port, int *rfd, pthread_t *th)
+{
+    struct sockaddr_in a = { .sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t len = sizeof(a);
+    int c = socket(AF_INET, SOCK_STREAM, 0);
+
+    if(host)
+    {
+        a.sin_port = htons((unsigned short)atoi(port));
+        if(inet_pton(AF_INET, host, &a.sin_addr) != 1) return -1;
+        if(connect(c, (struct sockaddr *)&a, sizeof(a)) == -1) return -1;
+        *rfd = -1;
+        return c;
+    }
+
+    int ls = socket(AF_INET, SOCK_STREAM, 0);
+    bind(ls, (struct sockaddr *)&a, sizeof(a));
+    getsockname(ls, (struct sockaddr *)&a, &len);
+    listen(ls, 1);
+    connect(c, (struct sockaddr *)&a, sizeof(a));
+    *rfd = accept(ls, NULL, NULL);
+    close(ls);
+
+    drain_stop = 0;
+    pthread_create(th, NULL, drain, rfd);
+    return c;
+}
+
+int main(int argc, char **argv)
+{
+    static const size_t sizes[] = { 1024, 4096, 8192, 16384, 32768, 65536, 262144, 1048576 };
+    const char *host = argc > 2 ? argv[1] : NULL;
+    const char *port = argc > 2 ? argv[2] : NULL;
+    char *buf = malloc(BENCH_MAX_SIZE);
+
+    memset(buf, 7, BENCH_MAX_SIZE);
+    printf("%8s  %-8s  %9s  %11s  %s\n", "size", "mode", "MB/s", "cpu us/MB", "copied");
+
+    for(size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); si++)
+    {
+        for(int zc = 0; zc < 2; zc++)
+        {
+            int rfd;
+            pthread_t th;
+            int c = open_sink(host, port, &rfd, &th);
+            if(c == -1) { perror("connect"); return 1; }
+
+            int one = 1;
+            if(zc && setsockopt(c, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == -1) { perror("SO_ZEROCOPY"); return 1; }
+
+            size_t size = sizes[si];
+            unsigned long long total = 0;
+            unsigned notes = 0, copied = 0;
+            double t0 = now_sec(), c0 = thread_cpu_sec();
+
+            while(total < BENCH_TOTAL)
+            {
+                ssize_t r = send(c, buf, size, zc ? MSG_ZEROCOPY : 0);
+                if(r > 0) total += (unsigned long long)r;
+                else
+                if(errno == ENOBUFS)
+                {
+                    // optmem の上限（完了通知待ち）
+                    struct pollfd p = { .fd = c, .events = 0 };
+                    poll(&p, 1, 10);
+                }
+                else
+                {
+                    perror("send");
+                    break;
+                }
+                if(zc) copied += reap(c, &notes);
+            }
+
+            double t = now_sec() - t0, cpu = thread_cpu_sec() - c0;
+            printf("%8zu  %-8s  %9.0f  %11.1f  %s\n", size, zc ? "zerocopy" : "send",
+                total / t / 1e6, cpu * 1e6 / (total / 1e6), zc ? (copied ? "yes" : "no") : "-");
+
+            drain_stop = 1;
+            shutdown(c, SHUT_RDWR);
+            if(rfd >= 0) { pthread_join(th, NULL); close(rfd); }
+            close(c);
+        }
+    }
+
+    free(buf);
+    return 0;
+}
@@ -1,18 +1,105 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE     // splice / sched_setaffinity
+#endif
+
 #include <sys/epoll.h>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <linux/errqueue.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <time.h>
 #include <unistd.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <sys/random.h>
+#include <stdatomic.h>
+
+#ifndef SO_ZEROCOPY
+#define SO_ZEROCOPY 60
+#endif
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+#ifndef EPIOCSPARAMS
+// epoll 単位のビジーポーリング設定（Linux 6.9 以降。古いヘッダ向けに定義）
+struct epoll_params {
+    uint32_t busy_poll_usecs;
+    uint16_t busy_poll_budget;
+    uint8_t  prefer_busy_poll;
+    uint8_t  __pad;
+};
+#define EPIOCSPARAMS _IOW(0x8A, 0x01, struct epoll_params)
+#endif
+#ifndef MSG_ZEROCOPY
+#define MSG_ZEROCOPY 0x4000000
+#endif
 
 #define IO_EVENT_READ        1
 #define IO_EVENT_WRITE       2
 #define IO_EVENT_ERROR       3
 #define IO_EVENT_DISCONNECT  4
+#define IO_EVENT_ACCEPT      5   // 共有待ち受けの受け入れ（handle に受け入れた fd。Windows 版は AcceptEx 用）
+#define IO_EVENT_THROTTLE    8   // レート制限の発動（6〜7 は Windows 版で使用）
+#define IO_EVENT_CONNECT     9   // io_connect の接続完了
+#define IO_EVENT_CONNECT_FAIL 10 // io_connect の接続失敗（error_code に errno）
 
 #define MAX_EVENTS 128
+#define IO_ACCEPT_BATCH 16      // 共有待ち受けで 1 回に受け入れる既定の最大数
+
+#define IO_SENDFILE_MAX 0x7ffff000   // sendfile/splice 1 回あたりの上限（カーネル側の制限と同じ）
+#define IO_ZC_CLOSE_WAIT_MS 1000      // io_core_close で MSG_ZEROCOPY の完了通知を待つ上限
+
+#define IO_STAT_CYCLE       0   // 周期ドリブン処理 1 回の所要時間（ns。io_stats_begin／io_stats_end）
+#define IO_STAT_WAIT        1   // io_select 内の epoll_wait の所要時間（ns）
+#define IO_STAT_EVENTS      2   // io_select 1 回で返したイベント数
+#define IO_STAT_UNIT        3   // UNIT 1 回の所要時間（ns。io_stats_begin／io_stats_end）
+#define IO_STAT_DISPATCH    4   // io_select が戻ってから UNIT を実行するまでの遅延（ns。io_stats_end のみ）
+#define IO_STAT_COUNT       5
+
+#define IO_HIST_SUB_BITS    5   // 2 の冪ごとの分割数（2^5。相対誤差は 1/32 以内）
+#define IO_HIST_MAX_BITS    42  // 記録する値の上限（2^42 ns ≒ 73 分。超えた値は上限に丸める）
+#define IO_HIST_BUCKETS     ((IO_HIST_MAX_BITS - IO_HIST_SUB_BITS + 1) << IO_HIST_SUB_BITS)
+
+// 累積カウンタ（io_context.counters の添字。常に数える）
+#define IO_CNT_BYTES_IN     0   // 受信バイト数（ドライバ外で recv した分は呼び出し側が加算する）
+#define IO_CNT_BYTES_OUT    1   // 送信キューから送信したバイト数
+#define IO_CNT_SELECTS      2   // io_select の呼び出し回数
+#define IO_CNT_EVENTS       3   // io_select が返したイベント数の合計
+#define IO_CNT_BATCH_FULL   4   // 1 回で MAX_EVENTS 件を返した回数（取りこぼしの目安）
+#define IO_CNT_ACCEPTS      5   // 共有待ち受けでドライバ内で受け入れた接続数
+#define IO_CNT_COUNT        6
+
+// 現在値（io_get_metrics で取得時に集計する）
+#define IO_GAUGE_FDS            0   // 登録中の fd 数
+#define IO_GAUGE_FD_CAPACITY    1   // fd テーブルの要素数
+#define IO_GAUGE_LISTENERS      2   // 待ち受けソケット数
+#define IO_GAUGE_SEND_SEGMENTS  3   // 送信キューの要素数
+#define IO_GAUGE_SEND_BYTES     4   // 送信キューの未送信バイト数
+#define IO_GAUGE_SEND_MAX       5   // fd 単位の未送信バイト数の最大
+#define IO_GAUGE_ZC_SEGMENTS    6   // MSG_ZEROCOPY の完了通知待ちの要素数
+#define IO_GAUGE_PAUSED         7   // レート制限で読み込み停止中の fd 数（再開タイマー）
+#define IO_GAUGE_CONNECTING     8   // io_connect の接続待ちの fd 数（期限タイマー）
+#define IO_GAUGE_DNS_QUERIES    9   // 応答待ちの名前解決の問い合わせ数（再送タイマー）
+#define IO_GAUGE_DNS_CACHE      10  // 名前解決のキャッシュ件数
+#define IO_GAUGE_COUNT          11
 
 typedef struct {
     int     handle;
@@ -27,11 +114,280 @@ typedef struct {
     io_event  events[MAX_EVENTS];
 } io_event_list;
 
+#define IO_SEG_FILE 0   // sendfile
+#define IO_SEG_PIPE 1   // splice
+#define IO_SEG_DATA 2   // send（閾値以上は MSG_ZEROCOPY）
+
+// 送信キューの要素（ファイルは fd / offset / length、データは呼び出し側のバッファを参照）
+typedef struct io_file_seg {
+    int          kind;
+    int          fd;            // dup 済みの入力 fd（送信完了／解除時に close）
+    off_t        offset;        // DATA の場合は送信済みバイト数
+    size_t       remain;
+    const char  *data;          // DATA のみ
+    void        *owner;         // DATA のみ。カーネルが解放するまで保持（ctx->release で返却）
+    int          zc;            // MSG_ZEROCOPY で送信したか
+    uint32_t     zc_seq;        // 最後に MSG_ZEROCOPY 送信した時の通知番号
+    struct io_file_seg *next;
+} io_file_seg;
+
+// 解除後も MSG_ZEROCOPY の完了通知を待つバッファ（dup した fd でソケットを開いたままにする）
+typedef struct io_zc_deferred {
+    int          fd;            // dup 済みの fd（完了通知がすべて届いたら close）
+    io_file_seg *head;
+    io_file_seg *tail;
+    struct io_zc_deferred *next;
+} io_zc_deferred;
+
+// ソケットのチューニングプロファイル（-1 = 変更しない）
+typedef struct {
+    int nodelay;        // TCP_NODELAY
+    int sndbuf;         // SO_SNDBUF
+    int rcvbuf;         // SO_RCVBUF
+    int quickack;       // TCP_QUICKACK（受信のたびに再設定）
+    int notsent_lowat;  // TCP_NOTSENT_LOWAT
+    int busy_poll;      // SO_BUSY_POLL（μs）
+    int user_timeout;   // TCP_USER_TIMEOUT（ms）
+    int keepalive;      // SO_KEEPALIVE
+    int keepidle;       // TCP_KEEPIDLE（秒）
+    int keepintvl;      // TCP_KEEPINTVL（秒）
+    int keepcnt;        // TCP_KEEPCNT
+} io_sock_profile;
+
+#define IO_FRAME_NONE       0
+#define IO_FRAME_FIXED      1   // 固定長
+#define IO_FRAME_LENGTH     2   // 長さプレフィックス
+#define IO_FRAME_DELIMITER  3   // 区切り文字列
+
+#define IO_FRAME_MAX_DEFAULT (16 * 1024 * 1024)    // フレーム上限の既定値
+#define IO_FRAME_DELIM_MAX   16
+
+// フレーミング指定
+typedef struct {
+    int          mode;
+    size_t       size;                      // FIXED：フレームサイズ
+    size_t       len_offset;                // LENGTH：長さフィールドの位置
+    int          len_width;                 // LENGTH：長さフィールドのバイト数（1 / 2 / 4 / 8）
+    int          len_le;                    // LENGTH：リトルエンディアン
+    long long    len_adjust;                // LENGTH：長さフィールドの値への補正（ヘッダ込みの長さなら負数）
+    char         delim[IO_FRAME_DELIM_MAX]; // DELIMITER：区切り文字列
+    size_t       delim_len;
+    int          strip;                     // LENGTH はヘッダ、DELIMITER は区切りを除いて返す
+    size_t       max_frame;                 // フレームの上限（0 = IO_FRAME_MAX_DEFAULT）
+} io_frame_spec;
+
+// fd 単位のフレーミング状態（未完成のフレームを保持する）
+typedef struct {
+    io_frame_spec spec;
+    char         *buf;
+    size_t        head;     // 未取り出しの先頭
+    size_t        len;      // 格納済みの末尾
+    size_t        cap;
+    size_t        scan;     // DELIMITER：検索済みの位置（同じ範囲を繰り返し検索しない）
+} io_framer;
+
+#define IO_RATE_DELAY       0   // 読み込みを止め、トークンが戻るまで待つ
+#define IO_RATE_DROP        1   // 超過分の受信データを破棄する
+#define IO_RATE_DISCONNECT  2   // 切断を要求する
+
+// io_rate_consume の戻り値
+#define IO_RATE_PASS        0   // 制限内
+#define IO_RATE_PAUSED      1   // 読み込みを停止した（データは受け渡す）
+#define IO_RATE_DROPPED     2   // データを破棄すべき
+#define IO_RATE_EXCEEDED    3   // 切断すべき
+
+// レート制限の指定（rate が 0 の項目は制限しない）
+typedef struct {
+    double       bytes_rate;    // バイト／秒
+    double       bytes_burst;   // バケット容量（0 = bytes_rate）
+    double       msgs_rate;     // メッセージ／秒（read イベント、フレーミング中はフレーム単位）
+    double       msgs_burst;    // バケット容量（0 = msgs_rate）
+    int          policy;        // IO_RATE_DELAY / IO_RATE_DROP / IO_RATE_DISCONNECT
+} io_rate_spec;
+
+// トークンバケット（待ち受け単位のものは受け入れた接続で共有する）
+typedef struct {
+    io_rate_spec spec;
+    double       bytes;         // 残りトークン（DELAY では負数 = 借り越し）
+    double       msgs;
+    uint64_t     last_ns;       // 最後に補充した時刻
+    int          refs;
+} io_bucket;
+
+#define IO_DNS_NAME_MAX      253     // ホスト名の最大長
+#define IO_DNS_CACHE_BUCKETS 256
+#define IO_DNS_CACHE_MAX     4096    // キャッシュする名前の上限
+#define IO_DNS_TIMEOUT_MS    1000    // 1 回の問い合わせの応答待ち
+#define IO_DNS_ATTEMPTS      3       // 問い合わせの最大送信回数
+
+// 名前解決の結果（A レコード。TTL が切れるまで保持）
+typedef struct io_dns_cache {
+    struct io_dns_cache *next;
+    char           name[IO_DNS_NAME_MAX + 1];
+    struct in_addr addr;
+    uint64_t       expire_ns;   // UINT64_MAX = 無期限（/etc/hosts）
+} io_dns_cache;
+
+// 応答待ちの問い合わせ（同じ名前の接続はまとめて待つ）
+typedef struct io_dns_query {
+    struct io_dns_query *next;
+    uint16_t id;
+    char     name[IO_DNS_NAME_MAX + 1];
+    int      tries;             // 送信回数
+    uint64_t retry_ns;          // 再送する時刻
+    int      waiter_head;       // 解決待ちの fd リスト（-1 = なし）
+} io_dns_query;
+
+// イベントループ上で動く UDP の DNS クライアント
+typedef struct {
+    int                 fd;             // 問い合わせ用 UDP ソケット（-1 = 未生成）
+    struct sockaddr_in  server;
+    int                 timeout_ms;
+    int                 attempts;
+    io_dns_query       *queries;
+    io_dns_cache       *cache[IO_DNS_CACHE_BUCKETS];
+    int                 cache_count;
+} io_resolver;
+
+#define IO_SHM_MAGIC        0x534d4950u     // "SMIP"
+#define IO_SHM_NAME_MAX     64
+#define IO_SHM_CAPACITY     (1u << 20)      // リング容量の既定値（方向ごと）
+#define IO_SHM_CAPACITY_MIN (1u << 12)
+#define IO_SHM_CAPACITY_MAX (1u << 30)
+#define IO_SHM_READ_BURST   16              // 1 回の read イベントで読み出す最大回数
+
+// 共有メモリ上のリング（受信側だけが head を、送信側だけが tail を進める SPSC のバイトストリーム）
+typedef struct {
+    _Atomic uint64_t head;
+    char             pad0[56];
+    _Atomic uint64_t tail;
+    char             pad1[56];
+    _Atomic uint32_t waiting;   // 受信側が空を確認して呼び鈴を待っている
+    _Atomic uint32_t closed;    // 送信側がクローズした
+    char             pad2[56];
+} io_shm_ring;
+
+// 共有メモリの先頭（後ろに ring[0] → ring[1] の順でデータ領域が続く）
+typedef struct {
+    uint32_t    magic;
+    uint32_t    capacity;       // リング 1 本のデータ領域（2 のべき乗）
+    char        pad[56];
+    io_shm_ring ring[2];        // [0] = 作成側 → 参加側 / [1] = 参加側 → 作成側
+} io_shm_header;
+
+// プロセスごとのチャネル（呼び鈴ソケットの fd に紐付ける）
+typedef struct {
+    io_shm_header     *hdr;
+    size_t             map_size;
+    io_shm_ring       *tx;
+    io_shm_ring       *rx;
+    unsigned char     *tx_data;
+    unsigned char     *rx_data;
+    uint64_t           mask;
+    struct sockaddr_un self;        // 自身の呼び鈴（抽象名前空間）
+    socklen_t          self_len;
+    struct sockaddr_un peer;        // 相手の呼び鈴
+    socklen_t          peer_len;
+    int                owner;       // 作成側（クローズ時に共有メモリのファイルを削除する）
+    char               path[IO_SHM_NAME_MAX + 32];
+} io_shm_channel;
+
+// HDR 形式のヒストグラム（2 の冪ごとに IO_HIST_SUB_BITS ビットで線形に分割した固定長の度数表）
+typedef struct {
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    uint64_t buckets[IO_HIST_BUCKETS];
+} io_hist;
+
+// 計測値（io_stats_enable で確保する）
+typedef struct {
+    io_hist  hist[IO_STAT_COUNT];
+    uint64_t start[IO_STAT_COUNT];  // io_stats_begin の時刻（IO_STAT_DISPATCH は io_select が戻った時刻）
+} io_stats;
+
+// io_stats_get の結果（値の単位は計測対象と同じ。百分位はその度数区間の上限値）
+typedef struct {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t mean;
+    uint64_t p50;
+    uint64_t p90;
+    uint64_t p99;
+    uint64_t p999;
+} io_stats_summary;
+
+// fd 単位の登録情報（fd をインデックスとしたフラットテーブルで保持）
+typedef struct {
+    int active;
+    int is_listen;
+    int is_udp;
+    int is_client;
+    int quickack;               // 受信後に TCP_QUICKACK を再設定する
+
+    io_file_seg *send_head;     // 送信キュー
+    io_file_seg *send_tail;
+    size_t       send_pending;  // キュー内の未送信バイト数
+    int          want_out;      // EPOLLOUT 監視中フラグ
+
+    io_file_seg *zc_head;       // 送信済みで完了通知待ちのバッファ
+    io_file_seg *zc_tail;
+    uint32_t     zc_next;       // 次の MSG_ZEROCOPY 送信に付く通知番号
+    int          zc_state;      // 0 = 未設定 / 1 = 有効 / -1 = 使わない
+
+    io_framer   *framer;        // フレーミング（NULL = 受信データをそのまま返す）
+
+    io_bucket   *bucket;        // 接続単位のレート制限
+    io_bucket   *shared;        // 待ち受け単位のレート制限（受け入れ時に参照）
+    int          throttled;     // 制限中（スロットルイベントは制限に入った時のみ通知する）
+    int          paused;        // 読み込み停止中（EPOLLIN を外している）
+    uint64_t     resume_ns;     // 読み込みを再開する時刻
+    int          paused_next;   // 停止中リストの次の fd（-1 = 末尾）
+
+    int          connecting;    // io_connect の接続待ち（EPOLLOUT のみ監視）
+    uint64_t     connect_ns;    // 接続待ちの期限（0 = なし）
+    int          connect_err;   // 期限に通知する errno（0 = ETIMEDOUT。イベントが一杯で通知を持ち越した失敗）
+    int          connect_next;  // 接続待ちリストの次の fd（-1 = 末尾）
+
+    io_dns_query  *resolving;       // 名前解決待ちの問い合わせ（NULL = なし）
+    int            resolve_next;    // 同じ問い合わせを待つ次の fd（-1 = 末尾）
+    unsigned short connect_port;    // 名前解決後に接続するポート
+
+    io_shm_channel *shm;            // 共有メモリ IPC の呼び鈴（NULL = 通常のソケット）
+
+    int          accept_batch;      // 共有待ち受けで 1 回に受け入れる最大数（0 = PHP 側で受け入れる）
+} io_fd_entry;
+
 typedef struct {
     int epfd;
     int capacity;
     int count;
     struct epoll_event *evlist;
+
+    size_t       recv_buf_size;     // 受信バッファサイズ
+    io_fd_entry *fds;               // fd → エントリ
+    int          fd_capacity;       // fds の要素数
+
+    size_t       zc_threshold;              // MSG_ZEROCOPY を使うサイズ（0 = 使わない）
+    void       (*release)(void *owner);     // 送信データの返却先（NULL なら呼び出し側で管理）
+    io_zc_deferred *zc_deferred;            // 解除済みの fd の完了通知待ち
+
+    io_sock_profile profile[2];             // [0] = 受け入れ側 / [1] = クライアント側
+
+    int          busy_poll;                 // ビジーポーリングモード（epoll_wait を timeout 0 で回す）
+    int          prefer_busy_poll;          // 登録時に SO_PREFER_BUSY_POLL を設定する
+
+    io_bucket   *listen_bucket;             // 以降に受け入れる接続で共有するレート制限
+    int          paused_head;               // 読み込み停止中の fd リスト（-1 = なし）
+    int          connect_head;              // 接続待ちの fd リスト（-1 = なし）
+
+    io_resolver *resolver;                  // io_connect の名前解決（初回の使用時に生成）
+
+    io_stats    *stats;                     // ヒストグラム（NULL = 計測しない）
+
+    uint64_t     counters[IO_CNT_COUNT];    // 累積カウンタ（IO_CNT_*）
 } io_context;
 
 static int set_nonblock(int fd) {
@@ -40,124 +396,2647 @@ static int set_nonblock(int fd) {
     return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
 }
 
-/**
- * 初期化
- */
-int io_core_init(io_context *ctx, size_t recv_buf_size)
+/* fd → entry を取得（未登録なら NULL） */
+static io_fd_entry *io_get_entry(io_context *ctx, int fd)
 {
-    (void)recv_buf_size;
+    if(fd < 0 || fd >= ctx->fd_capacity) return NULL;
+    if(!ctx->fds[fd].active) return NULL;
+    return &ctx->fds[fd];
+}
 
-    if(!ctx) return -1;
+/* fd → entry を確保（テーブルが足りなければ拡張） */
+static io_fd_entry *io_create_entry(io_context *ctx, int fd)
+{
+    if(fd < 0) return NULL;
 
-    ctx->epfd = epoll_create1(EPOLL_CLOEXEC);
-    if(ctx->epfd < 0) return -1;
+    if(fd >= ctx->fd_capacity)
+    {
+        int new_cap = ctx->fd_capacity;
+        while(new_cap <= fd) new_cap *= 2;
 
-    ctx->capacity = 4096;
-    ctx->count = 0;
-    ctx->evlist = calloc(ctx->capacity, sizeof(struct epoll_event));
+        io_fd_entry *tmp = realloc(ctx->fds, sizeof(io_fd_entry) * new_cap);
+        if(!tmp) return NULL;
+
+        memset(tmp + ctx->fd_capacity, 0, sizeof(io_fd_entry) * (new_cap - ctx->fd_capacity));
+        ctx->fds = tmp;
+        ctx->fd_capacity = new_cap;
+    }
 
-    return ctx->evlist ? 0 : -1;
+    return &ctx->fds[fd];
 }
 
-/**
- * 登録
- */
-int io_register(io_context *ctx, int fd, int is_udp, int is_client)
+/* キュー要素の解放 */
+static void io_seg_free(io_context *ctx, io_file_seg *seg)
 {
-    (void)is_udp;
-    (void)is_client;
+    if(seg->kind == IO_SEG_DATA)
+    {
+        if(seg->owner && ctx->release) ctx->release(seg->owner);
+    }
+    else
+    {
+        close(seg->fd);
+    }
+    free(seg);
+}
 
-    if(!ctx) return -1;
+/* 送信キューを破棄（途中まで MSG_ZEROCOPY で送ったものはカーネルが参照しているため完了通知待ちへ移す） */
+static void io_seg_drop_queue(io_context *ctx, io_fd_entry *e)
+{
+    io_file_seg *seg = e->send_head;
+    while(seg)
+    {
+        io_file_seg *next = seg->next;
+        if(seg->kind == IO_SEG_DATA && seg->zc)
+        {
+            seg->next = NULL;
+            if(e->zc_tail) e->zc_tail->next = seg;
+            else           e->zc_head = seg;
+            e->zc_tail = seg;
+        }
+        else
+        {
+            io_seg_free(ctx, seg);
+        }
+        seg = next;
+    }
+    e->send_head = NULL;
+    e->send_tail = NULL;
+    e->send_pending = 0;
+}
 
-    // 既に登録済みかチェック
-    // epoll は重複登録するとエラーになるので、ここは必要
-    // （本番では fd→user_data の map を持つと高速）
-    struct epoll_event ev;
-    memset(&ev, 0, sizeof(ev));
+/* 完了通知が届かないまま要素を捨てる（owner はカーネルが参照している可能性があるため返却しない） */
+static void io_seg_abandon(io_file_seg *head)
+{
+    while(head)
+    {
+        io_file_seg *next = head->next;
+        free(head);
+        head = next;
+    }
+}
 
-    set_nonblock(fd);
+/* 送り終えた先頭要素を外す（MSG_ZEROCOPY で送ったものは完了通知待ちへ） */
+static void io_seg_done(io_context *ctx, io_fd_entry *e)
+{
+    io_file_seg *seg = e->send_head;
+    e->send_head = seg->next;
+    if(!e->send_head) e->send_tail = NULL;
+    seg->next = NULL;
 
-    ev.events = EPOLLIN;  // WSAPoll と同じく read 監視のみ
-    ev.data.fd = fd;
+    if(seg->kind == IO_SEG_DATA && seg->zc)
+    {
+        if(e->zc_tail) e->zc_tail->next = seg;
+        else           e->zc_head = seg;
+        e->zc_tail = seg;
+        return;
+    }
+    io_seg_free(ctx, seg);
+}
 
-    if(epoll_ctl(ctx->epfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+/* エラーキューから MSG_ZEROCOPY の完了通知を読み、解放されたバッファを返却する（state は NULL 可） */
+static void io_zc_reap_list(io_context *ctx, int fd, io_file_seg **head, io_file_seg **tail, int *state)
+{
+    char control[128];
+
+    while(*head)
     {
-        if(errno == EEXIST) return 0;
-        return -1;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof(control);
+
+        if(recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) break;
+
+        for(struct cmsghdr *cm = CMSG_FIRSTHDR(&msg); cm; cm = CMSG_NXTHDR(&msg, cm))
+        {
+            if(!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR)
+              || (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR))) continue;
+
+            struct sock_extended_err *serr = (struct sock_extended_err *)CMSG_DATA(cm);
+            if(serr->ee_errno != 0 || serr->ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+
+            // カーネル側でコピーに切り替わった（ループバック等）なら以降は通常の send にする
+            if(state && (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)) *state = -1;
+
+            // 通知は [ee_info, ee_data] の範囲で順番に届く
+            uint32_t hi = serr->ee_data;
+            while(*head && (int32_t)(hi - (*head)->zc_seq) >= 0)
+            {
+                io_file_seg *seg = *head;
+                *head = seg->next;
+                if(!*head) *tail = NULL;
+                io_seg_free(ctx, seg);
+            }
+        }
     }
+}
 
-    ctx->count++;
-    return 0;
+static void io_zc_reap(io_context *ctx, int fd, io_fd_entry *e)
+{
+    io_zc_reap_list(ctx, fd, &e->zc_head, &e->zc_tail, &e->zc_state);
 }
 
-/**
- * 解除
- */
-int io_unregister(io_context *ctx, int fd)
+/* 解除する fd の完了通知待ちを引き取る（呼び出し側が fd を close しても dup した fd で通知を受け取り続ける） */
+static void io_zc_defer(io_context *ctx, int fd, io_fd_entry *e)
 {
-    if(!ctx) return -1;
+    if(!e->zc_head) return;
 
-    epoll_ctl(ctx->epfd, EPOLL_CTL_DEL, fd, NULL);
-    if(ctx->count > 0) ctx->count--;
+    io_zc_reap(ctx, fd, e);
+    if(!e->zc_head) return;
+
+    io_zc_deferred *d = malloc(sizeof(io_zc_deferred));
+    int dfd = d ? fcntl(fd, F_DUPFD_CLOEXEC, 0) : -1;
+    if(dfd == -1)
+    {
+        free(d);
+        io_seg_abandon(e->zc_head);
+    }
+    else
+    {
+        d->fd   = dfd;
+        d->head = e->zc_head;
+        d->tail = e->zc_tail;
+        d->next = ctx->zc_deferred;
+        ctx->zc_deferred = d;
+    }
+    e->zc_head = NULL;
+    e->zc_tail = NULL;
+}
+
+/* 解除済みの fd の完了通知を回収し、すべて届いたものは close する */
+static void io_zc_deferred_poll(io_context *ctx)
+{
+    io_zc_deferred **p = &ctx->zc_deferred;
+    while(*p)
+    {
+        io_zc_deferred *d = *p;
+        io_zc_reap_list(ctx, d->fd, &d->head, &d->tail, NULL);
+        if(d->head)
+        {
+            p = &d->next;
+            continue;
+        }
+        close(d->fd);
+        *p = d->next;
+        free(d);
+    }
+}
+
+/* 監視イベントの更新（読み込み停止中は EPOLLIN を外す） */
+static int io_update_events(io_context *ctx, int fd, int want_out, int paused)
+{
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = (paused ? 0 : EPOLLIN) | (want_out ? EPOLLOUT : 0);
+    ev.data.fd = fd;
+
+    return epoll_ctl(ctx->epfd, EPOLL_CTL_MOD, fd, &ev);
+}
+
+/* EPOLLOUT 監視の切り替え（送信待ちがある間だけ監視する） */
+static int io_set_out(io_context *ctx, int fd, io_fd_entry *e, int on)
+{
+    if(e->want_out == on) return 0;
 
+    if(io_update_events(ctx, fd, on, e->paused) == -1) return -1;
+
+    e->want_out = on;
     return 0;
 }
 
-/**
- * イベント待機
- */
-int io_select(io_context *ctx, int timeout_ms, void *events_ptr)
+static uint64_t io_now_ns(void)
 {
-    io_event_list *events = (io_event_list *)events_ptr;
-    if(!ctx || !events) return -1;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
 
-    events->count = 0;
+static io_bucket *io_bucket_new(const io_rate_spec *spec)
+{
+    io_bucket *b = calloc(1, sizeof(io_bucket));
+    if(!b) return NULL;
 
-    if(ctx->count == 0)
+    b->spec = *spec;
+    if(b->spec.bytes_burst <= 0) b->spec.bytes_burst = b->spec.bytes_rate;
+    if(b->spec.msgs_burst <= 0)  b->spec.msgs_burst  = b->spec.msgs_rate;
+    b->bytes   = b->spec.bytes_burst;
+    b->msgs    = b->spec.msgs_burst;
+    b->last_ns = io_now_ns();
+    b->refs    = 1;
+    return b;
+}
+
+static void io_bucket_release(io_bucket *b)
+{
+    if(b && --b->refs <= 0) free(b);
+}
+
+/* 経過時間分のトークンを補充 */
+static void io_bucket_refill(io_bucket *b, uint64_t now)
+{
+    double sec = (double)(now - b->last_ns) / 1e9;
+    b->last_ns = now;
+
+    if(b->spec.bytes_rate > 0)
     {
-        if(timeout_ms > 0) usleep(timeout_ms * 1000);
-        return 0;
+        b->bytes += b->spec.bytes_rate * sec;
+        if(b->bytes > b->spec.bytes_burst) b->bytes = b->spec.bytes_burst;
+    }
+    if(b->spec.msgs_rate > 0)
+    {
+        b->msgs += b->spec.msgs_rate * sec;
+        if(b->msgs > b->spec.msgs_burst) b->msgs = b->spec.msgs_burst;
+    }
+}
+
+/* 借り越しが解消するまでの時間（ns） */
+static uint64_t io_bucket_wait_ns(const io_bucket *b)
+{
+    double wait = 0;
+    if(b->spec.bytes_rate > 0 && b->bytes < 0) wait = -b->bytes / b->spec.bytes_rate;
+    if(b->spec.msgs_rate > 0 && b->msgs < 0)
+    {
+        double w = -b->msgs / b->spec.msgs_rate;
+        if(w > wait) wait = w;
     }
+    return (uint64_t)(wait * 1e9);
+}
 
-    int n = epoll_wait(ctx->epfd, ctx->evlist, MAX_EVENTS, timeout_ms);
-    if(n <= 0) return n;
+/* レート制限の解除（停止中なら読み込みを再開） */
+static void io_rate_free(io_context *ctx, int fd, io_fd_entry *e)
+{
+    io_bucket_release(e->bucket);
+    io_bucket_release(e->shared);
+    e->bucket = NULL;
+    e->shared = NULL;
 
-    for(int i = 0; i < n && events->count < MAX_EVENTS; i++)
+    if(e->paused)
     {
-        struct epoll_event *ev = &ctx->evlist[i];
-        io_event *out = &events->events[events->count++];
+        // 停止中リストから外す
+        for(int *p = &ctx->paused_head; *p != -1; p = &ctx->fds[*p].paused_next)
+        {
+            if(*p == fd) { *p = e->paused_next; break; }
+        }
+        e->paused = 0;
+        if(e->active) io_update_events(ctx, fd, e->want_out, 0);
+    }
+    e->throttled = 0;
+}
 
-        out->handle = ev->data.fd;
-        out->bytes = 0;
-        out->user_data = NULL;
-        out->error_code = 0;
-        out->event_type = 0;
+/* キュー先頭から送れるだけ送る（未送信バイト数 or -1） */
+static ssize_t io_flush_entry(io_context *ctx, int fd, io_fd_entry *e)
+{
+    int blocked = 0;
 
-        if(ev->events & EPOLLIN)
-            out->event_type = IO_EVENT_READ;
+    if(e->zc_head) io_zc_reap(ctx, fd, e);
 
-        if(ev->events & EPOLLOUT)
-            out->event_type = IO_EVENT_WRITE;
+    while(e->send_head)
+    {
+        io_file_seg *seg = e->send_head;
+        size_t want = seg->remain < IO_SENDFILE_MAX ? seg->remain : IO_SENDFILE_MAX;
+        ssize_t r;
 
-        if(ev->events & EPOLLERR)
-            out->event_type = IO_EVENT_ERROR;
+        if(seg->kind == IO_SEG_DATA)
+        {
+            const char *p = seg->data + seg->offset;
+            int zc = (e->zc_state == 1 && ctx->zc_threshold > 0 && seg->remain >= ctx->zc_threshold);
 
-        if(ev->events & EPOLLHUP)
-            out->event_type = IO_EVENT_DISCONNECT;
+            r = send(fd, p, want, MSG_DONTWAIT | MSG_NOSIGNAL | (zc ? MSG_ZEROCOPY : 0));
+            if(r == -1 && zc && errno == ENOBUFS)
+            {
+                // optmem の上限に達した時はコピー送信で凌ぐ
+                zc = 0;
+                r = send(fd, p, want, MSG_DONTWAIT | MSG_NOSIGNAL);
+            }
+            if(r > 0)
+            {
+                seg->offset += r;
+                if(zc)
+                {
+                    seg->zc     = 1;
+                    seg->zc_seq = e->zc_next++;
+                }
+            }
+        }
+        else
+        if(seg->kind == IO_SEG_PIPE)
+        {
+            unsigned int flags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+            if(seg->next || seg->remain > want) flags |= SPLICE_F_MORE;
+            r = splice(seg->fd, NULL, fd, NULL, want, flags);
+        }
+        else
+        {
+            r = sendfile(fd, seg->fd, &seg->offset, want);
+        }
+
+        if(r > 0)
+        {
+            seg->remain     -= (size_t)r;
+            e->send_pending -= (size_t)r;
+            ctx->counters[IO_CNT_BYTES_OUT] += (uint64_t)r;
+            if(seg->remain == 0) io_seg_done(ctx, e);
+            continue;
+        }
+
+        if(r == 0)
+        {
+            // 指定長に届く前に入力が尽きた（ファイルの切り詰め／パイプの close）
+            io_seg_drop_queue(ctx, e);
+            if(e->zc_head) io_zc_reap(ctx, fd, e);
+            io_set_out(ctx, fd, e, 0);
+            errno = EPIPE;
+            return -1;
+        }
+
+        if(errno == EINTR) continue;
+
+        if(errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            // splice の EAGAIN はパイプが空の場合もある
+            // その時に EPOLLOUT を監視すると空回りするので、ソケット側が詰まっている時だけ監視する
+            blocked = 1;
+            if(seg->kind == IO_SEG_PIPE)
+            {
+                struct pollfd pfd = { .fd = seg->fd, .events = POLLIN, .revents = 0 };
+                if(poll(&pfd, 1, 0) <= 0 || !(pfd.revents & (POLLIN | POLLHUP))) blocked = 0;
+            }
+            break;
+        }
+
+        int err = errno;
+        io_seg_drop_queue(ctx, e);
+        if(e->zc_head) io_zc_reap(ctx, fd, e);
+        io_set_out(ctx, fd, e, 0);
+        errno = err;
+        return -1;
+    }
+
+    io_set_out(ctx, fd, e, blocked);
+
+    return (ssize_t)e->send_pending;
+}
+
+/* フレーミング状態の解放 */
+static void io_framer_free(io_fd_entry *e)
+{
+    if(!e->framer) return;
+
+    free(e->framer->buf);
+    free(e->framer);
+    e->framer = NULL;
+}
+
+/* 長さフィールドの読み取り */
+static unsigned long long io_frame_read_len(const unsigned char *p, int width, int le)
+{
+    unsigned long long v = 0;
+    for(int i = 0; i < width; i++)
+    {
+        v = (v << 8) | p[le ? (width - 1 - i) : i];
+    }
+    return v;
+}
+
+/* プロファイルの初期化（全項目を「変更しない」に） */
+static void io_profile_reset(io_sock_profile *p)
+{
+    p->nodelay       = -1;
+    p->sndbuf        = -1;
+    p->rcvbuf        = -1;
+    p->quickack      = -1;
+    p->notsent_lowat = -1;
+    p->busy_poll     = -1;
+    p->user_timeout  = -1;
+    p->keepalive     = -1;
+    p->keepidle      = -1;
+    p->keepintvl     = -1;
+    p->keepcnt       = -1;
+}
+
+/* プロファイルの適用（失敗した項目は読み飛ばす。SO_BUSY_POLL の引き上げ等は権限が要るため） */
+static void io_apply_profile(int fd, const io_sock_profile *p, int is_listen, int is_udp)
+{
+    if(p->sndbuf > 0)     setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &p->sndbuf, sizeof(int));
+    if(p->rcvbuf > 0)     setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &p->rcvbuf, sizeof(int));
+
+    // listen ソケットにはバッファサイズのみ（受け入れた接続へ継承され、ウィンドウスケールにも反映される）
+    if(is_listen) return;
+
+    if(p->busy_poll >= 0) setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &p->busy_poll, sizeof(int));
+
+    if(is_udp) return;
+
+    if(p->nodelay >= 0)       setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &p->nodelay, sizeof(int));
+    if(p->quickack > 0)       setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, &p->quickack, sizeof(int));
+    if(p->notsent_lowat > 0)  setsockopt(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, &p->notsent_lowat, sizeof(int));
+    if(p->user_timeout >= 0)  setsockopt(fd, IPPROTO_TCP, TCP_USER_TIMEOUT, &p->user_timeout, sizeof(int));
+
+    // キープアライブ（相手の消失はカーネルが検出し、ETIMEDOUT の EPOLLERR として届く）
+    if(p->keepalive >= 0)     setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &p->keepalive, sizeof(int));
+    if(p->keepidle > 0)       setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &p->keepidle, sizeof(int));
+    if(p->keepintvl > 0)      setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &p->keepintvl, sizeof(int));
+    if(p->keepcnt > 0)        setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &p->keepcnt, sizeof(int));
+}
+
+/* epoll へ追加してエントリを有効化 */
+static int io_attach(io_context *ctx, int fd, int is_listen, int is_udp, int is_client)
+{
+    io_fd_entry *e = io_create_entry(ctx, fd);
+    if(!e) return -1;
+
+    // 既に登録済みかチェック
+    // epoll は重複登録するとエラーになるので、ここは必要
+    if(e->active) return 0;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+
+    set_nonblock(fd);
+
+    // UDP 待ち受けは受け入れ側として扱う
+    const io_sock_profile *prof = &ctx->profile[(is_client && !is_listen) ? 1 : 0];
+    io_apply_profile(fd, prof, is_listen && !is_udp, is_udp);
+
+    ev.events = EPOLLIN;  // WSAPoll と同じく read 監視のみ
+    ev.data.fd = fd;
+
+    if(epoll_ctl(ctx->epfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+    {
+        if(errno != EEXIST) return -1;
+    }
+
+    memset(e, 0, sizeof(*e));
+    e->active    = 1;
+    e->is_listen = is_listen;
+    e->is_udp    = is_udp;
+    e->is_client = is_client;
+    e->quickack  = (!is_listen && !is_udp && prof->quickack > 0);
+    e->paused_next = -1;
+    e->connect_next = -1;
+    e->resolve_next = -1;
+
+    // 待ち受け単位のレート制限は受け入れた接続で共有する
+    if(!is_listen && !is_udp && !is_client && ctx->listen_bucket)
+    {
+        e->shared = ctx->listen_bucket;
+        e->shared->refs++;
+    }
+
+    if(ctx->prefer_busy_poll && !is_listen)
+    {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &one, sizeof(one));
     }
 
-    return events->count;
+    ctx->count++;
+    return 0;
 }
 
 /**
- * 終了処理
+ * 初期化
  */
-int io_core_close(io_context *ctx)
+int io_core_init(io_context *ctx, size_t recv_buf_size)
 {
     if(!ctx) return -1;
 
-    if(ctx->epfd >= 0) close(ctx->epfd);
-    free(ctx->evlist);
+    ctx->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if(ctx->epfd < 0) return -1;
+
+    ctx->capacity = 4096;
+    ctx->count = 0;
+    ctx->evlist = calloc(ctx->capacity, sizeof(struct epoll_event));
+
+    ctx->recv_buf_size = recv_buf_size;
+    ctx->zc_threshold = 0;
+    ctx->release = NULL;
+    io_profile_reset(&ctx->profile[0]);
+    io_profile_reset(&ctx->profile[1]);
+    ctx->busy_poll = 0;
+    ctx->prefer_busy_poll = 0;
+    ctx->listen_bucket = NULL;
+    ctx->paused_head = -1;
+    ctx->connect_head = -1;
+    ctx->resolver = NULL;
+    ctx->stats = NULL;
+    memset(ctx->counters, 0, sizeof(ctx->counters));
+    ctx->fd_capacity = 1024;
+    ctx->fds = calloc(ctx->fd_capacity, sizeof(io_fd_entry));
+
+    return (ctx->evlist && ctx->fds) ? 0 : -1;
+}
+
+/**
+ * 登録
+ */
+int io_register(io_context *ctx, int fd, int is_udp, int is_client)
+{
+    if(!ctx) return -1;
+
+    return io_attach(ctx, fd, 0, is_udp, is_client);
+}
+
+/**
+ * 登録（Listen用）
+ */
+int io_registerListen(io_context *ctx, int fd)
+{
+    if(!ctx) return -1;
+
+    return io_attach(ctx, fd, 1, 0, 0);
+}
+
+/**
+ * 登録（UDP待ち受け用）
+ */
+int io_registerUdpListen(io_context *ctx, int fd)
+{
+    if(!ctx) return -1;
+
+    return io_attach(ctx, fd, 1, 1, 0);
+}
+
+/**
+ * 共有待ち受けの設定（prefork したワーカー間で 1 つの listen ソケットを待ち受ける）
+ *
+ * EPOLLEXCLUSIVE で登録し直し、接続要求ごとに起こすワーカーを 1 つ（以上）に絞る。
+ * 以降の EPOLLIN では io_select 内で batch 件まで accept4 し、IO_EVENT_ACCEPT で通知する。
+ * EPOLLEXCLUSIVE は EPOLL_CTL_ADD でしか指定できないため、いったん削除してから追加する。
+ */
+int io_set_listen_exclusive(io_context *ctx, int fd, int batch)
+{
+    if(!ctx || batch < 0) { errno = EINVAL; return -1; }
+
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e || !e->is_listen || e->is_udp) { errno = EINVAL; return -1; }
+
+    if(batch == 0) batch = IO_ACCEPT_BATCH;
+    if(batch > MAX_EVENTS) batch = MAX_EVENTS;
+
+    if(e->accept_batch == 0)
+    {
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+        ev.data.fd = fd;
+
+        if(epoll_ctl(ctx->epfd, EPOLL_CTL_DEL, fd, NULL) == -1) return -1;
+        if(epoll_ctl(ctx->epfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+        {
+            // 元の監視へ戻す（EPOLLEXCLUSIVE 非対応のカーネル）
+            int err = errno;
+            ev.events = EPOLLIN;
+            epoll_ctl(ctx->epfd, EPOLL_CTL_ADD, fd, &ev);
+            errno = err;
+            return -1;
+        }
+    }
+
+    e->accept_batch = batch;
+    return 0;
+}
+
+/**
+ * チューニングプロファイルの設定（以降の登録から適用）
+ */
+int io_set_profile(io_context *ctx, int is_client, const io_sock_profile *profile)
+{
+    if(!ctx) return -1;
+
+    io_sock_profile *p = &ctx->profile[is_client ? 1 : 0];
+    if(profile) *p = *profile;
+    else        io_profile_reset(p);
+
+    return 0;
+}
+
+/**
+ * ビジーポーリングモードの設定
+ *
+ * usecs / budget / prefer は epoll 単位のカーネル側ビジーポーリング（EPIOCSPARAMS）へ渡す。
+ * 非対応のカーネルや権限不足の場合でも、epoll_wait を timeout 0 で回すモード自体は有効になる。
+ * 戻り値は 0（カーネル側の設定も適用） / 1（モードのみ有効） / -1（失敗）
+ */
+int io_set_busy_poll(io_context *ctx, int enable, unsigned int usecs, unsigned int budget, int prefer)
+{
+    if(!ctx) return -1;
+
+    ctx->busy_poll = enable ? 1 : 0;
+    ctx->prefer_busy_poll = (enable && prefer) ? 1 : 0;
+
+    struct epoll_params params;
+    memset(&params, 0, sizeof(params));
+    if(enable)
+    {
+        params.busy_poll_usecs  = usecs;
+        params.busy_poll_budget = (uint16_t)(budget > 0xffff ? 0xffff : budget);
+        params.prefer_busy_poll = ctx->prefer_busy_poll;
+    }
+
+    if(ioctl(ctx->epfd, EPIOCSPARAMS, &params) == -1) return enable ? 1 : 0;
+
+    return 0;
+}
+
+/**
+ * CPU アフィニティの設定（呼び出したスレッドを指定 CPU に固定）
+ */
+int io_set_affinity(const int *cpus, int count)
+{
+    if(!cpus || count <= 0) { errno = EINVAL; return -1; }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(int i = 0; i < count; i++)
+    {
+        if(cpus[i] < 0 || cpus[i] >= CPU_SETSIZE) { errno = EINVAL; return -1; }
+        CPU_SET(cpus[i], &set);
+    }
+
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+
+/**
+ * フレーミングの設定（spec = NULL または IO_FRAME_NONE で解除。保持中の未完成フレームは破棄される）
+ *
+ * 設定後は io_frame_feed で受信データを渡し、io_frame_next で完成したフレームだけを取り出す。
+ */
+int io_set_framing(io_context *ctx, int fd, const io_frame_spec *spec)
+{
+    if(!ctx) { errno = EINVAL; return -1; }
+
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e || e->is_listen || e->is_udp) { errno = EINVAL; return -1; }
+
+    if(!spec || spec->mode == IO_FRAME_NONE)
+    {
+        io_framer_free(e);
+        return 0;
+    }
+
+    size_t max_frame = spec->max_frame ? spec->max_frame : IO_FRAME_MAX_DEFAULT;
+    switch(spec->mode)
+    {
+        case IO_FRAME_FIXED:
+            if(spec->size == 0 || spec->size > max_frame) { errno = EINVAL; return -1; }
+            break;
+        case IO_FRAME_LENGTH:
+            if(spec->len_width != 1 && spec->len_width != 2 && spec->len_width != 4 && spec->len_width != 8) { errno = EINVAL; return -1; }
+            if(spec->len_offset + (size_t)spec->len_width > max_frame) { errno = EINVAL; return -1; }
+            break;
+        case IO_FRAME_DELIMITER:
+            if(spec->delim_len == 0 || spec->delim_len > IO_FRAME_DELIM_MAX) { errno = EINVAL; return -1; }
+            break;
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+
+    if(!e->framer)
+    {
+        e->framer = calloc(1, sizeof(io_framer));
+        if(!e->framer) return -1;
+    }
+    e->framer->spec = *spec;
+    e->framer->spec.max_frame = max_frame;
+    e->framer->scan = e->framer->head;
+
+    return 0;
+}
+
+/**
+ * 受信データをフレーミングバッファへ追加
+ */
+int io_frame_feed(io_context *ctx, int fd, const char *data, size_t length)
+{
+    io_fd_entry *e = ctx ? io_get_entry(ctx, fd) : NULL;
+    if(!e || !e->framer) { errno = EINVAL; return -1; }
+
+    io_framer *f = e->framer;
+
+    // 取り出し済みの領域を詰める
+    if(f->head > 0)
+    {
+        size_t rest = f->len - f->head;
+        if(rest > 0) memmove(f->buf, f->buf + f->head, rest);
+        f->scan -= (f->scan >= f->head) ? f->head : f->scan;
+        f->len = rest;
+        f->head = 0;
+    }
+
+    if(f->len + length > f->cap)
+    {
+        size_t cap = f->cap ? f->cap : 4096;
+        while(cap < f->len + length) cap *= 2;
+
+        char *tmp = realloc(f->buf, cap);
+        if(!tmp) return -1;
+        f->buf = tmp;
+        f->cap = cap;
+    }
+
+    memcpy(f->buf + f->len, data, length);
+    f->len += length;
+
+    return 0;
+}
+
+/**
+ * 完成したフレームを 1 つ取り出す
+ *
+ * 戻り値は 1（*frame / *length に設定） / 0（未完成） / -1（フレーム上限超過等。errno = EMSGSIZE）
+ * *frame は次の io_frame_feed まで有効。
+ */
+int io_frame_next(io_context *ctx, int fd, const char **frame, size_t *length)
+{
+    io_fd_entry *e = ctx ? io_get_entry(ctx, fd) : NULL;
+    if(!e || !e->framer) { errno = EINVAL; return -1; }
+
+    io_framer           *f = e->framer;
+    const io_frame_spec *s = &f->spec;
+    const char          *p = f->buf + f->head;
+    size_t               avail = f->len - f->head;
+    size_t               total, skip = 0, trim = 0;
+
+    switch(s->mode)
+    {
+        case IO_FRAME_FIXED:
+            if(avail < s->size) return 0;
+            total = s->size;
+            break;
+
+        case IO_FRAME_LENGTH:
+        {
+            size_t hdr = s->len_offset + (size_t)s->len_width;
+            if(avail < hdr) return 0;
+
+            unsigned long long v = io_frame_read_len((const unsigned char *)p + s->len_offset, s->len_width, s->len_le);
+            long long body = (v > (unsigned long long)s->max_frame) ? -1 : (long long)v + s->len_adjust;
+            if(body < 0 || (unsigned long long)body > s->max_frame - hdr) { errno = EMSGSIZE; return -1; }
+
+            total = hdr + (size_t)body;
+            if(avail < total) return 0;
+            if(s->strip) skip = hdr;
+            break;
+        }
+
+        case IO_FRAME_DELIMITER:
+        {
+            // glibc の memchr / memmem はベクトル化されている。検索済みの範囲は読み飛ばす
+            size_t from = (f->scan > f->head) ? f->scan - f->head : 0;
+            const char *hit = NULL;
+            if(avail >= s->delim_len && from <= avail - s->delim_len)
+            {
+                hit = (s->delim_len == 1)
+                    ? memchr(p + from, s->delim[0], avail - from)
+                    : memmem(p + from, avail - from, s->delim, s->delim_len);
+            }
+            if(!hit)
+            {
+                if(avail > s->max_frame + s->delim_len) { errno = EMSGSIZE; return -1; }
+                f->scan = f->head + ((avail >= s->delim_len) ? avail - s->delim_len + 1 : 0);
+                return 0;
+            }
+
+            total = (size_t)(hit - p) + s->delim_len;
+            if(total - s->delim_len > s->max_frame) { errno = EMSGSIZE; return -1; }
+            if(s->strip) trim = s->delim_len;
+            break;
+        }
+
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+
+    *frame  = p + skip;
+    *length = total - skip - trim;
+
+    f->head += total;
+    f->scan  = f->head;
+    if(f->head == f->len) f->head = f->len = f->scan = 0;
+
+    return 1;
+}
+
+/**
+ * レート制限の設定（spec = NULL で解除）
+ *
+ * 接続の fd なら接続単位、待ち受けの fd なら以降に受け入れる接続で共有するバケットを設定する。
+ * 受信のたびに io_rate_consume で消費し、ポリシーに従って読み込みの停止／破棄／切断要求を返す。
+ */
+int io_set_rate_limit(io_context *ctx, int fd, const io_rate_spec *spec)
+{
+    if(!ctx) { errno = EINVAL; return -1; }
+
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e || e->is_udp) { errno = EINVAL; return -1; }
+
+    if(spec && (spec->bytes_rate < 0 || spec->msgs_rate < 0 || (spec->bytes_rate == 0 && spec->msgs_rate == 0)
+        || spec->policy < IO_RATE_DELAY || spec->policy > IO_RATE_DISCONNECT))
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    io_bucket *b = NULL;
+    if(spec)
+    {
+        b = io_bucket_new(spec);
+        if(!b) return -1;
+    }
+
+    if(e->is_listen)
+    {
+        io_bucket_release(ctx->listen_bucket);
+        ctx->listen_bucket = b;
+        return 0;
+    }
+
+    io_bucket *shared = e->shared;
+    if(shared) shared->refs++;
+    io_rate_free(ctx, fd, e);
+    e->shared = shared;
+    e->bucket = b;
+
+    return 0;
+}
+
+/**
+ * 受信分のトークン消費
+ *
+ * 戻り値は IO_RATE_PASS / IO_RATE_PAUSED / IO_RATE_DROPPED / IO_RATE_EXCEEDED。
+ * *notify は制限に入った時（スロットルイベントを通知すべき時）に 1、*wait_ms は読み込みの停止時間。
+ */
+int io_rate_consume(io_context *ctx, int fd, size_t bytes, int msgs, int *notify, int *wait_ms)
+{
+    *notify  = 0;
+    *wait_ms = 0;
+
+    io_fd_entry *e = ctx ? io_get_entry(ctx, fd) : NULL;
+    if(!e || (!e->bucket && !e->shared)) return IO_RATE_PASS;
+
+    uint64_t   now = io_now_ns();
+    io_bucket *list[2] = { e->bucket, e->shared };
+    int        result = IO_RATE_PASS;
+    uint64_t   wait = 0;
+
+    for(int i = 0; i < 2; i++)
+    {
+        io_bucket *b = list[i];
+        if(!b) continue;
+
+        io_bucket_refill(b, now);
+
+        int short_bytes = (b->spec.bytes_rate > 0 && b->bytes < (double)bytes);
+        int short_msgs  = (b->spec.msgs_rate > 0 && b->msgs < (double)msgs);
+
+        if(b->spec.policy == IO_RATE_DELAY)
+        {
+            // 受信済みのデータは受け渡し、借り越し分だけ読み込みを止める
+            if(b->spec.bytes_rate > 0) b->bytes -= (double)bytes;
+            if(b->spec.msgs_rate > 0)  b->msgs  -= (double)msgs;
+            if(short_bytes || short_msgs)
+            {
+                uint64_t w = io_bucket_wait_ns(b);
+                if(w > wait) wait = w;
+                if(result < IO_RATE_PAUSED) result = IO_RATE_PAUSED;
+            }
+        }
+        else
+        if(short_bytes || short_msgs)
+        {
+            int r = (b->spec.policy == IO_RATE_DROP) ? IO_RATE_DROPPED : IO_RATE_EXCEEDED;
+            if(r > result) result = r;
+        }
+        else
+        {
+            if(b->spec.bytes_rate > 0) b->bytes -= (double)bytes;
+            if(b->spec.msgs_rate > 0)  b->msgs  -= (double)msgs;
+        }
+    }
+
+    if(result == IO_RATE_PASS)
+    {
+        e->throttled = 0;
+        return result;
+    }
+
+    if(result == IO_RATE_PAUSED && wait > 0)
+    {
+        if(!e->paused)
+        {
+            io_update_events(ctx, fd, e->want_out, 1);
+            e->paused = 1;
+            e->paused_next = ctx->paused_head;
+            ctx->paused_head = fd;
+        }
+        e->resume_ns = now + wait;
+        *wait_ms = (int)((wait + 999999) / 1000000);
+    }
+
+    *notify = !e->throttled || result == IO_RATE_EXCEEDED;
+    e->throttled = 1;
+
+    return result;
+}
+
+/* ホスト名の正規化（小文字化・末尾の '.' を除く）。長さを返す（-1 = 不正な名前） */
+static int io_dns_normalize(const char *in, char *out)
+{
+    size_t len = strlen(in);
+    if(len > 0 && in[len - 1] == '.') len--;
+    if(len == 0 || len > IO_DNS_NAME_MAX) return -1;
+
+    size_t label = 0;
+    for(size_t i = 0; i < len; i++)
+    {
+        unsigned char c = (unsigned char)in[i];
+        if(c == '.')
+        {
+            if(label == 0) return -1;
+            label = 0;
+        }
+        else
+        {
+            if(!isalnum(c) && c != '-' && c != '_') return -1;
+            if(++label > 63) return -1;
+        }
+        out[i] = (char)tolower(c);
+    }
+    out[len] = '\0';
+
+    return (int)len;
+}
+
+static unsigned int io_dns_hash(const char *name)
+{
+    unsigned int h = 2166136261u;
+    for(; *name; name++) h = (h ^ (unsigned char)*name) * 16777619u;
+    return h % IO_DNS_CACHE_BUCKETS;
+}
+
+/* キャッシュの参照（期限切れは削除する）。1 = ヒット */
+static int io_dns_cache_get(io_resolver *r, const char *name, struct in_addr *addr)
+{
+    uint64_t now = io_now_ns();
+
+    for(io_dns_cache **p = &r->cache[io_dns_hash(name)]; *p; )
+    {
+        io_dns_cache *c = *p;
+        if(c->expire_ns <= now)
+        {
+            *p = c->next;
+            free(c);
+            r->cache_count--;
+            continue;
+        }
+        if(strcmp(c->name, name) == 0)
+        {
+            *addr = c->addr;
+            return 1;
+        }
+        p = &c->next;
+    }
+
+    return 0;
+}
+
+/* キャッシュへ登録（上限に達している場合は期限切れを掃除し、それでも空かなければ登録しない） */
+static void io_dns_cache_put(io_resolver *r, const char *name, struct in_addr addr, uint64_t expire_ns)
+{
+    io_dns_cache **head = &r->cache[io_dns_hash(name)];
+
+    for(io_dns_cache *c = *head; c; c = c->next)
+    {
+        if(strcmp(c->name, name) == 0)
+        {
+            c->addr = addr;
+            c->expire_ns = expire_ns;
+            return;
+        }
+    }
+
+    if(r->cache_count >= IO_DNS_CACHE_MAX)
+    {
+        uint64_t now = io_now_ns();
+        for(int i = 0; i < IO_DNS_CACHE_BUCKETS; i++)
+        {
+            for(io_dns_cache **p = &r->cache[i]; *p; )
+            {
+                io_dns_cache *c = *p;
+                if(c->expire_ns <= now) { *p = c->next; free(c); r->cache_count--; }
+                else                    p = &c->next;
+            }
+        }
+        if(r->cache_count >= IO_DNS_CACHE_MAX) return;
+    }
+
+    io_dns_cache *c = malloc(sizeof(*c));
+    if(!c) return;
+    strcpy(c->name, name);
+    c->addr = addr;
+    c->expire_ns = expire_ns;
+    c->next = *head;
+    *head = c;
+    r->cache_count++;
+}
+
+/* /etc/hosts の IPv4 エントリを無期限でキャッシュへ登録する */
+static void io_dns_load_hosts(io_resolver *r)
+{
+    FILE *fp = fopen("/etc/hosts", "r");
+    if(!fp) return;
+
+    char line[1024];
+    while(fgets(line, sizeof(line), fp))
+    {
+        char *hash = strchr(line, '#');
+        if(hash) *hash = '\0';
+
+        char *save = NULL;
+        char *tok = strtok_r(line, " \t\r\n", &save);
+        struct in_addr addr;
+        if(!tok || inet_pton(AF_INET, tok, &addr) != 1) continue;
+
+        while((tok = strtok_r(NULL, " \t\r\n", &save)) != NULL)
+        {
+            char name[IO_DNS_NAME_MAX + 1];
+            struct in_addr dummy;
+            if(io_dns_normalize(tok, name) < 0) continue;
+            if(io_dns_cache_get(r, name, &dummy)) continue;   // 先に書かれたものを優先
+            io_dns_cache_put(r, name, addr, UINT64_MAX);
+        }
+    }
+    fclose(fp);
+}
+
+/* 問い合わせ先の既定値（/etc/resolv.conf の最初の IPv4 の nameserver。なければ 127.0.0.1） */
+static void io_dns_default_server(io_resolver *r)
+{
+    memset(&r->server, 0, sizeof(r->server));
+    r->server.sin_family = AF_INET;
+    r->server.sin_port   = htons(53);
+    r->server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    FILE *fp = fopen("/etc/resolv.conf", "r");
+    if(!fp) return;
+
+    char line[512];
+    while(fgets(line, sizeof(line), fp))
+    {
+        char ip[64];
+        struct in_addr addr;
+        if(sscanf(line, " nameserver %63s", ip) == 1 && inet_pton(AF_INET, ip, &addr) == 1)
+        {
+            r->server.sin_addr = addr;
+            break;
+        }
+    }
+    fclose(fp);
+}
+
+/* リゾルバの取得（初回に生成する） */
+static io_resolver *io_resolver_get(io_context *ctx)
+{
+    if(ctx->resolver) return ctx->resolver;
+
+    io_resolver *r = calloc(1, sizeof(*r));
+    if(!r) return NULL;
+
+    r->fd = -1;
+    r->timeout_ms = IO_DNS_TIMEOUT_MS;
+    r->attempts = IO_DNS_ATTEMPTS;
+    io_dns_default_server(r);
+    io_dns_load_hosts(r);
+
+    ctx->resolver = r;
+    return r;
+}
+
+/* 問い合わせ用 UDP ソケットの生成（問い合わせ先へ connect し、他からの応答を受け付けない） */
+static int io_dns_open(io_context *ctx, io_resolver *r)
+{
+    if(r->fd >= 0) return 0;
+
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd == -1) return -1;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = EPOLLIN;
+    ev.data.fd = fd;
+
+    if(connect(fd, (struct sockaddr *)&r->server, sizeof(r->server)) == -1
+    || epoll_ctl(ctx->epfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+    {
+        int err = errno;
+        close(fd);
+        errno = err;
+        return -1;
+    }
+
+    r->fd = fd;
+    return 0;
+}
+
+/* 問い合わせの送信（A レコード、再帰要求あり） */
+static int io_dns_send(io_resolver *r, io_dns_query *q)
+{
+    unsigned char pkt[12 + IO_DNS_NAME_MAX + 2 + 4];
+    size_t        len = 0;
+
+    pkt[len++] = q->id >> 8;  pkt[len++] = q->id & 0xff;
+    pkt[len++] = 0x01;        pkt[len++] = 0x00;    // RD
+    pkt[len++] = 0;           pkt[len++] = 1;       // QDCOUNT
+    memset(pkt + len, 0, 6);  len += 6;
+
+    for(const char *label = q->name; *label; )
+    {
+        const char *dot = strchr(label, '.');
+        size_t      n   = dot ? (size_t)(dot - label) : strlen(label);
+
+        pkt[len++] = (unsigned char)n;
+        memcpy(pkt + len, label, n);
+        len += n;
+        label += n + (dot ? 1 : 0);
+    }
+    pkt[len++] = 0;
+    pkt[len++] = 0; pkt[len++] = 1;     // QTYPE  = A
+    pkt[len++] = 0; pkt[len++] = 1;     // QCLASS = IN
+
+    q->tries++;
+    q->retry_ns = io_now_ns() + (uint64_t)r->timeout_ms * 1000000ULL;
+
+    return send(r->fd, pkt, len, 0) == (ssize_t)len ? 0 : -1;
+}
+
+/* 名前解決待ちの fd を問い合わせから外す（問い合わせ自体は結果をキャッシュするため残す） */
+static void io_dns_unwait(io_context *ctx, int fd)
+{
+    io_dns_query *q = ctx->fds[fd].resolving;
+
+    for(int *p = &q->waiter_head; *p != -1; p = &ctx->fds[*p].resolve_next)
+    {
+        if(*p == fd) { *p = ctx->fds[fd].resolve_next; break; }
+    }
+    ctx->fds[fd].resolving = NULL;
+    ctx->fds[fd].resolve_next = -1;
+}
+
+/* 圧縮を含む名前を読み、正規化した文字列を out へ格納する。名前の直後のオフセットを返す（-1 = 不正） */
+static long io_dns_read_name(const unsigned char *buf, size_t len, size_t off, char *out)
+{
+    long   end  = -1;
+    size_t pos  = 0;
+    int    hops = 0;
+
+    for(;;)
+    {
+        if(off >= len) return -1;
+        unsigned char n = buf[off];
+
+        if((n & 0xc0) == 0xc0)
+        {
+            if(off + 1 >= len || ++hops > 16) return -1;
+            if(end < 0) end = (long)off + 2;
+            off = ((size_t)(n & 0x3f) << 8) | buf[off + 1];
+            continue;
+        }
+        if(n == 0)
+        {
+            if(end < 0) end = (long)off + 1;
+            break;
+        }
+        if(n > 63 || off + 1 + n > len || pos + n + 1 > IO_DNS_NAME_MAX + 1) return -1;
+
+        if(pos > 0) out[pos++] = '.';
+        for(unsigned char i = 0; i < n; i++) out[pos++] = (char)tolower(buf[off + 1 + i]);
+        off += 1 + n;
+    }
+    out[pos] = '\0';
+
+    return end;
+}
+
+/* 接続待ちリストから外す */
+static void io_connect_unlink(io_context *ctx, int fd)
+{
+    for(int *p = &ctx->connect_head; *p != -1; p = &ctx->fds[*p].connect_next)
+    {
+        if(*p == fd) { *p = ctx->fds[fd].connect_next; break; }
+    }
+    ctx->fds[fd].connecting = 0;
+    ctx->fds[fd].connect_next = -1;
+    if(ctx->fds[fd].resolving) io_dns_unwait(ctx, fd);
+}
+
+/* 接続待ちの結果をイベントへ（失敗した fd は監視を外し、io_unregister を待つ） */
+static void io_connect_done(io_context *ctx, int fd, int error_code, io_event_list *events)
+{
+    io_fd_entry *e = &ctx->fds[fd];
+
+    io_connect_unlink(ctx, fd);
+    if(error_code == 0) io_update_events(ctx, fd, e->want_out, e->paused);
+    else                epoll_ctl(ctx->epfd, EPOLL_CTL_DEL, fd, NULL);
+
+    if(events->count >= MAX_EVENTS) return;
+
+    io_event *out = &events->events[events->count++];
+    out->handle     = fd;
+    out->event_type = error_code == 0 ? IO_EVENT_CONNECT : IO_EVENT_CONNECT_FAIL;
+    out->error_code = error_code;
+    out->bytes      = 0;
+    out->user_data  = NULL;
+}
+
+/* 期限切れの接続待ちを失敗として通知し、次の期限までの ms を返す（-1 = なし） */
+static int io_connect_expire(io_context *ctx, io_event_list *events)
+{
+    if(ctx->connect_head == -1) return -1;
+
+    uint64_t now = io_now_ns();
+    uint64_t next = 0;
+
+    for(int fd = ctx->connect_head; fd != -1; )
+    {
+        io_fd_entry *e = &ctx->fds[fd];
+        int nfd = e->connect_next;
+
+        if(e->connect_ns != 0)
+        {
+            if(e->connect_ns <= now)
+            {
+                if(events->count >= MAX_EVENTS) break;
+                io_connect_done(ctx, fd, e->connect_err ? e->connect_err : ETIMEDOUT, events);
+            }
+            else
+            if(next == 0 || e->connect_ns < next) next = e->connect_ns;
+        }
+        fd = nfd;
+    }
+
+    if(next == 0) return -1;
+    return (int)((next - now + 999999) / 1000000);
+}
+
+int io_unregister(io_context *ctx, int fd);
+
+/* connect を発行し、完了（書き込み可能）を待つ間は EPOLLOUT のみ監視する */
+static int io_connect_start(io_context *ctx, int fd, const struct sockaddr *addr, socklen_t addr_len)
+{
+    if(connect(fd, addr, addr_len) == -1 && errno != EINPROGRESS) return -1;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events  = EPOLLOUT;
+    ev.data.fd = fd;
+
+    if(epoll_ctl(ctx->epfd, EPOLL_CTL_MOD, fd, &ev) == -1)
+    {
+        // 名前解決待ちの間は監視から外している
+        if(errno != ENOENT || epoll_ctl(ctx->epfd, EPOLL_CTL_ADD, fd, &ev) == -1) return -1;
+    }
+
+    return 0;
+}
+
+/* 問い合わせの完了。待っていた fd の接続を開始する（error_code != 0 は接続失敗として通知） */
+static void io_dns_finish(io_context *ctx, io_dns_query *q, int error_code, struct in_addr addr, io_event_list *events)
+{
+    io_resolver *r = ctx->resolver;
+
+    for(io_dns_query **p = &r->queries; *p; p = &(*p)->next)
+    {
+        if(*p == q) { *p = q->next; break; }
+    }
+
+    while(q->waiter_head != -1)
+    {
+        int          fd = q->waiter_head;
+        io_fd_entry *e  = &ctx->fds[fd];
+
+        q->waiter_head  = e->resolve_next;
+        e->resolving    = NULL;
+        e->resolve_next = -1;
+
+        int err = error_code;
+        if(err == 0)
+        {
+            struct sockaddr_in in4;
+            memset(&in4, 0, sizeof(in4));
+            in4.sin_family = AF_INET;
+            in4.sin_port   = htons(e->connect_port);
+            in4.sin_addr   = addr;
+
+            if(io_connect_start(ctx, fd, (struct sockaddr *)&in4, sizeof(in4)) == -1) err = errno;
+        }
+        if(err == 0) continue;
+
+        // イベントが一杯なら errno を残して次の io_select で通知する
+        if(events->count >= MAX_EVENTS)
+        {
+            e->connect_err = err;
+            e->connect_ns  = 1;
+            continue;
+        }
+        io_connect_done(ctx, fd, err, events);
+    }
+
+    free(q);
+}
+
+/* 応答の受信（A レコードを取り出し、TTL の間キャッシュする） */
+static void io_dns_recv(io_context *ctx, io_event_list *events)
+{
+    io_resolver  *r = ctx->resolver;
+    unsigned char buf[4096];
+    char          name[IO_DNS_NAME_MAX + 1];
+
+    for(;;)
+    {
+        // 問い合わせ先が応答しない（ICMP の到達不能など）場合は再送タイマーに任せる
+        ssize_t len = recv(r->fd, buf, sizeof(buf), 0);
+        if(len < 0) break;
+        if(len < 12 || !(buf[2] & 0x80)) continue;
+        if(((buf[4] << 8) | buf[5]) != 1) continue;
+
+        uint16_t id = (uint16_t)((buf[0] << 8) | buf[1]);
+        long     off = io_dns_read_name(buf, (size_t)len, 12, name);
+        if(off < 0 || off + 4 > len) continue;
+        off += 4;
+
+        // ID と問い合わせた名前の両方が一致するものだけを受け付ける
+        io_dns_query *q;
+        for(q = r->queries; q; q = q->next)
+        {
+            if(q->id == id && strcmp(q->name, name) == 0) break;
+        }
+        if(!q) continue;
+
+        struct in_addr addr;
+        memset(&addr, 0, sizeof(addr));
+
+        int rcode = buf[3] & 0x0f;
+        if(rcode != 0)
+        {
+            io_dns_finish(ctx, q, rcode == 3 ? ENXIO : EIO, addr, events);  // 3 = NXDOMAIN
+            continue;
+        }
+
+        // CNAME を含む応答でも最初の A レコードを使う（TTL は応答中の最小値）
+        int      an = (buf[6] << 8) | buf[7];
+        int      found = 0;
+        uint32_t ttl = UINT32_MAX;
+        for(int i = 0; i < an; i++)
+        {
+            char rr_name[IO_DNS_NAME_MAX + 1];
+            off = io_dns_read_name(buf, (size_t)len, (size_t)off, rr_name);
+            if(off < 0 || off + 10 > len) break;
+
+            const unsigned char *rr = buf + off;
+            int      type   = (rr[0] << 8) | rr[1];
+            int      klass  = (rr[2] << 8) | rr[3];
+            uint32_t rr_ttl = ((uint32_t)rr[4] << 24) | ((uint32_t)rr[5] << 16) | ((uint32_t)rr[6] << 8) | rr[7];
+            int      rdlen  = (rr[8] << 8) | rr[9];
+            off += 10;
+            if(off + rdlen > len) break;
+
+            if(klass == 1 && (type == 1 || type == 5))
+            {
+                if(rr_ttl < ttl) ttl = rr_ttl;
+                if(type == 1 && rdlen == 4 && !found)
+                {
+                    memcpy(&addr, buf + off, 4);
+                    found = 1;
+                }
+            }
+            off += rdlen;
+        }
+
+        if(!found)
+        {
+            io_dns_finish(ctx, q, ENXIO, addr, events);
+            continue;
+        }
+        if(ttl > 0) io_dns_cache_put(r, q->name, addr, io_now_ns() + (uint64_t)ttl * 1000000000ULL);
+        io_dns_finish(ctx, q, 0, addr, events);
+    }
+}
+
+/* 応答のない問い合わせを再送し（attempts 回で ETIMEDOUT）、次の再送時刻までの ms を返す（-1 = なし） */
+static int io_dns_expire(io_context *ctx, io_event_list *events)
+{
+    io_resolver *r = ctx->resolver;
+    if(!r || !r->queries) return -1;
+
+    uint64_t now = io_now_ns();
+    uint64_t next = 0;
+
+    for(io_dns_query *q = r->queries, *nq; q; q = nq)
+    {
+        nq = q->next;
+        if(q->retry_ns <= now)
+        {
+            if(q->tries >= r->attempts)
+            {
+                struct in_addr none;
+                memset(&none, 0, sizeof(none));
+                io_dns_finish(ctx, q, ETIMEDOUT, none, events);
+                continue;
+            }
+            io_dns_open(ctx, r);
+            io_dns_send(r, q);
+        }
+        if(next == 0 || q->retry_ns < next) next = q->retry_ns;
+    }
+
+    if(next == 0) return -1;
+    return (int)((next - now + 999999) / 1000000);
+}
+
+/* fd を name の問い合わせの応答待ちにする（同じ名前の問い合わせが送信済みならそれを待つ） */
+static int io_dns_wait(io_context *ctx, int fd, const char *name)
+{
+    io_resolver *r = ctx->resolver;
+    if(io_dns_open(ctx, r) == -1) return -1;
+
+    io_dns_query *q;
+    for(q = r->queries; q; q = q->next)
+    {
+        if(strcmp(q->name, name) == 0) break;
+    }
+
+    if(!q)
+    {
+        q = calloc(1, sizeof(*q));
+        if(!q) return -1;
+
+        strcpy(q->name, name);
+        q->waiter_head = -1;
+        if(getrandom(&q->id, sizeof(q->id), GRND_NONBLOCK) != sizeof(q->id)) q->id = (uint16_t)io_now_ns();
+
+        // 送信に失敗しても再送タイマーで送り直す
+        io_dns_send(r, q);
+        q->next = r->queries;
+        r->queries = q;
+    }
+
+    io_fd_entry *e  = &ctx->fds[fd];
+    e->resolving    = q;
+    e->resolve_next = q->waiter_head;
+    q->waiter_head  = fd;
+
+    return 0;
+}
+
+/*
+ * UNIX ドメインソケットのアドレス解析
+ *
+ * "unix:///path" はファイルシステム上のパス、"unix://@name" は抽象名前空間（先頭 NUL）。
+ * 戻り値は 1（UNIX ドメイン）、0（それ以外）、-1（不正なアドレス）。
+ */
+static int io_unix_addr(const char *host, struct sockaddr_un *sun, socklen_t *len)
+{
+    if(strncmp(host, "unix://", 7) != 0) return 0;
+
+    const char *path = host + 7;
+    size_t      n    = strlen(path);
+    if(n == 0 || n >= sizeof(sun->sun_path) || (path[0] != '/' && path[0] != '@')) return -1;
+
+    memset(sun, 0, sizeof(*sun));
+    sun->sun_family = AF_UNIX;
+    memcpy(sun->sun_path, path, n);
+    if(path[0] == '@')
+    {
+        if(n == 1) return -1;
+        sun->sun_path[0] = '\0';
+        *len = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + n);
+    }
+    else
+    {
+        *len = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + n + 1);
+    }
+
+    return 1;
+}
+
+/**
+ * ノンブロッキング接続（TCP／UNIX ドメインのストリーム）
+ *
+ * ソケットを生成して connect し、クライアントとして登録する。完了は io_select が
+ * IO_EVENT_CONNECT / IO_EVENT_CONNECT_FAIL（timeout_ms 経過時は ETIMEDOUT）で通知する。
+ * host が "unix:///path" / "unix://@name" の場合は UNIX ドメインで接続する（port は使わない）。
+ * host がホスト名の場合は名前解決も io_select の中で行う（キャッシュにない場合のみ問い合わせる）。
+ * 解決できない名前は ENXIO、問い合わせ先が応答しない場合は ETIMEDOUT の接続失敗となる。
+ * 戻り値は fd（-1 = 失敗）。失敗イベントの後も登録は残るので io_unregister と close は呼び出し側で行う。
+ */
+int io_connect(io_context *ctx, const char *host, unsigned short port, int timeout_ms)
+{
+    if(!ctx || !host) { errno = EINVAL; return -1; }
+
+    struct sockaddr_storage addr;
+    socklen_t               addr_len;
+    memset(&addr, 0, sizeof(addr));
+
+    char name[IO_DNS_NAME_MAX + 1];
+    int  resolve = 0;
+
+    struct sockaddr_in  *in4 = (struct sockaddr_in *)&addr;
+    struct sockaddr_in6 *in6 = (struct sockaddr_in6 *)&addr;
+    int unix_rc = io_unix_addr(host, (struct sockaddr_un *)&addr, &addr_len);
+    if(unix_rc == -1 || (unix_rc == 0 && port == 0)) { errno = EINVAL; return -1; }
+
+    if(unix_rc == 1)
+    {
+        // UNIX ドメイン（解析済み。ポート番号は使わず、backlog が一杯の場合は EAGAIN で失敗する）
+    }
+    else
+    if(inet_pton(AF_INET, host, &in4->sin_addr) == 1)
+    {
+        in4->sin_family = AF_INET;
+        in4->sin_port   = htons(port);
+        addr_len = sizeof(*in4);
+    }
+    else
+    if(inet_pton(AF_INET6, host, &in6->sin6_addr) == 1)
+    {
+        in6->sin6_family = AF_INET6;
+        in6->sin6_port   = htons(port);
+        addr_len = sizeof(*in6);
+    }
+    else
+    {
+        // ホスト名（A レコードのみ）：キャッシュにあればそのまま接続する
+        io_resolver *r = io_resolver_get(ctx);
+        if(!r) return -1;
+        if(io_dns_normalize(host, name) < 0) { errno = EINVAL; return -1; }
+
+        in4->sin_family = AF_INET;
+        in4->sin_port   = htons(port);
+        addr_len = sizeof(*in4);
+        resolve = !io_dns_cache_get(r, name, &in4->sin_addr);
+    }
+
+    int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd == -1) return -1;
+
+    // プロファイル（SO_RCVBUF 等）は connect 前に適用する必要があるため先に登録する
+    if(io_attach(ctx, fd, 0, 0, 1) == -1) { int err = errno; close(fd); errno = err; return -1; }
+
+    io_fd_entry *e = &ctx->fds[fd];
+    int rc;
+    if(resolve)
+    {
+        // 応答が届くまでは監視から外す（未接続の TCP ソケットは EPOLLHUP を返し続けるため）
+        epoll_ctl(ctx->epfd, EPOLL_CTL_DEL, fd, NULL);
+        e->connect_port = port;
+        rc = io_dns_wait(ctx, fd, name);
+    }
+    else
+    {
+        rc = io_connect_start(ctx, fd, (struct sockaddr *)&addr, addr_len);
+    }
+    if(rc == -1)
+    {
+        int err = errno;
+        io_unregister(ctx, fd);
+        close(fd);
+        errno = err;
+        return -1;
+    }
+
+    e->connecting   = 1;
+    e->connect_err  = 0;
+    e->connect_ns   = timeout_ms > 0 ? io_now_ns() + (uint64_t)timeout_ms * 1000000ULL : 0;
+    e->connect_next = ctx->connect_head;
+    ctx->connect_head = fd;
+
+    return fd;
+}
+
+/**
+ * 名前解決の設定
+ *
+ * server が NULL の場合は /etc/resolv.conf の nameserver（port が 0 なら 53）。
+ * timeout_ms は 1 回の問い合わせの応答待ち、attempts は最大送信回数（0 以下は既定値）。
+ * キャッシュは保持したまま、応答待ちの問い合わせは次の再送から新しい問い合わせ先へ送る。
+ */
+int io_set_resolver(io_context *ctx, const char *server, unsigned short port, int timeout_ms, int attempts)
+{
+    if(!ctx) { errno = EINVAL; return -1; }
+
+    io_resolver *r = io_resolver_get(ctx);
+    if(!r) return -1;
+
+    if(server)
+    {
+        struct sockaddr_in sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sin_family = AF_INET;
+        sa.sin_port   = htons(port ? port : 53);
+        if(inet_pton(AF_INET, server, &sa.sin_addr) != 1) { errno = EINVAL; return -1; }
+        r->server = sa;
+    }
+    else
+    {
+        io_dns_default_server(r);
+        if(port) r->server.sin_port = htons(port);
+    }
+
+    r->timeout_ms = timeout_ms > 0 ? timeout_ms : IO_DNS_TIMEOUT_MS;
+    r->attempts   = attempts > 0 ? attempts : IO_DNS_ATTEMPTS;
+
+    if(r->fd >= 0)
+    {
+        epoll_ctl(ctx->epfd, EPOLL_CTL_DEL, r->fd, NULL);
+        close(r->fd);
+        r->fd = -1;
+    }
+
+    return 0;
+}
+
+
+/* 共有メモリ IPC の名前（/dev/shm のファイル名と呼び鈴のアドレスに使う） */
+static int io_shm_name_valid(const char *name)
+{
+    size_t n = strlen(name);
+    if(n == 0 || n > IO_SHM_NAME_MAX) return 0;
+
+    for(size_t i = 0; i < n; i++)
+    {
+        unsigned char c = (unsigned char)name[i];
+        if(!isalnum(c) && c != '.' && c != '_' && c != '-') return 0;
+    }
+
+    return 1;
+}
+
+/* 呼び鈴のアドレス（抽象名前空間。role 0 = 作成側 / 1 = 参加側） */
+static void io_shm_bell_addr(struct sockaddr_un *sun, socklen_t *len, const char *name, int role)
+{
+    memset(sun, 0, sizeof(*sun));
+    sun->sun_family = AF_UNIX;
+    int n = snprintf(sun->sun_path + 1, sizeof(sun->sun_path) - 1, "socket-manager-ipc.%s.%d", name, role);
+    *len = (socklen_t)(offsetof(struct sockaddr_un, sun_path) + 1 + n);
+}
+
+/* 呼び鈴を読み捨てる */
+static void io_shm_drain(int fd)
+{
+    char buf[64];
+    while(recv(fd, buf, sizeof(buf), MSG_DONTWAIT) > 0);
+}
+
+/*
+ * 受信側の待機宣言
+ *
+ * 空を確認した後に waiting を立て、立てる前に書き込まれていないかを再確認する。
+ * 書き込まれていた場合、送信側がまだ waiting を見ていなければ（呼び鈴が鳴っていないので）自分で鳴らす。
+ * 戻り値は 1（読めるデータ or クローズあり） / 0（待機に入った）。
+ */
+static int io_shm_arm(io_shm_channel *ch, int fd, uint64_t head)
+{
+    io_shm_ring *r = ch->rx;
+
+    atomic_store_explicit(&r->waiting, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(&r->tail, memory_order_acquire) == head && !atomic_load_explicit(&r->closed, memory_order_acquire)) return 0;
+
+    if(atomic_exchange_explicit(&r->waiting, 0, memory_order_acq_rel) == 1)
+    {
+        sendto(fd, "", 1, MSG_DONTWAIT, (struct sockaddr *)&ch->self, ch->self_len);
+    }
+    return 1;
+}
+
+/* 送信側の通知（受信側が待機中の場合のみ呼び鈴を鳴らす） */
+static void io_shm_notify(io_shm_channel *ch, int fd)
+{
+    io_shm_ring *r = ch->tx;
+
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(&r->waiting, memory_order_relaxed) && atomic_exchange_explicit(&r->waiting, 0, memory_order_acq_rel) == 1)
+    {
+        sendto(fd, "", 1, MSG_DONTWAIT, (struct sockaddr *)&ch->peer, ch->peer_len);
+    }
+}
+
+/* チャネルの解放（相手へクローズを伝え、作成側は共有メモリのファイルを削除する） */
+static void io_shm_free(io_shm_channel *ch, int fd)
+{
+    if(!ch) return;
+
+    if(ch->hdr)
+    {
+        atomic_store_explicit(&ch->tx->closed, 1, memory_order_release);
+        atomic_store_explicit(&ch->tx->waiting, 0, memory_order_relaxed);
+        if(fd >= 0) sendto(fd, "", 1, MSG_DONTWAIT, (struct sockaddr *)&ch->peer, ch->peer_len);
+        munmap(ch->hdr, ch->map_size);
+    }
+    if(ch->owner) unlink(ch->path);
+    free(ch);
+}
+
+/**
+ * 共有メモリ IPC チャネルのオープン
+ *
+ * 同じホスト上のプロセス間で、/dev/shm/socket-manager-ipc.<name> を mmap した SPSC リングを方向ごとに 1 本ずつ使う。
+ * owner = 1 の側がファイルを作成（同名のファイルは作り直す）し、owner = 0 の側は作成済みのファイルへ参加する（未作成は ENOENT）。
+ * 空のリングを待つ間は抽象名前空間の UNIX ドメインのデータグラム（呼び鈴）を epoll で監視する。
+ * 呼び鈴は受信側が待機を宣言している時だけ鳴らすため、連続した送受信ではシステムコールを発行しない。
+ * 戻り値は登録済みの呼び鈴の fd（-1 = 失敗。同じ名前・役割が使用中なら EADDRINUSE）。
+ */
+int io_shm_open(io_context *ctx, const char *name, int owner, size_t capacity)
+{
+    if(!ctx || !name || !io_shm_name_valid(name)) { errno = EINVAL; return -1; }
+
+    io_shm_channel *ch = calloc(1, sizeof(*ch));
+    if(!ch) return -1;
+
+    ch->owner = owner ? 1 : 0;
+    snprintf(ch->path, sizeof(ch->path), "/dev/shm/socket-manager-ipc.%s", name);
+
+    // 呼び鈴を先にバインドする（同じ名前・役割が使用中なら共有メモリに触れずに EADDRINUSE で失敗させる）
+    int tx = ch->owner ? 0 : 1;
+    io_shm_bell_addr(&ch->self, &ch->self_len, name, tx);
+    io_shm_bell_addr(&ch->peer, &ch->peer_len, name, 1 - tx);
+
+    int mfd = -1;
+    int published = 0;
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd == -1) goto fail;
+    if(bind(fd, (struct sockaddr *)&ch->self, ch->self_len) == -1) goto fail;
+
+    if(ch->owner)
+    {
+        // 容量は 2 のべき乗へ切り上げる
+        size_t cap = capacity ? capacity : IO_SHM_CAPACITY;
+        if(cap > IO_SHM_CAPACITY_MAX) { errno = EINVAL; goto fail; }
+        size_t c = IO_SHM_CAPACITY_MIN;
+        while(c < cap) c <<= 1;
+
+        // 初期化を終えてから rename で公開する（参加側が初期化途中の領域を見ないように）
+        char tmp[sizeof(ch->path) + 16];
+        snprintf(tmp, sizeof(tmp), "%s.%d", ch->path, (int)getpid());
+        mfd = open(tmp, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+        if(mfd == -1) goto fail;
+
+        ch->map_size = sizeof(io_shm_header) + 2 * c;
+        if(ftruncate(mfd, (off_t)ch->map_size) == -1) { int err = errno; unlink(tmp); errno = err; goto fail; }
+        void *p = mmap(NULL, ch->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, mfd, 0);
+        if(p == MAP_FAILED) { int err = errno; unlink(tmp); errno = err; goto fail; }
+        ch->hdr = p;
+
+        // ftruncate で 0 埋め済み（head／tail／フラグは 0）
+        ch->hdr->capacity = (uint32_t)c;
+        ch->hdr->magic    = IO_SHM_MAGIC;
+        if(rename(tmp, ch->path) == -1) { int err = errno; unlink(tmp); errno = err; goto fail; }
+        published = 1;
+    }
+    else
+    {
+        mfd = open(ch->path, O_RDWR | O_CLOEXEC);
+        if(mfd == -1) goto fail;
+
+        struct stat st;
+        if(fstat(mfd, &st) == -1) goto fail;
+        if((size_t)st.st_size < sizeof(io_shm_header)) { errno = EPROTO; goto fail; }
+
+        ch->map_size = (size_t)st.st_size;
+        void *p = mmap(NULL, ch->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, mfd, 0);
+        if(p == MAP_FAILED) goto fail;
+        ch->hdr = p;
+
+        if(ch->hdr->magic != IO_SHM_MAGIC || sizeof(io_shm_header) + 2 * (size_t)ch->hdr->capacity != ch->map_size)
+        {
+            errno = EPROTO;
+            goto fail;
+        }
+    }
+    close(mfd);
+    mfd = -1;
+
+    uint64_t       cap  = ch->hdr->capacity;
+    unsigned char *base = (unsigned char *)(ch->hdr + 1);
+    ch->tx      = &ch->hdr->ring[tx];
+    ch->rx      = &ch->hdr->ring[1 - tx];
+    ch->tx_data = base + cap * tx;
+    ch->rx_data = base + cap * (1 - tx);
+    ch->mask    = cap - 1;
+
+    // UDP 扱いで登録する（TCP 向けのプロファイルやレート制限の共有を適用しない）
+    if(io_attach(ctx, fd, 0, 1, !ch->owner) == -1) goto fail;
+    ctx->fds[fd].shm = ch;
+
+    // 参加前に書き込まれていたデータがあれば読めるようにしておく
+    io_shm_arm(ch, fd, atomic_load_explicit(&ch->rx->head, memory_order_relaxed));
+
+    return fd;
+
+fail:
+    {
+        int err = errno;
+        if(mfd != -1) close(mfd);
+        if(fd != -1) close(fd);
+        if(ch->hdr) munmap(ch->hdr, ch->map_size);
+        if(published) unlink(ch->path);
+        free(ch);
+        errno = err;
+    }
+    return -1;
+}
+
+/**
+ * 共有メモリ IPC の送信
+ *
+ * リングの空きへ書き込めた分だけ書き込む（write(2) と同じく一部だけの場合がある）。
+ * 戻り値は書き込んだバイト数（-1 = 失敗。空きがなければ EAGAIN、相手がクローズ済みなら EPIPE）。
+ */
+ssize_t io_shm_send(io_context *ctx, int fd, const char *data, size_t length)
+{
+    if(!ctx || !data) { errno = EINVAL; return -1; }
+
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e || !e->shm) { errno = EINVAL; return -1; }
+
+    io_shm_channel *ch = e->shm;
+    io_shm_ring    *r  = ch->tx;
+    if(atomic_load_explicit(&ch->rx->closed, memory_order_acquire)) { errno = EPIPE; return -1; }
+    if(length == 0) return 0;
+
+    uint64_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    uint64_t cap  = ch->mask + 1;
+    size_t   n    = (size_t)(cap - (tail - head));
+    if(n > length) n = length;
+    if(n == 0) { errno = EAGAIN; return -1; }
+
+    size_t off   = (size_t)(tail & ch->mask);
+    size_t first = n < cap - off ? n : (size_t)(cap - off);
+    memcpy(ch->tx_data + off, data, first);
+    if(n > first) memcpy(ch->tx_data, data + first, n - first);
+    atomic_store_explicit(&r->tail, tail + n, memory_order_release);
+
+    io_shm_notify(ch, fd);
+
+    return (ssize_t)n;
+}
+
+/**
+ * 共有メモリ IPC の受信
+ *
+ * 戻り値は読み出したバイト数（0 = 相手がクローズ済みで残りなし、-1 = 失敗。空なら EAGAIN）。
+ * 空になった時点で待機を宣言するため、読み残しがある間は呼び鈴の EPOLLIN が続く（ソケットと同じレベルトリガ）。
+ */
+ssize_t io_shm_recv(io_context *ctx, int fd, char *buf, size_t length)
+{
+    if(!ctx || !buf) { errno = EINVAL; return -1; }
+
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e || !e->shm) { errno = EINVAL; return -1; }
+
+    io_shm_channel *ch = e->shm;
+    io_shm_ring    *r  = ch->rx;
+    for(;;)
+    {
+        uint64_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+        uint64_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+        if(tail != head)
+        {
+            uint64_t cap   = ch->mask + 1;
+            size_t   n     = (size_t)(tail - head) < length ? (size_t)(tail - head) : length;
+            size_t   off   = (size_t)(head & ch->mask);
+            size_t   first = n < cap - off ? n : (size_t)(cap - off);
+            memcpy(buf, ch->rx_data + off, first);
+            if(n > first) memcpy(buf + first, ch->rx_data, n - first);
+            atomic_store_explicit(&r->head, head + n, memory_order_release);
+            return (ssize_t)n;
+        }
+        if(atomic_load_explicit(&r->closed, memory_order_acquire)) return 0;
+
+        // 空：呼び鈴を読み捨ててから待機を宣言する（宣言の前に書き込まれていれば読み直す）
+        io_shm_drain(fd);
+        if(!io_shm_arm(ch, fd, head)) { errno = EAGAIN; return -1; }
+    }
+}
+
+/**
+ * 共有メモリ IPC の読み残しの持ち越し
+ *
+ * 呼び鈴は空になるまで鳴らし直されないため、読み残しがある場合は自分で鳴らして次回の epoll_wait で通知させる。
+ */
+void io_shm_yield(io_context *ctx, int fd)
+{
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e || !e->shm) return;
+
+    io_shm_channel *ch = e->shm;
+    if(atomic_load_explicit(&ch->rx->tail, memory_order_acquire) != atomic_load_explicit(&ch->rx->head, memory_order_relaxed))
+    {
+        sendto(fd, "", 1, MSG_DONTWAIT, (struct sockaddr *)&ch->self, ch->self_len);
+    }
+}
+
+/* 停止期間が過ぎた fd の読み込みを再開し、次に再開する時刻までの ms を返す（-1 = なし） */
+static int io_rate_resume(io_context *ctx)
+{
+    if(ctx->paused_head == -1) return -1;
+
+    uint64_t now = io_now_ns();
+    uint64_t next = 0;
+
+    for(int *p = &ctx->paused_head; *p != -1; )
+    {
+        int          fd = *p;
+        io_fd_entry *e  = &ctx->fds[fd];
+
+        if(e->resume_ns <= now)
+        {
+            *p = e->paused_next;
+            e->paused = 0;
+            e->paused_next = -1;
+            io_update_events(ctx, fd, e->want_out, 0);
+            continue;
+        }
+
+        if(next == 0 || e->resume_ns < next) next = e->resume_ns;
+        p = &e->paused_next;
+    }
+
+    if(next == 0) return -1;
+    return (int)((next - now + 999999) / 1000000);
+}
+
+/**
+ * 解除
+ */
+int io_unregister(io_context *ctx, int fd)
+{
+    if(!ctx) return -1;
+
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e) return 0;
+
+    epoll_ctl(ctx->epfd, EPOLL_CTL_DEL, fd, NULL);
+    io_seg_drop_queue(ctx, e);
+    io_zc_defer(ctx, fd, e);
+    io_framer_free(e);
+    e->active = 0;
+    io_rate_free(ctx, fd, e);
+    if(e->connecting) io_connect_unlink(ctx, fd);
+    io_shm_free(e->shm, fd);
+    memset(e, 0, sizeof(*e));
+    if(ctx->count > 0) ctx->count--;
+
+    return 0;
+}
+
+/* 共有待ち受けの受け入れ（キューが空になるか batch 件で打ち切る） */
+static void io_accept_batch(io_context *ctx, int fd, int batch, io_event_list *events)
+{
+    for(int k = 0; k < batch && events->count < MAX_EVENTS; k++)
+    {
+        int nfd = accept4(fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(nfd < 0)
+        {
+            // 相手が先に切断した接続は飛ばす
+            if(errno == ECONNABORTED || errno == EINTR) continue;
+
+            // EAGAIN は他のワーカーが先に受け入れた。EMFILE 等はキューに残して次回に回す
+            return;
+        }
+
+        if(io_attach(ctx, nfd, 0, 0, 0) != 0)
+        {
+            close(nfd);
+            continue;
+        }
+
+        ctx->counters[IO_CNT_ACCEPTS]++;
+
+        io_event *out = &events->events[events->count++];
+
+        out->handle = nfd;
+        out->bytes = 0;
+        out->user_data = NULL;
+        out->error_code = 0;
+        out->event_type = IO_EVENT_ACCEPT;
+    }
+}
+
+/**
+ * ヒストグラムの度数区間の番号
+ */
+static inline int io_hist_index(uint64_t v)
+{
+    if(v >= (1ULL << IO_HIST_MAX_BITS)) v = (1ULL << IO_HIST_MAX_BITS) - 1;
+
+    int msb = 63 - __builtin_clzll(v | 1);
+    int e = msb > IO_HIST_SUB_BITS ? msb - IO_HIST_SUB_BITS : 0;
+
+    return (e << IO_HIST_SUB_BITS) + (int)(v >> e);
+}
+
+/**
+ * ヒストグラムの度数区間の上限値
+ */
+static uint64_t io_hist_value(int idx)
+{
+    if(idx < (2 << IO_HIST_SUB_BITS)) return (uint64_t)idx;
+
+    int e = (idx >> IO_HIST_SUB_BITS) - 1;
+    uint64_t m = (uint64_t)idx - ((uint64_t)e << IO_HIST_SUB_BITS);
+
+    return ((m + 1) << e) - 1;
+}
+
+/**
+ * 度数の記録
+ */
+static inline void io_hist_record(io_hist *h, uint64_t v)
+{
+    h->buckets[io_hist_index(v)]++;
+    if(h->count == 0 || v < h->min) h->min = v;
+    if(v > h->max) h->max = v;
+    h->count++;
+    h->sum += v;
+}
+
+/**
+ * 百分位の値（permille = 990 で p99、999 で p99.9）
+ */
+static uint64_t io_hist_percentile(const io_hist *h, int permille)
+{
+    if(h->count == 0) return 0;
+
+    uint64_t rank = (h->count * (uint64_t)permille + 999) / 1000;
+    if(rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for(int i = 0; i < IO_HIST_BUCKETS; i++)
+    {
+        seen += h->buckets[i];
+        if(seen >= rank)
+        {
+            uint64_t v = io_hist_value(i);
+            return v > h->max ? h->max : v;
+        }
+    }
+
+    return h->max;
+}
+
+/**
+ * 計測の開始／終了（enable = 0 で終了し、計測値を破棄する）
+ */
+int io_stats_enable(io_context *ctx, int enable)
+{
+    if(!ctx) return -1;
+
+    if(!enable)
+    {
+        free(ctx->stats);
+        ctx->stats = NULL;
+        return 0;
+    }
+    if(!ctx->stats)
+    {
+        ctx->stats = calloc(1, sizeof(io_stats));
+        if(!ctx->stats) return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * 所要時間の計測開始（計測していなければ何もしない）
+ */
+void io_stats_begin(io_context *ctx, int metric)
+{
+    if(!ctx || !ctx->stats || metric < 0 || metric >= IO_STAT_COUNT) return;
+
+    ctx->stats->start[metric] = io_now_ns();
+}
+
+/**
+ * 所要時間の計測終了（io_stats_begin からの経過時間を記録する。開始時刻は残す）
+ */
+void io_stats_end(io_context *ctx, int metric)
+{
+    if(!ctx || !ctx->stats || metric < 0 || metric >= IO_STAT_COUNT) return;
+
+    uint64_t start = ctx->stats->start[metric];
+    if(!start) return;
+
+    uint64_t now = io_now_ns();
+    io_hist_record(&ctx->stats->hist[metric], now > start ? now - start : 0);
+}
+
+/**
+ * 値の記録
+ */
+void io_stats_record(io_context *ctx, int metric, uint64_t value)
+{
+    if(!ctx || !ctx->stats || metric < 0 || metric >= IO_STAT_COUNT) return;
+
+    io_hist_record(&ctx->stats->hist[metric], value);
+}
+
+/**
+ * 集計値の取得（reset = 1 で取得後にその計測対象の度数をクリアする）
+ */
+int io_stats_get(io_context *ctx, int metric, io_stats_summary *out, int reset)
+{
+    if(!ctx || !ctx->stats || !out || metric < 0 || metric >= IO_STAT_COUNT) { errno = EINVAL; return -1; }
+
+    io_hist *h = &ctx->stats->hist[metric];
+    out->count = h->count;
+    out->min   = h->min;
+    out->max   = h->max;
+    out->mean  = h->count ? h->sum / h->count : 0;
+    out->p50   = io_hist_percentile(h, 500);
+    out->p90   = io_hist_percentile(h, 900);
+    out->p99   = io_hist_percentile(h, 990);
+    out->p999  = io_hist_percentile(h, 999);
+
+    if(reset) memset(h, 0, sizeof(*h));
+
+    return 0;
+}
+
+/**
+ * カウンタと現在値の取得（counters は IO_CNT_COUNT 個、gauges は IO_GAUGE_COUNT 個の配列）
+ *
+ * 現在値は fd テーブルを走査して集計するため、取得（スクレイプ）の時だけ呼ぶ
+ */
+int io_get_metrics(io_context *ctx, uint64_t *counters, uint64_t *gauges)
+{
+    if(!ctx || !counters || !gauges) { errno = EINVAL; return -1; }
+
+    memcpy(counters, ctx->counters, sizeof(ctx->counters));
+    memset(gauges, 0, sizeof(uint64_t) * IO_GAUGE_COUNT);
+
+    gauges[IO_GAUGE_FDS]         = (uint64_t)ctx->count;
+    gauges[IO_GAUGE_FD_CAPACITY] = (uint64_t)ctx->fd_capacity;
+    for(int fd = 0; fd < ctx->fd_capacity; fd++)
+    {
+        io_fd_entry *e = &ctx->fds[fd];
+        if(!e->active) continue;
+
+        if(e->is_listen) gauges[IO_GAUGE_LISTENERS]++;
+        if(e->paused) gauges[IO_GAUGE_PAUSED]++;
+        if(e->connecting) gauges[IO_GAUGE_CONNECTING]++;
+        for(io_file_seg *seg = e->send_head; seg; seg = seg->next) gauges[IO_GAUGE_SEND_SEGMENTS]++;
+        for(io_file_seg *seg = e->zc_head; seg; seg = seg->next) gauges[IO_GAUGE_ZC_SEGMENTS]++;
+        gauges[IO_GAUGE_SEND_BYTES] += (uint64_t)e->send_pending;
+        if(e->send_pending > gauges[IO_GAUGE_SEND_MAX]) gauges[IO_GAUGE_SEND_MAX] = (uint64_t)e->send_pending;
+    }
+    for(io_zc_deferred *d = ctx->zc_deferred; d; d = d->next)
+    {
+        for(io_file_seg *seg = d->head; seg; seg = seg->next) gauges[IO_GAUGE_ZC_SEGMENTS]++;
+    }
+    if(ctx->resolver)
+    {
+        for(io_dns_query *q = ctx->resolver->queries; q; q = q->next) gauges[IO_GAUGE_DNS_QUERIES]++;
+        gauges[IO_GAUGE_DNS_CACHE] = (uint64_t)ctx->resolver->cache_count;
+    }
+
+    return 0;
+}
+
+/**
+ * epoll_wait の所要時間を記録し、UNIT 実行までの遅延の起点にする
+ */
+static inline void io_stats_waited(io_context *ctx, uint64_t wait_start)
+{
+    uint64_t now = io_now_ns();
+
+    io_hist_record(&ctx->stats->hist[IO_STAT_WAIT], now - wait_start);
+    ctx->stats->start[IO_STAT_DISPATCH] = now;
+}
+
+/**
+ * io_select の戻り値の記録（イベント数のカウンタとヒストグラム）
+ */
+static inline int io_stats_events(io_context *ctx, int count)
+{
+    ctx->counters[IO_CNT_SELECTS]++;
+    ctx->counters[IO_CNT_EVENTS] += (uint64_t)count;
+    if(count >= MAX_EVENTS) ctx->counters[IO_CNT_BATCH_FULL]++;
+
+    if(ctx->stats) io_hist_record(&ctx->stats->hist[IO_STAT_EVENTS], (uint64_t)count);
+
+    return count;
+}
+
+/**
+ * イベント待機
+ */
+int io_select(io_context *ctx, int timeout_ms, void *events_ptr)
+{
+    io_event_list *events = (io_event_list *)events_ptr;
+    if(!ctx || !events) return -1;
+
+    events->count = 0;
+
+    // 解除済みの fd に残った MSG_ZEROCOPY の完了通知
+    if(ctx->zc_deferred) io_zc_deferred_poll(ctx);
+
+    // 読み込み停止中の fd があれば再開時刻までに戻ってくる
+    int resume_ms = io_rate_resume(ctx);
+    if(resume_ms >= 0 && (timeout_ms < 0 || resume_ms < timeout_ms)) timeout_ms = resume_ms;
+
+    // 接続待ちの期限切れを通知し、次の期限までに戻ってくる
+    int expire_ms = io_connect_expire(ctx, events);
+    if(expire_ms >= 0 && (timeout_ms < 0 || expire_ms < timeout_ms)) timeout_ms = expire_ms;
+
+    // 名前解決の再送／タイムアウトを処理し、次の再送時刻までに戻ってくる
+    int dns_ms = io_dns_expire(ctx, events);
+    if(dns_ms >= 0 && (timeout_ms < 0 || dns_ms < timeout_ms)) timeout_ms = dns_ms;
+    if(events->count > 0) timeout_ms = 0;
+
+    if(ctx->count == 0)
+    {
+        if(timeout_ms > 0 && !ctx->busy_poll) usleep(timeout_ms * 1000);
+        return 0;
+    }
+
+    int n;
+    uint64_t wait_start = ctx->stats ? io_now_ns() : 0;
+    if(ctx->busy_poll)
+    {
+        // スリープせずに timeout_ms の間 epoll_wait(0) を回す（ウェイクアップの遅延を避ける）
+        struct timespec now, end;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        end.tv_sec  += timeout_ms / 1000;
+        end.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if(end.tv_nsec >= 1000000000L) { end.tv_sec++; end.tv_nsec -= 1000000000L; }
+
+        for(;;)
+        {
+            n = epoll_wait(ctx->epfd, ctx->evlist, MAX_EVENTS, 0);
+            if(n != 0 || timeout_ms <= 0) break;
+
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            if(now.tv_sec > end.tv_sec || (now.tv_sec == end.tv_sec && now.tv_nsec >= end.tv_nsec)) break;
+        }
+    }
+    else
+    {
+        n = epoll_wait(ctx->epfd, ctx->evlist, MAX_EVENTS, timeout_ms);
+    }
+    if(ctx->stats) io_stats_waited(ctx, wait_start);
+    if(n < 0) return n;
+    if(n == 0) return io_stats_events(ctx, events->count);
+
+    for(int i = 0; i < n && events->count < MAX_EVENTS; i++)
+    {
+        struct epoll_event *ev = &ctx->evlist[i];
+        uint32_t revents = ev->events;
+        int error_code = 0;
+
+        // 名前解決の応答
+        if(ctx->resolver && ev->data.fd == ctx->resolver->fd)
+        {
+            io_dns_recv(ctx, events);
+            continue;
+        }
+
+        // io_connect の接続待ちは SO_ERROR で成否を判定する
+        io_fd_entry *ce = io_get_entry(ctx, ev->data.fd);
+        if(ce && ce->connecting)
+        {
+            int       so_error = 0;
+            socklen_t len = sizeof(so_error);
+
+            if(getsockopt(ev->data.fd, SOL_SOCKET, SO_ERROR, &so_error, &len) == -1) so_error = errno;
+            if(so_error == 0 && (revents & (EPOLLERR | EPOLLHUP))) so_error = ECONNREFUSED;
+            io_connect_done(ctx, ev->data.fd, so_error, events);
+            continue;
+        }
+
+        // ファイル送信待ちの書き込み可能通知はドライバ内で消化する
+        if(revents & EPOLLOUT)
+        {
+            io_fd_entry *e = io_get_entry(ctx, ev->data.fd);
+            if(e && e->send_head)
+            {
+                if(io_flush_entry(ctx, ev->data.fd, e) < 0)
+                {
+                    revents |= EPOLLERR;
+                    error_code = errno;
+                }
+                revents &= ~EPOLLOUT;
+            }
+        }
+
+        // MSG_ZEROCOPY の完了通知はエラーキュー経由（EPOLLERR）で届く（送信エラー後も回収しないと EPOLLERR が続く）
+        if(revents & EPOLLERR)
+        {
+            io_fd_entry *e = io_get_entry(ctx, ev->data.fd);
+            if(e && e->zc_head)
+            {
+                io_zc_reap(ctx, ev->data.fd, e);
+
+                // 送信エラーはそのまま通知する
+                if(error_code == 0)
+                {
+                    int       so_error = 0;
+                    socklen_t len = sizeof(so_error);
+
+                    if(getsockopt(ev->data.fd, SOL_SOCKET, SO_ERROR, &so_error, &len) == 0 && so_error == 0)
+                    {
+                        revents &= ~EPOLLERR;
+                    }
+                    else
+                    {
+                        error_code = so_error;
+                    }
+                }
+            }
+        }
+
+        if(revents == 0) continue;
+
+        // 共有待ち受けはドライバ内でまとめて受け入れる
+        io_fd_entry *le = io_get_entry(ctx, ev->data.fd);
+        if(le && le->accept_batch > 0 && revents == EPOLLIN)
+        {
+            io_accept_batch(ctx, ev->data.fd, le->accept_batch, events);
+            continue;
+        }
+
+        // エラー／切断はソケットエラーを添える（キープアライブや TCP_USER_TIMEOUT の満了は ETIMEDOUT）
+        if((revents & (EPOLLERR | EPOLLHUP)) && error_code == 0)
+        {
+            int       so_error = 0;
+            socklen_t len = sizeof(so_error);
+
+            if(getsockopt(ev->data.fd, SOL_SOCKET, SO_ERROR, &so_error, &len) == 0 && so_error != 0)
+            {
+                error_code = so_error;
+                revents |= EPOLLERR;
+                revents &= ~EPOLLHUP;
+            }
+        }
+
+        io_event *out = &events->events[events->count++];
+
+        out->handle = ev->data.fd;
+        out->bytes = 0;
+        out->user_data = NULL;
+        out->error_code = error_code;
+        out->event_type = 0;
+
+        if(revents & EPOLLIN)
+            out->event_type = IO_EVENT_READ;
+
+        if(revents & EPOLLOUT)
+            out->event_type = IO_EVENT_WRITE;
+
+        if(revents & EPOLLERR)
+            out->event_type = IO_EVENT_ERROR;
+
+        if(revents & EPOLLHUP)
+            out->event_type = IO_EVENT_DISCONNECT;
+    }
+
+    return io_stats_events(ctx, events->count);
+}
+
+/**
+ * ファイル送信（fd / offset / length をキューへ積み、送れるだけ送る）
+ *
+ * length = 0 の場合は通常ファイルの末尾まで。入力 fd は dup して保持する。
+ * 戻り値は未送信バイト数（0 で完了）。残りは EPOLLOUT を契機に io_select 内で送信される。
+ */
+ssize_t io_send_file(io_context *ctx, int fd, int in_fd, off_t offset, size_t length)
+{
+    if(!ctx || offset < 0) { errno = EINVAL; return -1; }
+
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e || e->is_listen || e->is_udp) { errno = EINVAL; return -1; }
+
+    struct stat st;
+    if(fstat(in_fd, &st) == -1) return -1;
+
+    int is_pipe = S_ISFIFO(st.st_mode);
+    if(!is_pipe && !S_ISREG(st.st_mode) && !S_ISBLK(st.st_mode)) { errno = EINVAL; return -1; }
+
+    if(length == 0)
+    {
+        if(is_pipe || offset > st.st_size) { errno = EINVAL; return -1; }
+        length = (size_t)(st.st_size - offset);
+        if(length == 0) return (ssize_t)e->send_pending;
+    }
+
+    io_file_seg *seg = malloc(sizeof(io_file_seg));
+    if(!seg) return -1;
+
+    memset(seg, 0, sizeof(*seg));
+    seg->fd = fcntl(in_fd, F_DUPFD_CLOEXEC, 0);
+    if(seg->fd == -1) { free(seg); return -1; }
+    seg->kind    = is_pipe ? IO_SEG_PIPE : IO_SEG_FILE;
+    seg->offset  = offset;
+    seg->remain  = length;
+
+    if(e->send_tail) e->send_tail->next = seg;
+    else             e->send_head = seg;
+    e->send_tail = seg;
+    e->send_pending += length;
+
+    return io_flush_entry(ctx, fd, e);
+}
+
+/**
+ * データ送信（送れなかった分はキューへ積み、EPOLLOUT を契機に io_select 内で送信される）
+ *
+ * 閾値以上のデータは MSG_ZEROCOPY で送信する。data はカーネルが解放を通知するまで参照されるため、
+ * owner を渡しておくと不要になった時点で ctx->release(owner) が呼ばれる（-1 を返す場合も含む）。
+ * 戻り値は未送信バイト数（0 で完了）。
+ */
+ssize_t io_send(io_context *ctx, int fd, const char *data, size_t length, void *owner)
+{
+    if(!ctx) { errno = EINVAL; return -1; }
+
+    // キューへ積めなかった場合も owner は返却する（呼び出し側は成否に関わらず手放してよい）
+    io_fd_entry *e = data ? io_get_entry(ctx, fd) : NULL;
+    if(!e || e->is_listen || e->is_udp)
+    {
+        if(owner && ctx->release) ctx->release(owner);
+        errno = EINVAL;
+        return -1;
+    }
+
+    if(length == 0)
+    {
+        if(owner && ctx->release) ctx->release(owner);
+        return (ssize_t)e->send_pending;
+    }
+
+    // SO_ZEROCOPY は最初に必要になった時点で設定する
+    if(e->zc_state == 0 && ctx->zc_threshold > 0 && length >= ctx->zc_threshold)
+    {
+        int one = 1;
+        e->zc_state = setsockopt(fd, SOL_SOCKET, SO_ZEROCOPY, &one, sizeof(one)) == 0 ? 1 : -1;
+    }
+
+    io_file_seg *seg = malloc(sizeof(io_file_seg));
+    if(!seg)
+    {
+        if(owner && ctx->release) ctx->release(owner);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    memset(seg, 0, sizeof(*seg));
+    seg->kind   = IO_SEG_DATA;
+    seg->fd     = -1;
+    seg->data   = data;
+    seg->remain = length;
+    seg->owner  = owner;
+
+    if(e->send_tail) e->send_tail->next = seg;
+    else             e->send_head = seg;
+    e->send_tail = seg;
+    e->send_pending += length;
+
+    return io_flush_entry(ctx, fd, e);
+}
+
+/**
+ * MSG_ZEROCOPY を使う送信サイズの設定（0 で無効）
+ */
+int io_set_zerocopy(io_context *ctx, size_t threshold)
+{
+    if(!ctx) return -1;
+
+    ctx->zc_threshold = threshold;
+    return 0;
+}
+
+/**
+ * 送信キューの再開（未送信バイト数 or -1）
+ */
+ssize_t io_flush(io_context *ctx, int fd)
+{
+    if(!ctx) { errno = EINVAL; return -1; }
+
+    io_fd_entry *e = io_get_entry(ctx, fd);
+    if(!e) { errno = EBADF; return -1; }
+    if(!e->send_head)
+    {
+        if(e->zc_head) io_zc_reap(ctx, fd, e);
+        return 0;
+    }
+
+    return io_flush_entry(ctx, fd, e);
+}
+
+/* 終了時の完了通知待ち（deadline_ns までにエラーキューへ届いた分だけ返却する） */
+static void io_zc_wait(io_context *ctx, int fd, io_file_seg **head, io_file_seg **tail, uint64_t deadline_ns)
+{
+    io_zc_reap_list(ctx, fd, head, tail, NULL);
+    while(*head)
+    {
+        uint64_t now = io_now_ns();
+        if(now >= deadline_ns) break;
+
+        struct pollfd pfd = { .fd = fd, .events = 0, .revents = 0 };
+        int ms = (int)((deadline_ns - now + 999999) / 1000000);
+        if(poll(&pfd, 1, ms) <= 0) break;
+        io_zc_reap_list(ctx, fd, head, tail, NULL);
+    }
+
+    io_seg_abandon(*head);
+    *head = NULL;
+    *tail = NULL;
+}
+
+/**
+ * 終了処理
+ */
+int io_core_close(io_context *ctx)
+{
+    if(!ctx) return -1;
+
+    if(ctx->epfd >= 0) close(ctx->epfd);
+
+    // MSG_ZEROCOPY の完了通知は IO_ZC_CLOSE_WAIT_MS まで待ち、届かなかったバッファは返却しない
+    uint64_t zc_deadline = io_now_ns() + (uint64_t)IO_ZC_CLOSE_WAIT_MS * 1000000ULL;
+    for(int fd = 0; fd < ctx->fd_capacity && ctx->fds; fd++)
+    {
+        io_fd_entry *e = &ctx->fds[fd];
+        if(e->send_head) io_seg_drop_queue(ctx, e);
+        if(e->zc_head) io_zc_wait(ctx, fd, &e->zc_head, &e->zc_tail, zc_deadline);
+    }
+    while(ctx->zc_deferred)
+    {
+        io_zc_deferred *d = ctx->zc_deferred;
+        io_zc_wait(ctx, d->fd, &d->head, &d->tail, zc_deadline);
+        close(d->fd);
+        ctx->zc_deferred = d->next;
+        free(d);
+    }
+
+    for(int fd = 0; fd < ctx->fd_capacity && ctx->fds; fd++)
+    {
+        io_framer_free(&ctx->fds[fd]);
+        io_bucket_release(ctx->fds[fd].bucket);
+        io_bucket_release(ctx->fds[fd].shared);
+        io_shm_free(ctx->fds[fd].shm, ctx->fds[fd].active ? fd : -1);
+    }
+    io_bucket_release(ctx->listen_bucket);
+    ctx->listen_bucket = NULL;
+    if(ctx->resolver)
+    {
+        io_resolver *r = ctx->resolver;
+        if(r->fd >= 0) close(r->fd);
+        while(r->queries) { io_dns_query *q = r->queries; r->queries = q->next; free(q); }
+        for(int i = 0; i < IO_DNS_CACHE_BUCKETS; i++)
+        {
+            while(r->cache[i]) { io_dns_cache *c = r->cache[i]; r->cache[i] = c->next; free(c); }
+        }
+        free(r);
+        ctx->resolver = NULL;
+    }
+    ctx->paused_head = -1;
+    ctx->connect_head = -1;
+    free(ctx->stats);
+    ctx->stats = NULL;
+    free(ctx->evlist);
+    free(ctx->fds);
+    ctx->evlist = NULL;
+    ctx->fds = NULL;
+    ctx->fd_capacity = 0;
+
+    return 0;
+}
+
+/**
+ * メモリ解放
+ */
+void io_free(void *p)
+{
+    free(p);
+}
+
+/**
+ * ソケットのアドレス情報の取得
+ */
+int io_getsockname(io_context *ctx, int fd, char *ip_buf, unsigned short *port)
+{
+    if(!ctx || !ip_buf || !port) return -1;
+
+    struct sockaddr_in addr;
+    socklen_t addrlen = sizeof(addr);
+    if(getsockname(fd, (struct sockaddr *)&addr, &addrlen) == -1) return -1;
+    if(addr.sin_family != AF_INET) return -1;
+
+    if(inet_ntop(AF_INET, &addr.sin_addr, ip_buf, INET_ADDRSTRLEN) == NULL) return -1;
+    *port = ntohs(addr.sin_port);
 
     return 0;
 }
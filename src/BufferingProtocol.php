@@ -146,10 +146,34 @@ class BufferingProtocol implements IProtocolParameter
         }
     }
 
+    /**
+     * 送信ファイルの設定
+     * 
+     * ファイルの内容は PHP 側へ読み込まずに送信される（Range 応答等は $p_offset／$p_length で指定）
+     * 
+     * @param mixed $p_file ファイルパス or ストリームリソース
+     * @param int $p_offset 送信開始位置
+     * @param ?int $p_length 送信サイズ（null の場合はファイル末尾まで）
+     */
+    final public function setSendingFile($p_file, int $p_offset = 0, ?int $p_length = null)
+    {
+        // 送信ファイルの設定
+        $cid = $this->param->getConnectionId();
+        $w_ret = $this->manager->setSendingFile($cid, $p_file, $p_offset, $p_length);
+        if($w_ret === false)
+        {
+            throw new UnitException(
+                UnitExceptionEnum::ECODE_SENDING_DATA_SET_FAIL->message(),
+                UnitExceptionEnum::ECODE_SENDING_DATA_SET_FAIL->value,
+                $this->param
+            );
+        }
+    }
+
     /**
      * データ送信
      * 
-     * setSendingDataで設定されたデータを送信するまで続ける
+     * setSendingData／setSendingFileで設定されたデータを送信するまで続ける
      * 
      * @return mixed true（成功） or null（送信中）
      */
@@ -205,4 +229,64 @@ class BufferingProtocol implements IProtocolParameter
         return $w_ret;
     }
 
+    /**
+     * 受信フレーミングの設定
+     * 
+     * 未完成のフレームは I/O ドライバ内に保持され、receivingFrame() では完成したフレームだけを取り出せる  
+     * setReceivingSize／receiving による組み立てが不要になる（socketsfd 拡張の I/O ドライバでのみ有効）
+     * 
+     * 例：['mode' => 'length', 'width' => 2]、['mode' => 'delimiter', 'delimiter' => "\r\n", 'strip' => true]
+     * 
+     * @param ?array $p_spec フレーミング指定 or null（解除）
+     * @return bool true（成功） or false（I/O ドライバが未対応）
+     */
+    public function setFraming(?array $p_spec): bool
+    {
+        $cid = $this->param->getConnectionId();
+        $w_ret = $this->manager->setFraming($cid, $p_spec);
+
+        return $w_ret;
+    }
+
+    /**
+     * フレーム受信
+     * 
+     * 同じイベントで複数のフレームが届くことがあるため、null になるまで取り出すこと
+     * 
+     * @return ?string 受信フレーム or null（受信済みのフレームなし）
+     */
+    public function receivingFrame(): ?string
+    {
+        $cid = $this->param->getConnectionId();
+        $w_ret = $this->manager->receivingFrame($cid);
+        if($w_ret === false)
+        {
+            throw new UnitException(
+                UnitExceptionEnum::ECODE_RECEIVING_FAIL->message(),
+                UnitExceptionEnum::ECODE_RECEIVING_FAIL->value,
+                $this->param
+            );
+        }
+
+        return $w_ret;
+    }
+
+    /**
+     * バッファリング受信ストアの取得
+     * 
+     * socketsfd 拡張がロードされている場合は SocketsFd\Buffer が受信ストアとなる
+     * 
+     * peek / readUint16BE / indexOf などで直接解析し、確定した分を consume すれば
+     * 中間の文字列コピーなしにフレーミングできる
+     * 
+     * @return ?\SocketsFd\Buffer 受信ストア or null（ネイティブストア未使用）
+     */
+    public function getReceiveBuffer(): ?\SocketsFd\Buffer
+    {
+        $cid = $this->param->getConnectionId();
+        $w_ret = $this->manager->getReceivingStore($cid);
+
+        return $w_ret;
+    }
+
 }
@@ -12,6 +12,12 @@
 namespace SocketManager\Library;
 
 
+use Closure;
+use Fiber;
+use SplPriorityQueue;
+use Throwable;
+
+
 /**
  * 周期ドリブンマネージャークラス
  * 
@@ -35,6 +41,76 @@ class CycleDrivenManager
      */
     private array $queues = [];
 
+    /**
+     * Fiber UNIT のリスト（キュー名 => ステータス名 => true）
+     */
+    private array $fiber_units = [];
+
+    /**
+     * 【中断中の Fiber のリスト】
+     * 
+     * キー（接続ID） => [
+     * 
+     *		'fiber' => Fiber,
+     * 
+     *		'queue' => 実行中のキュー名,
+     * 
+     *		'status' => 実行中のステータス名,
+     * 
+     *		'wait' => 再開条件 or null（次の周期で再開）
+     * 
+     *		（再開条件 ⇒ ['cid' => 受信を待つ接続ID or null, 'deadline' => 期限（hrtime ns） or null, 'cond' => 条件（callable） or null]）
+     * 
+     *		'seq' => 中断の通し番号（タイマーの古いエントリの判定用）
+     * 
+     * ]
+     */
+    private array $fibers = [];
+
+    /**
+     * 受信待ちの Fiber の索引（接続ID => キー => true）
+     */
+    private array $fiber_recv = [];
+
+    /**
+     * 期限付きで待つ Fiber のタイマー（優先度は期限の符号反転。値は [キー, 中断の通し番号]）
+     * 
+     * 再開済みのエントリは取り出す時に読み捨てる
+     */
+    private SplPriorityQueue $fiber_timers;
+
+    /**
+     * タイマーで待機中の Fiber の数（タイマーの再構築の判定用）
+     */
+    private int $fiber_timer_count = 0;
+
+    /**
+     * 中断の通し番号
+     */
+    private int $fiber_seq = 0;
+
+    /**
+     * 再開する Fiber（キー => true。再開した時点で外す）
+     */
+    private array $fiber_runnable = [];
+
+    /**
+     * コンパイル済みの UNIT テーブル（UNIT ID => 関数）
+     * 
+     * Fiber UNIT は含まない
+     */
+    private array $compiled_units = [];
+
+    /**
+     * UNIT ID の索引（キュー名 => ステータス名 => UNIT ID）
+     */
+    private array $compiled_index = [];
+
+    /**
+     * 遷移テーブル（UNIT ID => 同じキューの UNIT ID の索引（ステータス名 => UNIT ID））
+     */
+    private array $compiled_transitions = [];
+
 
     //--------------------------------------------------------------------------
     // メソッド
@@ -46,6 +122,7 @@ class CycleDrivenManager
      */
     public function __construct()
     {
+        $this->fiber_timers = new SplPriorityQueue();
     }
 
     /**
@@ -72,6 +149,143 @@ class CycleDrivenManager
         $this->queues[$p_que_nm][$p_sta_nm] = $p_fnc;
     }
 
+    /**
+     * Fiber UNIT の追加
+     * 
+     * Fiber 内で実行され、SocketManagerParameter の awaitRecv／awaitSend／sleep／awaitTimeout で中断できる  
+     * 中断中は再開条件が整うまで UNIT を呼び出さず、関数の戻り値（遷移先のステータス名 or null）で通常の UNIT と同じように遷移する
+     * 
+     * @param string $p_que_nm キュー名
+     * @param string $p_sta_nm ステータス名
+     * @param mixed $p_fnc 関数
+     */
+    public function addFiberUnit(string $p_que_nm, string $p_sta_nm, $p_fnc)
+    {
+        $this->queues[$p_que_nm][$p_sta_nm] = $p_fnc;
+        $this->fiber_units[$p_que_nm][$p_sta_nm] = true;
+    }
+
+    /**
+     * 中断中の Fiber の有無
+     * 
+     * @param string $p_key キー（接続ID）
+     * @return bool true（あり） or false（なし）
+     */
+    public function hasFiber(string $p_key): bool
+    {
+        return isset($this->fibers[$p_key]);
+    }
+
+    /**
+     * 中断中の Fiber の破棄（切断時）
+     * 
+     * @param string $p_key キー（接続ID）
+     */
+    public function cancelFiber(string $p_key)
+    {
+        $this->unindexFiber($p_key);
+        unset($this->fibers[$p_key]);
+    }
+
+    /**
+     * 今回の周期で再開する Fiber の決定
+     * 
+     * 受信イベントがあった接続を待つ Fiber と、期限に達した Fiber を再開対象にする（セレクトの直後に呼び出す）  
+     * 待機中の全 Fiber の再開条件を評価せずに済むため、コストはイベント数と期限切れの数に比例する
+     * 
+     * @param array $p_selected 受信イベントがあった接続IDの集合（接続ID => true）
+     */
+    public function prepareFibers(array $p_selected)
+    {
+        // 前の周期で再開されなかった Fiber（UNIT が実行されなかった接続）は対象のまま残す
+        if(count($this->fibers) <= 0)
+        {
+            return;
+        }
+
+        foreach($p_selected as $cid => $flg)
+        {
+            if(isset($this->fiber_recv[$cid]))
+            {
+                $this->fiber_runnable += $this->fiber_recv[$cid];
+            }
+        }
+
+        $now = hrtime(true);
+        while(!$this->fiber_timers->isEmpty())
+        {
+            $top = $this->fiber_timers->top();
+            $ent = $this->fibers[$top[0]] ?? null;
+            $live = ($ent !== null && $ent['seq'] === $top[1] && $ent['wait'] !== null);
+            if($live === true && $ent['wait']['deadline'] > $now)
+            {
+                break;
+            }
+            $this->fiber_timers->extract();
+            if($live === true)
+            {
+                $this->fiber_runnable[$top[0]] = true;
+            }
+        }
+    }
+
+    /**
+     * UNIT のコンパイル
+     * 
+     * 登録済みの UNIT に整数の UNIT ID を割り当て、UNIT テーブルと遷移テーブルを構築する  
+     * UNIT ID は再コンパイルしても変わらない（同じキュー名／ステータス名には同じ ID を割り当てる）
+     */
+    public function compile()
+    {
+        foreach($this->queues as $que => $units)
+        {
+            foreach($units as $sta => $fnc)
+            {
+                $id = $this->compiled_index[$que][$sta] ?? count($this->compiled_units);
+
+                // Fiber UNIT と呼び出せない関数は名前による実行に任せる
+                if(isset($this->fiber_units[$que][$sta]) || !is_callable($fnc))
+                {
+                    if(isset($this->compiled_index[$que][$sta]))
+                    {
+                        $this->compiled_units[$id] = null;
+                        unset($this->compiled_index[$que][$sta]);
+                    }
+                    continue;
+                }
+
+                $this->compiled_units[$id] = Closure::fromCallable($fnc);
+                $this->compiled_index[$que][$sta] = $id;
+            }
+        }
+
+        $this->compiled_transitions = [];
+        foreach($this->compiled_index as $index)
+        {
+            foreach($index as $id)
+            {
+                $this->compiled_transitions[$id] = $index;
+            }
+        }
+    }
+
+    /**
+     * UNIT ID の取得
+     * 
+     * @param ?string $p_que_nm キュー名
+     * @param ?string $p_sta_nm ステータス名
+     * @return ?int UNIT ID or null（コンパイル済みの UNIT がない）
+     */
+    public function getUnitId(?string $p_que_nm, ?string $p_sta_nm): ?int
+    {
+        if($p_que_nm === null || $p_sta_nm === null)
+        {
+            return null;
+        }
+
+        return $this->compiled_index[$p_que_nm][$p_sta_nm] ?? null;
+    }
+
     /**
      * キュー名のリスト取得
      * 
@@ -99,9 +313,10 @@ class CycleDrivenManager
      * 周期ドリブン処理の実行
      * 
      * @param IUnitParameter $p_param UNITパラメータ
+     * @param string $p_key Fiber UNIT のキー（接続ID）
      * @return bool true（成功） or false（失敗：登録UNITがない）
      */
-    public function cycleDriven(IUnitParameter $p_param)
+    public function cycleDriven(IUnitParameter $p_param, string $p_key = '')
     {
         // キュー名の取得
         $que = $p_param->getQueueName();
@@ -116,6 +331,11 @@ class CycleDrivenManager
             {
                 return false;
             }
+            if(isset($this->fiber_units[$que][$sta]))
+            {
+                $this->resumeFiber($p_param, $p_key, $que, $sta);
+                return true;
+            }
             $w_ret = $this->queues[$que][$sta]($p_param);
             $p_param->setStatusName($w_ret);
         }
@@ -123,4 +343,163 @@ class CycleDrivenManager
         return true;
     }
 
+    /**
+     * 周期ドリブン処理の実行（UNIT ID 指定）
+     * 
+     * コンパイル済みの UNIT を呼び出し、戻り値のステータス名を遷移テーブルで UNIT ID に変換する  
+     * ステータス名の反映は呼び出し元で行う
+     * 
+     * @param IUnitParameter $p_param UNITパラメータ
+     * @param ?int &$p_id UNIT ID（実行後は遷移先の UNIT ID。同じキューにない場合は null）
+     * @param ?string &$p_sta 遷移先のステータス名（UNIT の戻り値）
+     * @return bool true（成功） or false（失敗：コンパイル済みの UNIT がない）
+     */
+    public function cycleDrivenById(IUnitParameter $p_param, ?int &$p_id, ?string &$p_sta): bool
+    {
+        $fnc = $this->compiled_units[$p_id] ?? null;
+        if($fnc === null)
+        {
+            return false;
+        }
+
+        $p_sta = $fnc($p_param);
+        $p_id = $p_sta === null ? null : ($this->compiled_transitions[$p_id][$p_sta] ?? null);
+
+        return true;
+    }
+
+    /**
+     * Fiber UNIT の開始／再開
+     * 
+     * @param IUnitParameter $p_param UNITパラメータ
+     * @param string $p_key キー（接続ID）
+     * @param string $p_que キュー名
+     * @param string $p_sta ステータス名
+     */
+    private function resumeFiber(IUnitParameter $p_param, string $p_key, string $p_que, string $p_sta)
+    {
+        // 中断中にキュー／ステータスが切り替えられた場合は破棄して開始し直す
+        $ent = $this->fibers[$p_key] ?? null;
+        if($ent !== null && ($ent['queue'] !== $p_que || $ent['status'] !== $p_sta))
+        {
+            $this->unindexFiber($p_key);
+            unset($this->fibers[$p_key]);
+            $ent = null;
+        }
+
+        try
+        {
+            if($ent === null)
+            {
+                $fiber = new Fiber($this->queues[$p_que][$p_sta]);
+                $this->fibers[$p_key] = [
+                    'fiber' => $fiber,
+                    'queue' => $p_que,
+                    'status' => $p_sta,
+                    'wait' => null,
+                    'seq' => 0
+                ];
+                $wait = $fiber->start($p_param);
+            }
+            else
+            {
+                // 再開条件が整っていなければ UNIT を呼び出さない（受信とタイマーは prepareFibers で判定済み）
+                $wait = $ent['wait'];
+                if(
+                    $wait !== null
+                &&  !isset($this->fiber_runnable[$p_key])
+                &&  ($wait['cond'] === null || ($wait['cond'])() !== true)
+                ){
+                    return;
+                }
+                $this->unindexFiber($p_key);
+                $fiber = $ent['fiber'];
+                $wait = $fiber->resume();
+            }
+        }
+        catch(Throwable $e)
+        {
+            $this->unindexFiber($p_key);
+            unset($this->fibers[$p_key]);
+            throw $e;
+        }
+
+        if($fiber->isTerminated())
+        {
+            unset($this->fibers[$p_key]);
+            $p_param->setStatusName($fiber->getReturn());
+            return;
+        }
+
+        // 再開条件の索引付け（callable は条件として毎周期評価する）
+        if($wait !== null && !is_array($wait))
+        {
+            $wait = ['cid' => null, 'deadline' => null, 'cond' => $wait];
+        }
+        $this->fibers[$p_key]['wait'] = $wait;
+        $this->fibers[$p_key]['seq'] = ++$this->fiber_seq;
+        if($wait === null)
+        {
+            return;
+        }
+        if($wait['cid'] !== null)
+        {
+            $this->fiber_recv[$wait['cid']][$p_key] = true;
+        }
+        if($wait['deadline'] !== null)
+        {
+            $this->fiber_timers->insert([$p_key, $this->fiber_seq], -$wait['deadline']);
+            $this->fiber_timer_count++;
+            if($this->fiber_timers->count() > $this->fiber_timer_count * 2 + 64)
+            {
+                $this->rebuildFiberTimers();
+            }
+        }
+    }
+
+    /**
+     * 再開条件の索引から外す
+     * 
+     * @param string $p_key キー（接続ID）
+     */
+    private function unindexFiber(string $p_key)
+    {
+        $wait = $this->fibers[$p_key]['wait'] ?? null;
+        if($wait === null)
+        {
+            return;
+        }
+
+        if($wait['cid'] !== null)
+        {
+            unset($this->fiber_recv[$wait['cid']][$p_key]);
+            if(count($this->fiber_recv[$wait['cid']]) <= 0)
+            {
+                unset($this->fiber_recv[$wait['cid']]);
+            }
+        }
+        if($wait['deadline'] !== null)
+        {
+            $this->fiber_timer_count--;
+        }
+        $this->fibers[$p_key]['wait'] = null;
+        unset($this->fiber_runnable[$p_key]);
+    }
+
+    /**
+     * タイマーの再構築（再開済みで読み捨てを待つエントリが溜まった時）
+     */
+    private function rebuildFiberTimers()
+    {
+        $timers = new SplPriorityQueue();
+        foreach($this->fibers as $key => $ent)
+        {
+            if($ent['wait'] !== null && $ent['wait']['deadline'] !== null)
+            {
+                $timers->insert([$key, $ent['seq']], -$ent['wait']['deadline']);
+            }
+        }
+        $this->fiber_timers = $timers;
+    }
+
 }
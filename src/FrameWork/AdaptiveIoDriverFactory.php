@@ -28,6 +28,39 @@ class AdaptiveIoDriverFactory
      */
     public static ?int $mode = null;
 
+    /**
+     * @var ?array ビジーポーリングモードの設定（null は無効。キーは usecs / budget / prefer / cpus）
+     */
+    public static ?array $busy_poll = null;
+
+    /**
+     * ビジーポーリングモードの指定
+     * 
+     * 以降に生成する SocketManager は I/O ドライバをビジーポーリングモードで起動し、周期インターバルのスリープを行わない  
+     * forkWorkers で作り直す子プロセスのドライバにも適用される（SocketManager::setBusyPoll は生成後の切り替え用）  
+     * I/O ドライバが未対応の場合はログを出力して通常モードで動作する
+     * 
+     * @param bool $p_enable 有効フラグ
+     * @param int $p_usecs カーネル側のビジーポーリング時間（μs。非対応のカーネルでは無視）
+     * @param int $p_budget カーネル側の 1 回あたりの処理パケット数
+     * @param bool $p_prefer SO_PREFER_BUSY_POLL フラグ
+     * @param ?array $p_cpus 固定する CPU 番号リスト（null は固定しない）
+     */
+    public static function setBusyPollMode(bool $p_enable, int $p_usecs = 50, int $p_budget = 8, bool $p_prefer = true, ?array $p_cpus = null): void
+    {
+        self::$busy_poll = null;
+        if($p_enable === true)
+        {
+            self::$busy_poll =
+            [
+                'usecs' => $p_usecs,
+                'budget' => $p_budget,
+                'prefer' => $p_prefer,
+                'cpus' => $p_cpus
+            ];
+        }
+    }
+
     /**
      * ドライバI/Fの取得
      * 
@@ -38,6 +71,15 @@ class AdaptiveIoDriverFactory
      */
     public static function create(array &$p_sockets, SocketManager $p_manager, int $p_recv_buf_size): IIoDriver
     {
+        // socketsfd 拡張に I/O ドライバが組み込まれていれば最優先（FFI 不要）
+        if(function_exists('socketsfd_io_create'))
+        {
+            self::$mode = self::MODE_IO_NATIVE; // モード設定
+            $driver = new ExtensionIoDriver($p_manager, $p_recv_buf_size);
+            printf("\033[1;32mBoot sequence finished — running in Adaptive IO-Driver Mode (extension).\033[0m\n");
+            return $driver;
+        }
+
         if(
             (filter_var(ini_get('ffi.enable'), FILTER_VALIDATE_BOOLEAN) || ini_get('ffi.enable') === 'preload')
         &&  (
@@ -73,25 +115,51 @@ class AdaptiveIoDriverFactory
 
                             unsigned long long recv_buf_size;
                         } io_context;
-
-                        // Windows 専用：listen ソケット登録
-                        int io_registerListen(io_context* ctx, int fd);
-                        // Windows 専用：UDP 待ち受け ソケット登録
-                        int io_registerUdpListen(io_context* ctx, int fd);
-                        // メモリ解放
-                        void io_free(void *p);
-                        // ソケットアドレス情報取得
-                        int io_getsockname(io_context *ctx, int fd, char *ip_buf, unsigned short *port);
 CDEF;
                     $lib = __DIR__ . '/driver/io_core_win.dll';
                     break;
                 case 'Linux':
                     $header_os = <<<CDEF
+                        typedef struct {
+                            int nodelay;
+                            int sndbuf;
+                            int rcvbuf;
+                            int quickack;
+                            int notsent_lowat;
+                            int busy_poll;
+                            int user_timeout;
+                            int keepalive;
+                            int keepidle;
+                            int keepintvl;
+                            int keepcnt;
+                        } io_sock_profile;
+
                         typedef struct {
                             int   epfd;
                             int   capacity;
                             int   count;
                             void *evlist;
+
+                            unsigned long long recv_buf_size;
+                            void *fds;          // io_fd_entry* → void*
+                            int   fd_capacity;
+
+                            unsigned long long zc_threshold;
+                            void *release;      // void (*)(void *) → void*
+
+                            io_sock_profile profile[2];
+                            int   busy_poll;
+                            int   prefer_busy_poll;
+
+                            void *listen_bucket;    // io_bucket* → void*
+                            int   paused_head;
+                            int   connect_head;
+
+                            void *resolver;         // io_resolver* → void*
+
+                            void *stats;            // io_stats* → void*
+
+                            unsigned long long counters[6];     // IO_CNT_COUNT
                         } io_context;
 CDEF;
                     $lib = __DIR__ . '/driver/libio_core_linux.so';
@@ -126,6 +194,12 @@ CDEF;
                 // return: 0 = success, 非0 = error code
                 int io_register(io_context* ctx, int fd, int is_udp, int is_client);
 
+                // listen ソケット登録
+                int io_registerListen(io_context* ctx, int fd);
+
+                // UDP 待ち受け ソケット登録
+                int io_registerUdpListen(io_context* ctx, int fd);
+
                 // ソケットハンドルを IO ドライバから解除
                 // ctx: IO ドライバのコンテキスト
                 // fd: OS のソケットハンドル（Windows=SOCKET, Linux=fd）
@@ -143,6 +217,12 @@ CDEF;
                 // ctx: IO ドライバのコンテキスト
                 // return: 0 = success, 非0 = error code
                 int io_core_close(io_context *ctx);
+
+                // メモリ解放
+                void io_free(void *p);
+
+                // ソケットアドレス情報取得
+                int io_getsockname(io_context *ctx, int fd, char *ip_buf, unsigned short *port);
 CDEF;
             $driver = new NativeIoDriver(FFI::cdef($header, $lib), $p_manager, $p_recv_buf_size);
             printf("\033[1;32mBoot sequence finished — running in Adaptive IO-Driver Mode.\033[0m\n");
@@ -176,4 +176,223 @@ class CompatibleIoDriver implements IIoDriver
     {
         return true;
     }
+
+    /**
+     * ファイル送信（sendfile）
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param $p_stream ストリームリソース
+     * @param int $p_offset 送信開始位置
+     * @param int $p_length 送信サイズ
+     * @return int|false|null 未送信サイズ or false（失敗） or null（未対応）
+     */
+    public function sendFile($p_handle, $p_stream, int $p_offset, int $p_length): int|false|null
+    {
+        // 未対応（SocketManager 側でチャンク送信される）
+        return null;
+    }
+
+    /**
+     * データ送信（MSG_ZEROCOPY）
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param string $p_data 送信データ
+     * @return int|false|null 未送信サイズ or false（失敗） or null（未対応）
+     */
+    public function sendData($p_handle, string $p_data): int|false|null
+    {
+        return null;
+    }
+
+    /**
+     * 送信キューの再開
+     * 
+     * @param $p_handle ソケットハンドル
+     * @return int|false|null 未送信サイズ or false（失敗） or null（未対応）
+     */
+    public function flushSend($p_handle): int|false|null
+    {
+        return null;
+    }
+
+    /**
+     * ゼロコピー送信の設定
+     * 
+     * @param int $p_threshold MSG_ZEROCOPY を使う送信サイズ（0 で無効）
+     * @return bool true（成功） or false（未対応）
+     */
+    public function setZeroCopy(int $p_threshold): bool
+    {
+        return false;
+    }
+
+    /**
+     * ソケットチューニングプロファイルの設定
+     * 
+     * @param bool $p_is_client クライアントフラグ（false は受け入れ側）
+     * @param ?array $p_options オプション配列 or null（解除）
+     * @return bool true（登録時に適用される） or false（未対応。SocketManager 側で適用される）
+     */
+    public function setProfile(bool $p_is_client, ?array $p_options): bool
+    {
+        return false;
+    }
+
+    /**
+     * ビジーポーリングモードの設定
+     * 
+     * @param bool $p_enable 有効フラグ
+     * @param int $p_usecs カーネル側のビジーポーリング時間（μs）
+     * @param int $p_budget カーネル側の 1 回あたりの処理パケット数
+     * @param bool $p_prefer SO_PREFER_BUSY_POLL フラグ
+     * @param ?array $p_cpus 固定する CPU 番号リスト（null は固定しない）
+     * @return bool true（成功） or false（未対応 or 失敗）
+     */
+    public function setBusyPoll(bool $p_enable, int $p_usecs, int $p_budget, bool $p_prefer, ?array $p_cpus): bool
+    {
+        return false;
+    }
+
+    /**
+     * 受信フレーミングの設定
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param ?array $p_spec フレーミング指定 or null（解除）
+     * @return bool true（成功） or false（未対応 or 失敗）
+     */
+    public function setFraming($p_handle, ?array $p_spec): bool
+    {
+        return false;
+    }
+
+    /**
+     * 受信のレート制限の設定
+     * 
+     * @param $p_handle ソケットハンドル（待ち受けの場合は受け入れた接続で共有）
+     * @param ?array $p_spec レート制限指定 or null（解除）
+     * @return bool true（成功） or false（未対応 or 失敗）
+     */
+    public function setRateLimit($p_handle, ?array $p_spec): bool
+    {
+        return false;
+    }
+
+    /**
+     * ノンブロッキング接続の開始
+     * 
+     * 接続の成否は waitEvents の connect／connect_fail イベントで通知される
+     * 
+     * @param string $p_host 接続先ホスト名 or IP アドレス（ホスト名は非同期に名前解決する）
+     * @param int $p_port 接続先ポート番号
+     * @param int $p_timeout 接続タイムアウト（ms。名前解決を含む。0 はカーネルの既定）
+     * @return \Socket|false|null 登録済みのソケット or false（失敗） or null（未対応）
+     */
+    public function connect(string $p_host, int $p_port, int $p_timeout): \Socket|false|null
+    {
+        return null;
+    }
+
+    /**
+     * 名前解決の設定（connect で使用する）
+     * 
+     * @param ?string $p_server 問い合わせ先 IP アドレス or null（/etc/resolv.conf の nameserver）
+     * @param int $p_port 問い合わせ先ポート番号
+     * @param int $p_timeout 1 回の問い合わせの応答待ち（ms。0 は既定値）
+     * @param int $p_attempts 最大送信回数（0 は既定値）
+     * @return bool true（成功） or false（未対応 or 失敗）
+     */
+    public function setResolver(?string $p_server, int $p_port, int $p_timeout, int $p_attempts): bool
+    {
+        return false;
+    }
+
+    /**
+     * 共有メモリ IPC チャネルのオープン
+     * 
+     * 受信データは waitEvents の read イベントで、相手のクローズは disconnect イベントで通知される
+     * 
+     * @param string $p_name チャネル名
+     * @param bool $p_owner 作成側フラグ（false は作成済みのチャネルへ参加）
+     * @param int $p_capacity 方向ごとのリング容量（作成側のみ。0 は既定値）
+     * @return \Socket|false|null 登録済みのソケット（呼び鈴） or false（失敗） or null（未対応）
+     */
+    public function openIpc(string $p_name, bool $p_owner, int $p_capacity): \Socket|false|null
+    {
+        return null;
+    }
+
+    /**
+     * 共有メモリ IPC の送信
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param string $p_data 送信データ
+     * @return int|false|null 書き込んだサイズ（リングが一杯なら 0） or false（失敗） or null（未対応）
+     */
+    public function sendIpc($p_handle, string $p_data): int|false|null
+    {
+        return null;
+    }
+
+    /**
+     * 共有待ち受けの設定（fork したワーカー間で listen ソケットを共有する）
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param int $p_batch 1 回に受け入れる最大数（0 = 既定）
+     * @return bool true（成功） or false（失敗／未対応）
+     */
+    public function setListenExclusive($p_handle, int $p_batch): bool
+    {
+        return false;
+    }
+
+    /**
+     * ヒストグラムによる計測の開始／終了
+     * 
+     * @param bool $p_enable true（開始） or false（終了。計測値は破棄される）
+     * @return bool true（成功） or false（失敗／未対応）
+     */
+    public function setStats(bool $p_enable): bool
+    {
+        return false;
+    }
+
+    /**
+     * 所要時間の計測開始
+     * 
+     * @param int $p_metric 計測対象（IIoDriver::STATS_CYCLE／STATS_UNIT）
+     */
+    public function statsBegin(int $p_metric): void
+    {
+    }
+
+    /**
+     * 所要時間の計測終了
+     * 
+     * @param int $p_metric 計測対象（IIoDriver::STATS_CYCLE／STATS_UNIT／STATS_DISPATCH）
+     */
+    public function statsEnd(int $p_metric): void
+    {
+    }
+
+    /**
+     * 計測値の取得
+     * 
+     * @param bool $p_reset 取得後に計測値をクリアする
+     * @return array|false|null 計測対象名（cycle／wait／events／unit／dispatch） => [count, min, max, mean, p50, p90, p99, p999]（時間は ns） or false（計測していない） or null（未対応）
+     */
+    public function getStats(bool $p_reset): array|false|null
+    {
+        return null;
+    }
+
+    /**
+     * カウンタと現在値の取得（メトリクスページ用）
+     * 
+     * @return ?array 名前 => 値（累積カウンタ：bytes_in／bytes_out／selects／events／batch_full／accepts、
+     * 現在値：fds／fd_capacity／listeners／send_segments／send_bytes／send_max／zc_segments／paused／connecting／dns_queries／dns_cache） or null（未対応）
+     */
+    public function getMetrics(): ?array
+    {
+        return null;
+    }
 }
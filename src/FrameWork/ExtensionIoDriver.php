@@ -0,0 +1,401 @@
+<?php
+/**
+ * ライブラリファイル
+ * 
+ * I/O ドライバ抽象化クラス関連ファイル
+ */
+
+namespace SocketManager\Library\FrameWork;
+
+use RuntimeException;
+
+use SocketManager\Library\SocketManager;
+
+
+/**
+ * Extension I/O Driver クラス
+ * 
+ * socketsfd 拡張に組み込まれた I/O ドライバによってハイパフォーマンスモードで動作します（FFI 不要）
+ */
+class ExtensionIoDriver implements IIoDriver
+{
+    private SocketManager $manager; // SocketManagerインスタンス
+
+    /** @var \SocketsFd\IoContext $ctx */
+    private $ctx;
+
+    /**
+     * コンストラクタ
+     * 
+     * @param SocketManager $p_manager SocketManagerインスタンス
+     * @param int $p_recv_buf_size 受信バッファサイズ
+     */
+    public function __construct(SocketManager $p_manager, int $p_recv_buf_size)
+    {
+        $this->manager = $p_manager;
+        $ctx = socketsfd_io_create($p_recv_buf_size);
+        if($ctx === false)
+        {
+            throw new RuntimeException('socketsfd_io_create failed');
+        }
+        $this->ctx = $ctx;
+    }
+
+    /**
+     * ソケットハンドルを I/O ドライバへ登録依頼する
+     * 
+     * @param $p_sock ソケットリソース
+     * @param bool $p_is_udp UDPフラグ
+     * @param bool $p_is_client クライアントフラグ
+     * @return int ソケットハンドル
+     */
+    public function register($p_sock, bool $p_is_udp, bool $p_is_client): int
+    {
+        $handle = socketsfd($p_sock);
+        socketsfd_io_register($this->ctx, $handle, $p_is_udp, $p_is_client);
+        return $handle;
+    }
+
+    /**
+     * ソケットハンドルを I/O ドライバへ登録依頼する（Listen用）
+     * 
+     * @param $p_sock ソケットリソース
+     * @return int ソケットハンドル
+     */
+    public function registerListen($p_sock): int
+    {
+        $handle = socketsfd($p_sock);
+        socketsfd_io_register_listen($this->ctx, $handle);
+        return $handle;
+    }
+
+    /**
+     * ソケットハンドルを I/O ドライバへ登録依頼する（UDP待ち受け用）
+     * 
+     * @param $p_sock ソケットリソース
+     * @return int ソケットハンドル
+     */
+    public function registerUdpListen($p_sock): int
+    {
+        $handle = socketsfd($p_sock);
+        socketsfd_io_register_udp_listen($this->ctx, $handle);
+        return $handle;
+    }
+
+    /**
+     * ソケットハンドルを I/O ドライバへ解除依頼する
+     * 
+     * @param $p_handle ソケットハンドル
+     */
+    public function unregister($p_handle): void
+    {
+        socketsfd_io_unregister($this->ctx, $p_handle);
+    }
+
+    /**
+     * イベント待機
+     * 
+     * イベント配列は拡張側で生成済み。PHP 側の判定が必要なイベントのみ補完する
+     * 
+     * @param int $p_timeout タイムアウト時間（ms）
+     * @return array|false 発生したイベントの配列 or false（失敗）
+     */
+    public function waitEvents(int $p_timeout = 0): array|false
+    {
+        $fallback = null;
+        $ret = socketsfd_io_wait($this->ctx, $p_timeout, $fallback);
+        if($ret === false)
+        {
+            return false;
+        }
+        if($fallback === null)
+        {
+            return $ret;
+        }
+
+        // 切断判定や UDP の受信は従来どおり SocketManager 側で行う
+        foreach($fallback as $idx)
+        {
+            $cid = $ret[$idx]['cid'];
+            $data = '';
+            $len = $this->manager->ioRecv($cid, $data);
+            if($len === null)
+            {
+                unset($ret[$idx]);
+            }
+            else
+            if($len === 0)
+            {
+                $ret[$idx]['type'] = 'disconnect';
+            }
+            else
+            if($len !== false)
+            {
+                $ret[$idx]['bytes'] = $len;
+                $ret[$idx]['data'] = $data;
+            }
+        }
+
+        return $ret;
+    }
+
+    /**
+     * ソケットのアドレス情報取得
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param string &$p_ip_buf IPアドレス格納エリア
+     * @param int &$p_port ポート番号格納エリア
+     * @return bool true（成功） or false（失敗）
+     */
+    public function getSockName($p_handle, string &$p_ip_buf, int &$p_port): bool
+    {
+        return socketsfd_io_getsockname($this->ctx, $p_handle, $p_ip_buf, $p_port);
+    }
+
+    /**
+     * ファイル送信（sendfile／splice）
+     * 
+     * 入力はドライバ側で複製されるため、呼び出し後にストリームを閉じても構わない
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param $p_stream ストリームリソース
+     * @param int $p_offset 送信開始位置
+     * @param int $p_length 送信サイズ
+     * @return int|false|null 未送信サイズ or false（失敗） or null（未対応）
+     */
+    public function sendFile($p_handle, $p_stream, int $p_offset, int $p_length): int|false|null
+    {
+        if($p_length <= 0)
+        {
+            return 0;
+        }
+        return @socketsfd_io_send_file($this->ctx, (int)$p_handle, $p_stream, $p_offset, $p_length);
+    }
+
+    /**
+     * データ送信（MSG_ZEROCOPY）
+     * 
+     * 送信データはカーネルから完了通知が届くまで拡張側で保持される
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param string $p_data 送信データ
+     * @return int|false|null 未送信サイズ or false（失敗） or null（未対応）
+     */
+    public function sendData($p_handle, string $p_data): int|false|null
+    {
+        return @socketsfd_io_send($this->ctx, (int)$p_handle, $p_data);
+    }
+
+    /**
+     * 送信キューの再開
+     * 
+     * 通常は socketsfd_io_wait 内で EPOLLOUT を契機に送信されるため、残りサイズの確認を兼ねる
+     * 
+     * @param $p_handle ソケットハンドル
+     * @return int|false|null 未送信サイズ or false（失敗） or null（未対応）
+     */
+    public function flushSend($p_handle): int|false|null
+    {
+        return @socketsfd_io_flush($this->ctx, (int)$p_handle);
+    }
+
+    /**
+     * ゼロコピー送信の設定
+     * 
+     * @param int $p_threshold MSG_ZEROCOPY を使う送信サイズ（0 で無効）
+     * @return bool true（成功） or false（未対応）
+     */
+    public function setZeroCopy(int $p_threshold): bool
+    {
+        return socketsfd_io_set_zerocopy($this->ctx, $p_threshold);
+    }
+
+    /**
+     * ソケットチューニングプロファイルの設定
+     * 
+     * 以降の登録時に C 側で setsockopt される
+     * 
+     * @param bool $p_is_client クライアントフラグ（false は受け入れ側）
+     * @param ?array $p_options オプション配列 or null（解除）
+     * @return bool true（登録時に適用される） or false（未対応。SocketManager 側で適用される）
+     */
+    public function setProfile(bool $p_is_client, ?array $p_options): bool
+    {
+        return socketsfd_io_set_profile($this->ctx, $p_is_client, $p_options);
+    }
+
+    /**
+     * ビジーポーリングモードの設定
+     * 
+     * @param bool $p_enable 有効フラグ
+     * @param int $p_usecs カーネル側のビジーポーリング時間（μs）
+     * @param int $p_budget カーネル側の 1 回あたりの処理パケット数
+     * @param bool $p_prefer SO_PREFER_BUSY_POLL フラグ
+     * @param ?array $p_cpus 固定する CPU 番号リスト（null は固定しない）
+     * @return bool true（成功） or false（未対応 or 失敗）
+     */
+    public function setBusyPoll(bool $p_enable, int $p_usecs, int $p_budget, bool $p_prefer, ?array $p_cpus): bool
+    {
+        if($p_enable === true && $p_cpus !== null)
+        {
+            $w_ret = socketsfd_set_affinity($p_cpus);
+            if($w_ret === false)
+            {
+                return false;
+            }
+        }
+
+        return socketsfd_io_set_busy_poll($this->ctx, $p_enable, $p_usecs, $p_budget, $p_prefer);
+    }
+
+    /**
+     * 受信フレーミングの設定
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param ?array $p_spec フレーミング指定 or null（解除）
+     * @return bool true（成功） or false（未対応 or 失敗）
+     */
+    public function setFraming($p_handle, ?array $p_spec): bool
+    {
+        return socketsfd_io_set_framing($this->ctx, $p_handle, $p_spec);
+    }
+
+    /**
+     * 受信のレート制限の設定
+     * 
+     * @param $p_handle ソケットハンドル（待ち受けの場合は受け入れた接続で共有）
+     * @param ?array $p_spec レート制限指定 or null（解除）
+     * @return bool true（成功） or false（未対応 or 失敗）
+     */
+    public function setRateLimit($p_handle, ?array $p_spec): bool
+    {
+        return socketsfd_io_set_rate_limit($this->ctx, $p_handle, $p_spec);
+    }
+
+    /**
+     * ノンブロッキング接続の開始
+     * 
+     * 接続の成否は waitEvents の connect／connect_fail イベントで通知される
+     * 
+     * @param string $p_host 接続先ホスト名 or IP アドレス（ホスト名は非同期に名前解決する）
+     * @param int $p_port 接続先ポート番号
+     * @param int $p_timeout 接続タイムアウト（ms。名前解決を含む。0 はカーネルの既定）
+     * @return \Socket|false|null 登録済みのソケット or false（失敗） or null（未対応）
+     */
+    public function connect(string $p_host, int $p_port, int $p_timeout): \Socket|false|null
+    {
+        return socketsfd_io_connect($this->ctx, $p_host, $p_port, $p_timeout);
+    }
+
+    /**
+     * 名前解決の設定（connect で使用する）
+     * 
+     * @param ?string $p_server 問い合わせ先 IP アドレス or null（/etc/resolv.conf の nameserver）
+     * @param int $p_port 問い合わせ先ポート番号
+     * @param int $p_timeout 1 回の問い合わせの応答待ち（ms。0 は既定値）
+     * @param int $p_attempts 最大送信回数（0 は既定値）
+     * @return bool true（成功） or false（未対応 or 失敗）
+     */
+    public function setResolver(?string $p_server, int $p_port, int $p_timeout, int $p_attempts): bool
+    {
+        return socketsfd_io_set_resolver($this->ctx, $p_server, $p_port, $p_timeout, $p_attempts);
+    }
+
+    /**
+     * 共有メモリ IPC チャネルのオープン
+     * 
+     * 受信データは waitEvents の read イベントで、相手のクローズは disconnect イベントで通知される
+     * 
+     * @param string $p_name チャネル名
+     * @param bool $p_owner 作成側フラグ（false は作成済みのチャネルへ参加）
+     * @param int $p_capacity 方向ごとのリング容量（作成側のみ。0 は既定値）
+     * @return \Socket|false|null 登録済みのソケット（呼び鈴） or false（失敗） or null（未対応）
+     */
+    public function openIpc(string $p_name, bool $p_owner, int $p_capacity): \Socket|false|null
+    {
+        return socketsfd_io_ipc_open($this->ctx, $p_name, $p_owner, $p_capacity);
+    }
+
+    /**
+     * 共有メモリ IPC の送信
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param string $p_data 送信データ
+     * @return int|false|null 書き込んだサイズ（リングが一杯なら 0） or false（失敗） or null（未対応）
+     */
+    public function sendIpc($p_handle, string $p_data): int|false|null
+    {
+        return @socketsfd_io_ipc_send($this->ctx, (int)$p_handle, $p_data);
+    }
+
+    /**
+     * 共有待ち受けの設定（fork したワーカー間で listen ソケットを共有する）
+     * 
+     * @param $p_handle ソケットハンドル
+     * @param int $p_batch 1 回に受け入れる最大数（0 = 既定）
+     * @return bool true（成功） or false（失敗／未対応）
+     */
+    public function setListenExclusive($p_handle, int $p_batch): bool
+    {
+        return @socketsfd_io_set_listen_exclusive($this->ctx, (int)$p_handle, $p_batch);
+    }
+
+    /**
+     * ヒストグラムによる計測の開始／終了
+     * 
+     * @param bool $p_enable true（開始） or false（終了。計測値は破棄される）
+     * @return bool true（成功） or false（失敗／未対応）
+     */
+    public function setStats(bool $p_enable): bool
+    {
+        return @socketsfd_io_stats_enable($this->ctx, $p_enable);
+    }
+
+    /**
+     * 所要時間の計測開始
+     * 
+     * @param int $p_metric 計測対象（IIoDriver::STATS_CYCLE／STATS_UNIT）
+     */
+    public function statsBegin(int $p_metric): void
+    {
+        socketsfd_io_stats_begin($this->ctx, $p_metric);
+    }
+
+    /**
+     * 所要時間の計測終了
+     * 
+     * @param int $p_metric 計測対象（IIoDriver::STATS_CYCLE／STATS_UNIT／STATS_DISPATCH）
+     */
+    public function statsEnd(int $p_metric): void
+    {
+        socketsfd_io_stats_end($this->ctx, $p_metric);
+    }
+
+    /**
+     * 計測値の取得
+     * 
+     * @param bool $p_reset 取得後に計測値をクリアする
+     * @return array|false|null 計測対象名（cycle／wait／events／unit／dispatch） => [count, min, max, mean, p50, p90, p99, p999]（時間は ns） or false（計測していない） or null（未対応）
+     */
+    public function getStats(bool $p_reset): array|false|null
+    {
+        return @socketsfd_io_stats_get($this->ctx, $p_reset);
+    }
+
+    /**
+     * カウンタと現在値の取得（メトリクスページ用）
+     * 
+     * @return ?array 名前 => 値（累積カウンタ：bytes_in／bytes_out／selects／events／batch_full／accepts、
+     * 現在値：fds／fd_capacity／listeners／send_segments／send_bytes／send_max／zc_segments／paused／connecting／dns_queries／dns_cache） or null（未対応）
+     */
+    public function getMetrics(): ?array
+    {
+        $w_ret = @socketsfd_io_metrics($this->ctx);
+        if($w_ret === false)
+        {
+            return null;
+        }
+
+        return $w_ret;
+    }
+}
@@ -14,10 +14,37 @@ namespace SocketManager\Library\FrameWork;
  */
 interface IIoDriver
 {
+    /**
+     * 計測対象（statsBegin／statsEnd。値は C ドライバの IO_STAT_* と同じ）
+     */
+    public const STATS_CYCLE = 0;       // 周期ドリブン処理 1 回の所要時間
+    public const STATS_WAIT = 1;        // waitEvents 内の待機時間（ドライバが記録）
+    public const STATS_EVENTS = 2;      // waitEvents 1 回のイベント数（ドライバが記録）
+    public const STATS_UNIT = 3;        // UNIT 1 回の所要時間
+    public const STATS_DISPATCH = 4;    // waitEvents が戻ってから UNIT を実行するまでの遅延（statsEnd のみ）
+
     public function register($p_sock, bool $p_is_udp, bool $p_is_client): int;
     public function registerListen($p_sock): int;
     public function registerUdpListen($p_sock): int;
     public function unregister($p_handle): void;
     public function waitEvents(int $p_timeout = 0): array|false;
     public function getSockName($p_handle, string &$p_ip_buf, int &$p_port);
+    public function sendFile($p_handle, $p_stream, int $p_offset, int $p_length): int|false|null;
+    public function sendData($p_handle, string $p_data): int|false|null;
+    public function flushSend($p_handle): int|false|null;
+    public function setZeroCopy(int $p_threshold): bool;
+    public function setProfile(bool $p_is_client, ?array $p_options): bool;
+    public function setBusyPoll(bool $p_enable, int $p_usecs, int $p_budget, bool $p_prefer, ?array $p_cpus): bool;
+    public function setFraming($p_handle, ?array $p_spec): bool;
+    public function setRateLimit($p_handle, ?array $p_spec): bool;
+    public function connect(string $p_host, int $p_port, int $p_timeout): \Socket|false|null;
+    public function setResolver(?string $p_server, int $p_port, int $p_timeout, int $p_attempts): bool;
+    public function openIpc(string $p_name, bool $p_owner, int $p_capacity): \Socket|false|null;
+    public function sendIpc($p_handle, string $p_data): int|false|null;
+    public function setListenExclusive($p_handle, int $p_batch): bool;
+    public function setStats(bool $p_enable): bool;
+    public function statsBegin(int $p_metric): void;
+    public function statsEnd(int $p_metric): void;
+    public function getStats(bool $p_reset): array|false|null;
+    public function getMetrics(): ?array;
 }
@@ -106,4 +106,16 @@ class InitForTemplate implements IInitSocketManager
     {
         return new SocketManagerParameter();
     }
+
+    /**
+     * ソケットチューニングプロファイルの取得
+     * 
+     * 'server'（受け入れた接続）／'client'（connect した接続）ごとに SocketProfileEnum かオプション配列を指定する。nullを返す場合は無効化となる。
+     * 
+     * @return ?array ['server' => SocketProfileEnum|array|null, 'client' => SocketProfileEnum|array|null] or null
+     */
+    public function getSocketProfile(): ?array
+    {
+        return null;
+    }
 }
@@ -33,6 +33,8 @@ interface IEntryUnits
      * 
      * ― UNITリストフォーマット⇒[['status' => ステータス名,'unit' => ステータスUNITの関数],...]
      * 
+     * ― 'fiber' => true を指定すると Fiber UNIT として登録される（SocketManagerParameter の awaitRecv／awaitSend／sleep／awaitTimeout で中断できる）
+     * 
      *----------------------------------------------------------------------------------------------------
      * 【ステータスUNIT関数仕様（※1）】
      * 
@@ -14,6 +14,9 @@
  * SocketManagerクラス初期化時にインプリメントしてsetInitSocketManagerメソッドへ渡すための定義
  * 
  * ※グローバル関数名指定も可
+ * 
+ * ※任意で getSocketProfile(): ?array を実装すると、ソケットチューニングプロファイルが設定される
+ * （['server' => SocketProfileEnum|array|null, 'client' => SocketProfileEnum|array|null] 形式。SocketManager::setSocketProfile 参照）
  */
 interface IInitSocketManager
 {
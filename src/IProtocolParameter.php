@@ -57,10 +57,21 @@ interface IProtocolParameter
      */
     public function setSendingData(string $p_data);
 
+    /**
+     * 送信ファイルの設定
+     * 
+     * ※プロトコルUNITで使用
+     * 
+     * @param mixed $p_file ファイルパス or ストリームリソース
+     * @param int $p_offset 送信開始位置
+     * @param ?int $p_length 送信サイズ（null の場合はファイル末尾まで）
+     */
+    public function setSendingFile($p_file, int $p_offset = 0, ?int $p_length = null);
+
     /**
      * データ送信
      * 
-     * setSendingDataで設定されたデータを送信するまで続ける
+     * setSendingData／setSendingFileで設定されたデータを送信するまで続ける
      * 
      * ※プロトコルUNITで使用 
      * 
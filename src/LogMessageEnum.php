@@ -37,6 +37,146 @@ enum LogMessageEnum
      */
     case ALIVE_CHECK_START_TIMEOUT;
 
+    /**
+     * @var キープアライブタイムアウト（カーネルによる相手の消失検出）
+     */
+    case KEEPALIVE_TIMEOUT;
+
+    /**
+     * @var レート制限の発動
+     */
+    case RATE_LIMIT_THROTTLED;
+
+    /**
+     * @var レート制限の超過による切断
+     */
+    case RATE_LIMIT_EXCEEDED;
+
+    /**
+     * @var 非同期接続に失敗
+     */
+    case CONNECT_ASYNC_FAIL;
+
+    /**
+     * @var 非同期接続に未対応
+     */
+    case CONNECT_ASYNC_UNSUPPORTED;
+
+    /**
+     * @var ホスト名の解決に失敗
+     */
+    case HOST_RESOLVE_FAIL;
+
+    /**
+     * @var ビジーポーリングモードに未対応
+     */
+    case BUSY_POLL_UNSUPPORTED;
+
+    /**
+     * @var UNIXドメインソケットのアドレスが不正
+     */
+    case UNIX_ADDRESS_INVALID;
+
+    /**
+     * @var 共有メモリIPCチャネルのオープンに失敗
+     */
+    case IPC_OPEN_FAIL;
+
+    /**
+     * @var 共有メモリIPCに未対応
+     */
+    case IPC_UNSUPPORTED;
+
+    /**
+     * @var ホットリスタートに未対応
+     */
+    case HOT_RESTART_UNSUPPORTED;
+
+    /**
+     * @var ホットリスタートの引き継ぎに失敗
+     */
+    case HOT_RESTART_FAIL;
+
+    /**
+     * @var ホットリスタートで後継プロセスへ引き継ぎ
+     */
+    case HOT_RESTART_HANDOVER;
+
+    /**
+     * @var ホットリスタートで旧プロセスから引き継ぎ
+     */
+    case HOT_RESTART_TAKEOVER;
+
+    /**
+     * @var コネクションマイグレーションに未対応
+     */
+    case MIGRATION_UNSUPPORTED;
+
+    /**
+     * @var コネクションマイグレーションに失敗
+     */
+    case MIGRATION_FAIL;
+
+    /**
+     * @var コネクションマイグレーションで接続を移動
+     */
+    case MIGRATION_SENT;
+
+    /**
+     * @var コネクションマイグレーションで接続を受け入れ
+     */
+    case MIGRATION_RECEIVED;
+
+    /**
+     * @var prefork ワーカーに未対応
+     */
+    case WORKER_UNSUPPORTED;
+
+    /**
+     * @var ワーカープロセスの生成に失敗
+     */
+    case WORKER_FORK_FAIL;
+
+    /**
+     * @var 共有待ち受け（EPOLLEXCLUSIVE）に未対応
+     */
+    case WORKER_SHARED_LISTEN;
+
+    /**
+     * @var オフロードに未対応
+     */
+    case OFFLOAD_UNSUPPORTED;
+
+    /**
+     * @var オフロードしたジョブが失敗
+     */
+    case OFFLOAD_FAIL;
+
+    /**
+     * @var UNIT プロファイラーの集計表
+     */
+    case PROFILE_REPORT;
+
+    /**
+     * @var UNIT プロファイラーの出力に失敗
+     */
+    case PROFILE_WRITE_FAIL;
+
+    /**
+     * @var ヒストグラムによる計測に未対応
+     */
+    case STATS_UNSUPPORTED;
+
+    /**
+     * @var ヒストグラムの計測値
+     */
+    case STATS_REPORT;
+
+    /**
+     * @var メトリクスページの応答に失敗
+     */
+    case METRICS_WRITE_FAIL;
+
     /**
      * @var ソケット生成に失敗
      */
@@ -62,6 +202,11 @@ enum LogMessageEnum
      */
     case RECEIVE_SIZE_NO_SETTING;
 
+    /**
+     * @var 受信フレーミングが未設定
+     */
+    case FRAMING_NO_SETTING;
+
     /**
      * @var 送信データが未設定
      */
@@ -112,6 +257,11 @@ enum LogMessageEnum
      */
     case RECEIVING_DURING_DOWNTIME;
 
+    /**
+     * @var 送信ファイルのオープンに失敗
+     */
+    case SEND_FILE_OPEN_FAIL;
+
 
     //--------------------------------------------------------------------------
     // メソッド
@@ -131,11 +281,40 @@ enum LogMessageEnum
             {
                 self::ALIVE_CHECK_TIMEOUT => 'アライブチェックタイムアウト発生',
                 self::ALIVE_CHECK_START_TIMEOUT => 'アライブチェック開始までのタイムアウトが発生',
+                self::KEEPALIVE_TIMEOUT => 'キープアライブタイムアウト発生（相手からの応答なし）',
+                self::RATE_LIMIT_THROTTLED => 'レート制限が発動',
+                self::RATE_LIMIT_EXCEEDED => 'レート制限の超過により切断',
+                self::CONNECT_ASYNC_FAIL => '非同期接続に失敗',
+                self::CONNECT_ASYNC_UNSUPPORTED => '非同期接続に未対応のI/Oドライバ（connect を使用してください）',
+                self::HOST_RESOLVE_FAIL => 'ホスト名の解決に失敗',
+                self::BUSY_POLL_UNSUPPORTED => 'ビジーポーリングモードに未対応のI/Oドライバ（通常モードで動作します）',
+                self::UNIX_ADDRESS_INVALID => 'UNIXドメインソケットのアドレスが不正（unix:///path or unix://@name）',
+                self::IPC_OPEN_FAIL => '共有メモリIPCチャネルのオープンに失敗',
+                self::IPC_UNSUPPORTED => '共有メモリIPCに未対応のI/Oドライバ（socketsfd 拡張が必要です）',
+                self::HOT_RESTART_UNSUPPORTED => 'ホットリスタートに未対応のOS（Linux のみ）',
+                self::HOT_RESTART_FAIL => 'ホットリスタートの引き継ぎに失敗',
+                self::HOT_RESTART_HANDOVER => 'ホットリスタートで後継プロセスへ引き継ぎ',
+                self::HOT_RESTART_TAKEOVER => 'ホットリスタートで旧プロセスから引き継ぎ',
+                self::MIGRATION_UNSUPPORTED => 'コネクションマイグレーションに未対応のOS（Linux のみ）',
+                self::MIGRATION_FAIL => 'コネクションマイグレーションに失敗',
+                self::MIGRATION_SENT => 'コネクションマイグレーションで接続を移動',
+                self::MIGRATION_RECEIVED => 'コネクションマイグレーションで接続を受け入れ',
+                self::WORKER_UNSUPPORTED => 'prefork ワーカーに未対応の環境（Linux と pcntl 拡張が必要です）',
+                self::WORKER_FORK_FAIL => 'ワーカープロセスの生成に失敗',
+                self::WORKER_SHARED_LISTEN => '共有待ち受け（EPOLLEXCLUSIVE）に未対応のI/Oドライバ（各ワーカーが受け入れを競合します）',
+                self::OFFLOAD_UNSUPPORTED => 'オフロード用ワーカープールが使用できない（Linux と pcntl 拡張が必要です）',
+                self::OFFLOAD_FAIL => 'オフロードしたジョブが失敗',
+                self::PROFILE_REPORT => 'UNIT プロファイラーの集計表',
+                self::PROFILE_WRITE_FAIL => 'UNIT プロファイラーのフォールデッドスタックの出力に失敗',
+                self::STATS_UNSUPPORTED => 'ヒストグラムによる計測に未対応のI/Oドライバ（socketsfd 拡張が必要です）',
+                self::STATS_REPORT => '周期ドリブン処理の計測値（μs。events は件数）',
+                self::METRICS_WRITE_FAIL => 'メトリクスページの応答に失敗',
                 self::SOCKET_CREATE_FAIL => 'ソケット生成に失敗',
                 self::QUEUE_START_FAIL => 'キュー処理開始設定に失敗',
                 self::SOCKET_OPTION_SETTING_FAIL => 'ソケットオプションの設定に失敗',
                 self::SOCKET_NO_COUNT => '処理対象のソケットが存在しない',
                 self::RECEIVE_SIZE_NO_SETTING => '受信サイズが未設定',
+                self::FRAMING_NO_SETTING => '受信フレーミングが未設定',
                 self::SEND_DATA_NO_SETTING => '送信データが未設定',
                 self::UNIT_NO_SETTING => '処理対象のUNITが未登録',
                 self::NONBLOCK_SETTING_FAIL => 'ノンブロック設定失敗',
@@ -146,6 +325,7 @@ enum LogMessageEnum
                 self::SEND_BUFFER_FULL => '送信バッファが一杯',
                 self::RECEIVE_BUFFER_FULL => '受信バッファが一杯',
                 self::RECEIVING_DURING_DOWNTIME => 'ダウンタイム中の受信',
+                self::SEND_FILE_OPEN_FAIL => '送信ファイルのオープンに失敗',
                 default => '存在しないEnum値です'
             };
         }
@@ -156,11 +336,40 @@ enum LogMessageEnum
             {
                 self::ALIVE_CHECK_TIMEOUT => 'Alive check timeout occurred',
                 self::ALIVE_CHECK_START_TIMEOUT => 'Timeout occurred before alive checking started',
+                self::KEEPALIVE_TIMEOUT => 'Keepalive timeout occurred (no response from the peer)',
+                self::RATE_LIMIT_THROTTLED => 'Rate limit triggered',
+                self::RATE_LIMIT_EXCEEDED => 'Disconnected for exceeding the rate limit',
+                self::CONNECT_ASYNC_FAIL => 'Asynchronous connection failed',
+                self::CONNECT_ASYNC_UNSUPPORTED => 'The I/O driver does not support asynchronous connection (use connect instead)',
+                self::HOST_RESOLVE_FAIL => 'Host name resolution failed',
+                self::BUSY_POLL_UNSUPPORTED => 'The I/O driver does not support busy-poll mode (running in normal mode)',
+                self::UNIX_ADDRESS_INVALID => 'Invalid UNIX domain socket address (unix:///path or unix://@name)',
+                self::IPC_OPEN_FAIL => 'Failed to open the shared-memory IPC channel',
+                self::IPC_UNSUPPORTED => 'The I/O driver does not support shared-memory IPC (the socketsfd extension is required)',
+                self::HOT_RESTART_UNSUPPORTED => 'Hot restart is not supported on this OS (Linux only)',
+                self::HOT_RESTART_FAIL => 'Hot restart handoff failed',
+                self::HOT_RESTART_HANDOVER => 'Handed over to the successor process for hot restart',
+                self::HOT_RESTART_TAKEOVER => 'Took over from the previous process for hot restart',
+                self::MIGRATION_UNSUPPORTED => 'Connection migration is not supported on this OS (Linux only)',
+                self::MIGRATION_FAIL => 'Connection migration failed',
+                self::MIGRATION_SENT => 'Migrated connections to a sibling process',
+                self::MIGRATION_RECEIVED => 'Accepted connections migrated from a sibling process',
+                self::WORKER_UNSUPPORTED => 'Prefork workers are not supported in this environment (Linux and the pcntl extension are required)',
+                self::WORKER_FORK_FAIL => 'Failed to fork a worker process',
+                self::WORKER_SHARED_LISTEN => 'The I/O driver does not support the shared listener (EPOLLEXCLUSIVE); workers will race to accept',
+                self::OFFLOAD_UNSUPPORTED => 'The offload worker pool is not available (Linux and the pcntl extension are required)',
+                self::OFFLOAD_FAIL => 'Offloaded job failed',
+                self::PROFILE_REPORT => 'Unit profiler report',
+                self::PROFILE_WRITE_FAIL => 'Failed to write the unit profiler folded stacks',
+                self::STATS_UNSUPPORTED => 'The I/O driver does not support histogram statistics (the socketsfd extension is required)',
+                self::STATS_REPORT => 'Cycle statistics (us; events are counts)',
+                self::METRICS_WRITE_FAIL => 'Failed to write the metrics response',
                 self::SOCKET_CREATE_FAIL => 'Failed to create socket',
                 self::QUEUE_START_FAIL => 'Queue processing start setting failed',
                 self::SOCKET_OPTION_SETTING_FAIL => 'Failed to set socket options',
                 self::SOCKET_NO_COUNT => 'No socket to process exists',
                 self::RECEIVE_SIZE_NO_SETTING => 'Reception size not set',
+                self::FRAMING_NO_SETTING => 'Reception framing not set',
                 self::SEND_DATA_NO_SETTING => 'Transmission data not set',
                 self::UNIT_NO_SETTING => 'UNIT to be processed is not registered',
                 self::NONBLOCK_SETTING_FAIL => 'Non-blocking setting failed',
@@ -171,6 +380,7 @@ enum LogMessageEnum
                 self::SEND_BUFFER_FULL => 'Send buffer full',
                 self::RECEIVE_BUFFER_FULL => 'Receive buffer is full',
                 self::RECEIVING_DURING_DOWNTIME => 'Receiving during downtime',
+                self::SEND_FILE_OPEN_FAIL => 'Failed to open the file to send',
                 default => 'Enum value that does not exist'
             };
         }
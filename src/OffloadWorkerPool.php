@@ -0,0 +1,684 @@
+<?php
+/**
+ * ライブラリファイル
+ * 
+ * オフロード用ワーカープールのファイル
+ */
+
+namespace SocketManager\Library;
+
+
+use FFI;
+use Socket;
+use Throwable;
+
+
+/**
+ * オフロード用ワーカープールクラス
+ * 
+ * データベースアクセスや画像変換など、周期ドリブン処理を止めてしまうブロッキング／CPU 負荷の高い処理を子プロセスで実行する
+ * SocketManager::setOffloadPool で連携し、コマンドUNITからは $p_param->offload() でジョブを依頼する
+ * 
+ * ジョブは登録済みの処理名とペイロード（serialize できる値）で依頼し、結果は周期ドリブン処理の中で依頼元の接続へ戻される
+ * 子プロセスは fork で生成するため、処理は start の前に register で登録しておく
+ */
+final class OffloadWorkerPool
+{
+    //--------------------------------------------------------------------------
+    // 定数
+    //--------------------------------------------------------------------------
+
+    /**
+     * フレームヘッダ（ペイロード長）のサイズ
+     */
+    private const HEADER_SIZE = 4;
+
+    /**
+     * 1 フレームの最大サイズ
+     */
+    private const MAX_FRAME_SIZE = 268435456;
+
+    /**
+     * 1 回の読み込みサイズ
+     */
+    private const READ_SIZE = 65536;
+
+
+    //--------------------------------------------------------------------------
+    // プロパティ
+    //--------------------------------------------------------------------------
+
+    /**
+     * 子プロセス数
+     */
+    private int $size = 4;
+
+    /**
+     * ジョブのタイムアウト（秒。超えた子プロセスは強制終了して生成し直す）
+     */
+    private int $timeout = 30;
+
+    /**
+     * 処理名 => 処理（callable。引数はペイロード、戻り値が結果）
+     */
+    private array $handlers = [];
+
+    /**
+     * 【子プロセスのリスト】
+     * 
+     * [
+     * 
+     *		[
+     *			'pid' => プロセスID（int）,
+     * 
+     *			'socket' => 親側のソケット（Socket）,
+     * 
+     *			'job' => 実行中のジョブ（array） or null（待機中）,
+     * 
+     *			'started' => ジョブの開始時刻（hrtime）,
+     * 
+     *			'in' => 受信途中のデータ（string）,
+     * 
+     *			'out' => 送信途中のデータ（string）
+     *		],
+     *		...
+     * 
+     * ]
+     */
+    private array $workers = [];
+
+    /**
+     * 子プロセスの空き待ちのジョブ（先頭から割り当てる）
+     */
+    private array $pending = [];
+
+    /**
+     * 次のジョブID
+     */
+    private int $sequence = 0;
+
+    /**
+     * 統計情報
+     */
+    private array $statistics = [
+        'submitted' => 0,   // 依頼されたジョブ数
+        'completed' => 0,   // 結果が戻ったジョブ数
+        'failed' => 0,      // 処理中の例外／子プロセスの異常終了
+        'timeouts' => 0,    // タイムアウト
+        'respawns' => 0     // 子プロセスの再生成
+    ];
+
+
+    //--------------------------------------------------------------------------
+    // メソッド
+    //--------------------------------------------------------------------------
+
+    /**
+     * コンストラクタ
+     * 
+     * @param int $p_size 子プロセス数
+     * @param int $p_timeout ジョブのタイムアウト（秒。0 は無制限）
+     */
+    public function __construct(int $p_size = 4, int $p_timeout = 30)
+    {
+        $this->size = max(1, $p_size);
+        $this->timeout = max(0, $p_timeout);
+    }
+
+    /**
+     * 処理の登録
+     * 
+     * @param string $p_name 処理名
+     * @param callable $p_handler 処理（引数：ペイロード、戻り値：結果）
+     * @return bool true（成功） or false（開始済み）
+     */
+    public function register(string $p_name, callable $p_handler): bool
+    {
+        if(count($this->workers) > 0)
+        {
+            return false;
+        }
+        $this->handlers[$p_name] = $p_handler;
+
+        return true;
+    }
+
+    /**
+     * 子プロセスの生成
+     * 
+     * 子プロセスはその時点のソケットを引き継ぐため、listen／connect の前に呼び出す
+     * 
+     * @return bool true（成功） or false（失敗）
+     */
+    public function start(): bool
+    {
+        if(!function_exists('pcntl_fork') || PHP_OS_FAMILY === 'Windows')
+        {
+            return false;
+        }
+        if(count($this->workers) > 0)
+        {
+            return true;
+        }
+
+        for($i = 0; $i < $this->size; $i++)
+        {
+            $w_ret = $this->spawn();
+            if($w_ret === null)
+            {
+                $this->shutdown();
+                return false;
+            }
+            $this->workers[] = $w_ret;
+        }
+
+        return true;
+    }
+
+    /**
+     * 開始済みの判定
+     * 
+     * @return bool true（開始済み） or false（未開始）
+     */
+    public function isStarted(): bool
+    {
+        return count($this->workers) > 0;
+    }
+
+    /**
+     * ジョブの依頼
+     * 
+     * @param string $p_cid 依頼元の接続ID
+     * @param string $p_name 処理名
+     * @param mixed $p_payload ペイロード
+     * @param array $p_context 結果と一緒に戻す任意の情報
+     * @return int|false ジョブID or false（未開始 or 未登録の処理名）
+     */
+    public function submit(string $p_cid, string $p_name, $p_payload, array $p_context = []): int|false
+    {
+        if(count($this->workers) <= 0 || !isset($this->handlers[$p_name]))
+        {
+            return false;
+        }
+
+        $id = ++$this->sequence;
+        $dat = serialize([$id, $p_name, $p_payload]);
+        $this->pending[] = [
+            'id' => $id,
+            'cid' => $p_cid,
+            'name' => $p_name,
+            'context' => $p_context,
+            'frame' => pack('N', strlen($dat)).$dat
+        ];
+        $this->statistics['submitted']++;
+
+        $this->dispatch();
+
+        return $id;
+    }
+
+    /**
+     * 実行中／空き待ちのジョブの有無
+     * 
+     * @return bool true（あり） or false（なし）
+     */
+    public function isBusy(): bool
+    {
+        if(count($this->pending) > 0)
+        {
+            return true;
+        }
+        foreach($this->workers as $worker)
+        {
+            if($worker['job'] !== null)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * 完了したジョブの回収
+     * 
+     * 周期ドリブン処理の中から呼び出す（ブロックしない）
+     * 
+     * @return array 完了したジョブのリスト（['id', 'cid', 'name', 'context', 'result', 'error'（null = 成功）]）
+     */
+    public function poll(): array
+    {
+        $ret = [];
+        if($this->isBusy() === false)
+        {
+            return $ret;
+        }
+
+        // 送信途中のジョブを送る
+        $this->dispatch();
+
+        // 結果の受信
+        $reads = [];
+        foreach($this->workers as $idx => $worker)
+        {
+            if($worker['job'] !== null && $worker['out'] === '')
+            {
+                $reads[$idx] = $worker['socket'];
+            }
+        }
+        if(count($reads) > 0)
+        {
+            $writes = null;
+            $excepts = null;
+            $w_ret = @socket_select($reads, $writes, $excepts, 0);
+            if($w_ret !== false && $w_ret > 0)
+            {
+                foreach($reads as $idx => $soc)
+                {
+                    $w_ret = $this->receive($idx);
+                    if($w_ret !== null)
+                    {
+                        $ret[] = $w_ret;
+                    }
+                }
+            }
+        }
+
+        // タイムアウトの判定
+        if($this->timeout > 0)
+        {
+            $now = hrtime(true);
+            foreach($this->workers as $idx => $worker)
+            {
+                if($worker['job'] !== null && ($now - $worker['started']) >= $this->timeout * 1000000000)
+                {
+                    $this->statistics['timeouts']++;
+                    $ret[] = $this->fail($idx, 'timeout');
+                }
+            }
+        }
+
+        // 空いた子プロセスへ次のジョブを割り当てる
+        $this->dispatch();
+
+        return $ret;
+    }
+
+    /**
+     * 統計情報の取得
+     * 
+     * @return array submitted／completed／failed／timeouts／respawns の各件数と、
+     *         pending（空き待ちのジョブ数）、busy（実行中の子プロセス数）
+     */
+    public function getStatistics(): array
+    {
+        $busy = 0;
+        foreach($this->workers as $worker)
+        {
+            if($worker['job'] !== null)
+            {
+                $busy++;
+            }
+        }
+
+        $ret = $this->statistics;
+        $ret['pending'] = count($this->pending);
+        $ret['busy'] = $busy;
+
+        return $ret;
+    }
+
+    /**
+     * fork で引き継いだプールの切り離し（fork した子プロセスで使用）
+     * 
+     * 親プロセスの子プロセスとの経路を閉じるだけで、終了の通知や回収は行わない（このプロセスの子プロセスではないため）  
+     * 空き待ちのジョブは破棄する。続けて start を呼び出すとこのプロセス専用の子プロセスを生成する
+     */
+    public function detachInherited(): void
+    {
+        foreach($this->workers as $worker)
+        {
+            @socket_close($worker['socket']);
+        }
+        $this->workers = [];
+        $this->pending = [];
+    }
+
+    /**
+     * 子プロセスの全終了
+     * 
+     * 実行中／空き待ちのジョブは破棄する
+     */
+    public function shutdown(): void
+    {
+        foreach($this->workers as $worker)
+        {
+            @socket_close($worker['socket']);
+            if($worker['job'] !== null)
+            {
+                posix_kill($worker['pid'], SIGKILL);
+            }
+        }
+        foreach($this->workers as $worker)
+        {
+            $status = 0;
+            pcntl_waitpid($worker['pid'], $status);
+        }
+        $this->workers = [];
+        $this->pending = [];
+    }
+
+
+    //--------------------------------------------------------------------------
+    // 内部処理
+    //--------------------------------------------------------------------------
+
+    /**
+     * 子プロセスの生成
+     * 
+     * @return ?array 子プロセスの情報 or null（失敗）
+     */
+    private function spawn(): ?array
+    {
+        $pair = [];
+        $w_ret = @socket_create_pair(AF_UNIX, SOCK_STREAM, 0, $pair);
+        if($w_ret === false)
+        {
+            return null;
+        }
+
+        $pid = pcntl_fork();
+        if($pid === -1)
+        {
+            @socket_close($pair[0]);
+            @socket_close($pair[1]);
+            return null;
+        }
+        if($pid === 0)
+        {
+            // 親から引き継いだ fd（待ち受けソケット、クライアント接続、他の子プロセスとの経路）を手放す
+            // 残すと親がクローズした接続がこの子プロセスの終了まで切断されない
+            $this->closeInherited($pair[1]);
+            $this->serve($pair[1]);
+
+            // exit は親のアプリケーションのシャットダウン関数や出力バッファのフラッシュを実行してしまう
+            posix_kill(getmypid(), SIGKILL);
+        }
+
+        @socket_close($pair[1]);
+        socket_set_nonblock($pair[0]);
+
+        return [
+            'pid' => $pid,
+            'socket' => $pair[0],
+            'job' => null,
+            'started' => 0,
+            'in' => '',
+            'out' => ''
+        ];
+    }
+
+    /**
+     * 親から引き継いだ fd の解放（子プロセス用）
+     * 
+     * 標準入出力と $p_keep 以外の fd を /dev/null に差し替える（socketsfd 拡張、なければ FFI で libc を呼ぶ）  
+     * close しないのは、親から引き継いだオブジェクトが後から同じ番号を close しても、子プロセスで開いた fd を巻き込まないようにするため  
+     * 処理（register で登録したもの）が使う接続やファイルは親で開いたものを使わず、処理の中で開くこと
+     * 
+     * @param Socket $p_keep 残すソケット（親との経路）
+     */
+    private function closeInherited(Socket $p_keep): void
+    {
+        if(function_exists('socketsfd_close_inherited'))
+        {
+            socketsfd_close_inherited($p_keep);
+            return;
+        }
+        if(!class_exists('FFI', false) || !is_dir('/proc/self/fd'))
+        {
+            return;
+        }
+
+        // 残すソケットは inode で識別する（/proc/self/fd のリンク先が socket:[inode]）
+        $stat = fstat(socket_export_stream($p_keep));
+        $keep = 'socket:['.$stat['ino'].']';
+        try
+        {
+            $libc = FFI::cdef('int open(const char *path, int flags); int dup2(int oldfd, int newfd); int close(int fd);', 'libc.so.6');
+        }
+        catch(Throwable $e)
+        {
+            return;
+        }
+        $null = $libc->open('/dev/null', 2);    // O_RDWR
+        if($null < 0)
+        {
+            return;
+        }
+        foreach(scandir('/proc/self/fd') as $ent)
+        {
+            if(!ctype_digit($ent))
+            {
+                continue;
+            }
+            $fd = (int)$ent;
+            $lnk = @readlink('/proc/self/fd/'.$ent);
+            if($fd <= 2 || $fd === $null || $lnk === false || $lnk === $keep)
+            {
+                continue;
+            }
+            $libc->dup2($null, $fd);
+        }
+        $libc->close($null);
+    }
+
+    /**
+     * 子プロセスの処理ループ
+     * 
+     * 親側のソケットが閉じられるまでジョブを 1 件ずつ実行する
+     * 
+     * @param Socket $p_socket 子側のソケット
+     */
+    private function serve(Socket $p_socket): void
+    {
+        while(true)
+        {
+            $hdr = $this->readAll($p_socket, self::HEADER_SIZE);
+            if($hdr === null)
+            {
+                return;
+            }
+            $len = unpack('N', $hdr)[1];
+            $dat = $this->readAll($p_socket, $len);
+            if($dat === null)
+            {
+                return;
+            }
+
+            [$id, $name, $payload] = unserialize($dat);
+            $res = ['id' => $id, 'result' => null, 'error' => null];
+            try
+            {
+                $res['result'] = ($this->handlers[$name])($payload);
+            }
+            catch(Throwable $e)
+            {
+                $res['error'] = get_class($e).': '.$e->getMessage();
+            }
+
+            $dat = serialize($res);
+            $dat = pack('N', strlen($dat)).$dat;
+            while($dat !== '')
+            {
+                $w_ret = @socket_write($p_socket, $dat);
+                if($w_ret === false)
+                {
+                    return;
+                }
+                $dat = substr($dat, $w_ret);
+            }
+        }
+    }
+
+    /**
+     * 指定サイズの読み込み（子プロセス用。ブロッキング）
+     * 
+     * @param Socket $p_socket ソケット
+     * @param int $p_size サイズ
+     * @return ?string 読み込んだデータ or null（切断）
+     */
+    private function readAll(Socket $p_socket, int $p_size): ?string
+    {
+        $ret = '';
+        while(strlen($ret) < $p_size)
+        {
+            $buf = '';
+            $w_ret = @socket_recv($p_socket, $buf, min(self::READ_SIZE, $p_size - strlen($ret)), 0);
+            if($w_ret === false || $w_ret === 0)
+            {
+                return null;
+            }
+            $ret .= $buf;
+        }
+
+        return $ret;
+    }
+
+    /**
+     * 空き待ちのジョブの割り当てと送信途中のデータの送信
+     */
+    private function dispatch()
+    {
+        foreach($this->workers as $idx => $worker)
+        {
+            if($worker['job'] === null && count($this->pending) > 0)
+            {
+                $job = array_shift($this->pending);
+                $this->workers[$idx]['out'] = $job['frame'];
+                unset($job['frame']);
+                $this->workers[$idx]['job'] = $job;
+                $this->workers[$idx]['started'] = hrtime(true);
+                $this->workers[$idx]['in'] = '';
+            }
+            if($this->workers[$idx]['out'] === '')
+            {
+                continue;
+            }
+
+            $w_ret = @socket_write($this->workers[$idx]['socket'], $this->workers[$idx]['out']);
+            if($w_ret === false)
+            {
+                $cod = socket_last_error($this->workers[$idx]['socket']);
+                socket_clear_error($this->workers[$idx]['socket']);
+                if($cod !== SOCKET_EAGAIN)
+                {
+                    // 子プロセスの異常終了は次の poll で回収する
+                    $this->workers[$idx]['out'] = '';
+                }
+                continue;
+            }
+            $this->workers[$idx]['out'] = (string)substr($this->workers[$idx]['out'], $w_ret);
+        }
+    }
+
+    /**
+     * 結果の受信
+     * 
+     * @param int $p_idx 子プロセスのインデックス
+     * @return ?array 完了したジョブ or null（受信途中）
+     */
+    private function receive(int $p_idx): ?array
+    {
+        $soc = $this->workers[$p_idx]['socket'];
+        while(true)
+        {
+            $buf = '';
+            $w_ret = @socket_recv($soc, $buf, self::READ_SIZE, 0);
+            if($w_ret === false)
+            {
+                $cod = socket_last_error($soc);
+                socket_clear_error($soc);
+                if($cod === SOCKET_EAGAIN)
+                {
+                    break;
+                }
+                return $this->fail($p_idx, 'worker error: '.socket_strerror($cod));
+            }
+            if($w_ret === 0)
+            {
+                return $this->fail($p_idx, 'worker exited');
+            }
+            $this->workers[$p_idx]['in'] .= $buf;
+        }
+
+        $in = $this->workers[$p_idx]['in'];
+        if(strlen($in) < self::HEADER_SIZE)
+        {
+            return null;
+        }
+        $len = unpack('N', $in)[1];
+        if($len > self::MAX_FRAME_SIZE)
+        {
+            return $this->fail($p_idx, 'invalid frame');
+        }
+        if(strlen($in) < self::HEADER_SIZE + $len)
+        {
+            return null;
+        }
+
+        $res = @unserialize(substr($in, self::HEADER_SIZE, $len));
+        $job = $this->workers[$p_idx]['job'];
+        $this->workers[$p_idx]['job'] = null;
+        $this->workers[$p_idx]['in'] = '';
+        if(!is_array($res) || $res['id'] !== $job['id'])
+        {
+            return $this->fail($p_idx, 'invalid frame', $job);
+        }
+
+        if($res['error'] !== null)
+        {
+            $this->statistics['failed']++;
+        }
+        else
+        {
+            $this->statistics['completed']++;
+        }
+        $job['result'] = $res['result'];
+        $job['error'] = $res['error'];
+
+        return $job;
+    }
+
+    /**
+     * 実行中のジョブの失敗と子プロセスの再生成
+     * 
+     * @param int $p_idx 子プロセスのインデックス
+     * @param string $p_error エラー内容
+     * @param ?array $p_job 失敗させるジョブ（null = 実行中のジョブ）
+     * @return array 失敗したジョブ
+     */
+    private function fail(int $p_idx, string $p_error, ?array $p_job = null): array
+    {
+        $job = $p_job ?? $this->workers[$p_idx]['job'];
+        $pid = $this->workers[$p_idx]['pid'];
+
+        @socket_close($this->workers[$p_idx]['socket']);
+        unset($this->workers[$p_idx]);
+        posix_kill($pid, SIGKILL);
+        $status = 0;
+        pcntl_waitpid($pid, $status);
+
+        $w_ret = $this->spawn();
+        if($w_ret !== null)
+        {
+            $this->workers[$p_idx] = $w_ret;
+            $this->statistics['respawns']++;
+        }
+
+        $this->statistics['failed']++;
+        $job['result'] = null;
+        $job['error'] = $p_error;
+
+        return $job;
+    }
+}
@@ -146,10 +146,34 @@ class ProtocolParameter implements IProtocolParameter
         }
     }
 
+    /**
+     * 送信ファイルの設定
+     * 
+     * ファイルの内容は PHP 側へ読み込まずに送信される（Range 応答等は $p_offset／$p_length で指定）
+     * 
+     * @param mixed $p_file ファイルパス or ストリームリソース
+     * @param int $p_offset 送信開始位置
+     * @param ?int $p_length 送信サイズ（null の場合はファイル末尾まで）
+     */
+    final public function setSendingFile($p_file, int $p_offset = 0, ?int $p_length = null)
+    {
+        // 送信ファイルの設定
+        $cid = $this->param->getConnectionId();
+        $w_ret = $this->manager->setSendingFile($cid, $p_file, $p_offset, $p_length);
+        if($w_ret === false)
+        {
+            throw new UnitException(
+                UnitExceptionEnum::ECODE_SENDING_DATA_SET_FAIL->message(),
+                UnitExceptionEnum::ECODE_SENDING_DATA_SET_FAIL->value,
+                $this->param
+            );
+        }
+    }
+
     /**
      * データ送信
      * 
-     * setSendingDataで設定されたデータを送信するまで続ける
+     * setSendingData／setSendingFileで設定されたデータを送信するまで続ける
      * 
      * @return mixed true（成功） or null（送信中）
      */
@@ -37,6 +37,13 @@ class RuntimeManagerParameter implements IUnitParameter
      */
     public ISimpleSocketUdp|ISimpleSocketTcpServer|ISimpleSocketTcpClient|null $simple_socket = null;
 
+    /**
+     * コネクションプール
+     * 
+     * SimpleSocketGenerator で生成する TCP Client が使用する（UNIT間で共有される）
+     */
+    public ?SimpleSocketConnectionPool $connection_pool = null;
+
 
     //--------------------------------------------------------------------------
     // メソッド
@@ -0,0 +1,278 @@
+<?php
+/**
+ * ライブラリファイル
+ * 
+ * シンプルソケット用コネクションプールのファイル
+ */
+
+namespace SocketManager\Library;
+
+
+use Socket;
+
+
+/**
+ * シンプルソケット用コネクションプールクラス
+ * 
+ * 接続先（ホスト＋ポート）ごとにアイドル接続を保持し、SimpleSocketTcpClient の接続に再利用する
+ * SimpleSocketGenerator::setConnectionPool、または UNITパラメータの connection_pool プロパティで連携する
+ */
+final class SimpleSocketConnectionPool
+{
+    //--------------------------------------------------------------------------
+    // 定数（ソケット関連エラーコード）
+    //--------------------------------------------------------------------------
+
+    /**
+     * ソケット操作を完了できなかった
+     */
+    private const SOCKET_ERROR_COULDNT_COMPLETED = 10035;
+
+    /**
+     * ソケット受信のリトライが必要
+     * （Resource temporarily unavailable）
+     */
+    private const SOCKET_ERROR_READ_RETRY = 11;
+
+
+    //--------------------------------------------------------------------------
+    // プロパティ
+    //--------------------------------------------------------------------------
+
+    /**
+     * 接続先ごとのアイドル接続数の上限
+     */
+    private int $max_idle = 8;
+
+    /**
+     * アイドルタイムアウト（秒）
+     */
+    private int $idle_timeout = 60;
+
+    /**
+     * 【アイドル接続のリスト】
+     * 
+     * 'ホスト:ポート' => [
+     * 
+     *		[
+     *			'socket' => ソケットリソース（Socket）,
+     * 
+     *			'timestamp' => プールへ戻した日時（int）
+     *		],
+     *		...（末尾が最も新しい）
+     * 
+     * ]
+     */
+    private array $idles = [];
+
+    /**
+     * 統計情報
+     */
+    private array $statistics = [
+        'hits' => 0,        // プールから取り出せた
+        'misses' => 0,      // 新規接続が必要だった
+        'checkins' => 0,    // プールへ戻した
+        'expired' => 0,     // アイドルタイムアウトで破棄
+        'unhealthy' => 0,   // 取り出し時のヘルスチェックで破棄
+        'overflows' => 0    // 上限超過で破棄
+    ];
+
+
+    //--------------------------------------------------------------------------
+    // メソッド
+    //--------------------------------------------------------------------------
+
+    /**
+     * コンストラクタ
+     * 
+     * @param int $p_max_idle 接続先ごとのアイドル接続数の上限
+     * @param int $p_idle_timeout アイドルタイムアウト（秒）
+     */
+    public function __construct(int $p_max_idle = 8, int $p_idle_timeout = 60)
+    {
+        $this->max_idle = max(0, $p_max_idle);
+        $this->idle_timeout = max(0, $p_idle_timeout);
+    }
+
+    /**
+     * 接続の取り出し
+     * 
+     * 最も新しいアイドル接続から順にヘルスチェックを行い、使用できるものを返す
+     * 
+     * @param string $p_host ホスト名
+     * @param int $p_port ポート番号
+     * @return ?Socket ソケットリソース or null（プールになし。新規接続が必要）
+     */
+    public function checkout(string $p_host, int $p_port): ?Socket
+    {
+        $key = $p_host.':'.$p_port;
+        $now = time();
+        while(isset($this->idles[$key]) && count($this->idles[$key]) > 0)
+        {
+            $idle = array_pop($this->idles[$key]);
+            if(($now - $idle['timestamp']) >= $this->idle_timeout)
+            {
+                $this->statistics['expired']++;
+                $this->close($idle['socket']);
+                continue;
+            }
+            if($this->isHealthy($idle['socket']) === false)
+            {
+                $this->statistics['unhealthy']++;
+                $this->close($idle['socket']);
+                continue;
+            }
+            $this->statistics['hits']++;
+            return $idle['socket'];
+        }
+
+        $this->statistics['misses']++;
+        return null;
+    }
+
+    /**
+     * 接続をプールへ戻す
+     * 
+     * 上限に達している場合はクローズする
+     * 
+     * @param string $p_host ホスト名
+     * @param int $p_port ポート番号
+     * @param Socket $p_socket ソケットリソース
+     * @return bool true（プールへ戻した） or false（クローズした）
+     */
+    public function checkin(string $p_host, int $p_port, Socket $p_socket): bool
+    {
+        $key = $p_host.':'.$p_port;
+        if(!isset($this->idles[$key]))
+        {
+            $this->idles[$key] = [];
+        }
+        if(count($this->idles[$key]) >= $this->max_idle)
+        {
+            $this->statistics['overflows']++;
+            $this->close($p_socket);
+            return false;
+        }
+
+        $this->idles[$key][] = [
+            'socket' => $p_socket,
+            'timestamp' => time()
+        ];
+        $this->statistics['checkins']++;
+
+        return true;
+    }
+
+    /**
+     * アイドルタイムアウトを過ぎた接続の破棄
+     * 
+     * 周期ドリブン処理の中など、定期的に呼び出す
+     * 
+     * @return int 破棄した接続数
+     */
+    public function purge(): int
+    {
+        $cnt = 0;
+        $now = time();
+        foreach(array_keys($this->idles) as $key)
+        {
+            // 先頭ほど古い
+            while(count($this->idles[$key]) > 0 && ($now - $this->idles[$key][0]['timestamp']) >= $this->idle_timeout)
+            {
+                $idle = array_shift($this->idles[$key]);
+                $this->close($idle['socket']);
+                $cnt++;
+            }
+            if(count($this->idles[$key]) <= 0)
+            {
+                unset($this->idles[$key]);
+            }
+        }
+        $this->statistics['expired'] += $cnt;
+
+        return $cnt;
+    }
+
+    /**
+     * 統計情報の取得
+     * 
+     * @return array hits／misses／checkins／expired／unhealthy／overflows の各件数と、
+     *         idle（現在のアイドル接続数）、hit_rate（ヒット率）
+     */
+    public function getStatistics(): array
+    {
+        $idle = 0;
+        foreach($this->idles as $idles)
+        {
+            $idle += count($idles);
+        }
+        $total = $this->statistics['hits'] + $this->statistics['misses'];
+
+        $ret = $this->statistics;
+        $ret['idle'] = $idle;
+        $ret['hit_rate'] = $total > 0 ? $this->statistics['hits'] / $total : 0.0;
+
+        return $ret;
+    }
+
+    /**
+     * アイドル接続の全クローズ
+     */
+    public function shutdownAll(): void
+    {
+        foreach($this->idles as $idles)
+        {
+            foreach($idles as $idle)
+            {
+                $this->close($idle['socket']);
+            }
+        }
+        $this->idles = [];
+    }
+
+
+    //--------------------------------------------------------------------------
+    // 内部処理
+    //--------------------------------------------------------------------------
+
+    /**
+     * ヘルスチェック
+     * 
+     * アイドル中に相手から切断された接続や、読み残しのデータがある接続は使用できない
+     * 
+     * @param Socket $p_socket ソケットリソース
+     * @return bool true（使用可能） or false（使用不可）
+     */
+    private function isHealthy(Socket $p_socket): bool
+    {
+        $err = @socket_get_option($p_socket, SOL_SOCKET, SO_ERROR);
+        if($err !== 0)
+        {
+            return false;
+        }
+
+        // ノンブロッキングで 1 バイト覗き見る（受信データなし＝正常）
+        $buf = '';
+        $w_ret = @socket_recv($p_socket, $buf, 1, MSG_PEEK);
+        if($w_ret === false)
+        {
+            $cod = socket_last_error($p_socket);
+            socket_clear_error($p_socket);
+            return ($cod === self::SOCKET_ERROR_READ_RETRY || $cod === self::SOCKET_ERROR_COULDNT_COMPLETED);
+        }
+
+        // 0：相手からの切断、1 以上：読み残しのデータ
+        return false;
+    }
+
+    /**
+     * ソケットクローズ
+     * 
+     * @param Socket $p_socket ソケットリソース
+     */
+    private function close(Socket $p_socket): void
+    {
+        @socket_shutdown($p_socket, 2);
+        @socket_close($p_socket);
+    }
+}
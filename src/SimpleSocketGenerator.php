@@ -47,6 +47,7 @@ final class SimpleSocketGenerator
     private ?int $buff_cnt;
     private ?int $retry;
     private ?int $retry_interval;
+    private ?SimpleSocketConnectionPool $pool = null;
 
     private SocketManagerParameter|RuntimeManagerParameter|null $unit_parameter = null;
     private ?array $argv = null;
@@ -221,6 +222,19 @@ final class SimpleSocketGenerator
         }
     }
 
+    /**
+     * コネクションプールの設定（TCP Client 用）
+     * 
+     * 生成するクライアントはプールから接続を取り出し、切断時（shutdownAll）にプールへ戻す  
+     * 未設定の場合は UNITパラメータの connection_pool プロパティが使われる
+     * 
+     * @param ?SimpleSocketConnectionPool $p_pool コネクションプール or null（使用しない）
+     */
+    public function setConnectionPool(?SimpleSocketConnectionPool $p_pool)
+    {
+        $this->pool = $p_pool;
+    }
+
     /**
      * 生成インスタンスのインターフェースを取得
      * 
@@ -302,7 +316,8 @@ final class SimpleSocketGenerator
         {
             try
             {
-                $this->tcp_client = new SimpleSocketTcpClient($this->type, $this->host, $this->port, $this->downtime, $this->size, $this->buff_cnt, $this->lang, $this->limit, $this->retry, $this->retry_interval);
+                $pool = $this->pool ?? $this->unit_parameter?->connection_pool;
+                $this->tcp_client = new SimpleSocketTcpClient($this->type, $this->host, $this->port, $this->downtime, $this->size, $this->buff_cnt, $this->lang, $this->retry, $this->retry_interval, $pool);
             }
             catch(Exception $e)
             {
@@ -216,6 +216,13 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
      */
     private \Closure|string|null $log_writer = null;
 
+    /**
+     * コネクションプール
+     * 
+     * 設定されている場合は接続をプールから取り出し、切断時にプールへ戻す
+     */
+    private ?SimpleSocketConnectionPool $pool = null;
+
 
     //--------------------------------------------------------------------------
     // メソッド
@@ -233,6 +240,7 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
      * @param ?string $p_lang 言語コード
      * @param ?int $p_retry 接続リトライ回数
      * @param ?int $p_retry_interval リトライ時インターバル（μs）
+     * @param ?SimpleSocketConnectionPool $p_pool コネクションプール
      */
     public function __construct
     (
@@ -244,7 +252,8 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
         ?int $p_buff_cnt = null,
         ?string $p_lang = null,
         ?int $p_retry = null,
-        ?int $p_retry_interval = null
+        ?int $p_retry_interval = null,
+        ?SimpleSocketConnectionPool $p_pool = null
     )
     {
         // シンプルソケットタイプの設定
@@ -295,6 +304,9 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
             $this->retry_interval = $p_retry_interval;
         }
 
+        // コネクションプールの設定
+        $this->pool = $p_pool;
+
         //--------------------------------------------------------------------------
         // 出力バッファの初期化
         //--------------------------------------------------------------------------
@@ -375,7 +387,7 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
             if($is_sending !== true)
             {
                 $cnt = count($this->descriptors[$cid]['send_buffers']);
-                if($cnt > 0)
+                if($cnt === 1)
                 {
                     $buf = array_shift($this->descriptors[$cid]['send_buffers']);
                     $w_ret = $this->write($cid, $buf['data']);
@@ -384,6 +396,24 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
                         return false;
                     }
                 }
+                else
+                if($cnt > 1)
+                {
+                    // 溜まっている送信データはまとめて送信する（応答を待たないパイプライン送信。応答は送信順に recv で取得）
+                    $dat = '';
+                    foreach($this->descriptors[$cid]['send_buffers'] as $buf)
+                    {
+                        $dat .= pack('n', strlen($buf['data'])).$buf['data'];
+                    }
+                    $this->descriptors[$cid]['send_buffers'] = [];
+                    $this->descriptors[$cid]['sending_buffer']['size'] = strlen($dat);
+                    $this->descriptors[$cid]['sending_buffer']['data'] = $dat;
+                    $w_ret = $this->write($cid, null);
+                    if($w_ret === false)
+                    {
+                        return false;
+                    }
+                }
             }
             else
             {
@@ -546,6 +576,8 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
     /**
      * ソケット作成
      * 
+     * 同期クライアントのため接続と名前解決はブロックする（周期ドリブン処理の中からは SocketManager::connectAsync を使用する）
+     * 
      * @throws Exception エラー終了
      * @return bool true（成功） or false（失敗）
      */
@@ -556,6 +588,21 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
             throw new Exception(LogMessageEnum::FOR_TCP->message($this->lang));
         }
 
+        // プールに使用できる接続があれば再利用する
+        if($this->pool !== null)
+        {
+            $soc = $this->pool->checkout($this->host, $this->port);
+            if($soc !== null)
+            {
+                $w_ret = $this->createDescriptor($soc);
+                if($w_ret === false)
+                {
+                    throw new Exception(LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang));
+                }
+                return;
+            }
+        }
+
         // Create TCP/IP sream socket
         $w_ret = socket_create(AF_INET, SOCK_STREAM, SOL_TCP);
         if($w_ret === false)
@@ -578,6 +625,17 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
             throw new Exception(LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang));
         }
 
+        // ホスト名の解決（リトライのたびに socket_connect 内で問い合わせないよう一度だけ行う）
+        $addr = $this->host;
+        if(filter_var($addr, FILTER_VALIDATE_IP, FILTER_FLAG_IPV4) === false)
+        {
+            $addr = gethostbyname($this->host);
+            if($addr === $this->host)
+            {
+                throw new Exception(LogMessageEnum::HOST_RESOLVE_FAIL->message($this->lang)." ({$this->host})");
+            }
+        }
+
         // connect to port
         $max = $this->retry;
         if($max === 0)
@@ -586,7 +644,7 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
         }
         for($i = 0; $i < $max; )
         {
-            $w_ret = @socket_connect($soc, $this->host, $this->port);
+            $w_ret = @socket_connect($soc, $addr, $this->port);
             if($w_ret === true)
             {
                 break;
@@ -661,6 +719,8 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
     /**
      * ソケットクローズ
      * 
+     * コネクションプールが設定されている場合、送受信の途中でない接続はクローズせずにプールへ戻す
+     * 
      * @param string $p_cid 接続ID
      * @return bool true（成功） or false（失敗）
      */
@@ -675,6 +735,23 @@ final class SimpleSocketTcpClient implements ISimpleSocketTcpClient
         // ソケットリソースの取得
         $soc = $this->sockets[$p_cid];
 
+        // 再利用できる接続はプールへ戻す
+        $des = $this->descriptors[$p_cid];
+        if
+        (
+                $this->pool !== null
+            &&  $des['sending_buffer']['size'] === null
+            &&  count($des['send_buffers']) <= 0
+            &&  $des['receiving_buffer']['len'] <= 0
+            &&  $des['receiving_buffer']['receiving_size'] <= 0
+        )
+        {
+            $this->pool->checkin($this->host, $this->port, $soc);
+            unset($this->sockets[$p_cid]);
+            unset($this->descriptors[$p_cid]);
+            return true;
+        }
+
         // ソケットの読み込み／書き込みを停止
         @socket_shutdown($soc, 2);
 
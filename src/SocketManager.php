@@ -54,6 +54,18 @@ class SocketManager
      */
     private const SOCKET_ERROR_SENDING_WHILE_CONNECTED = 10057;
 
+    /**
+     * 接続の拒否
+     * （Connection refused）
+     */
+    private const SOCKET_ERROR_CONNECTION_REFUSED = 111;
+
+    /**
+     * UNIX ドメインの接続先が未準備
+     * （No such file or directory / Resource temporarily unavailable / Connection refused）
+     */
+    private const SOCKET_ERROR_UNIX_NOT_READY = [2, 11, 111];
+
 
     //--------------------------------------------------------------------------
     // 定数（その他）
@@ -69,11 +81,120 @@ class SocketManager
      */
     private const UDP_CONNECTION_IDENTIFY = '';
 
+    /**
+     * UNIX ドメインソケットのアドレス接頭辞
+     */
+    private const UNIX_ADDRESS_PREFIX = 'unix://';
+
+    /**
+     * UNIX ドメインソケットのアドレス長の上限（sun_path のサイズ）
+     */
+    private const UNIX_ADDRESS_MAX = 108;
+
     /**
      * インターバル間隔
      */
     private const INTERVAL_SPAN = 30000000;
 
+    /**
+     * ファイル送信時の読み込みサイズ（I/O ドライバが sendfile 非対応の場合）
+     */
+    private const SENDING_FILE_CHUNK_SIZE = 65536;
+
+    /**
+     * ソケットチューニングプロファイルのキー
+     */
+    private const SOCKET_PROFILE_KEYS = ['nodelay', 'sndbuf', 'rcvbuf', 'quickack', 'notsent_lowat', 'busy_poll', 'user_timeout', 'keepalive', 'keepidle', 'keepintvl', 'keepcnt'];
+
+    /**
+     * ホットリスタートの引き継ぎ要求の確認間隔（秒）
+     */
+    private const HOT_RESTART_CHECK_INTERVAL = 1;
+
+    /**
+     * コネクションマイグレーションの要求の確認間隔（ns）
+     */
+    private const MIGRATION_CHECK_INTERVAL = 100000000;
+
+    /**
+     * メトリクスページの接続の受け付け間隔（ns）
+     */
+    private const METRICS_CHECK_INTERVAL = 100000000;
+
+    /**
+     * メトリクスページの要求を受け付けてから応答し終えるまでの期限（ns。超えた接続は閉じる）
+     */
+    private const METRICS_TIMEOUT = 5000000000;
+
+    /**
+     * メトリクスページの同時接続数の上限
+     */
+    private const METRICS_MAX_CLIENTS = 4;
+
+    /**
+     * メトリクスページの要求行の最大長
+     */
+    private const METRICS_REQUEST_MAX = 8192;
+
+    /**
+     * メトリクスページに載せる I/O ドライバの値（getMetrics のキー => [メトリクス名, 種別, 説明]）
+     */
+    private const METRICS_DRIVER = [
+        'bytes_in' => ['socket_manager_driver_received_bytes_total', 'counter', 'Bytes received inside the I/O driver.'],
+        'bytes_out' => ['socket_manager_driver_sent_bytes_total', 'counter', 'Bytes sent from the I/O driver send queue.'],
+        'selects' => ['socket_manager_driver_selects_total', 'counter', 'Event waits performed by the I/O driver.'],
+        'events' => ['socket_manager_driver_events_total', 'counter', 'Events returned by the I/O driver.'],
+        'batch_full' => ['socket_manager_driver_full_batches_total', 'counter', 'Event waits that returned a full batch.'],
+        'accepts' => ['socket_manager_driver_accepts_total', 'counter', 'Connections accepted inside the I/O driver.'],
+        'fds' => ['socket_manager_driver_fds', 'gauge', 'Descriptors registered with the I/O driver.'],
+        'fd_capacity' => ['socket_manager_driver_fd_capacity', 'gauge', 'Size of the I/O driver descriptor table.'],
+        'listeners' => ['socket_manager_driver_listeners', 'gauge', 'Listening sockets registered with the I/O driver.'],
+        'send_segments' => ['socket_manager_driver_send_queue_segments', 'gauge', 'Segments waiting in the I/O driver send queues.'],
+        'send_bytes' => ['socket_manager_driver_send_queue_bytes', 'gauge', 'Bytes waiting in the I/O driver send queues.'],
+        'send_max' => ['socket_manager_driver_send_queue_max_bytes', 'gauge', 'Largest per-connection I/O driver send queue in bytes.'],
+        'zc_segments' => ['socket_manager_driver_zerocopy_pending_segments', 'gauge', 'Zero-copy segments waiting for completion.'],
+        'paused' => ['socket_manager_driver_paused_fds', 'gauge', 'Descriptors paused by the rate limiter.'],
+        'connecting' => ['socket_manager_driver_connecting_fds', 'gauge', 'Asynchronous connects waiting for completion.'],
+        'dns_queries' => ['socket_manager_driver_dns_queries', 'gauge', 'Outstanding DNS queries.'],
+        'dns_cache' => ['socket_manager_driver_dns_cache_entries', 'gauge', 'Entries in the DNS cache.']
+    ];
+
+    /**
+     * メトリクスページに載せる計測値（getStats のキー => [メトリクス名, 説明, 秒換算するか]）
+     */
+    private const METRICS_STATS = [
+        'cycle' => ['socket_manager_cycle_duration_seconds', 'Duration of one cycle-driven pass.', true],
+        'wait' => ['socket_manager_wait_duration_seconds', 'Time spent waiting for events.', true],
+        'events' => ['socket_manager_event_batch_size', 'Events returned per wait.', false],
+        'unit' => ['socket_manager_unit_duration_seconds', 'Duration of one UNIT execution.', true],
+        'dispatch' => ['socket_manager_dispatch_lag_seconds', 'Delay from event arrival to UNIT execution.', true]
+    ];
+
+    /**
+     * ソケットの引き継ぎで 1 メッセージに載せるソケット数（SCM_MAX_FD = 253 未満）
+     */
+    private const HANDOFF_BATCH = 200;
+
+    /**
+     * ソケットの引き継ぎの状態データの分割サイズ
+     */
+    private const HANDOFF_CHUNK = 32768;
+
+    /**
+     * ソケットの引き継ぎの送受信タイムアウト（秒）
+     */
+    private const HANDOFF_TIMEOUT = 10;
+
+    /**
+     * ソケットの引き継ぎの完了応答
+     */
+    private const HANDOFF_ACK = 'OK';
+
+    /**
+     * ソケットの引き継ぎで渡すディスクリプタのキー（受信／送信バッファは個別に扱う）
+     */
+    private const HANDOFF_STATE_KEYS = ['remote', 'udp_peers', 'send_buffers', 'receive_buffers', 'receive_buffer', 'send_buffer', 'close_buffer', 'protocol_names', 'command_names', 'last_access_timestamp', 'alive_adjust_timeout', 'forced_dispatcher', 'user_property'];
+
 
     //--------------------------------------------------------------------------
     // プロパティ
@@ -94,6 +215,11 @@ class SocketManager
      */
     private ?string $await_connection_id = null;
 
+    /**
+     * 待ち受け用ソケットに SO_REUSEPORT を設定する（forkWorkers の SO_REUSEPORT モードで使用）
+     */
+    private bool $listen_reuseport = false;
+
     /**
      * 受信サイズ（recvメソッドのデフォルト受信サイズ）
      */
@@ -133,7 +259,11 @@ class SocketManager
      *
      *		'data' => 受信データ（string）,
      *
-     *		'receiving_size' => 受信中のサイズ（int）
+     *		'receiving_size' => 受信中のサイズ（int）,
+     *
+     *		'store' => バッファリング受信ストア（?SocketsFd\Buffer）,
+     *
+     *		'frames' => 受信済みフレームのキュー（?\SplQueue：setFraming で設定。null はフレーミングなし）
      *
      * ]
      *
@@ -145,6 +275,8 @@ class SocketManager
      * 'sending_buffer' => [
      * 
      *		'data' => 送信データ（string）,
+     *		'file' => 送信ファイル（array：setSendingFile で設定）,
+     *		'queued' => I/O ドライバの送信キューに未送信分あり（bool）,
      *
      * ]
      *
@@ -169,7 +301,9 @@ class SocketManager
      * 
      *		'queue_name' => キュー名（string）,
      *
-     * 		'status_name' => ステータス名（string）
+     * 		'status_name' => ステータス名（string）,
+     *
+     * 		'unit_id' => コンパイル済みの UNIT ID（int。名前を変更した時は null に戻して次の実行時に引き直す）
      * 
      * ],
      *
@@ -180,7 +314,9 @@ class SocketManager
      * 
      *		'queue_name' => キュー名（string）,
      *
-     * 		'status_name' => ステータス名（string）
+     * 		'status_name' => ステータス名（string）,
+     *
+     * 		'unit_id' => コンパイル済みの UNIT ID（int。名前を変更した時は null に戻して次の実行時に引き直す）
      * 
      * ],
      *
@@ -212,6 +348,11 @@ class SocketManager
      */
     private $changed_descriptors = [];
 
+    /**
+     * 前回のSELECTでイベントがあった接続IDの集合（接続ID => true）
+     */
+    private array $selected_cids = [];
+
     /**
      * 周期ドリブンマネージャー（プロトコルUNIT用）
      */
@@ -286,6 +427,106 @@ class SocketManager
      */
     private IIoDriver $iio_driver;
 
+    /**
+     * バッファリング受信ストアに SocketsFd\Buffer を使うかどうか
+     * 
+     */
+    private bool $native_buffer = false;
+
+    /**
+     * MSG_ZEROCOPY で送信するデータサイズ（0 = 使わない）
+     * 
+     */
+    private int $zerocopy_threshold = 0;
+
+    /**
+     * ビジーポーリングモード（周期インターバルのスリープを行わない）
+     * 
+     */
+    private bool $busy_poll = false;
+
+    /**
+     * オフロード用ワーカープール（null = 未使用）
+     * 
+     */
+    private ?OffloadWorkerPool $offload_pool = null;
+
+    /**
+     * UNIX ドメインのデータグラム用ローカルアドレスの通番
+     */
+    private int $unix_sequence = 0;
+
+    /**
+     * ソケットチューニングプロファイル（'server' => 受け入れ側、'client' => connect 側）
+     * 
+     * 各要素は null or ['user' => 指定されたオプション配列, 'options' => キープアライブ設定を含めたオプション配列, 'native' => I/O ドライバで適用するか]
+     * 
+     */
+    private array $socket_profiles = ['server' => null, 'client' => null];
+
+    /**
+     * カーネルキープアライブのオプション配列（null = 使わない）
+     * 
+     * 有効な場合、TCP 接続の無通信によるアライブチェックは行わない（相手の消失はカーネルが検出する）
+     * 
+     */
+    private ?array $keepalive = null;
+
+    /**
+     * ホットリスタートの設定（null = 無効）
+     * 
+     * ['socket' => 引き継ぎ要求の待ち受けソケット（引き継ぎ後は null）, 'host' => 指定されたアドレス, 'address' => バインドしたアドレス,
+     *  'connections' => 接続も引き継ぐか, 'checked' => 最後に確認した日時, 'handed' => 引き継ぎ済みか]
+     * 
+     */
+    private ?array $hot_restart = null;
+
+    /**
+     * コネクションマイグレーションの設定（null = 無効）
+     * 
+     * ['socket' => 要求の待ち受けソケット, 'address' => バインドしたアドレス, 'checked' => 最後に確認した時刻（hrtime）]
+     * 
+     */
+    private ?array $migration = null;
+
+    /**
+     * 周期ドリブン処理 1 回の所要時間（μs。指数移動平均）
+     * 
+     */
+    private float $cycle_time = 0;
+
+    /**
+     * UNIT プロファイラー（null = 無効）
+     * 
+     */
+    private ?UnitProfiler $profiler = null;
+
+    /**
+     * ヒストグラムによる計測の設定（null = 無効）
+     * 
+     * ['interval' => ログの出力間隔（ns。0 は出力しない）, 'next' => 次の出力時刻（hrtime）]
+     * 
+     */
+    private ?array $stats = null;
+
+    /**
+     * メトリクスページの設定（null = 無効）
+     * 
+     * ['socket' => 待ち受けソケット, 'address' => UNIX ドメインでバインドしたアドレス（TCP は null）, 'checked' => 最後に確認した時刻（hrtime）,
+     * 'clients' => [['socket' => 接続, 'in' => 受信途中の要求, 'out' => 送信途中の応答（null は要求の受信中）, 'deadline' => 期限（hrtime）],...]]
+     * 
+     */
+    private ?array $metrics = null;
+
+    /**
+     * マネージャーの累積カウンタ（メトリクスページ用）
+     * 
+     * accepts（受け入れた接続数）、rejects（接続制限数で拒否した数）、closes（クローズした数）、
+     * bytes_in／bytes_out（PHP 側で送受信したバイト数。I/O ドライバ内で受信したデータの受け取りを含む）
+     * 
+     */
+    private array $counters = ['accepts' => 0, 'rejects' => 0, 'closes' => 0, 'bytes_in' => 0, 'bytes_out' => 0];
+
 
     //--------------------------------------------------------------------------
     // メソッド
@@ -358,6 +599,8 @@ class SocketManager
         //--------------------------------------------------------------------------
 
         $this->iio_driver = AdaptiveIoDriverFactory::create($this->sockets, $this, $this->receive_buffer_size);
+        $this->applyBusyPollMode();
+        $this->native_buffer = class_exists('SocketsFd\Buffer', false);
         $protocol = null;
         if(AdaptiveIoDriverFactory::$mode === AdaptiveIoDriverFactory::MODE_IO_NATIVE)
         {
@@ -437,100 +680,586 @@ class SocketManager
             $this->unit_parameter->setSocketManager($this);
             $this->unit_parameter->setLanguage($this->lang);
         }
+
+        // ソケットチューニングプロファイルの設定（任意実装）
+        if(method_exists($p_init, 'getSocketProfile'))
+        {
+            $w_ret = $p_init->getSocketProfile();
+            if($w_ret !== null)
+            {
+                foreach($w_ret as $kind => $profile)
+                {
+                    $this->setSocketProfile($kind, $profile);
+                }
+            }
+        }
     }
 
     /**
-     * IEntryUnitsによるUNIT登録（プロトコル用）
+     * ソケットチューニングプロファイルの設定
      * 
-     * @param IEntryUnits $p_entry IEntryUnitsのインスタンス
+     * 以降に登録されるソケットへ適用する。I/O ドライバが対応していれば登録時に C 側で適用され、
+     * 未対応なら socket_set_option で適用される（この場合 Linux 専用の項目は PHP 側の定数がある時のみ）
+     * 
+     * ※SO_RCVBUF はウィンドウスケールに影響するため、受け入れ側は listen ソケットにも適用する
+     * 
+     * @param string $p_kind 'server'（受け入れた接続） or 'client'（connect した接続）
+     * @param SocketProfileEnum|array|null $p_profile プロファイル or オプション配列 or null（解除）
+     * @return bool true（成功） or false（失敗）
      */
-    public function setProtocolUnits(IEntryUnits $p_entry)
+    public function setSocketProfile(string $p_kind, SocketProfileEnum|array|null $p_profile): bool
     {
-        // キューリストの取得
-        $ques = $p_entry->getQueueList();
+        if(!array_key_exists($p_kind, $this->socket_profiles))
+        {
+            return false;
+        }
 
-        foreach($ques as $que)
+        if($p_profile === null)
         {
-            // UNITリストの取得
-            $units = $p_entry->getUnitList($que);
-            foreach($units as $unit)
+            $this->updateSocketProfile($p_kind, null);
+            return true;
+        }
+
+        $options = $p_profile;
+        if($p_profile instanceof SocketProfileEnum)
+        {
+            $options = $p_profile->options();
+        }
+
+        // キーの検査
+        foreach($options as $key => $val)
+        {
+            if(!in_array($key, self::SOCKET_PROFILE_KEYS, true) || ($val !== null && !is_int($val) && !is_bool($val)))
             {
-                $this->cycle_driven_for_protocol->addStatusUnit($que, $unit['status'], $unit['unit']);
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang), 'kind' => $p_kind, 'option' => $key]);
+                return false;
             }
         }
+
+        $this->updateSocketProfile($p_kind, $options);
+
+        return true;
     }
 
     /**
-     * IEntryUnitsによるUNIT登録（コマンド用）
+     * カーネルキープアライブの設定
      * 
-     * @param IEntryUnits $p_entry IEntryUnitsのインスタンス
+     * 以降に登録される TCP 接続へ SO_KEEPALIVE／TCP_KEEPIDLE／TCP_KEEPINTVL／TCP_KEEPCNT／TCP_USER_TIMEOUT を設定する  
+     * 相手の消失はカーネルが検出してエラーイベント（ETIMEDOUT）として通知されるため、TCP 接続の無通信によるアライブチェック（ALIVE キューの自動開始）は行わなくなる  
+     * ping フレームが必要なプロトコルは aliveCheck() で ALIVE キューを開始できる（UDP は従来どおり）
+     * 
+     * @param int $p_idle 最初のプローブまでの無通信時間（秒。0 以下で解除）
+     * @param int $p_interval プローブ間隔（秒）
+     * @param int $p_count 切断と判定するまでのプローブ回数
+     * @param ?int $p_user_timeout 未応答の送信データを待つ時間（ms。null は $p_idle + $p_interval * $p_count 相当）
+     * @return bool true（成功） or false（失敗）
      */
-    public function setCommandUnits(IEntryUnits $p_entry)
+    public function setKeepAlive(int $p_idle, int $p_interval = 5, int $p_count = 3, ?int $p_user_timeout = null): bool
     {
-        // キューリストの取得
-        $ques = $p_entry->getQueueList();
-        foreach($ques as $que)
+        if($p_idle <= 0)
         {
-            // UNITリストの取得
-            $units = $p_entry->getUnitList($que);
-            foreach($units as $unit)
+            $this->keepalive = null;
+        }
+        else
+        {
+            if($p_interval <= 0 || $p_count <= 0 || ($p_user_timeout !== null && $p_user_timeout < 0))
             {
-                $this->cycle_driven_for_command->addStatusUnit($que, $unit['status'], $unit['unit']);
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang), 'interval' => $p_interval, 'count' => $p_count]);
+                return false;
             }
+
+            $this->keepalive = [
+                'keepalive' => true,
+                'keepidle' => $p_idle,
+                'keepintvl' => $p_interval,
+                'keepcnt' => $p_count,
+                'user_timeout' => $p_user_timeout ?? ($p_idle + $p_interval * $p_count) * 1000
+            ];
+        }
+
+        foreach($this->socket_profiles as $kind => $profile)
+        {
+            $this->updateSocketProfile($kind, $profile['user'] ?? null);
         }
+
+        return true;
     }
 
     /**
-     * 周期ドリブン処理の実行
+     * ソケットチューニングプロファイルの反映
      * 
-     * @param int $p_cycle_interval 周期インターバルタイム（マイクロ秒）
-     * @param int $p_alive_interval アライブチェックインターバルタイム（秒）
-     * @return bool true（成功） or false（失敗）
+     * 指定されたオプション配列へキープアライブ設定を重ねて I/O ドライバへ設定する
+     * 
+     * @param string $p_kind 'server' or 'client'
+     * @param ?array $p_options 指定されたオプション配列 or null
      */
-    public function cycleDriven(int $p_cycle_interval = 2000, int $p_alive_interval = 0): bool
+    private function updateSocketProfile(string $p_kind, ?array $p_options)
     {
-        // ソケットセレクト
-        $w_ret = $this->select();
+        $options = $p_options ?? [];
+        if($this->keepalive !== null)
+        {
+            $options = array_merge($options, $this->keepalive);
+        }
+
+        if(count($options) <= 0)
+        {
+            $this->socket_profiles[$p_kind] = null;
+            $this->iio_driver->setProfile($p_kind === 'client', null);
+            return;
+        }
+
+        $native = $this->iio_driver->setProfile($p_kind === 'client', $options);
+        $this->socket_profiles[$p_kind] = [
+            'user' => $p_options,
+            'options' => $options,
+            'native' => $native
+        ];
+    }
+
+    /**
+     * ゼロコピー送信の設定
+     * 
+     * 指定サイズ以上の送信データを MSG_ZEROCOPY で送信する（0 で無効。既定値）  
+     * カーネル内のコピーが省ける一方で完了通知の処理が増えるため、大きなブロードキャストや一括転送向け  
+     * ループバック等でカーネルがコピーに切り替えた接続は自動で通常送信に戻る
+     * 
+     * 損益分岐点は NIC とカーネルで変わるため既定では無効にしている  
+     * ffi/linux/bench/zerocopy.c を実際の送信先に向けて計測し、CPU 時間が send を下回るサイズを指定する（目安は 32KB 以上。16KB 未満は逆効果）
+     * 
+     * @param int $p_size 閾値（バイト）
+     * @return bool true（成功） or false（I/O ドライバが未対応）
+     */
+    public function setZeroCopyThreshold(int $p_size): bool
+    {
+        $w_ret = $this->iio_driver->setZeroCopy(max(0, $p_size));
         if($w_ret === false)
         {
+            $this->zerocopy_threshold = 0;
             return false;
         }
 
-        // 待ち受けポートを除く
-        $dess = $this->descriptors;
-        unset($dess[$this->await_connection_id]);
+        $this->zerocopy_threshold = max(0, $p_size);
 
-        if(count($dess) <= 0)
+        return true;
+    }
+
+    /**
+     * 名前解決の設定（connectAsync 用）
+     * 
+     * 問い合わせは周期ドリブン処理の中で送受信され、応答の TTL の間は結果がキャッシュされる  
+     * 解決できない名前は ENXIO、問い合わせ先が応答しない場合は ETIMEDOUT の接続失敗になる
+     * 
+     * @param ?string $p_server 問い合わせ先 IP アドレス or null（/etc/resolv.conf の nameserver）
+     * @param int $p_port 問い合わせ先ポート番号
+     * @param int $p_timeout 1 回の問い合わせの応答待ち（ms。0 は既定値の 1000）
+     * @param int $p_attempts 最大送信回数（0 は既定値の 3）
+     * @return bool true（成功） or false（I/O ドライバが未対応 or 失敗）
+     */
+    public function setResolver(?string $p_server = null, int $p_port = 53, int $p_timeout = 0, int $p_attempts = 0): bool
+    {
+        return $this->iio_driver->setResolver($p_server, $p_port, $p_timeout, $p_attempts);
+    }
+
+    /**
+     * ファクトリで指定されたビジーポーリングモードの適用
+     * 
+     * AdaptiveIoDriverFactory::setBusyPollMode の設定があれば生成した I/O ドライバへ反映する
+     */
+    private function applyBusyPollMode(): void
+    {
+        $mode = AdaptiveIoDriverFactory::$busy_poll;
+        if($mode === null)
         {
-            // 周期インターバル
-            usleep($p_cycle_interval);
-            $this->prev_microtime = hrtime(true);
-            return true;
+            return;
         }
 
-        // ディスクリプタでループ
-        foreach($dess as $cid => $des)
+        $w_ret = $this->setBusyPoll(true, $mode['usecs'], $mode['budget'], $mode['prefer'], $mode['cpus']);
+        if($w_ret === false)
         {
-            // SELECTイベントが入ったディスクリプタでループ
-            $flg_changed = false;
-            foreach($this->changed_descriptors as $chg)
-            {
-                // 接続IDが一致
-                if($cid === $chg['connection_id'])
-                {
-                    $flg_changed = true;
-                    break;
-                }
-            }
+            // 生成時はログライターが未登録のため起動メッセージと同じくコンソールへ出力する
+            printf("\033[1;33m%s\033[0m\n", LogMessageEnum::BUSY_POLL_UNSUPPORTED->message($this->lang));
+        }
+    }
 
-            // アライブチェックフラグ
-            $alive_check = 0;
+    /**
+     * ビジーポーリングモードの設定
+     * 
+     * AdaptiveIoDriverFactory::setBusyPollMode で生成時から有効にすることもできる
+     * 
+     * 有効にすると周期インターバルのスリープを行わず、epoll_wait を timeout 0 で回し続ける  
+     * 起床レイテンシが削れる代わりに CPU を 1 コア占有するため、専用コアへの固定（$p_cpus）と併用すること  
+     * 1 コアの環境では相手プロセスの実行を妨げて逆にテールレイテンシが悪化する
+     * 
+     * @param bool $p_enable 有効フラグ
+     * @param int $p_usecs カーネル側のビジーポーリング時間（μs。非対応のカーネルでは無視）
+     * @param int $p_budget カーネル側の 1 回あたりの処理パケット数
+     * @param bool $p_prefer SO_PREFER_BUSY_POLL フラグ（以降に登録するソケットへ適用）
+     * @param ?array $p_cpus 固定する CPU 番号リスト（null は固定しない）
+     * @return bool true（成功） or false（I/O ドライバが未対応 or 失敗）
+     */
+    public function setBusyPoll(bool $p_enable, int $p_usecs = 50, int $p_budget = 8, bool $p_prefer = true, ?array $p_cpus = null): bool
+    {
+        $w_ret = $this->iio_driver->setBusyPoll($p_enable, max(0, $p_usecs), max(0, $p_budget), $p_prefer, $p_cpus);
+        if($w_ret === false)
+        {
+            $this->busy_poll = false;
+            return false;
+        }
 
-            // プロトコルUNITが処理中ではない
-            $flg_exec = $this->isExecutingSequence('protocol_names', $cid);
-            if($flg_exec === false)
-            {
-                // SELECTイベント対象のディスクリプタ
+        $this->busy_poll = $p_enable;
+
+        return true;
+    }
+
+    /**
+     * オフロード用ワーカープールの設定
+     * 
+     * 子プロセスを生成していなければ生成する（子プロセスはその時点のソケットを引き継ぐため、listen／connect の前に呼び出す）  
+     * 完了したジョブの結果は周期ドリブン処理の中で依頼元の接続へ戻される（offload を参照）
+     * 
+     * @param ?OffloadWorkerPool $p_pool ワーカープール（null は解除。子プロセスは終了しない）
+     * @return bool true（成功） or false（子プロセスの生成に失敗）
+     */
+    public function setOffloadPool(?OffloadWorkerPool $p_pool): bool
+    {
+        if($p_pool !== null && $p_pool->start() === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::OFFLOAD_UNSUPPORTED->message($this->lang)]);
+            return false;
+        }
+
+        $this->offload_pool = $p_pool;
+
+        return true;
+    }
+
+    /**
+     * UNIT プロファイラーの設定
+     * 
+     * UNIT の実行とコマンドディスパッチャーの呼び出しをサンプリングで計測し、出力間隔ごとに集計表をログ（info）へ出力する
+     * 
+     * @param ?UnitProfiler $p_profiler プロファイラー（null は解除）
+     */
+    public function setProfiler(?UnitProfiler $p_profiler)
+    {
+        $this->profiler = $p_profiler;
+    }
+
+    /**
+     * ヒストグラムによる計測の設定
+     * 
+     * I/O ドライバ（C）のヒストグラムへ次の値を記録し、出力間隔ごとに百分位をログ（info）へ 1 行で出力する  
+     * cycle（周期ドリブン処理 1 回）、wait（waitEvents 内の待機）、events（1 回のイベント数）、unit（UNIT 1 回）、dispatch（イベントを受け取ってから UNIT を実行するまで）
+     * 
+     * ログを出力した時点で計測値はクリアされる（getStats は前回の出力以降の値になる）
+     * 
+     * @param bool $p_enable true（開始） or false（終了）
+     * @param int $p_interval ログの出力間隔（秒。0 は出力しない）
+     * @return bool true（成功） or false（I/O ドライバが未対応）
+     */
+    public function setStats(bool $p_enable, int $p_interval = 60): bool
+    {
+        $w_ret = $this->iio_driver->setStats($p_enable);
+        if($p_enable === false || $w_ret === false)
+        {
+            $this->stats = null;
+            if($p_enable === true)
+            {
+                $this->logWriter('warning', [__METHOD__ => LogMessageEnum::STATS_UNSUPPORTED->message($this->lang)]);
+            }
+            return $w_ret;
+        }
+
+        $interval = max(0, $p_interval) * 1000000000;
+        $this->stats = [
+            'interval' => $interval,
+            'next' => hrtime(true) + $interval
+        ];
+
+        return true;
+    }
+
+    /**
+     * 計測値の取得
+     * 
+     * @param bool $p_reset 取得後に計測値をクリアする
+     * @return array|false 計測対象名（cycle／wait／events／unit／dispatch） => ['count', 'min', 'max', 'mean', 'p50', 'p90', 'p99', 'p999']（時間は ns） or false（計測していない）
+     */
+    public function getStats(bool $p_reset = false): array|false
+    {
+        if($this->stats === null)
+        {
+            return false;
+        }
+
+        $w_ret = $this->iio_driver->getStats($p_reset);
+        if($w_ret === null)
+        {
+            return false;
+        }
+
+        return $w_ret;
+    }
+
+    /**
+     * メトリクスページの設定
+     * 
+     * 指定したアドレスで Prometheus のテキスト形式のメトリクスページを提供する  
+     * 接続の状態別の数、受け入れ／クローズ数と送受信バイト数の累積値、送受信バッファスタックの深さ、I/O ドライバのカウンタと現在値、
+     * setStats が有効なら周期ドリブン処理の所要時間等の百分位（前回のログ出力以降の値）を返す
+     * 
+     * 接続の受け付けは周期ドリブン処理の中で 100ms に 1 回行い、要求の受信と応答の送信はノンブロッキングで周期をまたいで進める  
+     * 外部へ公開しないよう、TCP の場合はループバックのアドレスを指定すること  
+     * forkWorkers の前に設定した場合は親プロセスだけが提供する（値はプロセスごとのため、子プロセスは引き継いだ待ち受けを閉じる）
+     * 
+     * @param ?string $p_host 'unix:///path' or 'unix://@name'（抽象名前空間） or ホスト名（null は停止）
+     * @param int $p_port ポート番号（UNIX ドメインの場合は無視）
+     * @return bool true（成功） or false（失敗）
+     */
+    public function setMetrics(?string $p_host, int $p_port = 0): bool
+    {
+        // 設定済みの待ち受けを閉じる
+        if($this->metrics !== null)
+        {
+            foreach($this->metrics['clients'] as $cli)
+            {
+                @socket_close($cli['socket']);
+            }
+            @socket_close($this->metrics['socket']);
+            if($this->metrics['address'] !== null)
+            {
+                $this->unlinkUnixAddress($this->metrics['address']);
+            }
+            $this->metrics = null;
+        }
+        if($p_host === null)
+        {
+            return true;
+        }
+
+        $unix = $this->unixAddress($p_host);
+        if($unix === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::UNIX_ADDRESS_INVALID->message($this->lang), 'host' => $p_host]);
+            return false;
+        }
+
+        $w_ret = socket_create($unix !== null ? AF_UNIX : AF_INET, SOCK_STREAM, $unix !== null ? 0 : SOL_TCP);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+            return false;
+        }
+        $soc = $w_ret;
+
+        if($unix !== null)
+        {
+            $w_ret = $this->bindUnix($soc, $unix);
+        }
+        else
+        {
+            socket_set_option($soc, SOL_SOCKET, SO_REUSEADDR, 1);
+            $w_ret = socket_bind($soc, $p_host, $p_port);
+        }
+        if($w_ret === false)
+        {
+            // 使用中のパスは他のプロセスのものなので削除しない
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            socket_close($soc);
+            return false;
+        }
+        $w_ret = socket_listen($soc, 8);
+        if($w_ret === false)
+        {
+            // バインドしたのはこのプロセスなのでパスを削除する
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            socket_close($soc);
+            if($unix !== null)
+            {
+                $this->unlinkUnixAddress($unix);
+            }
+            return false;
+        }
+        socket_set_nonblock($soc);
+
+        $this->metrics = [
+            'socket' => $soc,
+            'address' => $unix,
+            'checked' => 0,
+            'clients' => []
+        ];
+
+        return true;
+    }
+
+    /**
+     * ジョブのオフロード
+     * 
+     * 登録済みの処理を子プロセスで実行し、周期ドリブン処理を止めないようにする  
+     * 結果は ['id' => ジョブID, 'name' => 処理名, 'result' => 処理の戻り値, 'error' => null（成功） or エラー内容] の配列で戻される
+     * 
+     * ・$p_queue の指定なし：結果を受信データスタックへ積む（コマンドディスパッチャーへ通常の受信データとして渡る）  
+     * ・$p_queue の指定あり：コマンドUNITが実行中でなくなった時点でそのキュー（$p_status のステータス）を開始し、結果を getRecvData で受け取る
+     * 
+     * @param string $p_cid 依頼元の接続ID
+     * @param string $p_name 処理名（OffloadWorkerPool::register で登録した名前）
+     * @param mixed $p_payload ペイロード（serialize できる値）
+     * @param ?string $p_queue 完了時に開始するコマンドUNITのキュー名
+     * @param ?string $p_status 完了時に開始するステータス名（null は START）
+     * @return int|false ジョブID or false（失敗）
+     */
+    public function offload(string $p_cid, string $p_name, $p_payload, ?string $p_queue = null, ?string $p_status = null): int|false
+    {
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+        if($this->offload_pool === null)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::OFFLOAD_UNSUPPORTED->message($this->lang), 'cid' => $p_cid]);
+            return false;
+        }
+
+        $w_ret = $this->offload_pool->submit($p_cid, $p_name, $p_payload, ['queue' => $p_queue, 'status' => $p_status]);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::OFFLOAD_FAIL->message($this->lang), 'cid' => $p_cid, 'name' => $p_name]);
+            return false;
+        }
+        $this->descriptors[$p_cid]['offload_jobs']++;
+
+        return $w_ret;
+    }
+
+    /**
+     * IEntryUnitsによるUNIT登録（プロトコル用）
+     * 
+     * @param IEntryUnits $p_entry IEntryUnitsのインスタンス
+     */
+    public function setProtocolUnits(IEntryUnits $p_entry)
+    {
+        // キューリストの取得
+        $ques = $p_entry->getQueueList();
+
+        foreach($ques as $que)
+        {
+            // UNITリストの取得
+            $units = $p_entry->getUnitList($que);
+            foreach($units as $unit)
+            {
+                if(($unit['fiber'] ?? false) === true)
+                {
+                    $this->cycle_driven_for_protocol->addFiberUnit($que, $unit['status'], $unit['unit']);
+                    continue;
+                }
+                $this->cycle_driven_for_protocol->addStatusUnit($que, $unit['status'], $unit['unit']);
+            }
+        }
+
+        // UNIT ID による実行テーブルの構築
+        $this->cycle_driven_for_protocol->compile();
+    }
+
+    /**
+     * IEntryUnitsによるUNIT登録（コマンド用）
+     * 
+     * @param IEntryUnits $p_entry IEntryUnitsのインスタンス
+     */
+    public function setCommandUnits(IEntryUnits $p_entry)
+    {
+        // キューリストの取得
+        $ques = $p_entry->getQueueList();
+        foreach($ques as $que)
+        {
+            // UNITリストの取得
+            $units = $p_entry->getUnitList($que);
+            foreach($units as $unit)
+            {
+                if(($unit['fiber'] ?? false) === true)
+                {
+                    $this->cycle_driven_for_command->addFiberUnit($que, $unit['status'], $unit['unit']);
+                    continue;
+                }
+                $this->cycle_driven_for_command->addStatusUnit($que, $unit['status'], $unit['unit']);
+            }
+        }
+
+        // UNIT ID による実行テーブルの構築
+        $this->cycle_driven_for_command->compile();
+    }
+
+    /**
+     * 周期ドリブン処理の実行
+     * 
+     * @param int $p_cycle_interval 周期インターバルタイム（マイクロ秒）
+     * @param int $p_alive_interval アライブチェックインターバルタイム（秒）
+     * @return bool true（成功） or false（失敗）
+     */
+    public function cycleDriven(int $p_cycle_interval = 2000, int $p_alive_interval = 0): bool
+    {
+        // ホットリスタートの引き継ぎ要求の確認
+        $this->pollHotRestart();
+
+        // コネクションマイグレーションの要求の確認
+        $this->pollMigration();
+
+        // メトリクスページの要求の確認
+        $this->pollMetrics();
+        $cycle_start = hrtime(true);
+        if($this->stats !== null)
+        {
+            $this->iio_driver->statsBegin(IIoDriver::STATS_CYCLE);
+        }
+
+        // ソケットセレクト
+        $w_ret = $this->select();
+        if($w_ret === false)
+        {
+            return false;
+        }
+
+        // オフロードしたジョブの結果の回収
+        $this->pollOffload();
+
+        // 受信イベントとタイマーから今回の周期で再開する Fiber を決める
+        $this->cycle_driven_for_protocol->prepareFibers($this->selected_cids);
+        $this->cycle_driven_for_command->prepareFibers($this->selected_cids);
+
+        // 待ち受けポートを除く
+        $dess = $this->descriptors;
+        unset($dess[$this->await_connection_id]);
+
+        if(count($dess) <= 0)
+        {
+            // 周期インターバル（ビジーポーリング中は行わない）
+            if($this->busy_poll === false)
+            {
+                usleep($p_cycle_interval);
+            }
+            $this->prev_microtime = hrtime(true);
+            return true;
+        }
+
+        // ディスクリプタでループ
+        foreach($dess as $cid => $des)
+        {
+            // 非同期接続中（接続イベント待ち）
+            if($des['connecting'] === true)
+            {
+                continue;
+            }
+
+            // SELECTイベントが入ったディスクリプタ
+            $flg_changed = isset($this->selected_cids[$cid]);
+
+            // アライブチェックフラグ
+            $alive_check = 0;
+
+            // プロトコルUNITが処理中ではない
+            $flg_exec = $this->isExecutingSequence('protocol_names', $cid);
+            if($flg_exec === false)
+            {
+                // SELECTイベント対象のディスクリプタ
                 if($flg_changed === true)
                 {
                     // データ受信時のキューを実行する
@@ -566,9 +1295,11 @@ class SocketManager
                     else
                     {
                         // インターバル指定あり、かつアライブキューが存在する
+                        // （カーネルキープアライブ使用中の TCP 接続は除く）
                         if
                         (
                                 $p_alive_interval > 0
+                            &&  ($this->keepalive === null || $des['udp'] !== false)
                             &&  $this->cycle_driven_for_protocol->isSetQueue(ProtocolQueueEnum::ALIVE->value, StatusEnum::START->value) === true
                         )
                         {
@@ -587,13 +1318,17 @@ class SocketManager
                 }
             }
 
-            // 最終アクセスタイムスタンプを取得
-            $w_ret = $this->getProperties($cid, ['last_access_timestamp']);
-            if($w_ret === false)
+            // 最終アクセスタイムスタンプを取得（タイムアウト判定がある時のみ）
+            $timestamp = null;
+            if($alive_check !== 0 || ($flg_exec === true && $p_alive_interval > 0))
             {
-                return false;
+                $w_ret = $this->getProperties($cid, ['last_access_timestamp']);
+                if($w_ret === false)
+                {
+                    return false;
+                }
+                $timestamp = $w_ret['last_access_timestamp'];
             }
-            $timestamp = $w_ret['last_access_timestamp'];
 
             // UNITパラメータへ接続IDを設定
             $this->unit_parameter->setConnectionId($des['connection_id']);
@@ -692,6 +1427,12 @@ class SocketManager
                 }
             }
 
+            // イベントを受け取ってから UNIT を実行するまでの遅延
+            if($flg_changed === true && $this->stats !== null)
+            {
+                $this->iio_driver->statsEnd(IIoDriver::STATS_DISPATCH);
+            }
+
             // プロトコルUNITの実行
             $w_ret = $this->executeUnit($cid, 'protocol_names');
             if($w_ret === false)
@@ -699,6 +1440,19 @@ class SocketManager
                 continue;
             }
 
+            // オフロードしたジョブの完了によるキューの開始
+            if(count($this->descriptors[$cid]['offload_callbacks']) > 0 && $this->descriptors[$cid]['command_names']['queue_name'] === null)
+            {
+                $job = array_shift($this->descriptors[$cid]['offload_callbacks']);
+                $this->setProperties($cid, ['receive_buffer' => $job['data']]);
+                $this->setQueueNameForStart('command_names', $cid, $job['queue']);
+                if($job['status'] !== null)
+                {
+                    $this->descriptors[$cid]['command_names']['status_name'] = $job['status'];
+                    $this->descriptors[$cid]['command_names']['unit_id'] = null;
+                }
+            }
+
             // コマンドディスパッチャーの処理
             if($this->command_dispatcher !== null)
             {
@@ -724,6 +1478,12 @@ class SocketManager
                         // コマンドディスパッチャーのコール
                         $fnc = $this->command_dispatcher;
                         $w_ret = false;
+                        $prof = $this->profiler !== null && $this->profiler->sample();
+                        if($prof === true)
+                        {
+                            $prof_mem = memory_get_usage();
+                            $prof_start = hrtime(true);
+                        }
                         try
                         {
                             $w_ret = $fnc($this->unit_parameter, $dat);
@@ -750,6 +1510,10 @@ class SocketManager
                             $this->shutdown($cid);	// ソケット緊急切断
                             continue;
                         }
+                        if($prof === true)
+                        {
+                            $this->profiler->record('dispatcher', $w_ret, null, hrtime(true) - $prof_start, memory_get_usage() - $prof_mem);
+                        }
                         if($w_ret !== null)
                         {
                             $this->setQueueNameForStart('command_names', $cid, $w_ret);
@@ -769,19 +1533,46 @@ class SocketManager
             $now_microtime = hrtime(true);
             if(($now_microtime - $this->prev_microtime) >= self::INTERVAL_SPAN)
             {
-                // 周期インターバル
-                usleep($p_cycle_interval);
+                // 周期インターバル（ビジーポーリング中は行わない）
+                if($this->busy_poll === false)
+                {
+                    usleep($p_cycle_interval);
+                }
                 $this->prev_microtime = $now_microtime;
             }
         }
 
-        return true;
-    }
+        // 所要時間の指数移動平均（負荷情報として SocketMigrationCoordinator へ返す）
+        $this->cycle_time += (((hrtime(true) - $cycle_start) / 1000) - $this->cycle_time) / 8;
 
-    /**
-     * 全接続IDを取得
-     * 
-     * @param ?string $p_cid 除外する接続ID
+        // ヒストグラムの記録と出力
+        if($this->stats !== null)
+        {
+            $this->iio_driver->statsEnd(IIoDriver::STATS_CYCLE);
+            if($this->stats['interval'] > 0 && hrtime(true) >= $this->stats['next'])
+            {
+                $this->stats['next'] = hrtime(true) + $this->stats['interval'];
+                $this->reportStats();
+            }
+        }
+
+        // UNIT プロファイラーの集計表の出力
+        if($this->profiler !== null && $this->profiler->isDue())
+        {
+            $this->logWriter('info', [__METHOD__ => LogMessageEnum::PROFILE_REPORT->message($this->lang), 'table' => $this->profiler->formatTable()]);
+            if($this->profiler->flush() === false)
+            {
+                $this->logWriter('warning', [__METHOD__ => LogMessageEnum::PROFILE_WRITE_FAIL->message($this->lang)]);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * 全接続IDを取得
+     * 
+     * @param ?string $p_cid 除外する接続ID
      * @return array 接続IDのリスト
      */
     public function getConnectionIdAll(?string $p_cid = null): array
@@ -841,6 +1632,7 @@ class SocketManager
     public function setStatusName(string $p_kind, string $p_cid, ?string $p_name)
     {
         $this->descriptors[$p_cid][$p_kind]['status_name'] = $p_name;
+        $this->descriptors[$p_cid][$p_kind]['unit_id'] = null;
         return;
     }
 
@@ -1188,6 +1980,7 @@ class SocketManager
         // 切断シーケンスを実行
         $this->descriptors[$p_cid]['protocol_names']['queue_name'] = ProtocolQueueEnum::CLOSE->value;
         $this->descriptors[$p_cid]['protocol_names']['status_name'] = StatusEnum::START->value;
+        $this->descriptors[$p_cid]['protocol_names']['unit_id'] = null;
 
         // プロトコルUNIT実行中は例外を投げて中断する
         $w_ret = $this->unit_parameter->getKindString();
@@ -1222,6 +2015,12 @@ class SocketManager
     /**
      * ソケット接続
      * 
+     * ホスト名に 'unix:///path' / 'unix://@name'（抽象名前空間）を指定すると UNIX ドメインで接続します（ポート番号は無視）  
+     * 待ち受け側が未起動の間はリトライします
+     * 
+     * 接続とホスト名の解決は socket_connect / socket_sendto 内でブロックします  
+     * 周期ドリブン処理を止めずに接続する場合は connectAsync を使用してください（名前解決も I/O ドライバ内で非同期に行います）
+     * 
      * @param string $p_host ホスト名
      * @param int $p_port ポート番号
      * @param bool $p_udp UDPフラグ true（UDP） or false（TCP）
@@ -1237,9 +2036,18 @@ class SocketManager
             return false;
         }
 
+        // UNIX ドメイン（'unix:///path' or 'unix://@name'）の判定
+        $unix = $this->unixAddress($p_host);
+        if($unix === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::UNIX_ADDRESS_INVALID->message($this->lang), 'host' => $p_host]);
+            return false;
+        }
+
         // ソケットタイプ、プロトコルの設定
         $from = '';
         $port = 0;
+        $domain = AF_INET;
         $type = SOCK_DGRAM;
         $protocol = SOL_UDP;
         if($p_udp !== true)
@@ -1247,9 +2055,14 @@ class SocketManager
             $type = SOCK_STREAM;
             $protocol = SOL_TCP;
         }
+        if($unix !== null)
+        {
+            $domain = AF_UNIX;
+            $protocol = 0;
+        }
 
         // Create TCP/IP sream socket
-        $w_ret = socket_create(AF_INET, $type, $protocol);
+        $w_ret = socket_create($domain, $type, $protocol);
         if($w_ret === false)
         {
             $this->logWriter('error', [__METHOD__ => 'socket_create', 'message' => LogMessageEnum::SOCKET_ERROR->socket()]);
@@ -1257,6 +2070,19 @@ class SocketManager
         }
         $soc = $w_ret;
 
+        // UNIX ドメインのデータグラムは応答を受け取るためのアドレスへバインドしておく
+        $local = null;
+        if($unix !== null && $p_udp === true)
+        {
+            $local = $this->createUnixLocalAddress($unix);
+            $w_ret = $this->bindUnix($soc, $local);
+            if($w_ret === false)
+            {
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+                return false;
+            }
+        }
+
         // connect to port
         $max = $p_retry;
         if($p_retry === 0)
@@ -1265,6 +2091,20 @@ class SocketManager
         }
         for($i = 0; $i < $max; )
         {
+            if($p_udp === true && $unix !== null)
+            {
+                $w_ret = $this->identifyUnixDatagram($soc, $unix, $local, $from);
+                if($w_ret === false)
+                {
+                    $this->unlinkUnixAddress($local);
+                    return false;
+                }
+                if($w_ret === true)
+                {
+                    break;
+                }
+            }
+            else
             if($p_udp === true)
             {
                 if(AdaptiveIoDriverFactory::$mode === AdaptiveIoDriverFactory::MODE_IO_NATIVE && PHP_OS_FAMILY === 'Windows')
@@ -1341,10 +2181,23 @@ class SocketManager
 
                 try
                 {
-                    $w_ret = socket_connect($soc, $p_host, $p_port);
+                    if($unix !== null)
+                    {
+                        $w_ret = @socket_connect($soc, $unix);
+                    }
+                    else
+                    {
+                        $w_ret = socket_connect($soc, $p_host, $p_port);
+                    }
                     if($w_ret === false)
                     {
                         $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
+                        if($unix !== null && in_array($w_ret['code'], self::SOCKET_ERROR_UNIX_NOT_READY, true))
+                        {
+                            // 待ち受け側が未起動 or backlog が一杯
+                            socket_clear_error($soc);
+                            throw new \Exception($w_ret['message'], $w_ret['code']);
+                        }
                         if($w_ret['code'] !== self::SOCKET_ERROR_CONNECT_PROGRESS && $w_ret['code'] !== self::SOCKET_ERROR_COULDNT_COMPLETED)
                         {
                             $this->logWriter('error', [__METHOD__ => 'socket_connect', 'message' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
@@ -1366,11 +2219,15 @@ class SocketManager
         }
         if($i >= $max)
         {
+            if($local !== null)
+            {
+                $this->unlinkUnixAddress($local);
+            }
             return false;
         }
 
         // ソケットディスクリプタの生成
-        $w_ret = $this->createDescriptor($soc, $p_udp);
+        $w_ret = $this->createDescriptor($soc, $p_udp, false, true);
         if($w_ret === false)
         {
             $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
@@ -1378,6 +2235,7 @@ class SocketManager
         }
         $des = $w_ret;
         $this->setProperties($des['connection_id'], ['remote' => ['host' => $p_host, 'port' => $p_port]]);
+        $this->descriptors[$des['connection_id']]['unix_address'] = $local;
 
         // キューの設定がない場合は抜ける
         $w_ret = $this->cycle_driven_for_protocol->isSetQueue(ProtocolQueueEnum::CONNECT->value, StatusEnum::START->value);
@@ -1410,1604 +2268,4098 @@ class SocketManager
     }
 
     /**
-     * ソケットリッスン（TCP用）
+     * ソケット接続（非同期）
      * 
-     * 引数のホスト名とポート番号の指定があれば、コンストラクタで設定された内容より優先されます
+     * 接続の完了を待たずに戻る。確立すると CONNECT キューが開始され、失敗した場合はログ出力後に切断される
      * 
-     * @param ?string $p_host ホスト名
-     * @param ?int $p_port ポート番号
-     * @return bool true（成功） or false（失敗）
+     * ホスト名は I/O ドライバ内の DNS クライアントで解決され、TTL の間はキャッシュされる（setResolver で問い合わせ先を変更できる）
+     * 
+     * 'unix:///path' / 'unix://@name'（抽象名前空間）を指定すると UNIX ドメインのストリームで接続する（ポート番号は 0）
+     * 
+     * 周期ドリブン処理を止めないため、リトライは行わない（必要な場合は CONNECT キューを監視して再度呼び出す）
+     * 
+     * I/O ドライバが未対応の場合（拡張モジュール未使用時）は失敗するので connect() を使用する
+     * 
+     * @param string $p_host ホスト名
+     * @param int $p_port ポート番号
+     * @param int $p_timeout 接続タイムアウト（ms。名前解決を含む。0 はカーネルの既定）
+     * @return string|false 接続ID or false（失敗）
      */
-    public function listen(?string $p_host = null, ?int $p_port = null): bool
+    public function connectAsync(string $p_host, int $p_port, int $p_timeout = 5000): string|false
     {
-        //--------------------------------------------------------------------------
-        // プロパティの設定
-        //--------------------------------------------------------------------------
-        if($p_host !== null)
-        {
-            $this->await_host = $p_host;
-        }
-        if($p_port !== null)
+        // 接続開始（ソケットは I/O ドライバへ登録済みで返る。ホスト名の解決もドライバ内で非同期に行う）
+        $w_ret = $this->iio_driver->connect($p_host, $p_port, $p_timeout);
+        if($w_ret === null)
         {
-            $this->await_port = $p_port;
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::CONNECT_ASYNC_UNSUPPORTED->message($this->lang)]);
+            return false;
         }
-
-        //--------------------------------------------------------------------------
-        // ソケットの初期化
-        //--------------------------------------------------------------------------
-
-        // Create TCP/IP sream socket
-        $w_ret = socket_create(AF_INET, SOCK_STREAM, SOL_TCP);
         if($w_ret === false)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::CONNECT_ASYNC_FAIL->message($this->lang), 'host' => $p_host, 'port' => $p_port]);
             return false;
         }
         $soc = $w_ret;
 
-        // reuseable port
-        $w_ret = socket_set_option($soc, SOL_SOCKET, SO_REUSEADDR, 1);
+        // ソケットディスクリプタの生成
+        $w_ret = $this->createDescriptor($soc, false, false, true);
         if($w_ret === false)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang)]);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
             return false;
         }
+        $des = $w_ret;
+        $this->setProperties($des['connection_id'], ['remote' => ['host' => $p_host, 'port' => $p_port]]);
+        $this->descriptors[$des['connection_id']]['connecting'] = true;
 
-        // bind socket to specified host
-        $w_ret = socket_bind($soc, $this->await_host, $this->await_port);
-        if($w_ret === false)
+        return $des['connection_id'];
+    }
+
+    /**
+     * 共有メモリIPCチャネルのオープン
+     * 
+     * 同じホスト上のフレームワークプロセス間で共有メモリのリングを使い、擬似的な接続IDとして扱えるようにする  
+     * 返した接続IDには通常の接続と同じく setSendStack 等で送信でき、受信データはプロトコルUNITで処理される
+     * 
+     * 片方のプロセスが $p_owner = true で作成し、もう一方が false で参加する（作成前の参加は失敗する）  
+     * 連続した送受信ではシステムコールが発生せず、相手のクローズは切断として通知される
+     * 
+     * I/O ドライバが未対応の場合（拡張モジュール未使用時）は失敗する
+     * 
+     * @param string $p_name チャネル名（英数字と . _ - の 64 文字まで）
+     * @param bool $p_owner 作成側フラグ
+     * @param int $p_capacity 方向ごとのリング容量（作成側のみ。0 は 1MB）
+     * @return string|false 接続ID or false（失敗）
+     */
+    public function openIpcChannel(string $p_name, bool $p_owner, int $p_capacity = 0): string|false
+    {
+        // チャネルのオープン（呼び鈴のソケットは I/O ドライバへ登録済みで返る）
+        $w_ret = $this->iio_driver->openIpc($p_name, $p_owner, $p_capacity);
+        if($w_ret === null)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::IPC_UNSUPPORTED->message($this->lang)]);
             return false;
         }
-
-        // listen to port
-        $w_ret = socket_listen($soc, 8192);
         if($w_ret === false)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::IPC_OPEN_FAIL->message($this->lang), 'name' => $p_name, 'owner' => $p_owner]);
             return false;
         }
+        $soc = $w_ret;
 
         // ソケットディスクリプタの生成
-        $w_ret = $this->createDescriptor($soc, false, true);
+        $w_ret = $this->createDescriptor($soc, false, false, !$p_owner);
         if($w_ret === false)
         {
             $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
             return false;
         }
         $des = $w_ret;
+        $this->setProperties($des['connection_id'], ['remote' => ['host' => 'ipc://'.$p_name, 'port' => 0]]);
+        $this->descriptors[$des['connection_id']]['ipc'] = true;
 
-        // 待ち受けソケットの接続IDの設定
-        $this->await_connection_id = $des['connection_id'];
-
-        return true;
+        return $des['connection_id'];
     }
 
     /**
-     * ソケットバインド（UDP用）
+     * ホットリスタートの有効化（旧プロセス側）
      * 
-     * 引数のホスト名とポート番号の指定があれば、コンストラクタで設定された内容より優先されます
+     * 指定した UNIX ドメインのアドレス（SOCK_SEQPACKET）で後継プロセスからの引き継ぎ要求を待つ  
+     * 要求が届くと待ち受けソケットと（$p_connections = true なら）確立済みの接続を SCM_RIGHTS で渡し、ディスクリプタの状態も送る  
+     * 渡したソケットは shutdown せずに手放し、残った接続の処理を続ける（isHotRestartDrained で終了を判定する）
      * 
-     * @param ?string $p_host ホスト名
-     * @param ?int $p_port ポート番号
+     * 要求の確認は周期ドリブン処理の中で 1 秒に 1 回行う。Linux のみ対応
+     * 
+     * @param string $p_host 'unix:///path' or 'unix://@name'（抽象名前空間）
+     * @param bool $p_connections 確立済みの接続も引き継ぐか
      * @return bool true（成功） or false（失敗）
      */
-    public function bind(?string $p_host = null, ?int $p_port = null): bool
+    public function enableHotRestart(string $p_host, bool $p_connections = false): bool
     {
-        //--------------------------------------------------------------------------
-        // プロパティの設定
-        //--------------------------------------------------------------------------
-        if($p_host !== null)
-        {
-            $this->await_host = $p_host;
-        }
-        if($p_port !== null)
+        if(PHP_OS_FAMILY === 'Windows')
         {
-            $this->await_port = $p_port;
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::HOT_RESTART_UNSUPPORTED->message($this->lang)]);
+            return false;
         }
 
-        // Create TCP/IP sream socket
-        $w_ret = socket_create(AF_INET, SOCK_DGRAM, SOL_UDP);
+        $unix = null;
+        $w_ret = $this->createControlListener($p_host, $unix);
         if($w_ret === false)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
             return false;
         }
-        $soc = $w_ret;
 
-        // reuseable port
-        $w_ret = socket_set_option($soc, SOL_SOCKET, SO_REUSEADDR, 1);
-        if($w_ret === false)
+        $this->hot_restart = [
+            'socket' => $w_ret,
+            'host' => $p_host,
+            'address' => $unix,
+            'connections' => $p_connections,
+            'checked' => 0,
+            'handed' => false
+        ];
+
+        return true;
+    }
+
+    /**
+     * ホットリスタートの引き継ぎ（後継プロセス側）
+     * 
+     * listen() の代わりに呼び出し、旧プロセスの待ち受けソケットと接続を accept し直さずにそのまま使う  
+     * 接続IDは fd 番号から振り直されるため、旧接続IDとの対応を返す（ユーザープロパティ等に保持した接続IDの読み替えに使う）
+     * 
+     * 旧プロセスが存在しない場合は失敗するので listen() を呼び出す。引き継ぎ後は改めて enableHotRestart を呼び出せる
+     * 
+     * @param string $p_host enableHotRestart に指定したアドレス
+     * @param int $p_timeout 送受信タイムアウト（秒）
+     * @return array|false 旧接続ID => 新接続ID の配列 or false（失敗）
+     */
+    public function takeover(string $p_host, int $p_timeout = self::HANDOFF_TIMEOUT): array|false
+    {
+        if(PHP_OS_FAMILY === 'Windows')
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang)]);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::HOT_RESTART_UNSUPPORTED->message($this->lang)]);
             return false;
         }
 
-        // bind socket to specified host
-        $w_ret = socket_bind($soc, $this->await_host, $this->await_port);
+        $w_ret = $this->connectControl($p_host, $p_timeout);
         if($w_ret === false)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            $this->logWriter('notice', [__METHOD__ => LogMessageEnum::HOT_RESTART_FAIL->message($this->lang), 'host' => $p_host]);
             return false;
         }
+        $soc = $w_ret;
 
-        // ソケットディスクリプタの生成
-        $udp = null;
-        if(!(AdaptiveIoDriverFactory::$mode === AdaptiveIoDriverFactory::MODE_IO_NATIVE && PHP_OS_FAMILY === 'Windows'))
+        // 引き継いだソケットの登録（完了応答を返すまで旧プロセスは手放さない）
+        $map = [];
+        $w_ret = $this->receiveHandoff($soc, $map);
+        if($w_ret === true)
         {
-            $udp = true;
+            $w_ret = @socket_send($soc, self::HANDOFF_ACK, strlen(self::HANDOFF_ACK), 0);
         }
-        $w_ret = $this->createDescriptor($soc, $udp, true);
         if($w_ret === false)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::HOT_RESTART_FAIL->message($this->lang), 'host' => $p_host, 'message' => socket_strerror(socket_last_error($soc))]);
+            socket_close($soc);
+
+            // 旧プロセスが処理を続けるので、登録したソケットは閉じずに手放す
+            foreach($map as $cid)
+            {
+                $this->releaseDescriptor($cid);
+            }
             return false;
         }
-        $des = $w_ret;
+        socket_close($soc);
 
-        // 待ち受けソケットの接続IDを設定
-        $this->await_connection_id = $des['connection_id'];
+        $this->logWriter('notice', [__METHOD__ => LogMessageEnum::HOT_RESTART_TAKEOVER->message($this->lang), 'listen' => $this->await_connection_id, 'connections' => $this->getClientCount()]);
 
-        return true;
+        return $map;
     }
 
     /**
-     * ソケットセレクト
+     * コネクションマイグレーションの有効化
      * 
-     * @param int $p_utimer ブロッキングタイム（マイクロ秒）
+     * 指定した UNIX ドメインのアドレス（SOCK_SEQPACKET）で SocketMigrationCoordinator と兄弟プロセスからの要求を待つ  
+     * 負荷の問い合わせ、他プロセスへの接続の移動指示、他プロセスからの接続の受け入れに応じる
+     * 
+     * 要求の確認は周期ドリブン処理の中で 100ms に 1 回行う。Linux のみ対応
+     * 
+     * @param string $p_host 'unix:///path' or 'unix://@name'（抽象名前空間）
      * @return bool true（成功） or false（失敗）
      */
-    private function select($p_utimer = 0): bool
+    public function enableMigration(string $p_host): bool
     {
-        //--------------------------------------------------------------------------
-        // 処理対象のソケットがない場合は抜ける
-        //--------------------------------------------------------------------------
-
-        $cnt = count($this->sockets);
-        if($cnt <= 0)
+        if(PHP_OS_FAMILY === 'Windows')
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_NO_COUNT->message($this->lang)]);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::MIGRATION_UNSUPPORTED->message($this->lang)]);
             return false;
         }
 
-        //--------------------------------------------------------------------------
-        // セレクト実行
-        //--------------------------------------------------------------------------
-
-        $chgs = $this->iio_driver->waitEvents();
-        if($chgs === false)
+        $unix = null;
+        $w_ret = $this->createControlListener($p_host, $unix);
+        if($w_ret === false)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
             return false;
         }
 
-        //--------------------------------------------------------------------------
-        // 下記変数の設定
-        // ・コネクトフラグ（$flg_accept） 0:コネクト要求ではない、1:TCPによるアクセプト、2:UDPによるコネクト
-        // ・セレクトしたディスクリプタリスト（$this->changed_descriptors）
-        //--------------------------------------------------------------------------
+        $this->migration = [
+            'socket' => $w_ret,
+            'address' => $unix,
+            'checked' => 0
+        ];
 
-        $cid = null;
-        $flg_connect = false;
-        $this->changed_descriptors = array();
-        foreach($chgs as $chg)
+        return true;
+    }
+
+    /**
+     * 負荷情報の取得
+     * 
+     * @return array pid（プロセスID）、connections（接続数）、movable（移動できる接続数）、cycle_time（周期ドリブン処理 1 回の所要時間 μs）
+     */
+    public function getLoad(): array
+    {
+        $movable = 0;
+        foreach($this->descriptors as $cid => $des)
         {
-            $chg_cid = $chg['cid'];
-            if($chg['type'] === 'udp_accept')
+            if($cid !== $this->await_connection_id && $this->isHandoffMovable($des) === true)
             {
-                // Create UDP/IP sream socket
-                $w_ret = socket_create(AF_INET, SOCK_DGRAM, SOL_UDP);
-                if($w_ret === false)
-                {
-                    $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
-                    return false;
-                }
-                $soc = $w_ret;
+                $movable++;
+            }
+        }
 
-                $w_ret = socket_bind($soc, '0.0.0.0', 0);
-                if($w_ret === false)
-                {
-                    $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
-                    return false;
-                }
+        return [
+            'pid' => getmypid(),
+            'connections' => $this->getClientCount(),
+            'movable' => $movable,
+            'cycle_time' => (int)$this->cycle_time
+        ];
+    }
 
-                $unpack_data = unpack('nport', $chg['data']);
-                $remote_port = (int)$unpack_data['port'];
+    /**
+     * 接続の移動
+     * 
+     * 移動できる接続を最終アクセス日時の古い順に選び、ソケットとディスクリプタの状態を兄弟プロセスへ SCM_RIGHTS で渡す  
+     * 相手側では接続IDが振り直されるため、接続IDを他の接続から参照している場合（ルーム管理等）は移動後の整合に注意する
+     * 
+     * @param string $p_host 移動先の enableMigration に指定したアドレス
+     * @param int $p_count 移動する最大接続数
+     * @return int|false 移動した接続数 or false（失敗）
+     */
+    public function migrateConnections(string $p_host, int $p_count): int|false
+    {
+        // 移動する接続の選定
+        $targets = [];
+        foreach($this->descriptors as $cid => $des)
+        {
+            if($cid !== $this->await_connection_id && $this->isHandoffMovable($des) === true)
+            {
+                $targets[$cid] = $des['last_access_timestamp'];
+            }
+        }
+        asort($targets);
+        $targets = array_slice(array_keys($targets), 0, max(0, $p_count));
+        if(count($targets) <= 0)
+        {
+            return 0;
+        }
 
-                $fd = socketsfd($soc);
-                $local_ip = '';
-                $local_port = 0;
-                $this->iio_driver->getSockName($fd, $local_ip, $local_port);
+        $w_ret = $this->connectControl($p_host, self::HANDOFF_TIMEOUT);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::MIGRATION_FAIL->message($this->lang), 'host' => $p_host]);
+            return false;
+        }
+        $soc = $w_ret;
 
-                $dat = pack('n', $local_port);
-                $len = strlen($dat);
-                $w_ret = socket_sendto($soc, $dat, $len, 0, $chg['from_ip'], $remote_port);
-                if($w_ret === false)
-                {
-                    $this->logWriter('error', ['udp first send' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
-                    return false;
-                }
+        $entries = [];
+        $sockets = [];
+        foreach($targets as $cid)
+        {
+            $entries[] = [
+                'type' => 'connection',
+                'cid' => $cid,
+                'state' => $this->exportHandoffState($cid)
+            ];
+            $sockets[] = $this->sockets[$cid];
+        }
 
-                // 制限接続数の判定
-                $cnt = $this->getClientCount();
-                if($cnt >= $this->limit_connection)
-                {
-                    @socket_close($soc);
-                    return true;
-                }
+        $req = serialize(['op' => 'adopt']);
+        $w_ret = @socket_send($soc, $req, strlen($req), 0);
+        if($w_ret !== false)
+        {
+            $w_ret = $this->sendHandoff($soc, $entries, $sockets);
+        }
+        socket_close($soc);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::MIGRATION_FAIL->message($this->lang), 'host' => $p_host]);
+            return false;
+        }
 
-                // ソケットディスクリプタの生成
-                $w_ret = $this->createDescriptor($soc, true);
-                if($w_ret === false)
-                {
-                    $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
-                    return false;
-                }
-                $des = $w_ret;
+        $this->logWriter('notice', [__METHOD__ => LogMessageEnum::MIGRATION_SENT->message($this->lang), 'host' => $p_host, 'connections' => count($entries)]);
 
-                $prop =
-                [
-                    'host' => $chg['from_ip'],
-                    'port' => $remote_port
-                ];
-                $this->setProperties($des['connection_id'], ['udp_peers' => $prop]);
+        return count($entries);
+    }
 
-                socket_connect($soc, $prop['host'], $prop['port']);
-                continue;
-            }
-            else
-            if($chg['type'] === 'handshake_read')
-            {
-                $unpack_data = unpack('nport', $chg['data']);
-                $port = (int)$unpack_data['port'];
-                $prop =
-                [
-                    'host' => $chg['from_ip'],
-                    'port' => $port
-                ];
-                $this->setProperties($chg_cid, ['udp_peers' => $prop]);
+    /**
+     * ホットリスタートの完了判定（旧プロセス側）
+     * 
+     * 後継プロセスへ引き継いだ後、手元に残った接続がすべて切断されていれば true を返す
+     * 
+     * @return bool true（終了してよい） or false（処理を続ける）
+     */
+    public function isHotRestartDrained(): bool
+    {
+        if($this->hot_restart === null || $this->hot_restart['handed'] === false)
+        {
+            return false;
+        }
 
-                socket_connect($this->sockets[$chg_cid], $prop['host'], $prop['port']);
+        return count($this->descriptors) <= 0;
+    }
 
-                // キューの設定がない場合は抜ける
-                $w_ret = $this->cycle_driven_for_protocol->isSetQueue(ProtocolQueueEnum::CONNECT->value, StatusEnum::START->value);
-                if($w_ret === true)
-                {
-                    // 接続時のキュー名設定
-                    $w_ret = $this->setQueueNameForStart('protocol_names', $chg_cid, ProtocolQueueEnum::CONNECT->value);
-                    if($w_ret === false)
-                    {
-                        $this->logWriter('error', [__METHOD__ => "[{$chg_cid}]".LogMessageEnum::QUEUE_START_FAIL->message($this->lang)]);
-                        return false;
-                    }
-                }
-                continue;
-            }
-            else
-            if($chg['type'] === 'error')
+    /**
+     * ワーカープロセスの prefork
+     * 
+     * listen の直後に呼び出し、待ち受けソケットを共有する子プロセスを $p_count 個生成する  
+     * 各プロセスは自分の I/O ドライバで待ち受けソケットを EPOLLEXCLUSIVE で監視し、起床したプロセスがドライバ内で最大 $p_accept_batch 件をまとめて受け入れる  
+     * 受け入れキューは 1 本で、待機中のプロセスだけが起床して受け入れる（SO_REUSEPORT はハッシュで振り分けるため処理中のプロセスにも割り当てられる）  
+     * socketsfd 拡張以外の I/O ドライバでは通常の待ち受けのまま共有する（受け入れを競合したプロセスは空振りする）
+     * 
+     * $p_reuseport = true の場合は SO_REUSEPORT で各プロセスが自分の待ち受けソケットを持つ（カーネルが接続を 4 タプルのハッシュで振り分ける）  
+     * 親プロセスの待ち受けソケットも SO_REUSEPORT を付けて作り直す。UNIX ドメインの待ち受けでは使用できない  
+     * 2 つのモードの比較は ffi/linux/bench/accept_balance.c で計測できる
+     * 
+     * 子プロセスはチューニングプロファイルとゼロコピー送信の設定を引き継ぐ  
+     * AdaptiveIoDriverFactory::setBusyPollMode のビジーポーリングモードも子プロセスのドライバへ適用される  
+     * setOffloadPool のワーカープールは各子プロセスで作り直す（親プロセスのオフロード用子プロセスは共有せず、子プロセスごとに同じ数を生成する）  
+     * setBusyPoll／setResolver／setRateLimit と enableHotRestart／enableMigration／setMetrics は forkWorkers の後に各プロセスで設定すること  
+     * forkWorkers の前に設定した setMetrics の待ち受けは子プロセスで閉じる（親プロセスだけが応答する。子プロセスで使う場合は別のアドレスを指定する）  
+     * 子プロセスの終了の回収（pcntl_wait 等）は呼び出し側で行う
+     * 
+     * @param int $p_count 生成する子プロセス数
+     * @param int $p_accept_batch 1 回に受け入れる最大数（0 = 既定値の 16。SO_REUSEPORT では使用しない）
+     * @param bool $p_reuseport SO_REUSEPORT フラグ true（プロセスごとの待ち受け） or false（EPOLLEXCLUSIVE で共有）
+     * @return int|false ワーカー番号（0 = 親プロセス、1〜$p_count = 子プロセス） or false（失敗）
+     */
+    public function forkWorkers(int $p_count, int $p_accept_batch = 16, bool $p_reuseport = false): int|false
+    {
+        if(PHP_OS_FAMILY !== 'Linux' || !function_exists('pcntl_fork'))
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::WORKER_UNSUPPORTED->message($this->lang)]);
+            return false;
+        }
+
+        // 待ち受けソケット以外のディスクリプタがあると親子で共有されてしまう
+        if($this->await_connection_id === null || count($this->descriptors) !== 1)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::WORKER_FORK_FAIL->message($this->lang), 'descriptors' => count($this->descriptors)]);
+            return false;
+        }
+
+        // SO_REUSEPORT は待ち受けソケットを作り直す（bind 前に設定する必要があるため）
+        if($p_reuseport === true)
+        {
+            if($this->descriptors[$this->await_connection_id]['unix_address'] !== null)
             {
-                $this->shutdown($chg_cid);
-                continue;
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::WORKER_FORK_FAIL->message($this->lang), 'reuseport' => 'unix domain']);
+                return false;
             }
-            else
-            if($chg['type'] === 'disconnect')
+            $w_ret = $this->relistenReusePort();
+            if($w_ret === false)
             {
-                $this->shutdown($chg_cid);
-                continue;
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::WORKER_FORK_FAIL->message($this->lang), 'reuseport' => 'listen']);
+                return false;
             }
-            else
-            if($chg['type'] === 'read')
+        }
+
+        $ret = 0;
+        for($i = 1; $i <= $p_count; $i++)
+        {
+            $pid = pcntl_fork();
+            if($pid === -1)
             {
-                if(!isset($this->descriptors[$chg_cid]))
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::WORKER_FORK_FAIL->message($this->lang), 'worker' => $i]);
+                if($i === 1)
                 {
-                    continue;
+                    return false;
                 }
-                $data = substr($chg['data'], 0, $chg['bytes']);
-                $this->descriptors[$chg_cid]['receiving_buffer']['data'] .= $data;
-                $this->descriptors[$chg_cid]['receiving_buffer']['receiving_size'] += $chg['bytes'];
-                $this->descriptors[$chg_cid]['last_access_timestamp'] = time();
-            }
-
-            $flg_accept = false;
-            $flg_connect = 1;
-            $w_ret = $this->getProperties($chg_cid, ['udp']);
-            if($w_ret !== false && ($w_ret === null || $w_ret['udp'] === true))
-            {
-                $flg_connect = 2;
+                break;
             }
-            if(PHP_OS_FAMILY === 'Windows')
+            if($pid === 0)
             {
-                if($flg_connect === 2 || $chg['type'] === 'read')
+                $ret = $i;
+
+                // epoll インスタンスは親と共有されるため、子プロセスは I/O ドライバを作り直す
+                $this->iio_driver = AdaptiveIoDriverFactory::create($this->sockets, $this, $this->receive_buffer_size);
+                $this->applyBusyPollMode();
+                foreach($this->socket_profiles as $kind => $profile)
                 {
-                    if($chg_cid == $this->await_connection_id)
+                    if($profile !== null && $profile['native'] === true)
                     {
-                        $flg_accept = true;
-                    }                
+                        $this->iio_driver->setProfile($kind === 'client', $profile['options']);
+                    }
                 }
-                else
-                if($chg['type'] === 'accept')
+                if($this->zerocopy_threshold > 0)
                 {
-                    $flg_accept = true;
+                    $this->iio_driver->setZeroCopy($this->zerocopy_threshold);
                 }
-            }
-            else
-            {
-                if($chg_cid == $this->await_connection_id)
+                if($this->stats !== null)
                 {
-                    $flg_accept = true;
-                }                
-            }
-
-            if($flg_accept === true)
-            {
-                $cid = $chg_cid;
-
-                //--------------------------------------------------------------------------
-                // アクセプト
-                //--------------------------------------------------------------------------
-
-                $des = null;
-                if($flg_connect === 1)
+                    $this->iio_driver->setStats(true);
+                }
+                if($this->metrics !== null)
                 {
-                    $soc = null;
-                    if($chg['type'] === 'accept')
-                    {
-                        $fd = (int)substr($cid, 1);
-                        $soc = socket_import_fd($fd);
-                    }
-                    else
-                    {
-                        $soc = @socket_accept($this->sockets[$this->await_connection_id]);
-                        if($soc === false)
-                        {
-                            $w_soc = $this->sockets[$this->await_connection_id];
-                            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($w_soc)]);
-                            return false;
-                        }
-                    }
-
-                    // 制限接続数の判定
-                    $cnt = $this->getClientCount();
-                    if($cnt >= $this->limit_connection)
-                    {
-                        $this->shutdown($cid);
-                        return true;
-                    }
-
-                    // ソケットディスクリプタの生成
-                    $w_ret = $this->createDescriptor($soc);
-                    if($w_ret === false)
+                    // メトリクスページは親プロセスの値を返すので、引き継いだ待ち受けは閉じる（パスは親プロセスのものなので削除しない）
+                    foreach($this->metrics['clients'] as $cli)
                     {
-                        $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
-                        return false;
+                        @socket_close($cli['socket']);
                     }
-                    $des = $w_ret;
+                    @socket_close($this->metrics['socket']);
+                    $this->metrics = null;
                 }
-                else
-                if($flg_connect === 2)
+                if($this->offload_pool !== null)
                 {
-                    $soc = $this->sockets[$cid];
-                    $buf = '';
-                    $from = '';
-                    $port = 0;
-                    $w_ret = socket_recvfrom($soc, $buf, $this->receive_buffer_size, 0, $from, $port);
-                    if($w_ret === false)
-                    {
-                        $this->logWriter('error', ['udp first recv' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
-                        continue;
-                    }
-
-                    if($buf !== self::UDP_CONNECTION_IDENTIFY)
-                    {
-                        return false;
-                    }
-
-                    // Create UDP/IP sream socket
-                    $w_ret = socket_create(AF_INET, SOCK_DGRAM, SOL_UDP);
-                    if($w_ret === false)
-                    {
-                        $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
-                        return false;
-                    }
-                    $soc = $w_ret;
-
-                    $dat = self::UDP_CONNECTION_IDENTIFY;
-                    $len = strlen($dat);
-                    $w_ret = socket_sendto($soc, $dat, $len, 0, $from, $port);
-                    if($w_ret === false)
-                    {
-                        $this->logWriter('error', ['udp first send' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
-                        return false;
-                    }
-
-                    // 制限接続数の判定
-                    $cnt = $this->getClientCount();
-                    if($cnt >= $this->limit_connection)
-                    {
-                        @socket_close($soc);
-                        return true;
-                    }
-
-                    // ソケットディスクリプタの生成
-                    $w_ret = $this->createDescriptor($soc, true);
+                    // 親プロセスのオフロード用子プロセスへの経路を共有すると結果を取り違えるため、自分のプールを作る
+                    $this->offload_pool->detachInherited();
+                    $w_ret = $this->offload_pool->start();
                     if($w_ret === false)
                     {
-                        $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
-                        return false;
+                        $this->logWriter('error', [__METHOD__ => LogMessageEnum::OFFLOAD_UNSUPPORTED->message($this->lang), 'worker' => $i]);
+                        exit(1);
                     }
-                    $des = $w_ret;
-
-                    $prop =
-                    [
-                        'host' => $from,
-                        'port' => $port
-                    ];
-                    $this->setProperties($des['connection_id'], ['udp_peers' => $prop, 'udp' => null]);
-                    socket_connect($soc, $prop['host'], $prop['port']);
                 }
-
-                if($des !== null)
+                if($p_reuseport === true)
                 {
-                    // キューの設定がない場合は抜ける
-                    $w_ret = $this->cycle_driven_for_protocol->isSetQueue(ProtocolQueueEnum::ACCEPT->value, StatusEnum::START->value);
-                    if($w_ret === true)
+                    // 引き継いだ待ち受けソケットは親プロセスの分なので手放し、自分の待ち受けソケットを作る
+                    $w_ret = $this->relistenReusePort();
+                    if($w_ret === false)
                     {
-                        // アクセプト時のキュー名設定
-                        $w_ret = $this->setQueueNameForStart('protocol_names', $des['connection_id'], ProtocolQueueEnum::ACCEPT->value);
-                        if($w_ret === false)
-                        {
-                            $this->logWriter('error', [__METHOD__ => LogMessageEnum::QUEUE_START_FAIL->message($this->lang)]);
-                            return false;
-                        }
+                        $this->logWriter('error', [__METHOD__ => LogMessageEnum::WORKER_FORK_FAIL->message($this->lang), 'worker' => $i, 'reuseport' => 'listen']);
+                        exit(1);
                     }
+                    break;
                 }
-            }
-            else
-            {
-                array_push($this->changed_descriptors, $this->descriptors[$chg_cid]);
+                $this->iio_driver->registerListen($this->sockets[$this->await_connection_id]);
+                break;
             }
         }
 
-        return true;
+        if($p_reuseport === true)
+        {
+            return $ret;
+        }
+
+        $w_ret = $this->iio_driver->setListenExclusive(substr($this->await_connection_id, 1), max(0, $p_accept_batch));
+        if($w_ret === false && $ret === 0)
+        {
+            $this->logWriter('notice', [__METHOD__ => LogMessageEnum::WORKER_SHARED_LISTEN->message($this->lang)]);
+        }
+
+        return $ret;
     }
 
     /**
-     * ソケットクローズ
+     * SO_REUSEPORT を付けた待ち受けソケットへの作り直し
+     * 
+     * 現在の待ち受けソケットを手放してから同じアドレスで listen し直す  
+     * ポート番号 0（自動割り当て）で待ち受けていた場合は割り当て済みのポート番号に固定する
      * 
-     * @param string $p_cid 接続ID
      * @return bool true（成功） or false（失敗）
      */
-    public function shutdown(string $p_cid): bool
+    private function relistenReusePort(): bool
     {
-        // ディスクリプタが存在しない場合は抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        $addr = null;
+        $port = null;
+        $w_ret = @socket_getsockname($this->sockets[$this->await_connection_id], $addr, $port);
+        if($w_ret === true && $port !== null)
         {
-            return false;
+            $this->await_port = $port;
         }
 
-        $fd = substr($p_cid, 1);
-        $this->iio_driver->unregister($fd);
-
-        // ソケットリソースの取得
-        $soc = $this->sockets[$p_cid];
-
-        // ソケットの読み込み／書き込みを停止
-        @socket_shutdown($soc, 2);
-
-        // ソケットリソースの解放
-        @socket_close($soc);
+        $this->releaseDescriptor($this->await_connection_id);
 
-        // マネージャーのエントリからはずす
-        unset($this->sockets[$p_cid]);
-        unset($this->descriptors[$p_cid]);
+        $this->listen_reuseport = true;
+        $w_ret = $this->listen();
+        $this->listen_reuseport = false;
 
-        return true;
+        return $w_ret;
     }
 
     /**
-     * ソケット全クローズ
+     * ソケットリッスン（TCP用）
+     * 
+     * 引数のホスト名とポート番号の指定があれば、コンストラクタで設定された内容より優先されます
+     * 
+     * ホスト名に 'unix:///path' / 'unix://@name'（抽象名前空間）を指定すると UNIX ドメインのストリームで待ち受けます（ポート番号は無視）  
+     * 前回のプロセスが残したソケットファイルは削除してからバインドし、待ち受けソケットのクローズ時にも削除します
      * 
+     * @param ?string $p_host ホスト名
+     * @param ?int $p_port ポート番号
      * @return bool true（成功） or false（失敗）
      */
-    public function shutdownAll(): bool
+    public function listen(?string $p_host = null, ?int $p_port = null): bool
     {
-        foreach($this->descriptors as $cid => $des)
+        //--------------------------------------------------------------------------
+        // プロパティの設定
+        //--------------------------------------------------------------------------
+        if($p_host !== null)
         {
-            $w_ret = $this->shutdown($cid);
-            if($w_ret === false)
-            {
-                return false;
-            }
+            $this->await_host = $p_host;
+        }
+        if($p_port !== null)
+        {
+            $this->await_port = $p_port;
         }
 
-        return true;
-    }
+        //--------------------------------------------------------------------------
+        // ソケットの初期化
+        //--------------------------------------------------------------------------
 
-    /**
-     * データ受信サイズの設定
-     * 
-     * ※プロトコルUNITで使用 
-     * 
-     * @param string $p_cid 接続ID
-     * @param int $p_size 受信サイズ
-     * @return bool true（成功） or false(失敗)
-     */
-    public function setReceivingSize(string $p_cid, int $p_size): bool
-    {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        // UNIX ドメイン（'unix:///path' or 'unix://@name'）の判定
+        $unix = $this->unixAddress($this->await_host);
+        if($unix === false)
         {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::UNIX_ADDRESS_INVALID->message($this->lang), 'host' => $this->await_host]);
             return false;
         }
+        $domain = AF_INET;
+        $protocol = SOL_TCP;
+        if($unix !== null)
+        {
+            $domain = AF_UNIX;
+            $protocol = 0;
+        }
 
-        // 受信バッファへ設定
-        $this->descriptors[$p_cid]['receiving_buffer']['size'] = $p_size;
-        $this->descriptors[$p_cid]['receiving_buffer']['data'] = '';
-        $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] = 0;
-
-        return true;
-    }
-
-    /**
-     * データ受信
-     * 
-     * setReceivingSizeで設定されたサイズ分を受信するまで続ける
-     * 
-     * ※プロトコルUNITで使用 
-     * 
-     * @param string $p_cid 接続ID
-     * @return mixed 受信データ or null（受信中） or false（失敗）
-     */
-    public function receiving(string $p_cid)
-    {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        // Create TCP/IP sream socket
+        $w_ret = socket_create($domain, SOCK_STREAM, $protocol);
+        if($w_ret === false)
         {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
             return false;
         }
+        $soc = $w_ret;
 
-        // データ受信サイズ設定がされていない場合は抜ける
-        if
-        (
-                $this->descriptors[$p_cid]['receiving_buffer']['size'] === null
-            &&	$this->descriptors[$p_cid]['receiving_buffer']['data'] === null
-        )
+        // reuseable port
+        $w_ret = socket_set_option($soc, SOL_SOCKET, SO_REUSEADDR, 1);
+        if($w_ret === false)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::RECEIVE_SIZE_NO_SETTING->message($this->lang)]);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang)]);
             return false;
         }
 
-        // 設定サイズの取得
-        $setting_siz = $this->descriptors[$p_cid]['receiving_buffer']['size'];
-
-        // 受信中サイズの取得
-        $receiving_siz = $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'];
-
-        // 今回の受信サイズ
-        $siz = $setting_siz - $receiving_siz;
-
-        // データ受信
-        $soc = $this->sockets[$p_cid];
-        $prop = $this->getProperties($p_cid, ['udp']);
-        $udp = $prop['udp'];
-        if($udp === true)
+        // プロセスごとの待ち受け（forkWorkers の SO_REUSEPORT モード）
+        if($this->listen_reuseport === true)
         {
-            $buf = '';
-            $from = '';
-            $port = 0;
-            $w_ret = @socket_recvfrom($soc, $buf, $siz, 0, $from, $port);
+            $w_ret = socket_set_option($soc, SOL_SOCKET, SO_REUSEPORT, 1);
             if($w_ret === false)
             {
-                $this->logWriter('error', [__METHOD__ => 'socket_recvfrom', "message" => LogMessageEnum::SOCKET_ERROR->socket($soc), 'connection id' => $p_cid]);
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang)]);
                 return false;
             }
-            $rcv = $buf;
-            $rcv_siz = strlen($rcv);
+        }
+
+        // bind socket to specified host
+        if($unix !== null)
+        {
+            $w_ret = $this->bindUnix($soc, $unix);
         }
         else
         {
-            $rcv = '';
-            $w_ret = @socket_read($soc, $siz);
-            if($w_ret === false)
-            {
-                $this->descriptors[$p_cid]['read_event'] = false;
-                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
-                if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
-                {
-                    return null;
-                }
-
-                // ソケット操作を完了できなかった
-                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
-                {
-                    return null;
-                }
-
-                // 相手からの切断を判定
-                $shutdown = false;
-                foreach(self::SOCKET_ERROR_PEER_SHUTDOWN as $cod)
-                {
-                    if($w_ret['code'] === $cod)
-                    {
-                        $shutdown = true;
-                    }
-                }
-                if($shutdown === true)
-                {
-                    // 緊急停止時コールバックを実行
-                    $callback = $this->emergency_callback;
-                    if($callback !== null)
-                    {
-                        $callback($this->unit_parameter);
-                    }
-                }
-                $this->logWriter('notice', [__METHOD__ => 'socket_read', "message" => $w_ret['message'], 'connection id' => $p_cid]);
-                return false;
-            }
-            $rcv = $w_ret;
-            $rcv_siz = strlen($rcv);
-            if($w_ret === "")
-            {
-                if($this->descriptors[$p_cid]['read_event'] === true)
-                {
-                    throw new UnitException(
-                        UnitExceptionEnum::ECODE_EMERGENCY_SHUTDOWN->message($this->lang),
-                        UnitExceptionEnum::ECODE_EMERGENCY_SHUTDOWN->value,
-                        $this->unit_parameter
-                    );
-                }
-            }
-            $this->descriptors[$p_cid]['read_event'] = false;
+            $w_ret = socket_bind($soc, $this->await_host, $this->await_port);
         }
-
-        // 最終アクセスタイムスタンプを設定
-        if($rcv_siz > 0)
+        if($w_ret === false)
         {
-            $w_ret = $this->setProperties($p_cid, ['last_access_timestamp' => time()]);
-            if($w_ret === false)
-            {
-                return false;
-            }
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            return false;
         }
 
-        // 設定サイズ未満の場合は抜ける
-        $receiving_siz += $rcv_siz;
-        if($receiving_siz < $setting_siz)
+        // listen to port
+        $w_ret = socket_listen($soc, 8192);
+        if($w_ret === false)
         {
-            return null;
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            return false;
         }
 
-        // 受信データを設定
-        $ret = $this->descriptors[$p_cid]['receiving_buffer']['data'] . $rcv;
+        // ソケットディスクリプタの生成
+        $w_ret = $this->createDescriptor($soc, false, true);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
+            return false;
+        }
+        $des = $w_ret;
 
-        // 受信バッファを初期化
-        $this->descriptors[$p_cid]['receiving_buffer']['size'] = null;
-        $this->descriptors[$p_cid]['receiving_buffer']['data'] = null;
-        $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] = 0;
+        // 待ち受けソケットの接続IDの設定
+        $this->await_connection_id = $des['connection_id'];
+        $this->descriptors[$des['connection_id']]['unix_address'] = $unix;
 
-        return $ret;
+        return true;
     }
 
     /**
-     * データ受信サイズの設定（バッファリング用）
+     * ソケットバインド（UDP用）
      * 
-     * ※プロトコルUNITで使用 
+     * 引数のホスト名とポート番号の指定があれば、コンストラクタで設定された内容より優先されます
      * 
-     * @param string $p_cid 接続ID
-     * @param int $p_size 受信サイズ
-     * @return bool true（成功） or false(失敗)
+     * ホスト名に 'unix:///path' / 'unix://@name'（抽象名前空間）を指定すると UNIX ドメインのデータグラムで待ち受けます（ポート番号は無視）  
+     * 接続ごとの通信用ソケットは待ち受けアドレスにプロセスIDと通番を付加したアドレスへバインドされます（ファイルシステム上のパスならディレクトリへの書き込み権限が必要）
+     * 
+     * @param ?string $p_host ホスト名
+     * @param ?int $p_port ポート番号
+     * @return bool true（成功） or false（失敗）
      */
-    public function setBufferingReceivingSize(string $p_cid, int $p_size): bool
+    public function bind(?string $p_host = null, ?int $p_port = null): bool
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        //--------------------------------------------------------------------------
+        // プロパティの設定
+        //--------------------------------------------------------------------------
+        if($p_host !== null)
+        {
+            $this->await_host = $p_host;
+        }
+        if($p_port !== null)
+        {
+            $this->await_port = $p_port;
+        }
+
+        // UNIX ドメイン（'unix:///path' or 'unix://@name'）の判定
+        $unix = $this->unixAddress($this->await_host);
+        if($unix === false)
         {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::UNIX_ADDRESS_INVALID->message($this->lang), 'host' => $this->await_host]);
             return false;
         }
+        $domain = AF_INET;
+        $protocol = SOL_UDP;
+        if($unix !== null)
+        {
+            $domain = AF_UNIX;
+            $protocol = 0;
+        }
 
-        // 受信バッファへ設定
-        $this->descriptors[$p_cid]['receiving_buffer']['size'] = $p_size;
+        // Create TCP/IP sream socket
+        $w_ret = socket_create($domain, SOCK_DGRAM, $protocol);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+            return false;
+        }
+        $soc = $w_ret;
+
+        // reuseable port
+        $w_ret = socket_set_option($soc, SOL_SOCKET, SO_REUSEADDR, 1);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang)]);
+            return false;
+        }
+
+        // bind socket to specified host
+        if($unix !== null)
+        {
+            $w_ret = $this->bindUnix($soc, $unix);
+        }
+        else
+        {
+            $w_ret = socket_bind($soc, $this->await_host, $this->await_port);
+        }
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            return false;
+        }
+
+        // ソケットディスクリプタの生成
+        $udp = null;
+        if(!(AdaptiveIoDriverFactory::$mode === AdaptiveIoDriverFactory::MODE_IO_NATIVE && PHP_OS_FAMILY === 'Windows'))
+        {
+            $udp = true;
+        }
+        $w_ret = $this->createDescriptor($soc, $udp, true);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
+            return false;
+        }
+        $des = $w_ret;
+
+        // 待ち受けソケットの接続IDを設定
+        $this->await_connection_id = $des['connection_id'];
+        $this->descriptors[$des['connection_id']]['unix_address'] = $unix;
+
+        return true;
+    }
+
+    /**
+     * ソケットセレクト
+     * 
+     * @param int $p_utimer ブロッキングタイム（マイクロ秒）
+     * @return bool true（成功） or false（失敗）
+     */
+    private function select($p_utimer = 0): bool
+    {
+        //--------------------------------------------------------------------------
+        // 処理対象のソケットがない場合は抜ける
+        //--------------------------------------------------------------------------
+
+        $cnt = count($this->sockets);
+        if($cnt <= 0)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_NO_COUNT->message($this->lang)]);
+            return false;
+        }
+
+        //--------------------------------------------------------------------------
+        // セレクト実行
+        //--------------------------------------------------------------------------
+
+        $chgs = $this->iio_driver->waitEvents();
+        if($chgs === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+            return false;
+        }
+
+        //--------------------------------------------------------------------------
+        // 下記変数の設定
+        // ・コネクトフラグ（$flg_accept） 0:コネクト要求ではない、1:TCPによるアクセプト、2:UDPによるコネクト
+        // ・セレクトしたディスクリプタリスト（$this->changed_descriptors）
+        //--------------------------------------------------------------------------
+
+        $cid = null;
+        $flg_connect = false;
+        $this->changed_descriptors = array();
+        $this->selected_cids = [];
+        foreach($chgs as $chg)
+        {
+            $chg_cid = $chg['cid'];
+            if($chg['type'] === 'udp_accept')
+            {
+                // Create UDP/IP sream socket
+                $w_ret = socket_create(AF_INET, SOCK_DGRAM, SOL_UDP);
+                if($w_ret === false)
+                {
+                    $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+                    return false;
+                }
+                $soc = $w_ret;
+
+                $w_ret = socket_bind($soc, '0.0.0.0', 0);
+                if($w_ret === false)
+                {
+                    $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+                    return false;
+                }
+
+                $unpack_data = unpack('nport', $chg['data']);
+                $remote_port = (int)$unpack_data['port'];
+
+                $fd = socketsfd($soc);
+                $local_ip = '';
+                $local_port = 0;
+                $this->iio_driver->getSockName($fd, $local_ip, $local_port);
+
+                $dat = pack('n', $local_port);
+                $len = strlen($dat);
+                $w_ret = socket_sendto($soc, $dat, $len, 0, $chg['from_ip'], $remote_port);
+                if($w_ret === false)
+                {
+                    $this->logWriter('error', ['udp first send' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+                    return false;
+                }
+
+                // 制限接続数の判定
+                $cnt = $this->getClientCount();
+                if($cnt >= $this->limit_connection)
+                {
+                    @socket_close($soc);
+                    return true;
+                }
+
+                // ソケットディスクリプタの生成
+                $w_ret = $this->createDescriptor($soc, true);
+                if($w_ret === false)
+                {
+                    $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
+                    return false;
+                }
+                $des = $w_ret;
+
+                $prop =
+                [
+                    'host' => $chg['from_ip'],
+                    'port' => $remote_port
+                ];
+                $this->setProperties($des['connection_id'], ['udp_peers' => $prop]);
+
+                socket_connect($soc, $prop['host'], $prop['port']);
+                continue;
+            }
+            else
+            if($chg['type'] === 'handshake_read')
+            {
+                $unpack_data = unpack('nport', $chg['data']);
+                $port = (int)$unpack_data['port'];
+                $prop =
+                [
+                    'host' => $chg['from_ip'],
+                    'port' => $port
+                ];
+                $this->setProperties($chg_cid, ['udp_peers' => $prop]);
+
+                socket_connect($this->sockets[$chg_cid], $prop['host'], $prop['port']);
+
+                // キューの設定がない場合は抜ける
+                $w_ret = $this->cycle_driven_for_protocol->isSetQueue(ProtocolQueueEnum::CONNECT->value, StatusEnum::START->value);
+                if($w_ret === true)
+                {
+                    // 接続時のキュー名設定
+                    $w_ret = $this->setQueueNameForStart('protocol_names', $chg_cid, ProtocolQueueEnum::CONNECT->value);
+                    if($w_ret === false)
+                    {
+                        $this->logWriter('error', [__METHOD__ => "[{$chg_cid}]".LogMessageEnum::QUEUE_START_FAIL->message($this->lang)]);
+                        return false;
+                    }
+                }
+                continue;
+            }
+            else
+            if($chg['type'] === 'error')
+            {
+                // キープアライブ／TCP_USER_TIMEOUT の満了（カーネルによる相手の消失検出）
+                if(defined('SOCKET_ETIMEDOUT') && ($chg['error_code'] ?? 0) === SOCKET_ETIMEDOUT && isset($this->descriptors[$chg_cid]))
+                {
+                    $this->logWriter('error', [__METHOD__ => LogMessageEnum::KEEPALIVE_TIMEOUT->message($this->lang), 'cid' => $chg_cid]);
+
+                    // UNITパラメータを設定
+                    $this->unit_parameter->setConnectionId($chg_cid);
+                    $this->unit_parameter->setKindString('protocol_names');
+
+                    // 緊急停止時コールバックを実行
+                    $callback = $this->emergency_callback;
+                    if($callback !== null)
+                    {
+                        $callback($this->unit_parameter);
+                    }
+                }
+
+                $this->shutdown($chg_cid);
+                continue;
+            }
+            else
+            if($chg['type'] === 'disconnect')
+            {
+                $this->shutdown($chg_cid);
+                continue;
+            }
+            else
+            if($chg['type'] === 'connect')
+            {
+                // 非同期接続の確立
+                if(!isset($this->descriptors[$chg_cid]))
+                {
+                    continue;
+                }
+                $this->descriptors[$chg_cid]['connecting'] = false;
+                $this->descriptors[$chg_cid]['last_access_timestamp'] = time();
+
+                // キューの設定がない場合は抜ける
+                $w_ret = $this->cycle_driven_for_protocol->isSetQueue(ProtocolQueueEnum::CONNECT->value, StatusEnum::START->value);
+                if($w_ret === true)
+                {
+                    // 接続時のキュー名設定
+                    $w_ret = $this->setQueueNameForStart('protocol_names', $chg_cid, ProtocolQueueEnum::CONNECT->value);
+                    if($w_ret === false)
+                    {
+                        $this->logWriter('error', [__METHOD__ => "[{$chg_cid}]".LogMessageEnum::QUEUE_START_FAIL->message($this->lang)]);
+                        return false;
+                    }
+                }
+                continue;
+            }
+            else
+            if($chg['type'] === 'connect_fail')
+            {
+                // 非同期接続の失敗（error_code：errno。タイムアウトは ETIMEDOUT）
+                $remote = $this->descriptors[$chg_cid]['remote'] ?? null;
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::CONNECT_ASYNC_FAIL->message($this->lang), 'cid' => $chg_cid, 'remote' => $remote, 'code' => $chg['error_code'], 'message' => socket_strerror($chg['error_code'])]);
+                $this->shutdown($chg_cid);
+                continue;
+            }
+            else
+            if($chg['type'] === 'throttle')
+            {
+                // レート制限の発動（error_code：1 = 読み込み停止、2 = 破棄、3 = 切断要求）
+                if($chg['error_code'] === 3)
+                {
+                    $this->logWriter('notice', [__METHOD__ => LogMessageEnum::RATE_LIMIT_EXCEEDED->message($this->lang), 'cid' => $chg_cid]);
+                    $this->shutdown($chg_cid);
+                }
+                else
+                {
+                    $this->logWriter('notice', [__METHOD__ => LogMessageEnum::RATE_LIMIT_THROTTLED->message($this->lang), 'cid' => $chg_cid, 'policy' => $chg['error_code'], 'wait_ms' => $chg['bytes']]);
+                }
+                continue;
+            }
+            else
+            if($chg['type'] === 'read')
+            {
+                if(!isset($this->descriptors[$chg_cid]))
+                {
+                    continue;
+                }
+                $data = substr($chg['data'], 0, $chg['bytes']);
+                $store = $this->descriptors[$chg_cid]['receiving_buffer']['store'];
+                if($this->descriptors[$chg_cid]['receiving_buffer']['frames'] !== null)
+                {
+                    // フレーミング中は完成したフレーム単位で届く（receiving で取り出さないため受信中サイズには含めない）
+                    $this->descriptors[$chg_cid]['receiving_buffer']['frames']->enqueue($data);
+                }
+                else
+                {
+                    if($store !== null)
+                    {
+                        $store->append($data);
+                    }
+                    else
+                    {
+                        $this->descriptors[$chg_cid]['receiving_buffer']['data'] .= $data;
+                    }
+                    $this->descriptors[$chg_cid]['receiving_buffer']['receiving_size'] += $chg['bytes'];
+                }
+                $this->counters['bytes_in'] += $chg['bytes'];
+                $this->descriptors[$chg_cid]['last_access_timestamp'] = time();
+            }
+
+            $flg_accept = false;
+            $flg_connect = 1;
+            $w_ret = $this->getProperties($chg_cid, ['udp']);
+            if($w_ret !== false && ($w_ret === null || $w_ret['udp'] === true))
+            {
+                $flg_connect = 2;
+            }
+            if(PHP_OS_FAMILY === 'Windows')
+            {
+                if($flg_connect === 2 || $chg['type'] === 'read')
+                {
+                    if($chg_cid == $this->await_connection_id)
+                    {
+                        $flg_accept = true;
+                    }                
+                }
+                else
+                if($chg['type'] === 'accept')
+                {
+                    $flg_accept = true;
+                }
+            }
+            else
+            {
+                if($chg_cid == $this->await_connection_id || $chg['type'] === 'accept')
+                {
+                    $flg_accept = true;
+                }                
+            }
+
+            if($flg_accept === true)
+            {
+                $cid = $chg_cid;
+
+                //--------------------------------------------------------------------------
+                // アクセプト
+                //--------------------------------------------------------------------------
+
+                $des = null;
+                if($flg_connect === 1)
+                {
+                    $soc = null;
+                    if($chg['type'] === 'accept')
+                    {
+                        // Windows は AcceptEx、Linux は共有待ち受け（forkWorkers）でドライバ内に受け入れ済み
+                        $fd = (int)substr($cid, 1);
+                        $soc = $chg['sock'] ?? socket_import_fd($fd);
+                    }
+                    else
+                    {
+                        $soc = @socket_accept($this->sockets[$this->await_connection_id]);
+                        if($soc === false)
+                        {
+                            $w_soc = $this->sockets[$this->await_connection_id];
+
+                            // 待ち受けソケットを共有している他のプロセスが先に受け入れた
+                            if(socket_last_error($w_soc) === self::SOCKET_ERROR_READ_RETRY)
+                            {
+                                socket_clear_error($w_soc);
+                                continue;
+                            }
+                            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($w_soc)]);
+                            return false;
+                        }
+                    }
+
+                    // 制限接続数の判定
+                    $cnt = $this->getClientCount();
+                    if($cnt >= $this->limit_connection)
+                    {
+                        $this->counters['rejects']++;
+                        if($chg['type'] === 'accept')
+                        {
+                            // ディスクリプタが未生成のため、ドライバへの登録を解除して閉じる
+                            $this->iio_driver->unregister($fd);
+                            @socket_close($soc);
+                            continue;
+                        }
+                        $this->shutdown($cid);
+                        return true;
+                    }
+
+                    // ソケットディスクリプタの生成
+                    $w_ret = $this->createDescriptor($soc);
+                    if($w_ret === false)
+                    {
+                        $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
+                        return false;
+                    }
+                    $des = $w_ret;
+                    $this->counters['accepts']++;
+                }
+                else
+                if($flg_connect === 2 && $this->descriptors[$cid]['unix_address'] !== null)
+                {
+                    $w_ret = $this->acceptUnixDatagram($cid);
+                    if($w_ret === false)
+                    {
+                        return false;
+                    }
+                    if($w_ret === null)
+                    {
+                        continue;
+                    }
+                    $des = $w_ret;
+                }
+                else
+                if($flg_connect === 2)
+                {
+                    $soc = $this->sockets[$cid];
+                    $buf = '';
+                    $from = '';
+                    $port = 0;
+                    $w_ret = socket_recvfrom($soc, $buf, $this->receive_buffer_size, 0, $from, $port);
+                    if($w_ret === false)
+                    {
+                        $this->logWriter('error', ['udp first recv' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+                        continue;
+                    }
+
+                    if($buf !== self::UDP_CONNECTION_IDENTIFY)
+                    {
+                        return false;
+                    }
+
+                    // Create UDP/IP sream socket
+                    $w_ret = socket_create(AF_INET, SOCK_DGRAM, SOL_UDP);
+                    if($w_ret === false)
+                    {
+                        $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+                        return false;
+                    }
+                    $soc = $w_ret;
+
+                    $dat = self::UDP_CONNECTION_IDENTIFY;
+                    $len = strlen($dat);
+                    $w_ret = socket_sendto($soc, $dat, $len, 0, $from, $port);
+                    if($w_ret === false)
+                    {
+                        $this->logWriter('error', ['udp first send' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+                        return false;
+                    }
+
+                    // 制限接続数の判定
+                    $cnt = $this->getClientCount();
+                    if($cnt >= $this->limit_connection)
+                    {
+                        @socket_close($soc);
+                        return true;
+                    }
+
+                    // ソケットディスクリプタの生成
+                    $w_ret = $this->createDescriptor($soc, true);
+                    if($w_ret === false)
+                    {
+                        $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
+                        return false;
+                    }
+                    $des = $w_ret;
+
+                    $prop =
+                    [
+                        'host' => $from,
+                        'port' => $port
+                    ];
+                    $this->setProperties($des['connection_id'], ['udp_peers' => $prop, 'udp' => null]);
+                    socket_connect($soc, $prop['host'], $prop['port']);
+                }
+
+                if($des !== null)
+                {
+                    // キューの設定がない場合は抜ける
+                    $w_ret = $this->cycle_driven_for_protocol->isSetQueue(ProtocolQueueEnum::ACCEPT->value, StatusEnum::START->value);
+                    if($w_ret === true)
+                    {
+                        // アクセプト時のキュー名設定
+                        $w_ret = $this->setQueueNameForStart('protocol_names', $des['connection_id'], ProtocolQueueEnum::ACCEPT->value);
+                        if($w_ret === false)
+                        {
+                            $this->logWriter('error', [__METHOD__ => LogMessageEnum::QUEUE_START_FAIL->message($this->lang)]);
+                            return false;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                array_push($this->changed_descriptors, $this->descriptors[$chg_cid]);
+                $this->selected_cids[$chg_cid] = true;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * ソケットクローズ
+     * 
+     * @param string $p_cid 接続ID
+     * @return bool true（成功） or false（失敗）
+     */
+    public function shutdown(string $p_cid): bool
+    {
+        // ディスクリプタが存在しない場合は抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        $fd = substr($p_cid, 1);
+        $this->iio_driver->unregister($fd);
+        $this->counters['closes']++;
+
+        // ソケットリソースの取得
+        $soc = $this->sockets[$p_cid];
+
+        // ソケットの読み込み／書き込みを停止
+        @socket_shutdown($soc, 2);
+
+        // ソケットリソースの解放
+        @socket_close($soc);
+
+        // UNIX ドメインのソケットファイルを削除
+        if($this->descriptors[$p_cid]['unix_address'] !== null)
+        {
+            $this->unlinkUnixAddress($this->descriptors[$p_cid]['unix_address']);
+        }
+
+        // マネージャーのエントリからはずす
+        unset($this->sockets[$p_cid]);
+        unset($this->descriptors[$p_cid]);
+
+        // 中断中の Fiber UNIT を破棄
+        $this->cycle_driven_for_protocol->cancelFiber($p_cid);
+        $this->cycle_driven_for_command->cancelFiber($p_cid);
+
+        return true;
+    }
+
+    /**
+     * ソケット全クローズ
+     * 
+     * @return bool true（成功） or false（失敗）
+     */
+    public function shutdownAll(): bool
+    {
+        foreach($this->descriptors as $cid => $des)
+        {
+            $w_ret = $this->shutdown($cid);
+            if($w_ret === false)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * データ受信サイズの設定
+     * 
+     * ※プロトコルUNITで使用 
+     * 
+     * @param string $p_cid 接続ID
+     * @param int $p_size 受信サイズ
+     * @return bool true（成功） or false(失敗)
+     */
+    public function setReceivingSize(string $p_cid, int $p_size): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // 受信バッファへ設定
+        $this->descriptors[$p_cid]['receiving_buffer']['size'] = $p_size;
+        $this->descriptors[$p_cid]['receiving_buffer']['data'] = '';
+        $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] = 0;
+
+        return true;
+    }
+
+    /**
+     * データ受信
+     * 
+     * setReceivingSizeで設定されたサイズ分を受信するまで続ける
+     * 
+     * ※プロトコルUNITで使用 
+     * 
+     * @param string $p_cid 接続ID
+     * @return mixed 受信データ or null（受信中） or false（失敗）
+     */
+    public function receiving(string $p_cid)
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // データ受信サイズ設定がされていない場合は抜ける
+        if
+        (
+                $this->descriptors[$p_cid]['receiving_buffer']['size'] === null
+            &&	$this->descriptors[$p_cid]['receiving_buffer']['data'] === null
+        )
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::RECEIVE_SIZE_NO_SETTING->message($this->lang)]);
+            return false;
+        }
+
+        // 設定サイズの取得
+        $setting_siz = $this->descriptors[$p_cid]['receiving_buffer']['size'];
+
+        // 受信中サイズの取得
+        $receiving_siz = $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'];
+
+        // 今回の受信サイズ
+        $siz = $setting_siz - $receiving_siz;
+
+        // データ受信
+        $soc = $this->sockets[$p_cid];
+        $prop = $this->getProperties($p_cid, ['udp']);
+        $udp = $prop['udp'];
+        if($udp === true)
+        {
+            $buf = '';
+            $from = '';
+            $port = 0;
+            $w_ret = @socket_recvfrom($soc, $buf, $siz, 0, $from, $port);
+            if($w_ret === false)
+            {
+                $this->logWriter('error', [__METHOD__ => 'socket_recvfrom', "message" => LogMessageEnum::SOCKET_ERROR->socket($soc), 'connection id' => $p_cid]);
+                return false;
+            }
+            $rcv = $buf;
+            $rcv_siz = strlen($rcv);
+        }
+        else
+        {
+            $rcv = '';
+            $w_ret = @socket_read($soc, $siz);
+            if($w_ret === false)
+            {
+                $this->descriptors[$p_cid]['read_event'] = false;
+                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
+                if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
+                {
+                    return null;
+                }
+
+                // ソケット操作を完了できなかった
+                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
+                {
+                    return null;
+                }
+
+                // 相手からの切断を判定
+                $shutdown = false;
+                foreach(self::SOCKET_ERROR_PEER_SHUTDOWN as $cod)
+                {
+                    if($w_ret['code'] === $cod)
+                    {
+                        $shutdown = true;
+                    }
+                }
+                if($shutdown === true)
+                {
+                    // 緊急停止時コールバックを実行
+                    $callback = $this->emergency_callback;
+                    if($callback !== null)
+                    {
+                        $callback($this->unit_parameter);
+                    }
+                }
+                $this->logWriter('notice', [__METHOD__ => 'socket_read', "message" => $w_ret['message'], 'connection id' => $p_cid]);
+                return false;
+            }
+            $rcv = $w_ret;
+            $rcv_siz = strlen($rcv);
+            if($w_ret === "")
+            {
+                if($this->descriptors[$p_cid]['read_event'] === true)
+                {
+                    throw new UnitException(
+                        UnitExceptionEnum::ECODE_EMERGENCY_SHUTDOWN->message($this->lang),
+                        UnitExceptionEnum::ECODE_EMERGENCY_SHUTDOWN->value,
+                        $this->unit_parameter
+                    );
+                }
+            }
+            $this->descriptors[$p_cid]['read_event'] = false;
+        }
+        $this->counters['bytes_in'] += $rcv_siz;
+
+        // 最終アクセスタイムスタンプを設定
+        if($rcv_siz > 0)
+        {
+            $w_ret = $this->setProperties($p_cid, ['last_access_timestamp' => time()]);
+            if($w_ret === false)
+            {
+                return false;
+            }
+        }
+
+        // 設定サイズ未満の場合は抜ける
+        $receiving_siz += $rcv_siz;
+        if($receiving_siz < $setting_siz)
+        {
+            return null;
+        }
+
+        // 受信データを設定
+        $ret = $this->descriptors[$p_cid]['receiving_buffer']['data'] . $rcv;
+
+        // 受信バッファを初期化
+        $this->descriptors[$p_cid]['receiving_buffer']['size'] = null;
+        $this->descriptors[$p_cid]['receiving_buffer']['data'] = null;
+        $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] = 0;
+
+        return $ret;
+    }
+
+    /**
+     * データ受信サイズの設定（バッファリング用）
+     * 
+     * ※プロトコルUNITで使用 
+     * 
+     * @param string $p_cid 接続ID
+     * @param int $p_size 受信サイズ
+     * @return bool true（成功） or false(失敗)
+     */
+    public function setBufferingReceivingSize(string $p_cid, int $p_size): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // 受信バッファへ設定
+        $this->descriptors[$p_cid]['receiving_buffer']['size'] = $p_size;
+
+        return true;
+    }
+
+    /**
+     * データ受信（バッファリング用）
+     * 
+     * setReceivingSizeで設定されたサイズ分を受信するまで続ける
+     * 
+     * ※プロトコルUNITで使用  
+     * ※最終アクセスタイムスタンプの設定はNativeIoDriverで行う
+     * 
+     * @param string $p_cid 接続ID
+     * @return mixed 受信データ or null（受信中） or false（失敗）
+     */
+    public function bufferingRreceiving(string $p_cid)
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // データ受信サイズ設定がされていない場合は抜ける
+        if
+        (
+                $this->descriptors[$p_cid]['receiving_buffer']['size'] === null
+        )
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::RECEIVE_SIZE_NO_SETTING->message($this->lang)]);
+            return false;
+        }
+
+        // 設定サイズの取得
+        $setting_siz = $this->descriptors[$p_cid]['receiving_buffer']['size'];
+
+        // 受信中サイズの取得
+        $store = $this->descriptors[$p_cid]['receiving_buffer']['store'];
+        if($store !== null)
+        {
+            $receiving_siz = $store->length();
+        }
+        else
+        {
+            $receiving_siz = $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'];
+        }
+
+        // 設定サイズ未満の場合は抜ける
+        if($receiving_siz < $setting_siz)
+        {
+            return null;
+        }
+
+        // ネイティブストアの場合は取り出した分だけ消費
+        if($store !== null)
+        {
+            $ret = $store->peek($setting_siz);
+            $store->consume($setting_siz);
+
+            $this->descriptors[$p_cid]['receiving_buffer']['size'] = null;
+            $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] = $store->length();
+
+            return $ret;
+        }
+
+        // 受信データを設定
+        $ret = substr($this->descriptors[$p_cid]['receiving_buffer']['data'], 0, $setting_siz);
+
+
+        // 受信バッファをリセット
+        $this->descriptors[$p_cid]['receiving_buffer']['size'] = null;
+        $this->descriptors[$p_cid]['receiving_buffer']['data'] = substr($this->descriptors[$p_cid]['receiving_buffer']['data'], $setting_siz);
+        $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] -= $setting_siz;
+
+        return $ret;
+    }
+
+    /**
+     * 今回のセレクトで受信イベントがあったかの検査
+     * 
+     * セレクト時に作る接続IDの集合を引くため、イベント数によらず定数時間で判定する
+     * 
+     * @param string $p_cid 接続ID
+     * @return bool true（あり） or false（なし）
+     */
+    public function isSelected(string $p_cid): bool
+    {
+        return isset($this->selected_cids[$p_cid]);
+    }
+
+    /**
+     * （receivingメソッドによる）データ受信中の検査
+     * 
+     * @param string $p_cid 接続ID
+     * @return bool true（受信中） or false（受信中ではない）
+     */
+    public function isReceiving(string $p_cid): bool
+    {
+        // 変数へ退避
+        $siz = $this->descriptors[$p_cid]['receiving_buffer']['size'];
+        $dat = $this->descriptors[$p_cid]['receiving_buffer']['data'];
+
+        // 受信バッファが未設定か
+        if($siz === null)
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * バッファリング受信データの存在検査
+     * 
+     * @param string $p_cid 接続ID
+     * @return bool true（存在する） or false（存在しない）
+     */
+    public function isExistReceivingBuffer(string $p_cid): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        $frames = $this->descriptors[$p_cid]['receiving_buffer']['frames'];
+        if($frames !== null && $frames->isEmpty() === false)
+        {
+            return true;
+        }
+
+        $store = $this->descriptors[$p_cid]['receiving_buffer']['store'];
+        if($store !== null)
+        {
+            return $store->length() > 0;
+        }
+
+        if($this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] > 0)
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * 受信フレーミングの設定
+     * 
+     * 設定後の受信データは I/O ドライバ内でフレーム単位に切り出され、完成したフレームだけが届く  
+     * 設定前に受信済みのデータは従来の受信バッファに残る
+     * 
+     * ※プロトコルUNITで使用
+     * 
+     * @param string $p_cid 接続ID
+     * @param ?array $p_spec フレーミング指定（ext/README.md 参照） or null（解除）
+     * @return bool true（成功） or false（失敗 or I/O ドライバが未対応）
+     */
+    public function setFraming(string $p_cid, ?array $p_spec): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]) || $this->descriptors[$p_cid]['udp'] !== false)
+        {
+            return false;
+        }
+
+        $w_ret = $this->iio_driver->setFraming(substr($p_cid, 1), $p_spec);
+        if($w_ret === false)
+        {
+            return false;
+        }
+
+        if($p_spec === null)
+        {
+            $this->descriptors[$p_cid]['receiving_buffer']['frames'] = null;
+        }
+        else
+        if($this->descriptors[$p_cid]['receiving_buffer']['frames'] === null)
+        {
+            $this->descriptors[$p_cid]['receiving_buffer']['frames'] = new \SplQueue();
+        }
+
+        return true;
+    }
+
+    /**
+     * 受信のレート制限の設定
+     * 
+     * トークンバケットで受信バイト数／メッセージ数を制限する。バケットが空になると I/O ドライバ内で
+     * 読み込みの停止（'delay'）、破棄（'drop'）、切断要求（'disconnect'）のいずれかを行う
+     * 
+     * 例：['bytes' => 65536, 'bytes_burst' => 262144, 'messages' => 100, 'policy' => 'delay']
+     * 
+     * @param ?string $p_cid 接続ID（null は待ち受けポート。以降に受け入れた接続全体で共有する）
+     * @param ?array $p_spec レート制限指定（ext/README.md 参照） or null（解除）
+     * @return bool true（成功） or false（失敗 or I/O ドライバが未対応）
+     */
+    public function setRateLimit(?string $p_cid, ?array $p_spec): bool
+    {
+        $cid = $p_cid ?? $this->await_connection_id;
+        if($cid === null || !isset($this->descriptors[$cid]))
+        {
+            return false;
+        }
+
+        return $this->iio_driver->setRateLimit(substr($cid, 1), $p_spec);
+    }
+
+    /**
+     * フレーム受信
+     * 
+     * setFraming で設定したフレームを 1 つ取り出す
+     * 
+     * ※プロトコルUNITで使用
+     * 
+     * @param string $p_cid 接続ID
+     * @return mixed 受信フレーム or null（受信済みのフレームなし） or false（失敗）
+     */
+    public function receivingFrame(string $p_cid)
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // フレーミングが設定されていない場合は抜ける
+        if($this->descriptors[$p_cid]['receiving_buffer']['frames'] === null)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::FRAMING_NO_SETTING->message($this->lang), 'cid' => $p_cid]);
+            return false;
+        }
+
+        $frames = $this->descriptors[$p_cid]['receiving_buffer']['frames'];
+        if($frames->isEmpty())
+        {
+            return null;
+        }
+
+        return $frames->dequeue();
+    }
+
+    /**
+     * バッファリング受信ストアの取得
+     * 
+     * ※プロトコルUNITで使用 
+     * 
+     * @param string $p_cid 接続ID
+     * @return ?\SocketsFd\Buffer 受信ストア or null（ネイティブストア未使用）
+     */
+    public function getReceivingStore(string $p_cid): ?\SocketsFd\Buffer
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return null;
+        }
+
+        return $this->descriptors[$p_cid]['receiving_buffer']['store'];
+    }
+
+    /**
+     * データ受信（バッファリング用）
+     * 
+     * 受信バッファサイズ分を受信する
+     * 
+     * ※プロトコルUNITで使用 
+     * ※最終アクセスタイムスタンプの設定はNativeIoDriverで行う
+     * 
+     * @param string $p_cid 接続ID
+     * @param mixed &$p_recv 受信エリア
+     * @param ?int $p_size 受信サイズ（指定があればデフォルトサイズより優先される）
+     * @return int 受信したサイズ or false（失敗） or null（取得できるデータがない）
+     */
+    public function bufferingRecv(string $p_cid, &$p_recv, ?int $p_size = null)
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // 受信データがなければ抜ける
+        $store = $this->descriptors[$p_cid]['receiving_buffer']['store'];
+        if($store !== null)
+        {
+            $receiving_siz = $store->length();
+        }
+        else
+        {
+            $receiving_siz = $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'];
+        }
+        if($receiving_siz <= 0)
+        {
+            return null;
+        }
+
+        // 受信サイズ決定
+        $size = $this->receive_buffer_size;
+        if($p_size !== null)
+        {
+            $size = $p_size;
+        }
+
+        $siz = min($size, $receiving_siz);
+
+        // ネイティブストアの場合は取り出した分だけ消費
+        if($store !== null)
+        {
+            $p_recv = $store->peek($siz);
+            $store->consume($siz);
+
+            $this->descriptors[$p_cid]['receiving_buffer']['size'] = null;
+            $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] = $store->length();
+
+            return $siz;
+        }
+
+        // 受信データを設定
+        $p_recv = substr($this->descriptors[$p_cid]['receiving_buffer']['data'], 0, $siz);
+
+        // 受信バッファをリセット
+        $this->descriptors[$p_cid]['receiving_buffer']['size'] = null;
+        $this->descriptors[$p_cid]['receiving_buffer']['data'] = substr($this->descriptors[$p_cid]['receiving_buffer']['data'], $siz);
+        $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] -= $siz;
+
+        return $siz;
+    }
+
+    /**
+     * データ受信（IOドライバ用）
+     * 
+     * 受信バッファサイズ分を受信する
+     * 
+     * ※プロトコルUNITで使用 
+     * 
+     * @param string $p_cid 接続ID
+     * @param mixed &$p_recv 受信エリア
+     * @param ?int $p_size 受信サイズ（指定があればデフォルトサイズより優先される）
+     * @return int 受信したサイズ or false（失敗） or null（取得できるデータがない）
+     */
+    public function ioRecv(string $p_cid, &$p_recv, ?int $p_size = null)
+    {
+        // 受信サイズ決定
+        $size = $this->receive_buffer_size;
+        if($p_size !== null)
+        {
+            $size = $p_size;
+        }
+
+        // ソケットリソースの取得
+        $soc = $this->sockets[$p_cid];
+
+        // データ受信
+        $p_recv = '';
+        $prop = $this->getProperties($p_cid, ['udp']);
+        if($prop === null)
+        {
+            $prop['udp'] = null;
+        }
+        if($prop['udp'] === true)
+        {
+            $prop = $this->getProperties($p_cid, ['udp_peers']);
+            if($prop !== null)
+            {
+                $buf = '';
+                $from = '';
+                $port = 0;
+                $w_ret = @socket_recvfrom($soc, $buf, $size, 0, $from, $port);
+                if($w_ret === false)
+                {
+                    $this->descriptors[$p_cid]['read_event'] = false;
+                    $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
+                    if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
+                    {
+                        return null;
+                    }
+
+                    // ソケット操作を完了できなかった
+                    if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
+                    {
+                        return null;
+                    }
+
+                    // 接続中の送受信
+                    if($w_ret['code'] === self::SOCKET_ERROR_SENDING_WHILE_CONNECTED)
+                    {
+                        return null;
+                    }
+
+                    // 相手からの切断を判定
+                    $shutdown = false;
+                    foreach(self::SOCKET_ERROR_PEER_SHUTDOWN as $cod)
+                    {
+                        if($w_ret['code'] === $cod)
+                        {
+                            $shutdown = true;
+                        }
+                    }
+                    if($shutdown === true)
+                    {
+                        // 緊急停止時コールバックを実行
+                        $callback = $this->emergency_callback;
+                        if($callback !== null)
+                        {
+                            $callback($this->unit_parameter);
+                        }
+                        return 0;
+                    }
+                    $this->logWriter('notice', [__METHOD__ => $w_ret['message']]);
+                    return false;
+                }
+
+                $p_recv = $buf;
+            }
+            else
+            {
+                if(AdaptiveIoDriverFactory::$mode === AdaptiveIoDriverFactory::MODE_IO_NATIVE)
+                {
+                    return false;
+                }
+                else
+                {
+                    return null;
+                }
+            }
+        }
+        else
+        {
+            $w_ret = @socket_read($soc, $size);
+            if($w_ret === false)
+            {
+                $this->descriptors[$p_cid]['read_event'] = false;
+                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
+                if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
+                {
+                    return null;
+                }
+
+                // ソケット操作を完了できなかった
+                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
+                {
+                    return null;
+                }
+
+                // 接続中の送受信
+                if($w_ret['code'] === self::SOCKET_ERROR_SENDING_WHILE_CONNECTED)
+                {
+                    return null;
+                }
+
+                // 相手からの切断を判定
+                $shutdown = false;
+                foreach(self::SOCKET_ERROR_PEER_SHUTDOWN as $cod)
+                {
+                    if($w_ret['code'] === $cod)
+                    {
+                        $shutdown = true;
+                    }
+                }
+                if($shutdown === true)
+                {
+                    // 緊急停止時コールバックを実行
+                    $callback = $this->emergency_callback;
+                    if($callback !== null)
+                    {
+                        $callback($this->unit_parameter);
+                    }
+                    return 0;
+                }
+                $this->logWriter('notice', [__METHOD__ => $w_ret['message']]);
+                return false;
+            }
+            if($w_ret === "")
+            {
+                // 緊急停止時コールバックを実行
+                $callback = $this->emergency_callback;
+                if($callback !== null)
+                {
+                    $callback($this->unit_parameter);
+                }
+                return 0;
+            }
+
+            $p_recv = $w_ret;
+        }
+
+        $len = strlen($p_recv);
+        $this->counters['bytes_in'] += $len;
+        
+        return $len;
+    }
+
+    /**
+     * データ受信
+     * 
+     * 受信バッファサイズ分を受信する
+     * 
+     * ※プロトコルUNITで使用 
+     * 
+     * @param string $p_cid 接続ID
+     * @param mixed &$p_recv 受信エリア
+     * @param ?int $p_size 受信サイズ（指定があればデフォルトサイズより優先される）
+     * @return int 受信したサイズ or false（失敗） or null（取得できるデータがない）
+     */
+    public function recv(string $p_cid, &$p_recv, ?int $p_size = null)
+    {
+        // 受信サイズ決定
+        $size = $this->receive_buffer_size;
+        if($p_size !== null)
+        {
+            $size = $p_size;
+        }
+
+        // ソケットリソースの取得
+        $soc = $this->sockets[$p_cid];
+
+        // データ受信
+        $prop = $this->getProperties($p_cid, ['udp']);
+        $udp = $prop['udp'];
+        if($udp === true)
+        {
+            $buf = '';
+            $from = '';
+            $port = 0;
+            $w_ret = @socket_recvfrom($soc, $buf, $size, 0, $from, $port);
+            if($w_ret === false)
+            {
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+                return false;
+            }
+
+            $p_recv = $buf;
+        }
+        else
+        {
+            $w_ret = @socket_read($soc, $size);
+            if($w_ret === false)
+            {
+                $this->descriptors[$p_cid]['read_event'] = false;
+                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
+                if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
+                {
+                    return null;
+                }
+
+                // ソケット操作を完了できなかった
+                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
+                {
+                    return null;
+                }
+
+                // 接続中の送受信
+                if($w_ret['code'] === self::SOCKET_ERROR_SENDING_WHILE_CONNECTED)
+                {
+                    return null;
+                }
+
+                // 相手からの切断を判定
+                $shutdown = false;
+                foreach(self::SOCKET_ERROR_PEER_SHUTDOWN as $cod)
+                {
+                    if($w_ret['code'] === $cod)
+                    {
+                        $shutdown = true;
+                    }
+                }
+                if($shutdown === true)
+                {
+                    // 緊急停止時コールバックを実行
+                    $callback = $this->emergency_callback;
+                    if($callback !== null)
+                    {
+                        $callback($this->unit_parameter);
+                    }
+                }
+                $this->logWriter('notice', [__METHOD__ => $w_ret['message']]);
+                return false;
+            }
+            if($w_ret === "")
+            {
+                if($this->descriptors[$p_cid]['read_event'] === true)
+                {
+                    throw new UnitException(
+                        UnitExceptionEnum::ECODE_EMERGENCY_SHUTDOWN->message($this->lang),
+                        UnitExceptionEnum::ECODE_EMERGENCY_SHUTDOWN->value,
+                        $this->unit_parameter
+                    );
+                }
+            }
+            $this->descriptors[$p_cid]['read_event'] = false;
+
+            $p_recv = $w_ret;
+        }
+
+        $len = strlen($p_recv);
+        $this->counters['bytes_in'] += $len;
+        
+        // 最終アクセスタイムスタンプを設定
+        if($len > 0)
+        {
+            $w_ret = $this->setProperties($p_cid, ['last_access_timestamp' => time()]);
+            if($w_ret === false)
+            {
+                return false;
+            }
+        }
+
+        return $len;
+    }
+
+    /**
+     * 送信データの設定
+     * 
+     * ※プロトコルUNITで使用
+     * 
+     * @param string $p_cid 接続ID
+     * @param string $p_data 送信データ
+     * @return bool true（成功） or false（失敗）
+     */
+    public function setSendingData(string $p_cid, string $p_data): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        $this->descriptors[$p_cid]['sending_buffer']['data'] = $p_data;
+
+        return true;
+    }
+
+    /**
+     * 送信ファイルの設定
+     * 
+     * ファイルの内容は PHP 側へ読み込まず、I/O ドライバが対応していれば sendfile／splice で送信する
+     * 
+     * setSendingData と併用した場合は送信データ（ヘッダ等）を送った後にファイルを送信する
+     * 
+     * ※プロトコルUNITで使用
+     * 
+     * @param string $p_cid 接続ID
+     * @param mixed $p_file ファイルパス or ストリームリソース
+     * @param int $p_offset 送信開始位置
+     * @param ?int $p_length 送信サイズ（null の場合はファイル末尾まで）
+     * @return bool true（成功） or false（失敗）
+     */
+    public function setSendingFile(string $p_cid, $p_file, int $p_offset = 0, ?int $p_length = null): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // ストリームの取得
+        $own = false;
+        $stream = $p_file;
+        if(is_string($p_file))
+        {
+            $stream = @fopen($p_file, 'rb');
+            if($stream === false)
+            {
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::SEND_FILE_OPEN_FAIL->message($this->lang), 'file' => $p_file, 'connection id' => $p_cid]);
+                return false;
+            }
+            $own = true;
+        }
+        if(!is_resource($stream) || $p_offset < 0)
+        {
+            return false;
+        }
+
+        // 送信サイズの確定（通常ファイル以外は指定必須）
+        $length = $p_length;
+        if($length === null)
+        {
+            $stat = fstat($stream);
+            if($stat === false || ($stat['mode'] & 0170000) !== 0100000)
+            {
+                if($own === true)
+                {
+                    fclose($stream);
+                }
+                return false;
+            }
+            $length = max(0, $stat['size'] - $p_offset);
+        }
+
+        $this->descriptors[$p_cid]['sending_buffer']['file'] = [
+            'stream' => $stream,
+            'own' => $own,
+            'offset' => $p_offset,
+            'length' => $length,
+            'native' => null    // null（未着手） or false（チャンク送信）
+        ];
+
+        return true;
+    }
+
+    /**
+     * データ送信
+     * 
+     * setSendingData／setSendingFileで設定されたデータを送信するまで続ける
+     * 
+     * ※プロトコルUNITで使用 
+     * 
+     * @param string $p_cid 接続ID
+     * @return bool|null true（成功） or false（失敗） or null（送信中）
+     */
+    public function sending(string $p_cid): ?bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // 送信データが設定されていない場合は抜ける
+        $buf = $this->descriptors[$p_cid]['sending_buffer'];
+        if($buf['data'] === null && $buf['file'] === null && $buf['queued'] === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SEND_DATA_NO_SETTING->message($this->lang), 'connection id' => $p_cid]);
+            return false;
+        }
+
+        // I/O ドライバの送信キューが空くまでは後続を送らない（送信順序の維持）
+        if($buf['queued'] === true)
+        {
+            $w_ret = $this->iio_driver->flushSend(substr($p_cid, 1));
+            if($w_ret === false)
+            {
+                $this->descriptors[$p_cid]['sending_buffer']['queued'] = false;
+                $this->logWriter('notice', [__METHOD__ => 'flushSend', 'connection id' => $p_cid]);
+                return false;
+            }
+            if($w_ret > 0)
+            {
+                return null;
+            }
+            $this->descriptors[$p_cid]['sending_buffer']['queued'] = false;
+        }
+
+        // 送信データ（ファイルより先に送る）
+        if($buf['data'] !== null)
+        {
+            $w_ret = $this->sendingData($p_cid);
+            if($w_ret !== true)
+            {
+                return $w_ret;
+            }
+        }
+
+        // 送信ファイル
+        if($buf['file'] !== null)
+        {
+            return $this->sendingFile($p_cid);
+        }
+
+        return true;
+    }
+
+    /**
+     * 送信データの送信
+     * 
+     * @param string $p_cid 接続ID
+     * @return bool|null true（成功） or false（失敗） or null（送信中）
+     */
+    private function sendingData(string $p_cid): ?bool
+    {
+        // ソケットリソースの取得
+        $soc = $this->sockets[$p_cid];
+
+        // 送信中データの取得
+        $dat = $this->descriptors[$p_cid]['sending_buffer']['data'];
+
+        // 送信処理
+        $prop = $this->getProperties($p_cid, ['udp']);
+        if($prop === null)
+        {
+            $udp = null;
+        }
+        else
+        {
+            $udp = $prop['udp'];
+        }
+        if($udp === true)
+        {
+            // 送信先を取得
+            $prop = $this->getProperties($p_cid, ['udp_peers']);
+
+            // データ送信
+            $len = strlen($dat);
+            if($this->descriptors[$p_cid]['unix_address'] !== null)
+            {
+                // UNIX ドメインは接続済みのソケットで送信（抽象名前空間のアドレスは sendto で指定できないため）
+                $w_ret = @socket_send($soc, $dat, $len, 0);
+            }
+            else
+            {
+                $host = $prop['udp_peers']['host'];
+                $port = $prop['udp_peers']['port'];
+                $w_ret = @socket_sendto($soc, $dat, $len, 0, $host, $port);
+            }
+            if($w_ret === false)
+            {
+                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
+                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
+                {
+                    return null;
+                }
+                $this->logWriter('error', [__METHOD__ => 'socket_sendto', "message" => $w_ret['message'], 'connection id' => $p_cid]);
+                return false;
+            }
+        }
+        else
+        if($this->descriptors[$p_cid]['ipc'] === true)
+        {
+            // 共有メモリIPCのリングへ書き込む（空きがなければ 0。残りは次回送信）
+            $w_ret = $this->iio_driver->sendIpc(substr($p_cid, 1), $dat);
+            if($w_ret === false || $w_ret === null)
+            {
+                $this->logWriter('notice', [__METHOD__ => 'sendIpc', 'connection id' => $p_cid]);
+                return false;
+            }
+        }
+        else
+        if($this->zerocopy_threshold > 0 && strlen($dat) >= $this->zerocopy_threshold)
+        {
+            // I/O ドライバによる送信（MSG_ZEROCOPY）
+            // 送り切れなかった分はドライバ側で保持されるので、以降は送信キューの完了を待つ
+            $w_ret = $this->iio_driver->sendData(substr($p_cid, 1), $dat);
+            if($w_ret === false)
+            {
+                $this->logWriter('notice', [__METHOD__ => 'sendData', 'connection id' => $p_cid]);
+                return false;
+            }
+            $this->descriptors[$p_cid]['sending_buffer']['data'] = null;
+            if($w_ret > 0)
+            {
+                $this->descriptors[$p_cid]['sending_buffer']['queued'] = true;
+                return null;
+            }
+            return true;
+        }
+        else
+        {
+            // データ送信
+            $w_ret = @socket_write($soc, $dat, strlen($dat));
+            if($w_ret === false)
+            {
+                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
+                if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
+                {
+                    return null;
+                }
+                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
+                {
+                    return null;
+                }
+                if($w_ret['code'] === self::SOCKET_ERROR_SENDING_WHILE_CONNECTED)
+                {
+                    return null;
+                }
+                $this->logWriter('notice', [__METHOD__ => 'socket_write', "message" => $w_ret['message'], 'connection id' => $p_cid]);
+                return false;
+            }
+        }
+        $this->counters['bytes_out'] += $w_ret;
+
+        // 送信完了でない場合
+        if($w_ret < strlen($dat))
+        {
+            // 送信バッファに次回送信分をセットする
+            $dat = substr($dat, $w_ret);
+            $this->descriptors[$p_cid]['sending_buffer']['data'] = $dat;
+            return null;
+        }
+
+        // 送信バッファを初期化
+        $this->descriptors[$p_cid]['sending_buffer']['data'] = null;
+
+        return true;
+    }
+
+    /**
+     * 送信ファイルの送信
+     * 
+     * I/O ドライバが対応していればカーネル内でコピーさせ、未対応ならチャンク単位で読み込んで送信する
+     * 
+     * @param string $p_cid 接続ID
+     * @return bool|null true（成功） or false（失敗） or null（送信中）
+     */
+    private function sendingFile(string $p_cid): ?bool
+    {
+        $file = &$this->descriptors[$p_cid]['sending_buffer']['file'];
+        $fd = substr($p_cid, 1);
+
+        // 共有メモリIPCはチャンク単位でリングへ書き込む
+        if($file['native'] === null && $this->descriptors[$p_cid]['ipc'] === true)
+        {
+            $file['native'] = false;
+        }
+
+        // I/O ドライバによる送信（残りは EPOLLOUT を契機にドライバ内で送信される）
+        if($file['native'] === null)
+        {
+            $w_ret = $this->iio_driver->sendFile($fd, $file['stream'], $file['offset'], $file['length']);
+            if($w_ret === null)
+            {
+                $file['native'] = false;
+            }
+            else
+            {
+                // 入力はドライバ側で複製済みなので、ここで手放してよい
+                $this->clearSendingFile($p_cid);
+                if($w_ret === false)
+                {
+                    $this->logWriter('notice', [__METHOD__ => 'sendFile', 'connection id' => $p_cid]);
+                    return false;
+                }
+                if($w_ret > 0)
+                {
+                    $this->descriptors[$p_cid]['sending_buffer']['queued'] = true;
+                    return null;
+                }
+                return true;
+            }
+        }
+
+        // 送信済みのチャンクがなければ次を読み込む
+        if($this->descriptors[$p_cid]['sending_buffer']['data'] === null)
+        {
+            if($file['length'] <= 0)
+            {
+                $this->clearSendingFile($p_cid);
+                return true;
+            }
+
+            $size = min(self::SENDING_FILE_CHUNK_SIZE, $file['length']);
+            $dat = stream_get_contents($file['stream'], $size, $file['offset']);
+            if($dat === false || $dat === '')
+            {
+                $this->logWriter('notice', [__METHOD__ => 'stream_get_contents', 'connection id' => $p_cid]);
+                $this->clearSendingFile($p_cid);
+                return false;
+            }
+            $file['offset'] += strlen($dat);
+            $file['length'] -= strlen($dat);
+            $this->descriptors[$p_cid]['sending_buffer']['data'] = $dat;
+        }
+
+        $w_ret = $this->sendingData($p_cid);
+        if($w_ret !== true)
+        {
+            if($w_ret === false)
+            {
+                $this->clearSendingFile($p_cid);
+            }
+            return $w_ret;
+        }
+
+        if($file['length'] > 0)
+        {
+            return null;
+        }
+
+        $this->clearSendingFile($p_cid);
+        return true;
+    }
+
+    /**
+     * 送信ファイルの解放
+     * 
+     * @param string $p_cid 接続ID
+     */
+    private function clearSendingFile(string $p_cid)
+    {
+        $file = $this->descriptors[$p_cid]['sending_buffer']['file'];
+        if($file !== null && $file['own'] === true)
+        {
+            fclose($file['stream']);
+        }
+        $this->descriptors[$p_cid]['sending_buffer']['file'] = null;
+    }
+
+
+    /**
+     * （sendingメソッドによる）データ送信中の検査
+     * 
+     * @param string $p_cid 接続ID
+     * @return bool true（送信中） or false（送信中ではない）
+     */
+    public function isSending(string $p_cid): bool
+    {
+        // 変数へ退避
+        $buf = $this->descriptors[$p_cid]['sending_buffer'];
+
+        // 送信バッファ／送信ファイルが未設定か
+        if($buf['data'] === null && $buf['file'] === null && $buf['queued'] === false)
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------
+    // 送受信バッファ操作
+    //--------------------------------------------------------------------------
+
+    /**
+     * 受信データスタックから取得
+     * 
+     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
+     * 
+     * @param string $p_cid 接続ID
+     * @param bool $p_convert
+     * ― 変換（シリアライズ／アンシリアライズの行使）フラグ
+     * 
+     * ― フラグ指定に関わらずシリアライザーが登録されていなければ変換はされない
+     * 
+     * @return mixed 受信した最新のペイロードデータ or null（空） or false（失敗）
+     */
+    private function getRecvStack(string $p_cid, bool $p_convert = true)
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // １件もなければ抜ける
+        $cnt = count($this->descriptors[$p_cid]['receive_buffers']);
+        if($cnt <= 0)
+        {
+            return null;
+        }
+
+        // １件分取得
+        $buf = array_shift($this->descriptors[$p_cid]['receive_buffers']);
+
+        $dat = $buf;
+        if($p_convert === true)
+        {
+            // アンシリアライザーの実行
+            if($this->unserializer !== null)
+            {
+                $unserializer = $this->unserializer;
+                $dat = $unserializer($buf);
+            }
+        }
+
+        return $dat;
+    }
+
+    /**
+     * 受信データスタックへ設定
+     * 
+     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
+     * 
+     * @param string $p_cid 接続ID
+     * @param mixed $p_data 設定するデータ
+     * @param bool $p_convert
+     * ― 変換（シリアライズ／アンシリアライズの行使）フラグ
+     * 
+     * ― フラグ指定に関わらずシリアライザーが登録されていなければ変換はされない
+     * 
+     * @return bool true（成功） or false（失敗）
+     */
+    public function setRecvStack(string $p_cid, $p_data = null, bool $p_convert = false): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // シリアライザーの実行
+        $data = $p_data;
+        if($p_convert === true && $this->serializer !== null)
+        {
+            $serializer = $this->serializer;
+            $data = $serializer($data);
+        }
+
+        // 最後尾に追加
+        array_push($this->descriptors[$p_cid]['receive_buffers'], $data);
+
+        return true;
+    }
+
+    /**
+     * 送信データスタックから取得
+     * 
+     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
+     * 
+     * @param string $p_cid 接続ID
+     * @param bool $p_convert
+     * ― 変換（シリアライズ／アンシリアライズの行使）フラグ
+     * 
+     * ― フラグ指定に関わらずシリアライザーが登録されていなければ変換はされない
+     * 
+     * @return mixed 送信データスタックエントリ or null（空） or false（失敗）
+     */
+    private function getSendStack(string $p_cid, bool $p_convert = false)
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // １件もなければ抜ける
+        $cnt = count($this->descriptors[$p_cid]['send_buffers']);
+        if($cnt <= 0)
+        {
+            return null;
+        }
+
+        // １件分取得
+        $buf = array_shift($this->descriptors[$p_cid]['send_buffers']);
+
+        // アンシリアライザーの実行
+        $data = $buf;
+        if($p_convert === true)
+        {
+            if($this->unserializer !== null)
+            {
+                $unserializer = $this->unserializer;
+                $data = $unserializer($buf);
+            }
+        }
+
+        return $data;
+    }
+
+    /**
+     * 送信データスタックへ設定
+     * 
+     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
+     * 
+     * @param string $p_cid 接続ID
+     * @param mixed $p_data 送信データ
+     * @return bool true（成功） or false（失敗）
+     */
+    public function setSendStack(string $p_cid, $p_data): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // シリアライズ
+        $data = $p_data;
+        if($this->serializer !== null)
+        {
+            $serializer = $this->serializer;
+            $data = $serializer($data);
+        }
+
+        // 送信データスタックへ追加
+        array_push($this->descriptors[$p_cid]['send_buffers'], $data);
+
+        return true;
+    }
+
+    /**
+     * 全接続の送信データスタックへ設定
+     * 
+     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
+     * 
+     * @param string $p_cid 接続ID
+     * @param mixed $p_data 送信データ
+     * @param bool $p_self_remove 自身の接続の除外フラグ
+     * @return bool true（成功） or false（失敗）
+     */
+    public function setSendStackAll(string $p_cid, $p_data, bool $p_self_remove = false): bool
+    {
+        // ディスクリプタが存在しなければ抜ける
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return false;
+        }
+
+        // 全ディスクリプタを退避
+        $dess = $this->descriptors;
+
+        // Listenポートを除く
+        unset($dess[$this->await_connection_id]);
+
+        // 自身を除く
+        if($p_self_remove === true)
+        {
+            unset($dess[$p_cid]);
+        }
+
+        // 全ディスクリプタでループ
+        foreach($dess as $cid => $des)
+        {
+            // 送信データスタックへ追加
+            $w_ret = $this->setSendStack($cid, $p_data);
+            if($w_ret === false)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    //--------------------------------------------------------------------------
+    // 内部処理
+    //--------------------------------------------------------------------------
+
+    /**
+     * キュー名の設定（処理開始用）
+     * 
+     * @param string $p_kind 設定対象種別（'protocol_names' or 'command_names'）
+     * @param string $p_cid 接続ID
+     * @param ?string $p_name キュー名 or null（なし）
+     * @return bool true（成功） or false (失敗)
+     */
+    private function setQueueNameForStart(string $p_kind, string $p_cid, ?string $p_name): bool
+    {
+        // キュー名の設定
+        $this->descriptors[$p_cid][$p_kind]['queue_name'] = $p_name;
+        $this->descriptors[$p_cid][$p_kind]['unit_id'] = null;
+
+        // ステータス名の設定
+        if($p_name === null)
+        {
+            $this->descriptors[$p_cid][$p_kind]['status_name'] = null;
+        }
+        else
+        {
+            if($p_kind === 'protocol_names')
+            {
+                $this->descriptors[$p_cid][$p_kind]['status_name'] = StatusEnum::START->value;
+            }
+            else
+            if($this->descriptors[$p_cid][$p_kind]['status_name'] === null)
+            {
+                $this->descriptors[$p_cid][$p_kind]['status_name'] = StatusEnum::START->value;
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * UNIT実行中の検査
+     * 
+     * @param string $p_kind 調査対象種別（'protocol_names' or 'command_names'）
+     * @param string $p_cid 接続ID
+     * @return bool true（実行中） or false（未実行）
+     */
+    private function isExecutingSequence(string $p_kind, string $p_cid): bool
+    {
+        // 強制ディスパッチの実行
+        if($p_kind === 'command_names')
+        {
+            if($this->descriptors[$p_cid]['forced_dispatcher'] === true)
+            {
+                // １件もなければ抜ける
+                $cnt = count($this->descriptors[$p_cid]['receive_buffers']);
+                if($cnt <= 0)
+                {
+                    return true;
+                }
+                $this->descriptors[$p_cid]['forced_dispatcher'] = false;
+                return false;
+            }
+        }
+
+        // キュー名の取得
+        $que_nam = $this->descriptors[$p_cid][$p_kind]['queue_name'];
+
+        // ステータス名の取得
+        $sta_nam = $this->descriptors[$p_cid][$p_kind]['status_name'];
+
+        // 実行中
+        if(isset($que_nam) && isset($sta_nam))
+        {
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * UNITの実行
+     * 
+     * @param string $p_cid 接続ID
+     * @param string $p_kind UNIT種別（"protocol_names" or "command_names"）
+     * @return bool true（成功） or false（切断）
+     */
+    private function executeUnit(string $p_cid, string $p_kind): bool
+    {
+        // 周期ドリブンマネージャーの取得
+        $cycle_driven = $this->cycle_driven_for_protocol;
+        if($p_kind !== 'protocol_names')
+        {
+            $cycle_driven = $this->cycle_driven_for_command;
+        }
+
+        // UNIT プロファイラーの計測開始（サンプリング対象で実行中の UNIT がある時のみ）
+        $prof = null;
+        if($this->profiler !== null && $this->profiler->sample())
+        {
+            $names = $this->descriptors[$p_cid][$p_kind];
+            if($names['queue_name'] !== null && $names['status_name'] !== null)
+            {
+                $prof = [$names['queue_name'], $names['status_name'], memory_get_usage(), hrtime(true)];
+            }
+        }
+
+        // UNIT 1 回の所要時間（実行中の UNIT がある時のみ）
+        $timed = false;
+        if($this->stats !== null)
+        {
+            $names = $this->descriptors[$p_cid][$p_kind];
+            if($names['queue_name'] !== null && $names['status_name'] !== null)
+            {
+                $timed = true;
+                $this->iio_driver->statsBegin(IIoDriver::STATS_UNIT);
+            }
+        }
+
+        // UNITの実行
+        $this->unit_parameter->setKindString($p_kind);
+        $ret = true;
+        try
+        {
+            // コンパイル済みの UNIT がなければ名前で実行する（Fiber UNIT 等）
+            $w_ret = $this->executeCompiledUnit($cycle_driven, $p_cid, $p_kind);
+            if($w_ret === false)
+            {
+                $w_ret = $cycle_driven->cycleDriven($this->unit_parameter, $p_cid);
+            }
+            if($w_ret === false)
+            {
+                $que = $this->getQueueName($p_kind, $p_cid);
+                $sta = $this->getStatusName($p_kind, $p_cid);
+                $this->logWriter('warning', [__METHOD__ => LogMessageEnum::UNIT_NO_SETTING->message($this->lang)."[{$que}][{$sta}]"]);
+            }
+        }
+        catch(UnitException | Exception $e)
+        {
+            $w_ret = get_class($e);
+            if($w_ret === self::E_CLASS_NAME_FOR_UNIT)
+            {
+                if($e->getCode() !== UnitExceptionEnum::ECODE_THROW_BREAK->value)
+                {
+                    $this->logWriter('error', $e->getArrayMessage());
+                    $this->shutdown($p_cid);	// ソケット緊急切断
+                    $ret = false;
+                }
+            }
+            else
+            {
+                $this->logWriter('error', ['code' => $e->getCode(), 'message' => $e->getMessage(), 'trace' => $e->getTraceAsString()]);
+                $this->shutdown($p_cid);	// ソケット緊急切断
+                $ret = false;
+            }
+        }
+
+        if($timed === true)
+        {
+            $this->iio_driver->statsEnd(IIoDriver::STATS_UNIT);
+        }
+
+        // UNIT プロファイラーの計測終了
+        if($prof !== null)
+        {
+            $this->profiler->record($p_kind, $prof[0], $prof[1], hrtime(true) - $prof[3], memory_get_usage() - $prof[2]);
+        }
+
+        return $ret;
+    }
+
+    /**
+     * 計測値のログ出力
+     * 
+     * 計測対象ごとに p50／p99／p99.9／max を 1 行で出力し、計測値をクリアする（時間は μs）
+     */
+    private function reportStats()
+    {
+        $w_ret = $this->iio_driver->getStats(true);
+        if(!is_array($w_ret))
+        {
+            return;
+        }
+
+        $line = [];
+        foreach($w_ret as $name => $hist)
+        {
+            $div = $name === 'events' ? 1 : 1000;
+            $line[] = sprintf(
+                '%s n=%d p50=%s p99=%s p999=%s max=%s',
+                $name, $hist['count'],
+                round($hist['p50'] / $div, 1), round($hist['p99'] / $div, 1), round($hist['p999'] / $div, 1), round($hist['max'] / $div, 1)
+            );
+        }
+        $this->logWriter('info', [__METHOD__ => LogMessageEnum::STATS_REPORT->message($this->lang), 'stats' => implode(' | ', $line)]);
+    }
+
+    /**
+     * コンパイル済み UNIT の実行
+     * 
+     * ディスクリプタに保持した UNIT ID で UNIT を呼び出し、遷移先の UNIT ID とステータス名を反映する
+     * 
+     * @param CycleDrivenManager $p_cycle_driven 周期ドリブンマネージャー
+     * @param string $p_cid 接続ID
+     * @param string $p_kind UNIT種別（"protocol_names" or "command_names"）
+     * @return bool true（成功） or false（コンパイル済みの UNIT がない）
+     */
+    private function executeCompiledUnit(CycleDrivenManager $p_cycle_driven, string $p_cid, string $p_kind): bool
+    {
+        $names = $this->descriptors[$p_cid][$p_kind];
+        $uid = $names['unit_id'];
+        if($uid === null)
+        {
+            $uid = $p_cycle_driven->getUnitId($names['queue_name'], $names['status_name']);
+            if($uid === null)
+            {
+                return false;
+            }
+            $this->descriptors[$p_cid][$p_kind]['unit_id'] = $uid;
+        }
+
+        $cur = $uid;
+        $sta = null;
+        $w_ret = $p_cycle_driven->cycleDrivenById($this->unit_parameter, $uid, $sta);
+        if($w_ret === false)
+        {
+            $this->descriptors[$p_cid][$p_kind]['unit_id'] = null;
+            return false;
+        }
+
+        // UNIT 内で切断された
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return true;
+        }
+
+        // UNIT 内でキュー名／ステータス名が変更された場合は次の実行時に名前から引き直す
+        if($this->descriptors[$p_cid][$p_kind]['unit_id'] !== $cur)
+        {
+            $uid = null;
+        }
+        $this->descriptors[$p_cid][$p_kind]['status_name'] = $sta;
+        $this->descriptors[$p_cid][$p_kind]['unit_id'] = $uid;
+
+        return true;
+    }
+
+    /**
+     * ソケットのアドレス情報を取得
+     * 
+     * @param string $p_cid 接続ID
+     * @param string &$p_host ホストアドレス格納先
+     * @param int &$p_port ポート番号格納先
+     * @return bool true（成功） or false（失敗）
+     */
+    public function getSockName(string $p_cid, string &$p_host, int &$p_port): bool
+    {
+        return socket_getsockname($this->sockets[$p_cid], $p_host, $p_port);
+    }
+
+    /**
+     * 接続相手の資格情報を取得（UNIX ドメインのストリーム用）
+     * 
+     * 接続した時点の相手プロセスの pid／uid／gid（SO_PEERCRED）を返す。socketsfd 拡張（Linux）が必要
+     * 
+     * @param string $p_cid 接続ID
+     * @return ?array ['pid' => int, 'uid' => int, 'gid' => int] or null（取得できない）
+     */
+    public function getPeerCredentials(string $p_cid): ?array
+    {
+        if(!isset($this->sockets[$p_cid]) || !function_exists('socketsfd_peer_cred'))
+        {
+            return null;
+        }
+
+        $w_ret = @socketsfd_peer_cred($this->sockets[$p_cid]);
+        if($w_ret === false)
+        {
+            return null;
+        }
+
+        return $w_ret;
+    }
+
+    /**
+     * ソケットディスクリプタの生成
+     * 
+     * @param Socket $p_socket ソケットリソース
+     * @param ?bool $p_udp UDPフラグ
+     * @param bool $p_listen Listenポートフラグ
+     * @param bool $p_is_client クライアントフラグ
+     * @return array|bool ディスクリプタ or false（失敗）
+     */
+    private function createDescriptor(Socket $p_socket, ?bool $p_udp = false, bool $p_listen = false, bool $p_is_client = false)
+    {
+        $id = null;
+        if($p_listen === true)
+        {
+            if($p_udp === null && $p_listen && AdaptiveIoDriverFactory::$mode === AdaptiveIoDriverFactory::MODE_IO_NATIVE && PHP_OS_FAMILY === 'Windows')
+            {
+                $id = $this->iio_driver->registerUdpListen($p_socket);
+            }
+            else
+            {
+                $id = $this->iio_driver->registerListen($p_socket);
+            }
+        }
+        else
+        {
+            $flg = $p_udp;
+            if($flg === null)
+            {
+                $flg = true;
+            }
+            $id = $this->iio_driver->register($p_socket, $flg, $p_is_client);
+        }
+
+        // ソケットの接続IDを生成
+        $cid = '#'.$id;
+
+        // ソケット要素の反映
+        $this->sockets[$cid] = $p_socket;
+
+        $this->descriptors[$cid] = [];
+
+        // 接続ID
+        $this->descriptors[$cid]['connection_id'] = $cid;
+
+        // リモートアドレス
+        $this->descriptors[$cid]['remote'] = [
+            'host' => null,
+            'port' => null
+        ];
+
+        // UDPフラグ
+        $this->descriptors[$cid]['udp'] = $p_udp;
+
+        // 非同期接続中フラグ
+        $this->descriptors[$cid]['connecting'] = false;
+
+        // readイベントフラグ
+        $this->descriptors[$cid]['read_event'] = false;
+
+        // UDPクライアントリスト
+        $this->descriptors[$cid]['udp_peers'] = null;
+
+        // UNIX ドメインでバインドしたアドレス（クローズ時にソケットファイルを削除）
+        $this->descriptors[$cid]['unix_address'] = null;
+
+        // 共有メモリIPCフラグ（送信は I/O ドライバのリングへ書き込む）
+        $this->descriptors[$cid]['ipc'] = false;
+
+        // オフロード中のジョブ数
+        $this->descriptors[$cid]['offload_jobs'] = 0;
+
+        // キューの開始待ちのオフロード結果（['queue', 'status', 'data']）
+        $this->descriptors[$cid]['offload_callbacks'] = [];
+
+        // 送信バッファスタック
+        $this->descriptors[$cid]['send_buffers'] = [];
+
+        // 受信バッファスタック
+        $this->descriptors[$cid]['receive_buffers'] = [];
+
+        // 受信バッファ
+        $this->descriptors[$cid]['receiving_buffer'] = [
+            'size' => null,
+            'data' => null,
+            'receiving_size' => 0,
+            'store' => ($this->native_buffer === true && $p_listen === false) ? new \SocketsFd\Buffer($this->receive_buffer_size) : null,
+            'frames' => null
+        ];
+
+        // 送信バッファ
+        $this->descriptors[$cid]['sending_buffer'] = [
+            'data' => null,
+            'file' => null,
+            'queued' => false
+        ];
+
+        // ピックアップ受信バッファ（コマンドUNIT用）
+        $this->descriptors[$cid]['receive_buffer'] = null;
+
+        // ピックアップ送信バッファ（プロトコルUNIT用）
+        $this->descriptors[$cid]['send_buffer'] = null;
+
+        // 切断情報バッファ
+        $this->descriptors[$cid]['close_buffer'] = null;
+
+        // プロトコル用
+        $this->descriptors[$cid]['protocol_names'] = [
+              'queue_name' => null	// キュー名
+            , 'status_name' => null	// ステータス名
+            , 'unit_id' => null		// UNIT ID
+        ];
+
+        // コマンド用
+        $this->descriptors[$cid]['command_names'] = [
+              'queue_name' => null	// キュー名
+            , 'status_name' => null	// ステータス名
+            , 'unit_id' => null		// UNIT ID
+        ];
+
+        // 最終アクセス日時
+        $this->descriptors[$cid]['last_access_timestamp'] = time();
+
+        // アライブチェックタイムアウト調整用
+        $this->descriptors[$cid]['alive_adjust_timeout'] = null;
+
+        // 強制ディスパッチフラグ
+        $this->descriptors[$cid]['forced_dispatcher'] = false;
+
+        // ユーザープロパティ（自由定義）
+        $this->descriptors[$cid]['user_property'] = [];
+
+        // ノンブロッキングの設定
+        $w_ret = socket_set_nonblock($p_socket);
+        if($w_ret === false) {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::NONBLOCK_SETTING_FAIL->message($this->lang)]);
+            return false;
+        }
+
+        // ソケットチューニングプロファイルの適用（I/O ドライバが未対応の場合）
+        $profile = $this->socket_profiles[$p_is_client === true ? 'client' : 'server'];
+        if($profile !== null && $profile['native'] === false)
+        {
+            $this->applySocketProfile($p_socket, $profile['options'], $p_listen, $p_udp !== false);
+        }
+
+        return $this->descriptors[$cid];
+    }
+
+    /**
+     * ソケットチューニングプロファイルの適用（socket_set_option 版）
+     * 
+     * 適用できない項目（PHP 側に定数がない等）は読み飛ばす
+     * 
+     * @param Socket $p_socket ソケットリソース
+     * @param array $p_options オプション配列
+     * @param bool $p_listen 待ち受けフラグ
+     * @param bool $p_udp UDPフラグ
+     */
+    private function applySocketProfile(Socket $p_socket, array $p_options, bool $p_listen, bool $p_udp)
+    {
+        foreach($p_options as $key => $val)
+        {
+            if($val === null)
+            {
+                continue;
+            }
+
+            // listen ソケットはバッファサイズのみ、UDP は TCP 固有の項目を除く
+            $level = SOL_SOCKET;
+            $name = null;
+            if($key === 'sndbuf')
+            {
+                $name = SO_SNDBUF;
+            }
+            else
+            if($key === 'rcvbuf')
+            {
+                $name = SO_RCVBUF;
+            }
+            else
+            if($p_listen === true)
+            {
+                continue;
+            }
+            else
+            if($key === 'busy_poll')
+            {
+                $name = defined('SO_BUSY_POLL') ? constant('SO_BUSY_POLL') : null;
+            }
+            else
+            if($p_udp === true)
+            {
+                continue;
+            }
+            else
+            if($key === 'keepalive')
+            {
+                $name = SO_KEEPALIVE;
+            }
+            else
+            {
+                $level = SOL_TCP;
+                $const = 'TCP_'.strtoupper($key);
+                $name = defined($const) ? constant($const) : null;
+            }
+
+            if($name === null)
+            {
+                continue;
+            }
 
-        return true;
+            $w_ret = @socket_set_option($p_socket, $level, $name, (int)$val);
+            if($w_ret === false)
+            {
+                $this->logWriter('notice', [__METHOD__ => LogMessageEnum::SOCKET_OPTION_SETTING_FAIL->message($this->lang), 'option' => $key]);
+            }
+        }
     }
 
     /**
-     * データ受信（バッファリング用）
-     * 
-     * setReceivingSizeで設定されたサイズ分を受信するまで続ける
+     * UNIX ドメインソケットのアドレス変換
      * 
-     * ※プロトコルUNITで使用  
-     * ※最終アクセスタイムスタンプの設定はNativeIoDriverで行う
+     * 'unix:///path' はファイルシステム上のパス、'unix://@name' は抽象名前空間（先頭 NUL）のアドレスに変換する
      * 
-     * @param string $p_cid 接続ID
-     * @return mixed 受信データ or null（受信中） or false（失敗）
+     * @param string $p_host ホスト名
+     * @return string|false|null ソケット関数に渡すアドレス or false（不正なアドレス） or null（UNIX ドメインではない）
      */
-    public function bufferingRreceiving(string $p_cid)
+    private function unixAddress(string $p_host): string|false|null
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        if(strncmp($p_host, self::UNIX_ADDRESS_PREFIX, strlen(self::UNIX_ADDRESS_PREFIX)) !== 0)
         {
-            return false;
+            return null;
         }
 
-        // データ受信サイズ設定がされていない場合は抜ける
-        if
-        (
-                $this->descriptors[$p_cid]['receiving_buffer']['size'] === null
-        )
+        $path = substr($p_host, strlen(self::UNIX_ADDRESS_PREFIX));
+        if(strlen($path) < 2 || strlen($path) >= self::UNIX_ADDRESS_MAX)
         {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::RECEIVE_SIZE_NO_SETTING->message($this->lang)]);
             return false;
         }
+        if($path[0] === '@')
+        {
+            return "\0".substr($path, 1);
+        }
+        if($path[0] === '/')
+        {
+            return $path;
+        }
 
-        // 設定サイズの取得
-        $setting_siz = $this->descriptors[$p_cid]['receiving_buffer']['size'];
-
-        // 受信中サイズの取得
-        $receiving_siz = $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'];
+        return false;
+    }
 
-        // 設定サイズ未満の場合は抜ける
-        if($receiving_siz < $setting_siz)
+    /**
+     * UNIX ドメインソケットのバインド
+     * 
+     * 前回のプロセスが残したソケットファイルがあれば削除してからバインドする  
+     * 接続できるソケットファイルは使用中とみなして削除しない（バインドは EADDRINUSE で失敗する）
+     * 
+     * @param Socket $p_socket ソケットリソース
+     * @param string $p_address アドレス
+     * @return bool true（成功） or false（失敗）
+     */
+    private function bindUnix(Socket $p_socket, string $p_address): bool
+    {
+        if($p_address[0] !== "\0" && @filetype($p_address) === 'socket')
         {
-            return null;
+            $type = socket_get_option($p_socket, SOL_SOCKET, SO_TYPE);
+            $soc = @socket_create(AF_UNIX, $type, 0);
+            if($soc !== false)
+            {
+                socket_set_nonblock($soc);
+                $w_ret = @socket_connect($soc, $p_address);
+                $cod = socket_last_error($soc);
+                socket_close($soc);
+                if($w_ret === false && $cod === self::SOCKET_ERROR_CONNECTION_REFUSED)
+                {
+                    @unlink($p_address);
+                }
+            }
         }
 
-        // 受信データを設定
-        $ret = substr($this->descriptors[$p_cid]['receiving_buffer']['data'], 0, $setting_siz);
-
+        return @socket_bind($p_socket, $p_address);
+    }
 
-        // 受信バッファをリセット
-        $this->descriptors[$p_cid]['receiving_buffer']['size'] = null;
-        $this->descriptors[$p_cid]['receiving_buffer']['data'] = substr($this->descriptors[$p_cid]['receiving_buffer']['data'], $setting_siz);
-        $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] -= $setting_siz;
+    /**
+     * UNIX ドメインのデータグラム用ローカルアドレスの生成
+     * 
+     * 待ち受けアドレスにプロセスIDと通番を付加する（抽象名前空間なら抽象名前空間のまま）
+     * 
+     * @param string $p_address 待ち受けアドレス
+     * @return string ローカルアドレス
+     */
+    private function createUnixLocalAddress(string $p_address): string
+    {
+        $this->unix_sequence++;
 
-        return $ret;
+        return $p_address.'.'.getmypid().'.'.$this->unix_sequence;
     }
 
     /**
-     * （receivingメソッドによる）データ受信中の検査
+     * UNIX ドメインのソケットファイルの削除
      * 
-     * @param string $p_cid 接続ID
-     * @return bool true（受信中） or false（受信中ではない）
+     * @param string $p_address アドレス（抽象名前空間は対象外）
      */
-    public function isReceiving(string $p_cid): bool
+    private function unlinkUnixAddress(string $p_address)
     {
-        // 変数へ退避
-        $siz = $this->descriptors[$p_cid]['receiving_buffer']['size'];
-        $dat = $this->descriptors[$p_cid]['receiving_buffer']['data'];
-
-        // 受信バッファが未設定か
-        if($siz === null)
+        if($p_address[0] !== "\0")
         {
-            return false;
+            @unlink($p_address);
         }
-
-        return true;
     }
 
     /**
-     * バッファリング受信データの存在検査
+     * UNIX ドメインのデータグラム接続の識別（クライアント側）
      * 
-     * @param string $p_cid 接続ID
-     * @return bool true（存在する） or false（存在しない）
+     * 一時ソケットから待ち受け側へ自身のアドレスを送り、待ち受け側が生成した通信用ソケットのアドレスを受け取る  
+     * 抽象名前空間のアドレスは recvfrom で取得できないため、識別データとしてアドレスそのものを送り合う  
+     * （接続済みのデータグラムソケットは接続先以外からの送信を受け付けないため、送信は一時ソケットで行う）
+     * 
+     * @param Socket $p_socket ソケットリソース（自身のアドレスへバインド済み）
+     * @param string $p_address 待ち受けアドレス
+     * @param string $p_local 自身のアドレス
+     * @param string &$p_peer 通信用ソケットのアドレス格納先
+     * @return ?bool true（成功） or false（失敗） or null（待ち受け側が未起動）
      */
-    public function isExistReceivingBuffer(string $p_cid): bool
+    private function identifyUnixDatagram(Socket $p_socket, string $p_address, string $p_local, string &$p_peer): ?bool
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        $w_ret = socket_create(AF_UNIX, SOCK_DGRAM, 0);
+        if($w_ret === false)
         {
+            $this->logWriter('error', [__METHOD__ => 'socket_create', 'message' => LogMessageEnum::SOCKET_ERROR->socket()]);
             return false;
         }
+        $tmp = $w_ret;
 
-        if($this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] > 0)
+        $w_ret = @socket_connect($tmp, $p_address);
+        if($w_ret !== false)
         {
-            return true;
+            $w_ret = @socket_send($tmp, $p_local, strlen($p_local), 0);
+        }
+        if($w_ret === false)
+        {
+            $w_ret = LogMessageEnum::SOCKET_ERROR->array($tmp);
+            socket_close($tmp);
+            if(in_array($w_ret['code'], self::SOCKET_ERROR_UNIX_NOT_READY, true))
+            {
+                return null;
+            }
+            $this->logWriter('error', [__METHOD__ => 'socket_send', 'message' => $w_ret['message']]);
+            return false;
         }
+        socket_close($tmp);
 
-        return false;
+        // 応答の受信（通信用ソケットのアドレス）
+        $buf = '';
+        $w_ret = socket_recv($p_socket, $buf, $this->receive_buffer_size, 0);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => 'socket_recv', 'message' => LogMessageEnum::SOCKET_ERROR->socket($p_socket)]);
+            return false;
+        }
+        if($this->isUnixAddress($buf) === false)
+        {
+            return false;
+        }
+        $p_peer = $buf;
+
+        return true;
     }
 
     /**
-     * データ受信（バッファリング用）
+     * UNIX ドメインのデータグラム接続の受け付け（待ち受け側）
      * 
-     * 受信バッファサイズ分を受信する
-     * 
-     * ※プロトコルUNITで使用 
-     * ※最終アクセスタイムスタンプの設定はNativeIoDriverで行う
+     * 識別データ（相手のアドレス）を受信し、通信用ソケットを生成して自身のアドレスを返送する
      * 
-     * @param string $p_cid 接続ID
-     * @param mixed &$p_recv 受信エリア
-     * @param ?int $p_size 受信サイズ（指定があればデフォルトサイズより優先される）
-     * @return int 受信したサイズ or false（失敗） or null（取得できるデータがない）
+     * @param string $p_cid 待ち受けソケットの接続ID
+     * @return array|false|null ディスクリプタ or false（失敗） or null（読み飛ばし）
      */
-    public function bufferingRecv(string $p_cid, &$p_recv, ?int $p_size = null)
+    private function acceptUnixDatagram(string $p_cid): array|false|null
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        $soc = $this->sockets[$p_cid];
+        $buf = '';
+        $w_ret = @socket_recv($soc, $buf, $this->receive_buffer_size, 0);
+        if($w_ret === false)
         {
-            return false;
+            $this->logWriter('error', ['unix first recv' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            return null;
+        }
+        if($this->isUnixAddress($buf) === false)
+        {
+            return null;
         }
+        $peer = $buf;
 
-        // 受信データがなければ抜ける
-        $receiving_siz = $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'];
-        if($receiving_siz <= 0)
+        // 制限接続数の判定
+        $cnt = $this->getClientCount();
+        if($cnt >= $this->limit_connection)
         {
             return null;
         }
 
-        // 受信サイズ決定
-        $size = $this->receive_buffer_size;
-        if($p_size !== null)
+        // 通信用ソケットの生成
+        $w_ret = socket_create(AF_UNIX, SOCK_DGRAM, 0);
+        if($w_ret === false)
         {
-            $size = $p_size;
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+            return false;
         }
+        $soc = $w_ret;
 
-        $siz = min($size, $receiving_siz);
+        // 自身のアドレスへバインドして相手へ返送
+        $local = $this->createUnixLocalAddress($this->descriptors[$p_cid]['unix_address']);
+        $w_ret = $this->bindUnix($soc, $local);
+        if($w_ret !== false)
+        {
+            $w_ret = @socket_connect($soc, $peer);
+        }
+        if($w_ret !== false)
+        {
+            $w_ret = @socket_send($soc, $local, strlen($local), 0);
+        }
+        if($w_ret === false)
+        {
+            // 相手が識別データの送信後に終了した場合など
+            $this->logWriter('notice', ['unix first send' => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            @socket_close($soc);
+            $this->unlinkUnixAddress($local);
+            return null;
+        }
 
-        // 受信データを設定
-        $p_recv = substr($this->descriptors[$p_cid]['receiving_buffer']['data'], 0, $siz);
+        // ソケットディスクリプタの生成
+        $w_ret = $this->createDescriptor($soc, true);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
+            return false;
+        }
+        $des = $w_ret;
 
-        // 受信バッファをリセット
-        $this->descriptors[$p_cid]['receiving_buffer']['size'] = null;
-        $this->descriptors[$p_cid]['receiving_buffer']['data'] = substr($this->descriptors[$p_cid]['receiving_buffer']['data'], $siz);
-        $this->descriptors[$p_cid]['receiving_buffer']['receiving_size'] -= $siz;
+        $prop =
+        [
+            'host' => $peer,
+            'port' => 0
+        ];
+        $this->setProperties($des['connection_id'], ['udp_peers' => $prop, 'udp' => null]);
+        $this->descriptors[$des['connection_id']]['unix_address'] = $local;
 
-        return $siz;
+        return $des;
     }
 
     /**
-     * データ受信（IOドライバ用）
-     * 
-     * 受信バッファサイズ分を受信する
+     * UNIX ドメインのアドレス判定（識別データの検証）
      * 
-     * ※プロトコルUNITで使用 
-     * 
-     * @param string $p_cid 接続ID
-     * @param mixed &$p_recv 受信エリア
-     * @param ?int $p_size 受信サイズ（指定があればデフォルトサイズより優先される）
-     * @return int 受信したサイズ or false（失敗） or null（取得できるデータがない）
+     * @param string $p_address アドレス
+     * @return bool true（ファイルシステム上のパス or 抽象名前空間） or false（不正）
      */
-    public function ioRecv(string $p_cid, &$p_recv, ?int $p_size = null)
+    private function isUnixAddress(string $p_address): bool
     {
-        // 受信サイズ決定
-        $size = $this->receive_buffer_size;
-        if($p_size !== null)
+        if(strlen($p_address) < 2 || strlen($p_address) >= self::UNIX_ADDRESS_MAX)
         {
-            $size = $p_size;
+            return false;
         }
 
-        // ソケットリソースの取得
-        $soc = $this->sockets[$p_cid];
+        return ($p_address[0] === '/' || $p_address[0] === "\0");
+    }
 
-        // データ受信
-        $p_recv = '';
-        $prop = $this->getProperties($p_cid, ['udp']);
-        if($prop === null)
-        {
-            $prop['udp'] = null;
-        }
-        if($prop['udp'] === true)
+    /**
+     * オフロードしたジョブの結果の回収
+     * 
+     * 依頼元の接続が切断済みの結果は破棄する
+     */
+    private function pollOffload()
+    {
+        if($this->offload_pool === null)
         {
-            $prop = $this->getProperties($p_cid, ['udp_peers']);
-            if($prop !== null)
-            {
-                $buf = '';
-                $from = '';
-                $port = 0;
-                $w_ret = @socket_recvfrom($soc, $buf, $size, 0, $from, $port);
-                if($w_ret === false)
-                {
-                    $this->descriptors[$p_cid]['read_event'] = false;
-                    $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
-                    if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
-                    {
-                        return null;
-                    }
-
-                    // ソケット操作を完了できなかった
-                    if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
-                    {
-                        return null;
-                    }
-
-                    // 接続中の送受信
-                    if($w_ret['code'] === self::SOCKET_ERROR_SENDING_WHILE_CONNECTED)
-                    {
-                        return null;
-                    }
-
-                    // 相手からの切断を判定
-                    $shutdown = false;
-                    foreach(self::SOCKET_ERROR_PEER_SHUTDOWN as $cod)
-                    {
-                        if($w_ret['code'] === $cod)
-                        {
-                            $shutdown = true;
-                        }
-                    }
-                    if($shutdown === true)
-                    {
-                        // 緊急停止時コールバックを実行
-                        $callback = $this->emergency_callback;
-                        if($callback !== null)
-                        {
-                            $callback($this->unit_parameter);
-                        }
-                        return 0;
-                    }
-                    $this->logWriter('notice', [__METHOD__ => $w_ret['message']]);
-                    return false;
-                }
-
-                $p_recv = $buf;
-            }
-            else
-            {
-                if(AdaptiveIoDriverFactory::$mode === AdaptiveIoDriverFactory::MODE_IO_NATIVE)
-                {
-                    return false;
-                }
-                else
-                {
-                    return null;
-                }
-            }
+            return;
         }
-        else
+
+        foreach($this->offload_pool->poll() as $job)
         {
-            $w_ret = @socket_read($soc, $size);
-            if($w_ret === false)
+            $cid = $job['cid'];
+            if(!isset($this->descriptors[$cid]))
             {
-                $this->descriptors[$p_cid]['read_event'] = false;
-                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
-                if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
-                {
-                    return null;
-                }
-
-                // ソケット操作を完了できなかった
-                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
-                {
-                    return null;
-                }
+                continue;
+            }
+            $this->descriptors[$cid]['offload_jobs']--;
 
-                // 接続中の送受信
-                if($w_ret['code'] === self::SOCKET_ERROR_SENDING_WHILE_CONNECTED)
-                {
-                    return null;
-                }
+            if($job['error'] !== null)
+            {
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::OFFLOAD_FAIL->message($this->lang), 'cid' => $cid, 'name' => $job['name'], 'error' => $job['error']]);
+            }
 
-                // 相手からの切断を判定
-                $shutdown = false;
-                foreach(self::SOCKET_ERROR_PEER_SHUTDOWN as $cod)
-                {
-                    if($w_ret['code'] === $cod)
-                    {
-                        $shutdown = true;
-                    }
-                }
-                if($shutdown === true)
-                {
-                    // 緊急停止時コールバックを実行
-                    $callback = $this->emergency_callback;
-                    if($callback !== null)
-                    {
-                        $callback($this->unit_parameter);
-                    }
-                    return 0;
-                }
-                $this->logWriter('notice', [__METHOD__ => $w_ret['message']]);
-                return false;
+            $data = [
+                'id' => $job['id'],
+                'name' => $job['name'],
+                'result' => $job['result'],
+                'error' => $job['error']
+            ];
+            if($job['context']['queue'] === null)
+            {
+                $this->setRecvStack($cid, $data, true);
             }
-            if($w_ret === "")
+            else
             {
-                // 緊急停止時コールバックを実行
-                $callback = $this->emergency_callback;
-                if($callback !== null)
-                {
-                    $callback($this->unit_parameter);
-                }
-                return 0;
+                $this->descriptors[$cid]['offload_callbacks'][] = [
+                    'queue' => $job['context']['queue'],
+                    'status' => $job['context']['status'],
+                    'data' => $data
+                ];
             }
+        }
+    }
 
-            $p_recv = $w_ret;
+    /**
+     * ホットリスタートの引き継ぎ要求の確認（旧プロセス側）
+     * 
+     * 周期ドリブン処理から呼び出され、1 秒に 1 回だけ accept を試みる
+     */
+    private function pollHotRestart()
+    {
+        if($this->hot_restart === null || $this->hot_restart['socket'] === null)
+        {
+            return;
+        }
+        $now = time();
+        if(($now - $this->hot_restart['checked']) < self::HOT_RESTART_CHECK_INTERVAL)
+        {
+            return;
         }
+        $this->hot_restart['checked'] = $now;
 
-        $len = strlen($p_recv);
-        
-        return $len;
+        $con = @socket_accept($this->hot_restart['socket']);
+        if($con === false)
+        {
+            return;
+        }
+
+        // 引き継ぎは 1 回限り（後継プロセスが同じアドレスで待ち受けられるように先に閉じる）
+        socket_close($this->hot_restart['socket']);
+        $this->unlinkUnixAddress($this->hot_restart['address']);
+        $this->hot_restart['socket'] = null;
+
+        $w_ret = $this->handoverHotRestart($con);
+        socket_close($con);
+        if($w_ret === false)
+        {
+            // 引き継げなかった場合はそのまま処理を続け、次の要求を待つ
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::HOT_RESTART_FAIL->message($this->lang), 'host' => $this->hot_restart['host']]);
+            $this->enableHotRestart($this->hot_restart['host'], $this->hot_restart['connections']);
+            return;
+        }
+        $this->hot_restart['handed'] = true;
     }
 
     /**
-     * データ受信
-     * 
-     * 受信バッファサイズ分を受信する
+     * コネクションマイグレーションの要求の確認
      * 
-     * ※プロトコルUNITで使用 
-     * 
-     * @param string $p_cid 接続ID
-     * @param mixed &$p_recv 受信エリア
-     * @param ?int $p_size 受信サイズ（指定があればデフォルトサイズより優先される）
-     * @return int 受信したサイズ or false（失敗） or null（取得できるデータがない）
+     * 周期ドリブン処理から呼び出され、100ms に 1 回だけ accept を試みる
      */
-    public function recv(string $p_cid, &$p_recv, ?int $p_size = null)
+    private function pollMigration()
     {
-        // 受信サイズ決定
-        $size = $this->receive_buffer_size;
-        if($p_size !== null)
+        if($this->migration === null)
         {
-            $size = $p_size;
+            return;
+        }
+        $now = hrtime(true);
+        if(($now - $this->migration['checked']) < self::MIGRATION_CHECK_INTERVAL)
+        {
+            return;
         }
+        $this->migration['checked'] = $now;
 
-        // ソケットリソースの取得
-        $soc = $this->sockets[$p_cid];
+        $con = @socket_accept($this->migration['socket']);
+        if($con === false)
+        {
+            return;
+        }
+        socket_set_block($con);
+        socket_set_option($con, SOL_SOCKET, SO_RCVTIMEO, ['sec' => self::HANDOFF_TIMEOUT, 'usec' => 0]);
+        socket_set_option($con, SOL_SOCKET, SO_SNDTIMEO, ['sec' => self::HANDOFF_TIMEOUT, 'usec' => 0]);
 
-        // データ受信
-        $prop = $this->getProperties($p_cid, ['udp']);
-        $udp = $prop['udp'];
-        if($udp === true)
+        $buf = '';
+        $w_ret = @socket_recv($con, $buf, 4096, 0);
+        $req = ($w_ret === false) ? false : @unserialize($buf);
+        if(!is_array($req) || !isset($req['op']))
         {
-            $buf = '';
-            $from = '';
-            $port = 0;
-            $w_ret = @socket_recvfrom($soc, $buf, $size, 0, $from, $port);
-            if($w_ret === false)
-            {
-                $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
-                return false;
-            }
+            socket_close($con);
+            return;
+        }
 
-            $p_recv = $buf;
+        $res = null;
+        if($req['op'] === 'load')
+        {
+            // 負荷の問い合わせ
+            $res = $this->getLoad();
         }
         else
+        if($req['op'] === 'migrate')
         {
-            $w_ret = @socket_read($soc, $size);
+            // 接続の移動指示
+            $w_ret = $this->migrateConnections((string)$req['to'], (int)$req['count']);
+            $res = ['moved' => ($w_ret === false) ? 0 : $w_ret];
+        }
+        else
+        if($req['op'] === 'adopt')
+        {
+            // 接続の受け入れ（完了応答を返すまで移動元は手放さない）
+            $map = [];
+            $w_ret = $this->receiveHandoff($con, $map, false);
+            if($w_ret === true)
+            {
+                $w_ret = @socket_send($con, self::HANDOFF_ACK, strlen(self::HANDOFF_ACK), 0);
+            }
             if($w_ret === false)
             {
-                $this->descriptors[$p_cid]['read_event'] = false;
-                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
-                if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::MIGRATION_FAIL->message($this->lang)]);
+                foreach($map as $cid)
                 {
-                    return null;
+                    $this->releaseDescriptor($cid);
                 }
+            }
+            else
+            {
+                $this->logWriter('notice', [__METHOD__ => LogMessageEnum::MIGRATION_RECEIVED->message($this->lang), 'connections' => count($map)]);
+            }
+        }
 
-                // ソケット操作を完了できなかった
-                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
+        if($res !== null)
+        {
+            $dat = serialize($res);
+            @socket_send($con, $dat, strlen($dat), 0);
+        }
+        socket_close($con);
+    }
+
+    /**
+     * メトリクスページの要求の処理
+     * 
+     * 周期ドリブン処理から毎回呼び出される。新しい接続の accept は 100ms に 1 回だけ試みる  
+     * 接続はノンブロッキングのまま、受信できた分だけ要求行を溜め、送信できた分だけ応答を進める（周期ドリブン処理を止めない）  
+     * 要求行が GET なら要求先のパスによらずメトリクスを返し、送り終えたら接続を閉じる（HTTP/1.0）
+     */
+    private function pollMetrics()
+    {
+        if($this->metrics === null)
+        {
+            return;
+        }
+        $now = hrtime(true);
+
+        // 新しい接続の受け付け
+        if(($now - $this->metrics['checked']) >= self::METRICS_CHECK_INTERVAL && count($this->metrics['clients']) < self::METRICS_MAX_CLIENTS)
+        {
+            $this->metrics['checked'] = $now;
+            $con = @socket_accept($this->metrics['socket']);
+            if($con !== false)
+            {
+                socket_set_nonblock($con);
+                $this->metrics['clients'][] = [
+                    'socket' => $con,
+                    'in' => '',
+                    'out' => null,
+                    'deadline' => $now + self::METRICS_TIMEOUT
+                ];
+            }
+        }
+
+        foreach($this->metrics['clients'] as $idx => &$cli)
+        {
+            $done = false;
+            if($now >= $cli['deadline'])
+            {
+                $done = true;
+            }
+            else
+            if($cli['out'] === null)
+            {
+                // 要求行の受信（ヘッダーの残りは読み捨てる）
+                $buf = '';
+                $w_ret = @socket_recv($cli['socket'], $buf, 4096, 0);
+                if($w_ret === false)
                 {
-                    return null;
+                    $done = (socket_last_error($cli['socket']) !== self::SOCKET_ERROR_READ_RETRY);
                 }
-
-                // 接続中の送受信
-                if($w_ret['code'] === self::SOCKET_ERROR_SENDING_WHILE_CONNECTED)
+                else
+                if($w_ret === 0)
                 {
-                    return null;
+                    $done = true;
                 }
-
-                // 相手からの切断を判定
-                $shutdown = false;
-                foreach(self::SOCKET_ERROR_PEER_SHUTDOWN as $cod)
+                else
                 {
-                    if($w_ret['code'] === $cod)
+                    $cli['in'] .= $buf;
+                    if(strpos($cli['in'], "\n") !== false)
                     {
-                        $shutdown = true;
+                        if(strncmp($cli['in'], 'GET ', 4) === 0)
+                        {
+                            $body = $this->buildMetrics();
+                            $cli['out'] = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: ".strlen($body)."\r\nConnection: close\r\n\r\n".$body;
+                        }
+                        else
+                        {
+                            $cli['out'] = "HTTP/1.0 405 Method Not Allowed\r\nAllow: GET\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+                        }
+                        $cli['in'] = '';
                     }
-                }
-                if($shutdown === true)
-                {
-                    // 緊急停止時コールバックを実行
-                    $callback = $this->emergency_callback;
-                    if($callback !== null)
+                    else
+                    if(strlen($cli['in']) > self::METRICS_REQUEST_MAX)
                     {
-                        $callback($this->unit_parameter);
+                        $done = true;
                     }
                 }
-                $this->logWriter('notice', [__METHOD__ => $w_ret['message']]);
-                return false;
             }
-            if($w_ret === "")
+
+            // 応答の送信（送れた分だけ進める）
+            if($done === false && $cli['out'] !== null)
             {
-                if($this->descriptors[$p_cid]['read_event'] === true)
+                $w_ret = @socket_write($cli['socket'], $cli['out'], strlen($cli['out']));
+                if($w_ret === false)
                 {
-                    throw new UnitException(
-                        UnitExceptionEnum::ECODE_EMERGENCY_SHUTDOWN->message($this->lang),
-                        UnitExceptionEnum::ECODE_EMERGENCY_SHUTDOWN->value,
-                        $this->unit_parameter
-                    );
+                    if(socket_last_error($cli['socket']) !== self::SOCKET_ERROR_READ_RETRY)
+                    {
+                        $this->logWriter('notice', [__METHOD__ => LogMessageEnum::METRICS_WRITE_FAIL->message($this->lang), 'message' => LogMessageEnum::SOCKET_ERROR->socket($cli['socket'])]);
+                        $done = true;
+                    }
+                }
+                else
+                {
+                    $cli['out'] = substr($cli['out'], $w_ret);
+                    $done = ($cli['out'] === '');
                 }
             }
-            $this->descriptors[$p_cid]['read_event'] = false;
 
-            $p_recv = $w_ret;
-        }
-
-        $len = strlen($p_recv);
-        
-        // 最終アクセスタイムスタンプを設定
-        if($len > 0)
-        {
-            $w_ret = $this->setProperties($p_cid, ['last_access_timestamp' => time()]);
-            if($w_ret === false)
+            if($done === true)
             {
-                return false;
+                @socket_close($cli['socket']);
+                unset($this->metrics['clients'][$idx]);
             }
         }
-
-        return $len;
+        unset($cli);
     }
 
     /**
-     * 送信データの設定
+     * メトリクスページの生成（Prometheus のテキスト形式）
      * 
-     * ※プロトコルUNITで使用
+     * 接続の状態と送受信バッファスタックの深さはディスクリプタを走査して集計する（要求を受けた時だけ呼ぶ）
      * 
-     * @param string $p_cid 接続ID
-     * @param string $p_data 送信データ
-     * @return bool true（成功） or false（失敗）
+     * @return string メトリクス
      */
-    public function setSendingData(string $p_cid, string $p_data): bool
+    private function buildMetrics(): string
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        // 接続の状態別の数とバッファスタックの深さ
+        $states = ['connecting' => 0, 'protocol' => 0, 'command' => 0, 'idle' => 0];
+        $queues = [];
+        $depth = ['send' => 0, 'send_max' => 0, 'receive' => 0, 'receive_max' => 0];
+        foreach($this->descriptors as $cid => $des)
         {
-            return false;
-        }
-
-        $this->descriptors[$p_cid]['sending_buffer']['data'] = $p_data;
-
-        return true;
-    }
+            if($cid === $this->await_connection_id)
+            {
+                continue;
+            }
 
-    /**
-     * データ送信
-     * 
-     * setSendingDataで設定されたデータを送信するまで続ける
-     * 
-     * ※プロトコルUNITで使用 
-     * 
-     * @param string $p_cid 接続ID
-     * @return bool|null true（成功） or false（失敗） or null（送信中）
-     */
-    public function sending(string $p_cid): ?bool
-    {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
-        {
-            return false;
-        }
+            $state = 'idle';
+            if($des['connecting'] === true)
+            {
+                $state = 'connecting';
+            }
+            else
+            if($des['protocol_names']['queue_name'] !== null)
+            {
+                $state = 'protocol';
+            }
+            else
+            if($des['command_names']['queue_name'] !== null)
+            {
+                $state = 'command';
+            }
+            $states[$state]++;
+            foreach(['protocol' => 'protocol_names', 'command' => 'command_names'] as $kind => $key)
+            {
+                $que = $des[$key]['queue_name'];
+                if($que !== null)
+                {
+                    $lbl = 'kind="'.$kind.'",queue="'.addcslashes($que, "\\\"\n").'"';
+                    $queues[$lbl] = ($queues[$lbl] ?? 0) + 1;
+                }
+            }
 
-        // 送信データが設定されていない場合は抜ける
-        if($this->descriptors[$p_cid]['sending_buffer']['data'] === null)
-        {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SEND_DATA_NO_SETTING->message($this->lang), 'connection id' => $p_cid]);
-            return false;
+            $cnt = count($des['send_buffers']);
+            $depth['send'] += $cnt;
+            $depth['send_max'] = max($depth['send_max'], $cnt);
+            $cnt = count($des['receive_buffers']);
+            $depth['receive'] += $cnt;
+            $depth['receive_max'] = max($depth['receive_max'], $cnt);
         }
 
-        // ソケットリソースの取得
-        $soc = $this->sockets[$p_cid];
-
-        // 送信中データの取得
-        $dat = $this->descriptors[$p_cid]['sending_buffer']['data'];
-
-        // 送信処理
-        $prop = $this->getProperties($p_cid, ['udp']);
-        if($prop === null)
-        {
-            $udp = null;
-        }
-        else
+        $lbls = [];
+        foreach($states as $state => $cnt)
         {
-            $udp = $prop['udp'];
-        }
-        if($udp === true)
+            $lbls['state="'.$state.'"'] = $cnt;
+        }
+        $ret = $this->formatMetric('socket_manager_connections', 'gauge', 'Connections by state.', $lbls);
+        $ret .= $this->formatMetric('socket_manager_queue_connections', 'gauge', 'Connections running a UNIT queue.', $queues);
+        $ret .= $this->formatMetric('socket_manager_connection_limit', 'gauge', 'Configured connection limit.', ['' => $this->limit_connection]);
+        $ret .= $this->formatMetric('socket_manager_accepts_total', 'counter', 'Connections accepted.', ['' => $this->counters['accepts']]);
+        $ret .= $this->formatMetric('socket_manager_rejects_total', 'counter', 'Connections rejected by the connection limit.', ['' => $this->counters['rejects']]);
+        $ret .= $this->formatMetric('socket_manager_closes_total', 'counter', 'Connections closed.', ['' => $this->counters['closes']]);
+        $ret .= $this->formatMetric('socket_manager_received_bytes_total', 'counter', 'Bytes received.', ['' => $this->counters['bytes_in']]);
+        $ret .= $this->formatMetric('socket_manager_sent_bytes_total', 'counter', 'Bytes sent by the manager (driver send queues are counted separately).', ['' => $this->counters['bytes_out']]);
+        $ret .= $this->formatMetric('socket_manager_send_buffers', 'gauge', 'Entries in the send buffer stacks.', ['' => $depth['send']]);
+        $ret .= $this->formatMetric('socket_manager_send_buffers_max', 'gauge', 'Deepest per-connection send buffer stack.', ['' => $depth['send_max']]);
+        $ret .= $this->formatMetric('socket_manager_receive_buffers', 'gauge', 'Entries in the receive buffer stacks.', ['' => $depth['receive']]);
+        $ret .= $this->formatMetric('socket_manager_receive_buffers_max', 'gauge', 'Deepest per-connection receive buffer stack.', ['' => $depth['receive_max']]);
+        $ret .= $this->formatMetric('socket_manager_cycle_time_seconds', 'gauge', 'Moving average of the cycle-driven pass duration.', ['' => $this->cycle_time / 1000000]);
+
+        // I/O ドライバのカウンタと現在値
+        $w_ret = $this->iio_driver->getMetrics();
+        if($w_ret !== null)
         {
-            // 送信先を取得
-            $prop = $this->getProperties($p_cid, ['udp_peers']);
-
-            // データ送信
-            $len = strlen($dat);
-            $host = $prop['udp_peers']['host'];
-            $port = $prop['udp_peers']['port'];
-            $w_ret = @socket_sendto($soc, $dat, $len, 0, $host, $port);
-            if($w_ret === false)
+            foreach(self::METRICS_DRIVER as $key => [$name, $type, $help])
             {
-                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
-                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
+                if(isset($w_ret[$key]))
                 {
-                    return null;
+                    $ret .= $this->formatMetric($name, $type, $help, ['' => $w_ret[$key]]);
                 }
-                $this->logWriter('error', [__METHOD__ => 'socket_sendto', "message" => $w_ret['message'], 'connection id' => $p_cid]);
-                return false;
             }
         }
-        else
+
+        // ヒストグラムの百分位（前回のログ出力以降の値）
+        $w_ret = $this->getStats();
+        if($w_ret !== false)
         {
-            // データ送信
-            $w_ret = @socket_write($soc, $dat, strlen($dat));
-            if($w_ret === false)
+            foreach(self::METRICS_STATS as $key => [$name, $help, $secs])
             {
-                $w_ret = LogMessageEnum::SOCKET_ERROR->array($soc);
-                if($w_ret['code'] === self::SOCKET_ERROR_READ_RETRY)
+                $sta = $w_ret[$key] ?? null;
+                if($sta === null)
                 {
-                    return null;
-                }
-                if($w_ret['code'] === self::SOCKET_ERROR_COULDNT_COMPLETED)
-                {
-                    return null;
+                    continue;
                 }
-                if($w_ret['code'] === self::SOCKET_ERROR_SENDING_WHILE_CONNECTED)
+                $div = $secs === true ? 1000000000 : 1;
+                $lbls = [];
+                foreach(['0.5' => 'p50', '0.9' => 'p90', '0.99' => 'p99', '0.999' => 'p999'] as $quantile => $col)
                 {
-                    return null;
+                    $lbls['quantile="'.$quantile.'"'] = $sta[$col] / $div;
                 }
-                $this->logWriter('notice', [__METHOD__ => 'socket_write', "message" => $w_ret['message'], 'connection id' => $p_cid]);
-                return false;
+                $ret .= $this->formatMetric($name, 'summary', $help, $lbls);
+                $ret .= $name.'_sum '.$this->formatMetricValue($sta['mean'] * $sta['count'] / $div)."\n";
+                $ret .= $name.'_count '.$sta['count']."\n";
             }
         }
 
-        // 送信完了でない場合
-        if($w_ret < strlen($dat))
+        return $ret;
+    }
+
+    /**
+     * メトリクス 1 件の整形
+     * 
+     * @param string $p_name メトリクス名
+     * @param string $p_type 種別（counter／gauge／summary）
+     * @param string $p_help 説明
+     * @param array $p_values ラベル（'name="value",...'。'' はラベルなし） => 値
+     * @return string HELP／TYPE 行と値の行
+     */
+    private function formatMetric(string $p_name, string $p_type, string $p_help, array $p_values): string
+    {
+        $ret = "# HELP {$p_name} {$p_help}\n# TYPE {$p_name} {$p_type}\n";
+        foreach($p_values as $lbl => $val)
         {
-            // 送信バッファに次回送信分をセットする
-            $dat = substr($dat, $w_ret);
-            $this->descriptors[$p_cid]['sending_buffer']['data'] = $dat;
-            return null;
+            $ret .= $p_name.($lbl === '' ? '' : '{'.$lbl.'}').' '.$this->formatMetricValue($val)."\n";
         }
 
-        // 送信バッファを初期化
-        $this->descriptors[$p_cid]['sending_buffer']['data'] = null;
-
-        return true;
+        return $ret;
     }
 
     /**
-     * （sendingメソッドによる）データ送信中の検査
+     * メトリクスの値の整形
      * 
-     * @param string $p_cid 接続ID
-     * @return bool true（送信中） or false（送信中ではない）
+     * @param int|float $p_value 値
+     * @return string 整数はそのまま、小数は有効桁数 9 桁
      */
-    public function isSending(string $p_cid): bool
+    private function formatMetricValue(int|float $p_value): string
     {
-        // 変数へ退避
-        $dat = $this->descriptors[$p_cid]['sending_buffer']['data'];
-
-        // 送信バッファが未設定か
-        if($dat === null)
+        if(is_int($p_value))
         {
-            return false;
+            return (string)$p_value;
         }
 
-        return true;
+        return sprintf('%.9g', $p_value);
     }
 
-
-    //--------------------------------------------------------------------------
-    // 送受信バッファ操作
-    //--------------------------------------------------------------------------
-
     /**
-     * 受信データスタックから取得
-     * 
-     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
-     * 
-     * @param string $p_cid 接続ID
-     * @param bool $p_convert
-     * ― 変換（シリアライズ／アンシリアライズの行使）フラグ
-     * 
-     * ― フラグ指定に関わらずシリアライザーが登録されていなければ変換はされない
+     * 制御用の待ち受けソケットの生成（ホットリスタート／コネクションマイグレーション）
      * 
-     * @return mixed 受信した最新のペイロードデータ or null（空） or false（失敗）
+     * @param string $p_host 'unix:///path' or 'unix://@name'（抽象名前空間）
+     * @param ?string &$p_address バインドしたアドレスの格納先
+     * @return Socket|false ノンブロッキングの待ち受けソケット（SOCK_SEQPACKET） or false（失敗）
      */
-    private function getRecvStack(string $p_cid, bool $p_convert = true)
+    private function createControlListener(string $p_host, ?string &$p_address): Socket|false
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        $unix = $this->unixAddress($p_host);
+        if($unix === false || $unix === null)
         {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::UNIX_ADDRESS_INVALID->message($this->lang), 'host' => $p_host]);
             return false;
         }
 
-        // １件もなければ抜ける
-        $cnt = count($this->descriptors[$p_cid]['receive_buffers']);
-        if($cnt <= 0)
+        $w_ret = socket_create(AF_UNIX, SOCK_SEQPACKET, 0);
+        if($w_ret === false)
         {
-            return null;
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+            return false;
         }
+        $soc = $w_ret;
 
-        // １件分取得
-        $buf = array_shift($this->descriptors[$p_cid]['receive_buffers']);
-
-        $dat = $buf;
-        if($p_convert === true)
+        $w_ret = $this->bindUnix($soc, $unix);
+        if($w_ret === false)
         {
-            // アンシリアライザーの実行
-            if($this->unserializer !== null)
-            {
-                $unserializer = $this->unserializer;
-                $dat = $unserializer($buf);
-            }
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            socket_close($soc);
+            return false;
+        }
+        $w_ret = socket_listen($soc, 8);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            socket_close($soc);
+            $this->unlinkUnixAddress($unix);
+            return false;
         }
+        socket_set_nonblock($soc);
+        $p_address = $unix;
 
-        return $dat;
+        return $soc;
     }
 
     /**
-     * 受信データスタックへ設定
-     * 
-     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
-     * 
-     * @param string $p_cid 接続ID
-     * @param mixed $p_data 設定するデータ
-     * @param bool $p_convert
-     * ― 変換（シリアライズ／アンシリアライズの行使）フラグ
-     * 
-     * ― フラグ指定に関わらずシリアライザーが登録されていなければ変換はされない
+     * 制御用の接続（ホットリスタート／コネクションマイグレーション）
      * 
-     * @return bool true（成功） or false（失敗）
+     * @param string $p_host 'unix:///path' or 'unix://@name'（抽象名前空間）
+     * @param int $p_timeout 送受信タイムアウト（秒）
+     * @return Socket|false ブロッキングのソケット（SOCK_SEQPACKET） or false（失敗）
      */
-    public function setRecvStack(string $p_cid, $p_data = null, bool $p_convert = false): bool
+    private function connectControl(string $p_host, int $p_timeout): Socket|false
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        $unix = $this->unixAddress($p_host);
+        if($unix === false || $unix === null)
         {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::UNIX_ADDRESS_INVALID->message($this->lang), 'host' => $p_host]);
             return false;
         }
 
-        // シリアライザーの実行
-        $data = $p_data;
-        if($p_convert === true && $this->serializer !== null)
+        $w_ret = socket_create(AF_UNIX, SOCK_SEQPACKET, 0);
+        if($w_ret === false)
         {
-            $serializer = $this->serializer;
-            $data = $serializer($data);
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket()]);
+            return false;
         }
+        $soc = $w_ret;
+        socket_set_option($soc, SOL_SOCKET, SO_RCVTIMEO, ['sec' => $p_timeout, 'usec' => 0]);
+        socket_set_option($soc, SOL_SOCKET, SO_SNDTIMEO, ['sec' => $p_timeout, 'usec' => 0]);
 
-        // 最後尾に追加
-        array_push($this->descriptors[$p_cid]['receive_buffers'], $data);
+        $w_ret = @socket_connect($soc, $unix);
+        if($w_ret === false)
+        {
+            $this->logWriter('notice', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($soc)]);
+            socket_close($soc);
+            return false;
+        }
 
-        return true;
+        return $soc;
     }
 
     /**
-     * 送信データスタックから取得
-     * 
-     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
-     * 
-     * @param string $p_cid 接続ID
-     * @param bool $p_convert
-     * ― 変換（シリアライズ／アンシリアライズの行使）フラグ
+     * ホットリスタートのソケットと状態の送信（旧プロセス側）
      * 
-     * ― フラグ指定に関わらずシリアライザーが登録されていなければ変換はされない
-     * 
-     * @return mixed 送信データスタックエントリ or null（空） or false（失敗）
+     * @param Socket $p_socket 後継プロセスとの接続
+     * @return bool true（後継プロセスが引き継いだ） or false（失敗）
      */
-    private function getSendStack(string $p_cid, bool $p_convert = false)
+    private function handoverHotRestart(Socket $p_socket): bool
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        socket_set_block($p_socket);
+        socket_set_option($p_socket, SOL_SOCKET, SO_RCVTIMEO, ['sec' => self::HANDOFF_TIMEOUT, 'usec' => 0]);
+        socket_set_option($p_socket, SOL_SOCKET, SO_SNDTIMEO, ['sec' => self::HANDOFF_TIMEOUT, 'usec' => 0]);
+
+        // 引き継ぐディスクリプタの選定（TCP の待ち受けソケットが先頭）
+        $entries = [];
+        $sockets = [];
+        $await = $this->await_connection_id;
+        if($await !== null && $this->descriptors[$await]['udp'] === false)
         {
-            return false;
+            $entries[] = [
+                'type' => 'listen',
+                'cid' => $await,
+                'host' => $this->await_host,
+                'port' => $this->await_port,
+                'unix_address' => $this->descriptors[$await]['unix_address']
+            ];
+            $sockets[] = $this->sockets[$await];
         }
-
-        // １件もなければ抜ける
-        $cnt = count($this->descriptors[$p_cid]['send_buffers']);
-        if($cnt <= 0)
+        if($this->hot_restart['connections'] === true)
         {
-            return null;
+            foreach($this->descriptors as $cid => $des)
+            {
+                if($cid === $await || $this->isHandoffMovable($des) === false)
+                {
+                    continue;
+                }
+                $entries[] = [
+                    'type' => 'connection',
+                    'cid' => $cid,
+                    'state' => $this->exportHandoffState($cid)
+                ];
+                $sockets[] = $this->sockets[$cid];
+            }
         }
 
-        // １件分取得
-        $buf = array_shift($this->descriptors[$p_cid]['send_buffers']);
-
-        // アンシリアライザーの実行
-        $data = $buf;
-        if($p_convert === true)
+        $w_ret = $this->sendHandoff($p_socket, $entries, $sockets);
+        if($w_ret === false)
         {
-            if($this->unserializer !== null)
-            {
-                $unserializer = $this->unserializer;
-                $data = $unserializer($buf);
-            }
+            return false;
         }
 
-        return $data;
+        $this->logWriter('notice', [__METHOD__ => LogMessageEnum::HOT_RESTART_HANDOVER->message($this->lang), 'sockets' => count($entries), 'remaining' => count($this->descriptors)]);
+
+        return true;
     }
 
     /**
-     * 送信データスタックへ設定
+     * 引き継ぎの送信
      * 
-     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
+     * バッチ単位で送信して空のバッチで終了を伝え、完了応答を受けてから渡したソケットを手放す  
+     * 応答がなければ手放さずに処理を続ける
      * 
-     * @param string $p_cid 接続ID
-     * @param mixed $p_data 送信データ
-     * @return bool true（成功） or false（失敗）
+     * @param Socket $p_socket 引き継ぎ先との接続（ブロッキング）
+     * @param array $p_entries エントリ
+     * @param array $p_sockets エントリに対応するソケット
+     * @return bool true（引き継ぎ先が受け取った） or false（失敗）
      */
-    public function setSendStack(string $p_cid, $p_data): bool
+    private function sendHandoff(Socket $p_socket, array $p_entries, array $p_sockets): bool
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        $entry_chunks = array_chunk($p_entries, self::HANDOFF_BATCH);
+        $socket_chunks = array_chunk($p_sockets, self::HANDOFF_BATCH);
+        $entry_chunks[] = [];
+        $socket_chunks[] = [];
+        foreach($entry_chunks as $idx => $chunk)
         {
-            return false;
+            $w_ret = $this->sendHandoffBatch($p_socket, $chunk, $socket_chunks[$idx]);
+            if($w_ret === false)
+            {
+                return false;
+            }
         }
 
-        // シリアライズ
-        $data = $p_data;
-        if($this->serializer !== null)
+        $buf = '';
+        $w_ret = @socket_recv($p_socket, $buf, 16, 0);
+        if($w_ret === false || $buf !== self::HANDOFF_ACK)
         {
-            $serializer = $this->serializer;
-            $data = $serializer($data);
+            return false;
         }
 
-        // 送信データスタックへ追加
-        array_push($this->descriptors[$p_cid]['send_buffers'], $data);
+        foreach($p_entries as $entry)
+        {
+            $this->releaseDescriptor($entry['cid']);
+        }
 
         return true;
     }
 
     /**
-     * 全接続の送信データスタックへ設定
+     * ソケットの引き継ぎ対象の判定
      * 
-     * ※基本的に送受信スタック内のペイロードデータはシリアライズ化されている事を前提とする
+     * I/O ドライバ内に保持しているデータ（受信フレーミングの未完成分、ファイル送信／ゼロコピー送信のキュー）は渡せないため、
+     * それらを使用中の接続は旧プロセスに残して処理を終えさせる
      * 
-     * @param string $p_cid 接続ID
-     * @param mixed $p_data 送信データ
-     * @param bool $p_self_remove 自身の接続の除外フラグ
-     * @return bool true（成功） or false（失敗）
+     * @param array $p_des ディスクリプタ
+     * @return bool true（引き継ぐ） or false（旧プロセスに残す）
      */
-    public function setSendStackAll(string $p_cid, $p_data, bool $p_self_remove = false): bool
+    private function isHandoffMovable(array $p_des): bool
     {
-        // ディスクリプタが存在しなければ抜ける
-        if(!isset($this->descriptors[$p_cid]))
+        // UDP／共有メモリIPC／接続中／UNIX ドメインのデータグラムは対象外
+        if($p_des['udp'] !== false || $p_des['ipc'] === true || $p_des['connecting'] === true || $p_des['unix_address'] !== null)
         {
             return false;
         }
-
-        // 全ディスクリプタを退避
-        $dess = $this->descriptors;
-
-        // Listenポートを除く
-        unset($dess[$this->await_connection_id]);
-
-        // 自身を除く
-        if($p_self_remove === true)
+        if($p_des['receiving_buffer']['frames'] !== null || $p_des['sending_buffer']['file'] !== null || $p_des['sending_buffer']['queued'] === true)
         {
-            unset($dess[$p_cid]);
+            return false;
         }
 
-        // 全ディスクリプタでループ
-        foreach($dess as $cid => $des)
+        // オフロードの結果を待っている
+        if($p_des['offload_jobs'] > 0 || count($p_des['offload_callbacks']) > 0)
         {
-            // 送信データスタックへ追加
-            $w_ret = $this->setSendStack($cid, $p_data);
-            if($w_ret === false)
-            {
-                return false;
-            }
+            return false;
         }
 
-        return true;
-    }
-
+        // Fiber UNIT の中断中（実行状態はプロセス内にしかない）
+        $cid = $p_des['connection_id'];
+        if($this->cycle_driven_for_protocol->hasFiber($cid) || $this->cycle_driven_for_command->hasFiber($cid))
+        {
+            return false;
+        }
 
-    //--------------------------------------------------------------------------
-    // 内部処理
-    //--------------------------------------------------------------------------
+        return true;
+    }
 
     /**
-     * キュー名の設定（処理開始用）
+     * 引き継ぎで渡すディスクリプタの状態
      * 
-     * @param string $p_kind 設定対象種別（'protocol_names' or 'command_names'）
      * @param string $p_cid 接続ID
-     * @param ?string $p_name キュー名 or null（なし）
-     * @return bool true（成功） or false (失敗)
+     * @return array 状態
      */
-    private function setQueueNameForStart(string $p_kind, string $p_cid, ?string $p_name): bool
+    private function exportHandoffState(string $p_cid): array
     {
-        // キュー名の設定
-        $this->descriptors[$p_cid][$p_kind]['queue_name'] = $p_name;
+        $des = $this->descriptors[$p_cid];
 
-        // ステータス名の設定
-        if($p_name === null)
+        $state = [];
+        foreach(self::HANDOFF_STATE_KEYS as $key)
         {
-            $this->descriptors[$p_cid][$p_kind]['status_name'] = null;
+            $state[$key] = $des[$key];
         }
-        else
+
+        // 受信ストアは内容だけを渡す（フレーミング中の接続は isHandoffMovable で対象外）
+        $buf = $des['receiving_buffer'];
+        if($buf['store'] !== null)
         {
-            if($p_kind === 'protocol_names')
-            {
-                $this->descriptors[$p_cid][$p_kind]['status_name'] = StatusEnum::START->value;
-            }
-            else
-            if($this->descriptors[$p_cid][$p_kind]['status_name'] === null)
-            {
-                $this->descriptors[$p_cid][$p_kind]['status_name'] = StatusEnum::START->value;
-            }
+            $buf['store'] = $buf['store']->peek($buf['store']->length());
         }
+        $state['receiving_buffer'] = $buf;
+        $state['sending_data'] = $des['sending_buffer']['data'];
 
-        return true;
+        return $state;
     }
 
     /**
-     * UNIT実行中の検査
+     * 引き継ぎで受け取ったディスクリプタの状態の反映
      * 
-     * @param string $p_kind 調査対象種別（'protocol_names' or 'command_names'）
      * @param string $p_cid 接続ID
-     * @return bool true（実行中） or false（未実行）
+     * @param array $p_state 状態
      */
-    private function isExecutingSequence(string $p_kind, string $p_cid): bool
+    private function importHandoffState(string $p_cid, array $p_state)
     {
-        // 強制ディスパッチの実行
-        if($p_kind === 'command_names')
+        foreach(self::HANDOFF_STATE_KEYS as $key)
         {
-            if($this->descriptors[$p_cid]['forced_dispatcher'] === true)
-            {
-                // １件もなければ抜ける
-                $cnt = count($this->descriptors[$p_cid]['receive_buffers']);
-                if($cnt <= 0)
-                {
-                    return true;
-                }
-                $this->descriptors[$p_cid]['forced_dispatcher'] = false;
-                return false;
-            }
+            $this->descriptors[$p_cid][$key] = $p_state[$key];
         }
 
-        // キュー名の取得
-        $que_nam = $this->descriptors[$p_cid][$p_kind]['queue_name'];
-
-        // ステータス名の取得
-        $sta_nam = $this->descriptors[$p_cid][$p_kind]['status_name'];
+        // UNIT ID はプロセスごとに割り当てるため名前から引き直す
+        $this->descriptors[$p_cid]['protocol_names']['unit_id'] = null;
+        $this->descriptors[$p_cid]['command_names']['unit_id'] = null;
 
-        // 実行中
-        if(isset($que_nam) && isset($sta_nam))
+        // 受信ストアの有無が旧プロセスと異なる場合は受信バッファで受け渡す
+        $buf = $p_state['receiving_buffer'];
+        $store = $this->descriptors[$p_cid]['receiving_buffer']['store'];
+        if($store !== null)
         {
-            return true;
+            if($buf['store'] !== null)
+            {
+                $store->append($buf['store']);
+            }
+            $buf['store'] = $store;
         }
-
-        return false;
+        else
+        if($buf['store'] !== null)
+        {
+            $buf['data'] = $buf['data'].$buf['store'];
+            $buf['store'] = null;
+        }
+        $this->descriptors[$p_cid]['receiving_buffer'] = $buf;
+        $this->descriptors[$p_cid]['sending_buffer']['data'] = $p_state['sending_data'];
     }
 
     /**
-     * UNITの実行
+     * 引き継ぎのバッチ送信
      * 
-     * @param string $p_cid 接続ID
-     * @param string $p_kind UNIT種別（"protocol_names" or "command_names"）
-     * @return bool true（成功） or false（切断）
+     * ヘッダ（ソケット数＋状態データ長）に SCM_RIGHTS でソケットを添付し、状態データは分割して続けて送る  
+     * （SOCK_SEQPACKET はメッセージ単位で送信バッファに収まる必要があるため）
+     * 
+     * @param Socket $p_socket 引き継ぎ先との接続
+     * @param array $p_entries エントリ
+     * @param array $p_sockets エントリに対応するソケット
+     * @return bool true（成功） or false（失敗）
      */
-    private function executeUnit(string $p_cid, string $p_kind): bool
+    private function sendHandoffBatch(Socket $p_socket, array $p_entries, array $p_sockets): bool
     {
-        // 周期ドリブンマネージャーの取得
-        $cycle_driven = $this->cycle_driven_for_protocol;
-        if($p_kind !== 'protocol_names')
+        $payload = '';
+        if(count($p_entries) > 0)
         {
-            $cycle_driven = $this->cycle_driven_for_command;
+            $payload = serialize($p_entries);
         }
 
-        // UNITの実行
-        $this->unit_parameter->setKindString($p_kind);
-        try
+        $msg = ['iov' => [pack('NJ', count($p_sockets), strlen($payload))]];
+        if(count($p_sockets) > 0)
         {
-            $w_ret = $cycle_driven->cycleDriven($this->unit_parameter);
-            if($w_ret === false)
-            {
-                $que = $this->getQueueName($p_kind, $p_cid);
-                $sta = $this->getStatusName($p_kind, $p_cid);
-                $this->logWriter('warning', [__METHOD__ => LogMessageEnum::UNIT_NO_SETTING->message($this->lang)."[{$que}][{$sta}]"]);
-            }
+            $msg['control'] = [['level' => SOL_SOCKET, 'type' => SCM_RIGHTS, 'data' => $p_sockets]];
         }
-        catch(UnitException | Exception $e)
+        $w_ret = @socket_sendmsg($p_socket, $msg, 0);
+        if($w_ret === false)
         {
-            $w_ret = get_class($e);
-            if($w_ret === self::E_CLASS_NAME_FOR_UNIT)
-            {
-                if($e->getCode() !== UnitExceptionEnum::ECODE_THROW_BREAK->value)
-                {
-                    $this->logWriter('error', $e->getArrayMessage());
-                    $this->shutdown($p_cid);	// ソケット緊急切断
-                    return false;
-                }
-            }
-            else
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($p_socket)]);
+            return false;
+        }
+
+        $len = strlen($payload);
+        for($off = 0; $off < $len; $off += self::HANDOFF_CHUNK)
+        {
+            $chunk = substr($payload, $off, self::HANDOFF_CHUNK);
+            $w_ret = @socket_send($p_socket, $chunk, strlen($chunk), 0);
+            if($w_ret === false)
             {
-                $this->logWriter('error', ['code' => $e->getCode(), 'message' => $e->getMessage(), 'trace' => $e->getTraceAsString()]);
-                $this->shutdown($p_cid);	// ソケット緊急切断
+                $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_ERROR->socket($p_socket)]);
                 return false;
             }
         }
@@ -3016,136 +6368,131 @@ class SocketManager
     }
 
     /**
-     * ソケットのアドレス情報を取得
+     * 引き継ぎの受信
      * 
-     * @param string $p_cid 接続ID
-     * @param string &$p_host ホストアドレス格納先
-     * @param int &$p_port ポート番号格納先
+     * @param Socket $p_socket 引き継ぎ元との接続
+     * @param array &$p_map 旧接続ID => 新接続ID の格納先（失敗時は登録済みの分が残る）
+     * @param bool $p_listen 待ち受けソケットを受け入れるか
      * @return bool true（成功） or false（失敗）
      */
-    public function getSockName(string $p_cid, string &$p_host, int &$p_port): bool
-    {
-        return socket_getsockname($this->sockets[$p_cid], $p_host, $p_port);
-    }
-
-    /**
-     * ソケットディスクリプタの生成
-     * 
-     * @param Socket $p_socket ソケットリソース
-     * @param ?bool $p_udp UDPフラグ
-     * @param bool $p_listen Listenポートフラグ
-     * @param bool $p_is_client クライアントフラグ
-     * @return array|bool ディスクリプタ or false（失敗）
-     */
-    private function createDescriptor(Socket $p_socket, ?bool $p_udp = false, bool $p_listen = false, bool $p_is_client = false)
+    private function receiveHandoff(Socket $p_socket, array &$p_map, bool $p_listen = true): bool
     {
-        $id = null;
-        if($p_listen === true)
+        while(true)
         {
-            if($p_udp === null && $p_listen && AdaptiveIoDriverFactory::$mode === AdaptiveIoDriverFactory::MODE_IO_NATIVE && PHP_OS_FAMILY === 'Windows')
+            $msg = [
+                'name' => [],
+                'buffer_size' => 12,
+                'controllen' => socket_cmsg_space(SOL_SOCKET, SCM_RIGHTS, self::HANDOFF_BATCH)
+            ];
+            $w_ret = @socket_recvmsg($p_socket, $msg, 0);
+            if($w_ret !== 12)
             {
-                $id = $this->iio_driver->registerUdpListen($p_socket);
+                return false;
             }
-            else
+            $hdr = unpack('Ncount/Jlength', $msg['iov'][0]);
+            if($hdr['count'] === 0 && $hdr['length'] === 0)
             {
-                $id = $this->iio_driver->registerListen($p_socket);
+                return true;
             }
-        }
-        else
-        {
-            $flg = $p_udp;
-            if($flg === null)
+
+            $sockets = [];
+            foreach($msg['control'] ?? [] as $cmsg)
             {
-                $flg = true;
+                if($cmsg['level'] === SOL_SOCKET && $cmsg['type'] === SCM_RIGHTS)
+                {
+                    $sockets = array_merge($sockets, $cmsg['data']);
+                }
             }
-            $id = $this->iio_driver->register($p_socket, $flg, $p_is_client);
-        }
-
-        // ソケットの接続IDを生成
-        $cid = '#'.$id;
-
-        // ソケット要素の反映
-        $this->sockets[$cid] = $p_socket;
-
-        $this->descriptors[$cid] = [];
-
-        // 接続ID
-        $this->descriptors[$cid]['connection_id'] = $cid;
-
-        // リモートアドレス
-        $this->descriptors[$cid]['remote'] = [
-            'host' => null,
-            'port' => null
-        ];
-
-        // UDPフラグ
-        $this->descriptors[$cid]['udp'] = $p_udp;
-
-        // readイベントフラグ
-        $this->descriptors[$cid]['read_event'] = false;
-
-        // UDPクライアントリスト
-        $this->descriptors[$cid]['udp_peers'] = null;
 
-        // 送信バッファスタック
-        $this->descriptors[$cid]['send_buffers'] = [];
-
-        // 受信バッファスタック
-        $this->descriptors[$cid]['receive_buffers'] = [];
-
-        // 受信バッファ
-        $this->descriptors[$cid]['receiving_buffer'] = [
-            'size' => null,
-            'data' => null,
-            'receiving_size' => 0
-        ];
-
-        // 送信バッファ
-        $this->descriptors[$cid]['sending_buffer'] = [
-            'data' => null,
-        ];
-
-        // ピックアップ受信バッファ（コマンドUNIT用）
-        $this->descriptors[$cid]['receive_buffer'] = null;
-
-        // ピックアップ送信バッファ（プロトコルUNIT用）
-        $this->descriptors[$cid]['send_buffer'] = null;
+            $payload = '';
+            while(strlen($payload) < $hdr['length'])
+            {
+                $buf = '';
+                $w_ret = @socket_recv($p_socket, $buf, self::HANDOFF_CHUNK, 0);
+                if($w_ret === false || $w_ret === 0)
+                {
+                    return false;
+                }
+                $payload .= $buf;
+            }
+            $entries = @unserialize($payload);
+            if(!is_array($entries) || count($entries) !== $hdr['count'] || count($sockets) !== $hdr['count'])
+            {
+                return false;
+            }
 
-        // 切断情報バッファ
-        $this->descriptors[$cid]['close_buffer'] = null;
+            foreach($entries as $idx => $entry)
+            {
+                if($p_listen === false && $entry['type'] === 'listen')
+                {
+                    return false;
+                }
+                $w_ret = $this->adoptHandoffEntry($entry, $sockets[$idx]);
+                if($w_ret === false)
+                {
+                    return false;
+                }
+                $p_map[$entry['cid']] = $w_ret;
+            }
+        }
+    }
 
-        // プロトコル用
-        $this->descriptors[$cid]['protocol_names'] = [
-              'queue_name' => null	// キュー名
-            , 'status_name' => null	// ステータス名
-        ];
+    /**
+     * 引き継ぎで受け取ったソケットの登録
+     * 
+     * @param array $p_entry エントリ
+     * @param Socket $p_socket ソケットリソース
+     * @return string|false 接続ID or false（失敗）
+     */
+    private function adoptHandoffEntry(array $p_entry, Socket $p_socket): string|false
+    {
+        $listen = ($p_entry['type'] === 'listen');
+        $w_ret = $this->createDescriptor($p_socket, false, $listen);
+        if($w_ret === false)
+        {
+            $this->logWriter('error', [__METHOD__ => LogMessageEnum::SOCKET_CREATE_FAIL->message($this->lang)]);
+            return false;
+        }
+        $cid = $w_ret['connection_id'];
 
-        // コマンド用
-        $this->descriptors[$cid]['command_names'] = [
-              'queue_name' => null	// キュー名
-            , 'status_name' => null	// ステータス名
-        ];
+        if($listen === true)
+        {
+            $this->await_host = $p_entry['host'];
+            $this->await_port = $p_entry['port'];
+            $this->await_connection_id = $cid;
+            $this->descriptors[$cid]['unix_address'] = $p_entry['unix_address'];
+            return $cid;
+        }
 
-        // 最終アクセス日時
-        $this->descriptors[$cid]['last_access_timestamp'] = time();
+        $this->importHandoffState($cid, $p_entry['state']);
 
-        // アライブチェックタイムアウト調整用
-        $this->descriptors[$cid]['alive_adjust_timeout'] = null;
+        return $cid;
+    }
 
-        // 強制ディスパッチフラグ
-        $this->descriptors[$cid]['forced_dispatcher'] = false;
+    /**
+     * ディスクリプタの手放し
+     * 
+     * ソケットは他のプロセスと共有しているため、shutdown（相手側へも及ぶ）やソケットファイルの削除は行わない
+     * 
+     * @param string $p_cid 接続ID
+     */
+    private function releaseDescriptor(string $p_cid)
+    {
+        if(!isset($this->descriptors[$p_cid]))
+        {
+            return;
+        }
 
-        // ユーザープロパティ（自由定義）
-        $this->descriptors[$cid]['user_property'] = [];
+        $fd = substr($p_cid, 1);
+        $this->iio_driver->unregister($fd);
+        @socket_close($this->sockets[$p_cid]);
 
-        // ノンブロッキングの設定
-        $w_ret = socket_set_nonblock($p_socket);
-        if($w_ret === false) {
-            $this->logWriter('error', [__METHOD__ => LogMessageEnum::NONBLOCK_SETTING_FAIL->message($this->lang)]);
-            return false;
+        if($p_cid === $this->await_connection_id)
+        {
+            $this->await_connection_id = null;
         }
-
-        return $this->descriptors[$cid];
+        unset($this->sockets[$p_cid]);
+        unset($this->descriptors[$p_cid]);
     }
 
 }
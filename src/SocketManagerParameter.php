@@ -8,6 +8,9 @@
 namespace SocketManager\Library;
 
 
+use Fiber;
+
+
 /**
  * UNITパラメータの基底クラス
  * 
@@ -54,6 +57,13 @@ class SocketManagerParameter implements IUnitParameter
      */
     public ISimpleSocketUdp|ISimpleSocketTcpServer|ISimpleSocketTcpClient|null $simple_socket = null;
 
+    /**
+     * コネクションプール
+     * 
+     * SimpleSocketGenerator で生成する TCP Client が使用する（UNIT間で共有される）
+     */
+    public ?SimpleSocketConnectionPool $connection_pool = null;
+
 
     //--------------------------------------------------------------------------
     // メソッド
@@ -453,6 +463,106 @@ class SocketManagerParameter implements IUnitParameter
         $this->setTempBuff(['__timeout' => null]);
     }
 
+    /**
+     * 受信の待機（Fiber UNIT 用）
+     * 
+     * 指定サイズを受信するまで Fiber を中断する。中断中は受信イベントがあった周期だけ再開する
+     * 
+     * @param int $p_size 受信サイズ
+     * @param ?int $p_timeout タイムアウト（ms。null は無制限）
+     * @return mixed 受信データ or null（タイムアウト。受信途中のデータは受信バッファに残る）
+     */
+    final public function awaitRecv(int $p_size, ?int $p_timeout = null)
+    {
+        $cid = $this->cid;
+        $limit = $this->deadline($p_timeout);
+        $this->protocol()->setReceivingSize($p_size);
+        while(true)
+        {
+            $w_ret = $this->protocol()->receiving();
+            if($w_ret !== null)
+            {
+                return $w_ret;
+            }
+            if($limit !== null && hrtime(true) >= $limit)
+            {
+                return null;
+            }
+            $this->suspend(['cid' => $cid, 'deadline' => $limit, 'cond' => null]);
+        }
+    }
+
+    /**
+     * 送信の待機（Fiber UNIT 用）
+     * 
+     * 送信データを送り切るまで Fiber を中断する（送信途中は周期ごとに再開する）
+     * 
+     * @param ?string $p_data 送信データ（null は setSendingData／setSendingFile で設定済みのデータ）
+     * @param ?int $p_timeout タイムアウト（ms。null は無制限）
+     * @return bool true（送信完了） or false（タイムアウト）
+     */
+    final public function awaitSend(?string $p_data = null, ?int $p_timeout = null): bool
+    {
+        $limit = $this->deadline($p_timeout);
+        if($p_data !== null)
+        {
+            $this->protocol()->setSendingData($p_data);
+        }
+        while(true)
+        {
+            $w_ret = $this->protocol()->sending();
+            if($w_ret !== null)
+            {
+                return true;
+            }
+            if($limit !== null && hrtime(true) >= $limit)
+            {
+                return false;
+            }
+            $this->suspend(null);
+        }
+    }
+
+    /**
+     * スリープ（Fiber UNIT 用）
+     * 
+     * 指定時間が経過するまで Fiber を中断する（周期ドリブン処理は止めない）
+     * 
+     * @param int $p_ms 時間（ms）
+     */
+    final public function sleep(int $p_ms)
+    {
+        $limit = $this->deadline(max(0, $p_ms));
+        $this->suspend(['cid' => null, 'deadline' => $limit, 'cond' => null]);
+    }
+
+    /**
+     * 条件の待機（Fiber UNIT 用）
+     * 
+     * 条件が true を返すか、タイムアウトするまで Fiber を中断する  
+     * 条件は他の接続の周期でも評価されるため、必要な値は use で取り込んでおくこと
+     * 
+     * @param callable $p_cond 条件（引数なし、戻り値 bool）
+     * @param int $p_timeout タイムアウト（ms）
+     * @return bool true（条件成立） or false（タイムアウト）
+     */
+    final public function awaitTimeout(callable $p_cond, int $p_timeout): bool
+    {
+        $limit = $this->deadline(max(0, $p_timeout));
+        while(true)
+        {
+            if($p_cond() === true)
+            {
+                return true;
+            }
+            if(hrtime(true) >= $limit)
+            {
+                return false;
+            }
+            $this->suspend(['cid' => null, 'deadline' => $limit, 'cond' => $p_cond]);
+        }
+    }
+
     /**
      * プロトコルUNIT処理を中断する
      * 
@@ -868,6 +978,83 @@ class SocketManagerParameter implements IUnitParameter
         return $this->manager->getSockName($cid, $p_host, $p_port);
     }
 
+    /**
+     * 接続相手の資格情報を取得（UNIX ドメインのストリーム用）
+     * 
+     * @param ?string $p_cid 接続ID
+     * @return ?array ['pid' => int, 'uid' => int, 'gid' => int] or null（取得できない）
+     */
+    final public function getPeerCredentials(?string $p_cid = null): ?array
+    {
+        $cid = $this->cid;
+        if($p_cid !== null)
+        {
+            $cid = $p_cid;
+        }
+
+        return $this->manager->getPeerCredentials($cid);
+    }
+
+    /**
+     * ジョブのオフロード
+     * 
+     * 登録済みの処理を子プロセスで実行する（SocketManager::offload を参照）
+     * 
+     * @param string $p_name 処理名
+     * @param mixed $p_payload ペイロード
+     * @param ?string $p_queue 完了時に開始するコマンドUNITのキュー名（null は受信データスタックへ積む）
+     * @param ?string $p_status 完了時に開始するステータス名
+     * @param ?string $p_cid 接続ID
+     * @return int|false ジョブID or false（失敗）
+     */
+    final public function offload(string $p_name, $p_payload, ?string $p_queue = null, ?string $p_status = null, ?string $p_cid = null): int|false
+    {
+        $cid = $this->cid;
+        if($p_cid !== null)
+        {
+            $cid = $p_cid;
+        }
+
+        return $this->manager->offload($cid, $p_name, $p_payload, $p_queue, $p_status);
+    }
+
+    /**
+     * 期限の算出（Fiber UNIT 用）
+     * 
+     * @param ?int $p_ms 時間（ms） or null（無期限）
+     * @return ?int 期限（hrtime） or null（無期限）
+     */
+    private function deadline(?int $p_ms): ?int
+    {
+        if($p_ms === null)
+        {
+            return null;
+        }
+
+        return hrtime(true) + $p_ms * 1000000;
+    }
+
+    /**
+     * Fiber の中断
+     * 
+     * 受信待ちとタイマーは CycleDrivenManager が索引を作り、該当する周期だけ再開する（条件 'cond' は毎周期評価される）
+     * 
+     * @param ?array $p_wait 再開条件（['cid' => 受信を待つ接続ID or null, 'deadline' => 期限（hrtime ns） or null, 'cond' => 条件（callable） or null]） or null（次の周期で再開）
+     */
+    private function suspend(?array $p_wait)
+    {
+        if(Fiber::getCurrent() === null)
+        {
+            throw new UnitException(
+                UnitExceptionEnum::ECODE_FIBER_REQUIRED->message(),
+                UnitExceptionEnum::ECODE_FIBER_REQUIRED->value,
+                $this
+            );
+        }
+
+        Fiber::suspend($p_wait);
+    }
+
     /**
      * リモートアドレスの取得
      * 
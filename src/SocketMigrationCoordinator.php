@@ -0,0 +1,283 @@
+<?php
+/**
+ * ライブラリファイル
+ * 
+ * コネクションマイグレーションのコーディネーターのファイル
+ */
+
+namespace SocketManager\Library;
+
+
+use Socket;
+
+
+/**
+ * コネクションマイグレーションのコーディネータークラス
+ * 
+ * SocketManager::enableMigration で待ち受けている各プロセスへ負荷を問い合わせ、
+ * 接続数が偏っている場合は最も多いプロセスへ、最も少ないプロセスへの接続の移動を指示する
+ * 
+ * 問い合わせは同期で行うため、対象のプロセス以外（RuntimeManager の UNIT 等）から定期的に balance を呼び出す
+ */
+final class SocketMigrationCoordinator
+{
+    //--------------------------------------------------------------------------
+    // 定数
+    //--------------------------------------------------------------------------
+
+    /**
+     * UNIX ドメインソケットのアドレス接頭辞
+     */
+    private const UNIX_ADDRESS_PREFIX = 'unix://';
+
+    /**
+     * 応答の受信サイズ
+     */
+    private const RESPONSE_SIZE = 4096;
+
+
+    //--------------------------------------------------------------------------
+    // プロパティ
+    //--------------------------------------------------------------------------
+
+    /**
+     * 対象プロセスのアドレスリスト（enableMigration に指定したアドレス）
+     */
+    private array $workers = [];
+
+    /**
+     * 偏りとみなす接続数の差の割合（最も多いプロセスの接続数に対する割合）
+     */
+    private float $threshold = 0.2;
+
+    /**
+     * 偏りとみなす接続数の差の下限
+     */
+    private int $min_difference = 10;
+
+    /**
+     * 1 回に移動する最大接続数
+     */
+    private int $max_batch = 100;
+
+    /**
+     * 送受信タイムアウト（秒）
+     */
+    private int $timeout = 10;
+
+    /**
+     * 統計情報
+     */
+    private array $statistics = [
+        'rounds' => 0,      // balance の呼び出し回数
+        'migrations' => 0,  // 移動を指示した回数
+        'moved' => 0,       // 移動した接続数
+        'failures' => 0     // 問い合わせ／指示の失敗回数
+    ];
+
+
+    //--------------------------------------------------------------------------
+    // メソッド
+    //--------------------------------------------------------------------------
+
+    /**
+     * コンストラクタ
+     * 
+     * @param array $p_workers 対象プロセスのアドレスリスト（'unix:///path' or 'unix://@name'）
+     * @param float $p_threshold 偏りとみなす接続数の差の割合
+     * @param int $p_min_difference 偏りとみなす接続数の差の下限
+     * @param int $p_max_batch 1 回に移動する最大接続数
+     */
+    public function __construct(array $p_workers, float $p_threshold = 0.2, int $p_min_difference = 10, int $p_max_batch = 100)
+    {
+        $this->workers = array_values($p_workers);
+        $this->threshold = max(0.0, $p_threshold);
+        $this->min_difference = max(1, $p_min_difference);
+        $this->max_batch = max(1, $p_max_batch);
+    }
+
+    /**
+     * 負荷情報の収集
+     * 
+     * @return array アドレス => 負荷情報（SocketManager::getLoad の戻り値） or null（応答なし）
+     */
+    public function collect(): array
+    {
+        $ret = [];
+        foreach($this->workers as $worker)
+        {
+            $w_ret = $this->request($worker, ['op' => 'load']);
+            if($w_ret === false)
+            {
+                $this->statistics['failures']++;
+                $ret[$worker] = null;
+                continue;
+            }
+            $ret[$worker] = $w_ret;
+        }
+
+        return $ret;
+    }
+
+    /**
+     * 負荷の平準化
+     * 
+     * 接続数が最も多いプロセスから最も少ないプロセスへ、差の半分（最大接続数まで）の移動を指示する
+     * 周期ドリブン処理の所要時間が平均の 2 倍を超えるプロセスは、接続数が少なくても移動先にしない
+     * 
+     * @return int 移動した接続数
+     */
+    public function balance(): int
+    {
+        $this->statistics['rounds']++;
+
+        $loads = array_filter($this->collect(), fn($load) => $load !== null);
+        if(count($loads) < 2)
+        {
+            return 0;
+        }
+
+        $avg = array_sum(array_column($loads, 'cycle_time')) / count($loads);
+        $from = null;
+        $to = null;
+        foreach($loads as $worker => $load)
+        {
+            if($from === null || $load['connections'] > $loads[$from]['connections'])
+            {
+                $from = $worker;
+            }
+            if($avg > 0 && $load['cycle_time'] > $avg * 2)
+            {
+                continue;
+            }
+            if($to === null || $load['connections'] < $loads[$to]['connections'])
+            {
+                $to = $worker;
+            }
+        }
+        if($to === null || $from === $to)
+        {
+            return 0;
+        }
+
+        $diff = $loads[$from]['connections'] - $loads[$to]['connections'];
+        if($diff < $this->min_difference || $diff < $loads[$from]['connections'] * $this->threshold)
+        {
+            return 0;
+        }
+        $cnt = min(intdiv($diff, 2), $this->max_batch, $loads[$from]['movable']);
+        if($cnt <= 0)
+        {
+            return 0;
+        }
+
+        $w_ret = $this->request($from, ['op' => 'migrate', 'to' => $to, 'count' => $cnt]);
+        if($w_ret === false)
+        {
+            $this->statistics['failures']++;
+            return 0;
+        }
+        $this->statistics['migrations']++;
+        $this->statistics['moved'] += $w_ret['moved'];
+
+        return $w_ret['moved'];
+    }
+
+    /**
+     * 統計情報の取得
+     * 
+     * @return array rounds／migrations／moved／failures の各件数
+     */
+    public function getStatistics(): array
+    {
+        return $this->statistics;
+    }
+
+
+    //--------------------------------------------------------------------------
+    // 内部処理
+    //--------------------------------------------------------------------------
+
+    /**
+     * 要求の送信と応答の受信
+     * 
+     * @param string $p_worker 対象プロセスのアドレス
+     * @param array $p_request 要求
+     * @return array|false 応答 or false（失敗）
+     */
+    private function request(string $p_worker, array $p_request): array|false
+    {
+        $address = $this->unixAddress($p_worker);
+        if($address === null)
+        {
+            return false;
+        }
+
+        $soc = @socket_create(AF_UNIX, SOCK_SEQPACKET, 0);
+        if($soc === false)
+        {
+            return false;
+        }
+        socket_set_option($soc, SOL_SOCKET, SO_RCVTIMEO, ['sec' => $this->timeout, 'usec' => 0]);
+        socket_set_option($soc, SOL_SOCKET, SO_SNDTIMEO, ['sec' => $this->timeout, 'usec' => 0]);
+
+        $ret = false;
+        $dat = serialize($p_request);
+        if(@socket_connect($soc, $address) !== false && @socket_send($soc, $dat, strlen($dat), 0) !== false)
+        {
+            $buf = '';
+            $w_ret = @socket_recv($soc, $buf, self::RESPONSE_SIZE, 0);
+            if($w_ret !== false && $w_ret > 0)
+            {
+                $res = @unserialize($buf, ['allowed_classes' => false]);
+                if(is_array($res))
+                {
+                    $ret = $res;
+                }
+            }
+        }
+        $this->close($soc);
+
+        return $ret;
+    }
+
+    /**
+     * UNIX ドメインソケットのアドレス変換
+     * 
+     * @param string $p_worker 'unix:///path' or 'unix://@name'
+     * @return ?string ソケット関数に渡すアドレス or null（不正なアドレス）
+     */
+    private function unixAddress(string $p_worker): ?string
+    {
+        if(strncmp($p_worker, self::UNIX_ADDRESS_PREFIX, strlen(self::UNIX_ADDRESS_PREFIX)) !== 0)
+        {
+            return null;
+        }
+
+        $path = substr($p_worker, strlen(self::UNIX_ADDRESS_PREFIX));
+        if(strlen($path) < 2)
+        {
+            return null;
+        }
+        if($path[0] === '@')
+        {
+            return "\0".substr($path, 1);
+        }
+        if($path[0] === '/')
+        {
+            return $path;
+        }
+
+        return null;
+    }
+
+    /**
+     * ソケットクローズ
+     * 
+     * @param Socket $p_socket ソケットリソース
+     */
+    private function close(Socket $p_socket): void
+    {
+        @socket_close($p_socket);
+    }
+}
@@ -0,0 +1,77 @@
+<?php
+/**
+ * ソケットチューニングプロファイルのEnumファイル
+ * 
+ * ライブラリ用
+ */
+
+namespace SocketManager\Library;
+
+
+/**
+ * ソケットチューニングプロファイルのEnum定義
+ * 
+ * SocketManager::setSocketProfile、または IInitSocketManager::getSocketProfile で指定する
+ * 個別に調整したい場合は options() と同じ形式の配列を直接指定できる
+ */
+enum SocketProfileEnum: string
+{
+    //--------------------------------------------------------------------------
+    // 定数
+    //--------------------------------------------------------------------------
+
+    /**
+     * @var string 低レイテンシ（小さなメッセージを即時に送受信する）
+     */
+    case LATENCY = 'latency';
+
+    /**
+     * @var string 一括転送（スループット優先）
+     */
+    case BULK = 'bulk';
+
+
+    //--------------------------------------------------------------------------
+    // メソッド
+    //--------------------------------------------------------------------------
+
+    /**
+     * オプション配列を返す
+     * 
+     * 指定のないキーは変更されない（OS の既定値のまま）
+     * 
+     * ― nodelay：TCP_NODELAY（bool）
+     * 
+     * ― sndbuf／rcvbuf：SO_SNDBUF／SO_RCVBUF（バイト。指定すると自動調整は無効になる）
+     * 
+     * ― quickack：TCP_QUICKACK（bool。Linux のみ）
+     * 
+     * ― notsent_lowat：TCP_NOTSENT_LOWAT（バイト。Linux のみ）
+     * 
+     * ― busy_poll：SO_BUSY_POLL（μs。Linux のみ）
+     * 
+     * ― user_timeout：TCP_USER_TIMEOUT（ms。Linux のみ）
+     * 
+     * ― keepalive：SO_KEEPALIVE（bool）
+     * 
+     * ― keepidle／keepintvl／keepcnt：TCP_KEEPIDLE／TCP_KEEPINTVL（秒）／TCP_KEEPCNT
+     * 
+     * @return array オプション配列
+     */
+    public function options(): array
+    {
+        return match($this)
+        {
+            self::LATENCY => [
+                'nodelay' => true,
+                'quickack' => true,
+                'notsent_lowat' => 16384
+            ],
+            self::BULK => [
+                'nodelay' => false,
+                'sndbuf' => 4194304,
+                'rcvbuf' => 4194304
+            ]
+        };
+    }
+}
@@ -114,6 +114,11 @@ enum UnitExceptionEnum: int
      */
     case ECODE_ALIVE_CHECK_FAIL = 190;
 
+    /**
+     * @var int Fiber UNIT 以外での待機
+     */
+    case ECODE_FIBER_REQUIRED = 200;
+
     /**
      * @var int 緊急停止
      */
@@ -186,6 +191,7 @@ enum UnitExceptionEnum: int
                 self::ECODE_REQUEST_CLOSE => 'クライアント要求による切断',
                 self::ECODE_FORCE_CLOSE => 'クライアント強制要求による切断',
                 self::ECODE_ALIVE_CHECK_FAIL => 'アライブチェックの実行失敗',
+                self::ECODE_FIBER_REQUIRED => 'Fiber UNIT 以外での待機',
                 self::ECODE_EMERGENCY_SHUTDOWN => '緊急停止',
                 self::ECODE_FINISH_SHUTDOWN => 'アプリ終了',
                 self::ECODE_THROW_BREAK => 'スローブレイク発生',
@@ -218,6 +224,7 @@ enum UnitExceptionEnum: int
                 self::ECODE_REQUEST_CLOSE => 'Disconnection due to client request',
                 self::ECODE_FORCE_CLOSE => 'Disconnection due to client forced request',
                 self::ECODE_ALIVE_CHECK_FAIL => 'Alive check execution failure',
+                self::ECODE_FIBER_REQUIRED => 'Await called outside a fiber unit',
                 self::ECODE_EMERGENCY_SHUTDOWN => 'emergency stop',
                 self::ECODE_FINISH_SHUTDOWN => 'application stop',
                 self::ECODE_THROW_BREAK => 'Throw break occurs',
@@ -0,0 +1,319 @@
+<?php
+/**
+ * ライブラリファイル
+ * 
+ * UNIT プロファイラーのファイル
+ */
+
+namespace SocketManager\Library;
+
+
+/**
+ * UNIT プロファイラークラス
+ * 
+ * SocketManager::setProfiler で連携し、UNIT の実行（executeUnit）とコマンドディスパッチャーの呼び出しを
+ * 種別／キュー名／ステータス名ごとに計測する（p99 の悪化がどの UNIT によるものかを調べるため）
+ * 
+ * 計測はサンプリングで行い（平均 sample_rate 回に 1 回）、集計は固定サイズの配列に持つ
+ * 呼び出し回数と合計時間はサンプル数にサンプリング間隔を掛けた推定値になる
+ * 
+ * 一定間隔で集計表をログへ出力し、フォールデッドスタック（flamegraph.pl 等の入力形式）をファイルへ追記する
+ */
+final class UnitProfiler
+{
+    //--------------------------------------------------------------------------
+    // 定数
+    //--------------------------------------------------------------------------
+
+    /**
+     * 集計枠が足りなくなった時にまとめる枠のラベル
+     */
+    private const OVERFLOW_LABEL = '(other)';
+
+
+    //--------------------------------------------------------------------------
+    // プロパティ
+    //--------------------------------------------------------------------------
+
+    /**
+     * サンプリング間隔（平均 何回に 1 回計測するか）
+     */
+    private int $sample_rate = 16;
+
+    /**
+     * 集計枠の数（最後の枠は溢れた分をまとめる）
+     */
+    private int $capacity = 256;
+
+    /**
+     * 集計表の出力間隔（ナノ秒）
+     */
+    private int $interval = 60000000000;
+
+    /**
+     * フォールデッドスタックの出力先（null は出力しない）
+     */
+    private ?string $folded_path = null;
+
+    /**
+     * 次の計測までの残り回数
+     */
+    private int $countdown = 1;
+
+    /**
+     * 次の集計表の出力時刻（hrtime）
+     */
+    private int $next_report = 0;
+
+    /**
+     * 集計の開始時刻（hrtime）
+     */
+    private int $window_start = 0;
+
+    /**
+     * 計測対象のキー（種別 "\t" キュー名 "\t" ステータス名） => 集計枠の番号
+     */
+    private array $slots = [];
+
+    /**
+     * 集計枠の番号 => [種別, キュー名, ステータス名]
+     */
+    private array $labels = [];
+
+    /**
+     * 集計枠の番号 => サンプル数
+     */
+    private array $samples = [];
+
+    /**
+     * 集計枠の番号 => 合計時間（ナノ秒）
+     */
+    private array $total = [];
+
+    /**
+     * 集計枠の番号 => 最大時間（ナノ秒）
+     */
+    private array $max = [];
+
+    /**
+     * 集計枠の番号 => メモリ使用量の増減の合計（バイト）
+     */
+    private array $memory = [];
+
+
+    //--------------------------------------------------------------------------
+    // メソッド
+    //--------------------------------------------------------------------------
+
+    /**
+     * コンストラクタ
+     * 
+     * @param int $p_sample_rate サンプリング間隔（1 は全件計測）
+     * @param int $p_interval 集計表の出力間隔（秒）
+     * @param ?string $p_folded_path フォールデッドスタックの出力先（追記する）
+     * @param int $p_capacity 集計枠の数
+     */
+    public function __construct(int $p_sample_rate = 16, int $p_interval = 60, ?string $p_folded_path = null, int $p_capacity = 256)
+    {
+        $this->sample_rate = max(1, $p_sample_rate);
+        $this->interval = max(1, $p_interval) * 1000000000;
+        $this->folded_path = $p_folded_path;
+        $this->capacity = max(2, $p_capacity);
+        $this->reset();
+    }
+
+    /**
+     * 計測対象の判定
+     * 
+     * 呼び出しごとに 1 回だけ呼ぶ。間隔は周期的な処理順と同期しないように平均 sample_rate の乱数にする
+     * 
+     * @return bool true（計測する） or false（計測しない）
+     */
+    public function sample(): bool
+    {
+        if(--$this->countdown > 0)
+        {
+            return false;
+        }
+        $this->countdown = $this->sample_rate > 1 ? mt_rand(1, $this->sample_rate * 2 - 1) : 1;
+
+        return true;
+    }
+
+    /**
+     * 計測結果の記録
+     * 
+     * @param string $p_kind 種別（'protocol_names'／'command_names'／'dispatcher'）
+     * @param ?string $p_que キュー名
+     * @param ?string $p_sta ステータス名
+     * @param int $p_elapsed 所要時間（ナノ秒）
+     * @param int $p_memory メモリ使用量の増減（バイト）
+     */
+    public function record(string $p_kind, ?string $p_que, ?string $p_sta, int $p_elapsed, int $p_memory)
+    {
+        $key = $p_kind."\t".$p_que."\t".$p_sta;
+        $idx = $this->slots[$key] ?? null;
+        if($idx === null)
+        {
+            // 最後の枠は溢れた分の集計に使う
+            $idx = count($this->slots);
+            if($idx >= $this->capacity - 1)
+            {
+                $idx = $this->capacity - 1;
+            }
+            else
+            {
+                $this->slots[$key] = $idx;
+                $this->labels[$idx] = [$p_kind, $p_que, $p_sta];
+            }
+        }
+
+        $this->samples[$idx]++;
+        $this->total[$idx] += $p_elapsed;
+        $this->memory[$idx] += $p_memory;
+        if($p_elapsed > $this->max[$idx])
+        {
+            $this->max[$idx] = $p_elapsed;
+        }
+    }
+
+    /**
+     * 集計表の出力時刻の検査
+     * 
+     * @return bool true（出力時刻） or false（まだ）
+     */
+    public function isDue(): bool
+    {
+        return hrtime(true) >= $this->next_report;
+    }
+
+    /**
+     * 集計表の取得
+     * 
+     * 推定合計時間の降順
+     * 
+     * @return array [['kind' => 種別, 'queue' => キュー名, 'status' => ステータス名, 'samples' => サンプル数,
+     * 'calls' => 推定呼び出し回数, 'total_us' => 推定合計時間, 'avg_us' => 平均時間, 'max_us' => 最大時間, 'avg_memory' => メモリ増減の平均],...]
+     */
+    public function getTable(): array
+    {
+        $ret = [];
+        foreach($this->samples as $idx => $cnt)
+        {
+            if($cnt <= 0)
+            {
+                continue;
+            }
+            [$kind, $que, $sta] = $this->labels[$idx];
+            $ret[] = [
+                'kind' => $kind,
+                'queue' => $que,
+                'status' => $sta,
+                'samples' => $cnt,
+                'calls' => $cnt * $this->sample_rate,
+                'total_us' => intdiv($this->total[$idx] * $this->sample_rate, 1000),
+                'avg_us' => intdiv($this->total[$idx], $cnt * 1000),
+                'max_us' => intdiv($this->max[$idx], 1000),
+                'avg_memory' => intdiv($this->memory[$idx], $cnt)
+            ];
+        }
+        usort($ret, fn($a, $b) => $b['total_us'] <=> $a['total_us']);
+
+        return $ret;
+    }
+
+    /**
+     * 集計表の整形
+     * 
+     * @return string ログ出力用の表
+     */
+    public function formatTable(): string
+    {
+        $secs = max(1, intdiv(hrtime(true) - $this->window_start, 1000000000));
+        $ret = sprintf("%-14s %-24s %-24s %10s %12s %8s %8s %10s\n", 'kind', 'queue', 'status', 'calls/s', 'total_us', 'avg_us', 'max_us', 'avg_mem');
+        foreach($this->getTable() as $row)
+        {
+            $ret .= sprintf(
+                "%-14s %-24s %-24s %10d %12d %8d %8d %10d\n",
+                $row['kind'], $row['queue'] ?? '-', $row['status'] ?? '-',
+                intdiv($row['calls'], $secs), $row['total_us'], $row['avg_us'], $row['max_us'], $row['avg_memory']
+            );
+        }
+
+        return $ret;
+    }
+
+    /**
+     * フォールデッドスタックの取得
+     * 
+     * 1 行が「種別;キュー名;ステータス名 推定合計時間（μs）」の形式
+     * 
+     * @return string フォールデッドスタック
+     */
+    public function getFolded(): string
+    {
+        $ret = '';
+        foreach($this->getTable() as $row)
+        {
+            if($row['total_us'] <= 0)
+            {
+                continue;
+            }
+            $frames = [$row['kind']];
+            foreach([$row['queue'], $row['status']] as $frame)
+            {
+                if($frame !== null && $frame !== '')
+                {
+                    $frames[] = $frame;
+                }
+            }
+            $ret .= str_replace([' ', "\n"], '_', implode(';', str_replace(';', '_', $frames)))." {$row['total_us']}\n";
+        }
+
+        return $ret;
+    }
+
+    /**
+     * 集計の出力とリセット
+     * 
+     * フォールデッドスタックを出力先へ追記し、次の集計を始める（flamegraph.pl は同じスタックを合算する）
+     * 
+     * @return bool true（成功） or false（出力先への書き込みに失敗）
+     */
+    public function flush(): bool
+    {
+        $ret = true;
+        if($this->folded_path !== null)
+        {
+            $dat = $this->getFolded();
+            if($dat !== '' && @file_put_contents($this->folded_path, $dat, FILE_APPEND | LOCK_EX) === false)
+            {
+                $ret = false;
+            }
+        }
+        $this->reset();
+
+        return $ret;
+    }
+
+
+    //--------------------------------------------------------------------------
+    // 内部処理
+    //--------------------------------------------------------------------------
+
+    /**
+     * 集計のリセット
+     * 
+     * 集計枠は固定サイズで確保し直す（キーの割り当ては残す）
+     */
+    private function reset()
+    {
+        $this->samples = array_fill(0, $this->capacity, 0);
+        $this->total = array_fill(0, $this->capacity, 0);
+        $this->max = array_fill(0, $this->capacity, 0);
+        $this->memory = array_fill(0, $this->capacity, 0);
+        $this->labels[$this->capacity - 1] = [self::OVERFLOW_LABEL, null, null];
+        $this->window_start = hrtime(true);
+        $this->next_report = $this->window_start + $this->interval;
+    }
+}